@@ -0,0 +1,268 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "AsyncLoadCoordinator.h"
+
+#include "Engine/AssetManager.h"
+#include "Engine/StreamableManager.h"
+#include "HAL/IConsoleManager.h"
+#include "Stats/Stats.h"
+#include "UObject/StrongObjectPtr.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogAsyncLoadCoordinator, Log, All);
+
+namespace AsyncLoadCoordinator
+{
+	static bool bCoalesceLoads = true;
+	static FAutoConsoleVariableRef CVarCoalesceLoads(
+		TEXT("AsyncMixin.CoalesceLoads"),
+		bCoalesceLoads,
+		TEXT("If true, async mix-ins share loads of the same paths and send the paths requested during a frame as one streamable handle."),
+		ECVF_Default);
+}
+
+struct FAsyncLoadCoordinator::FLoadBatch
+{
+	TSharedPtr<FStreamableHandle> Handle;
+	TArray<TWeakPtr<FAsyncLoadRequest::FPathLoad>> PathLoads;
+	bool bCompleted = false;
+};
+
+struct FAsyncLoadRequest::FPathLoad
+{
+	FSoftObjectPath Path;
+	bool bLoaded = false;
+
+	// Keeps an object that was already loaded when requested around until the requests for it are done, like a handle would
+	TStrongObjectPtr<UObject> ResolvedObject;
+
+	// Set once the path has been sent to the streamable manager
+	TSharedPtr<FAsyncLoadCoordinator::FLoadBatch> Batch;
+
+	TArray<TWeakPtr<FAsyncLoadRequest>> Requests;
+};
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+
+FAsyncLoadRequest::FAsyncLoadRequest()
+{
+}
+
+FAsyncLoadRequest::~FAsyncLoadRequest()
+{
+}
+
+bool FAsyncLoadRequest::IsComplete() const
+{
+	for (const TSharedRef<FPathLoad>& PathLoad : PathLoads)
+	{
+		if (!PathLoad->bLoaded)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool FAsyncLoadRequest::BindCompleteDelegate(const FSimpleDelegate& NewDelegate)
+{
+	if (IsComplete())
+	{
+		// Too Late!
+		return false;
+	}
+
+	CompleteDelegate = NewDelegate;
+	return true;
+}
+
+void FAsyncLoadRequest::Cancel()
+{
+	CompleteDelegate.Unbind();
+
+	// Dropping the path loads releases their batch handle once nobody else wants them
+	PathLoads.Reset();
+}
+
+void FAsyncLoadRequest::TryComplete()
+{
+	if (CompleteDelegate.IsBound() && IsComplete())
+	{
+		FSimpleDelegate DelegateToCall = MoveTemp(CompleteDelegate);
+		CompleteDelegate.Unbind();
+		DelegateToCall.Execute();
+	}
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+
+FAsyncLoadCoordinator& FAsyncLoadCoordinator::Get()
+{
+	static FAsyncLoadCoordinator Coordinator;
+	return Coordinator;
+}
+
+bool FAsyncLoadCoordinator::IsEnabled()
+{
+	return AsyncLoadCoordinator::bCoalesceLoads;
+}
+
+TSharedRef<FAsyncLoadRequest> FAsyncLoadCoordinator::RequestLoad(TConstArrayView<FSoftObjectPath> SoftObjectPaths)
+{
+	check(IsInGameThread());
+
+	TSharedRef<FAsyncLoadRequest> Request = MakeShared<FAsyncLoadRequest>();
+
+	for (const FSoftObjectPath& SoftObjectPath : SoftObjectPaths)
+	{
+		if (SoftObjectPath.IsNull())
+		{
+			continue;
+		}
+
+		NumPathsRequested++;
+
+		TSharedPtr<FAsyncLoadRequest::FPathLoad> PathLoad = PathLoads.FindRef(SoftObjectPath).Pin();
+		if (PathLoad.IsValid())
+		{
+			NumPathsShared++;
+		}
+		else
+		{
+			PathLoad = MakeShared<FAsyncLoadRequest::FPathLoad>();
+			PathLoad->Path = SoftObjectPath;
+
+			UObject* ResolvedObject = SoftObjectPath.ResolveObject();
+			if (ResolvedObject && !ResolvedObject->HasAnyFlags(RF_NeedLoad | RF_NeedPostLoad) && !ResolvedObject->HasAnyInternalFlags(EInternalObjectFlags::AsyncLoading))
+			{
+				PathLoad->bLoaded = true;
+				PathLoad->ResolvedObject.Reset(ResolvedObject);
+			}
+			else
+			{
+				PendingPathLoads.Add(PathLoad);
+				ScheduleFlush();
+			}
+
+			PathLoads.Add(SoftObjectPath, PathLoad);
+		}
+
+		PathLoad->Requests.Add(Request);
+		Request->PathLoads.Add(PathLoad.ToSharedRef());
+	}
+
+	return Request;
+}
+
+void FAsyncLoadCoordinator::ScheduleFlush()
+{
+	if (!FlushDelegateHandle.IsValid())
+	{
+		FlushDelegateHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([this](float DeltaTime) {
+			QUICK_SCOPE_CYCLE_COUNTER(STAT_FAsyncLoadCoordinator_FlushPendingLoads);
+			FlushDelegateHandle.Reset();
+			FlushPendingLoads();
+			return false;
+		}));
+	}
+}
+
+void FAsyncLoadCoordinator::FlushPendingLoads()
+{
+	check(IsInGameThread());
+
+	if (FlushDelegateHandle.IsValid())
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker(FlushDelegateHandle);
+		FlushDelegateHandle.Reset();
+	}
+
+	// Forget paths nobody is waiting on anymore
+	for (auto It = PathLoads.CreateIterator(); It; ++It)
+	{
+		if (!It.Value().IsValid())
+		{
+			It.RemoveCurrent();
+		}
+	}
+
+	TSharedRef<FLoadBatch> Batch = MakeShared<FLoadBatch>();
+	TArray<FSoftObjectPath> PathsToLoad;
+
+	for (const TWeakPtr<FAsyncLoadRequest::FPathLoad>& WeakPathLoad : PendingPathLoads)
+	{
+		// Loads canceled by every request before the flush are dropped
+		if (TSharedPtr<FAsyncLoadRequest::FPathLoad> PathLoad = WeakPathLoad.Pin())
+		{
+			PathLoad->Batch = Batch;
+			Batch->PathLoads.Add(PathLoad);
+			PathsToLoad.Add(PathLoad->Path);
+		}
+	}
+	PendingPathLoads.Reset();
+
+	if (PathsToLoad.Num() == 0)
+	{
+		return;
+	}
+
+	UE_LOG(LogAsyncLoadCoordinator, Verbose, TEXT("Requesting %d paths as one handle"), PathsToLoad.Num());
+
+	NumHandlesCreated++;
+
+	const TWeakPtr<FLoadBatch> WeakBatch = Batch;
+	Batch->Handle = UAssetManager::GetStreamableManager().RequestAsyncLoad(PathsToLoad, FStreamableDelegate::CreateLambda([this, WeakBatch]() {
+		if (TSharedPtr<FLoadBatch> LoadedBatch = WeakBatch.Pin())
+		{
+			CompleteBatch(LoadedBatch.ToSharedRef());
+		}
+	}), FStreamableManager::AsyncLoadHighPriority, false, false, TEXT("AsyncMixin"));
+
+	if (!Batch->Handle.IsValid() || Batch->Handle->HasLoadCompleted())
+	{
+		CompleteBatch(Batch);
+	}
+}
+
+void FAsyncLoadCoordinator::CompleteBatch(const TSharedRef<FLoadBatch>& Batch)
+{
+	if (Batch->bCompleted)
+	{
+		return;
+	}
+
+	Batch->bCompleted = true;
+
+	TArray<TSharedRef<FAsyncLoadRequest>> RequestsToComplete;
+	for (const TWeakPtr<FAsyncLoadRequest::FPathLoad>& WeakPathLoad : Batch->PathLoads)
+	{
+		if (TSharedPtr<FAsyncLoadRequest::FPathLoad> PathLoad = WeakPathLoad.Pin())
+		{
+			PathLoad->bLoaded = true;
+
+			for (const TWeakPtr<FAsyncLoadRequest>& WeakRequest : PathLoad->Requests)
+			{
+				if (TSharedPtr<FAsyncLoadRequest> Request = WeakRequest.Pin())
+				{
+					RequestsToComplete.AddUnique(Request.ToSharedRef());
+				}
+			}
+			PathLoad->Requests.Reset();
+		}
+	}
+
+	// Each request tells its own mix-in, which runs its steps in order
+	for (const TSharedRef<FAsyncLoadRequest>& Request : RequestsToComplete)
+	{
+		Request->TryComplete();
+	}
+}
+
+void FAsyncLoadCoordinator::ResetStats()
+{
+	NumHandlesCreated = 0;
+	NumPathsRequested = 0;
+	NumPathsShared = 0;
+}
@@ -2,6 +2,7 @@
 
 #include "AsyncMixin.h"
 
+#include "AsyncLoadCoordinator.h"
 #include "Engine/AssetManager.h"
 #include "Engine/StreamableManager.h"
 #include "Stats/Stats.h"
@@ -228,12 +229,19 @@ void FAsyncMixin::FLoadingState::AsyncLoad(FSoftObjectPath SoftObjectPath, const
 {
 	UE_LOG(LogAsyncMixin, Verbose, TEXT("[0x%X] AsyncLoad '%s'"), this, *SoftObjectPath.ToString());
 
-	AsyncSteps.Add(
-		MakeUnique<FAsyncStep>(
-			DelegateToCall,
-			UAssetManager::GetStreamableManager().RequestAsyncLoad(SoftObjectPath, FStreamableDelegate(), FStreamableManager::AsyncLoadHighPriority, false, false, TEXT("AsyncMixin"))
-			)
-	);
+	if (FAsyncLoadCoordinator::IsEnabled())
+	{
+		AsyncSteps.Add(MakeUnique<FAsyncStep>(DelegateToCall, TSharedPtr<FAsyncLoadRequest>(FAsyncLoadCoordinator::Get().RequestLoad(MakeArrayView(&SoftObjectPath, 1)))));
+	}
+	else
+	{
+		AsyncSteps.Add(
+			MakeUnique<FAsyncStep>(
+				DelegateToCall,
+				UAssetManager::GetStreamableManager().RequestAsyncLoad(SoftObjectPath, FStreamableDelegate(), FStreamableManager::AsyncLoadHighPriority, false, false, TEXT("AsyncMixin"))
+				)
+		);
+	}
 
 	TryScheduleStart();
 }
@@ -245,12 +253,19 @@ void FAsyncMixin::FLoadingState::AsyncLoad(const TArray<FSoftObjectPath>& SoftOb
 		UE_LOG(LogAsyncMixin, Verbose, TEXT("[0x%X] AsyncLoad [%s]"), this, *Paths);
 	}
 
-	AsyncSteps.Add(
-		MakeUnique<FAsyncStep>(
-			DelegateToCall,
-			UAssetManager::GetStreamableManager().RequestAsyncLoad(SoftObjectPaths, FStreamableDelegate(), FStreamableManager::AsyncLoadHighPriority, false, false, TEXT("AsyncMixin"))
-			)
-	);
+	if (FAsyncLoadCoordinator::IsEnabled())
+	{
+		AsyncSteps.Add(MakeUnique<FAsyncStep>(DelegateToCall, TSharedPtr<FAsyncLoadRequest>(FAsyncLoadCoordinator::Get().RequestLoad(SoftObjectPaths))));
+	}
+	else
+	{
+		AsyncSteps.Add(
+			MakeUnique<FAsyncStep>(
+				DelegateToCall,
+				UAssetManager::GetStreamableManager().RequestAsyncLoad(SoftObjectPaths, FStreamableDelegate(), FStreamableManager::AsyncLoadHighPriority, false, false, TEXT("AsyncMixin"))
+				)
+		);
+	}
 
 	TryScheduleStart();
 }
@@ -446,6 +461,12 @@ FAsyncMixin::FLoadingState::FAsyncStep::FAsyncStep(const FSimpleDelegate& InUser
 {
 }
 
+FAsyncMixin::FLoadingState::FAsyncStep::FAsyncStep(const FSimpleDelegate& InUserCallback, const TSharedPtr<FAsyncLoadRequest>& InLoadRequest)
+	: UserCallback(InUserCallback)
+	, LoadRequest(InLoadRequest)
+{
+}
+
 FAsyncMixin::FLoadingState::FAsyncStep::~FAsyncStep()
 {
 
@@ -467,6 +488,10 @@ bool FAsyncMixin::FLoadingState::FAsyncStep::IsComplete() const
 	{
 		return Condition->IsComplete();
 	}
+	else if (LoadRequest.IsValid())
+	{
+		return LoadRequest->IsComplete();
+	}
 
 	return true;
 }
@@ -482,6 +507,11 @@ void FAsyncMixin::FLoadingState::FAsyncStep::Cancel()
 	{
 		Condition.Reset();
 	}
+	else if (LoadRequest.IsValid())
+	{
+		LoadRequest->Cancel();
+		LoadRequest.Reset();
+	}
 
 	bIsCompletionDelegateBound = false;
 }
@@ -502,6 +532,10 @@ bool FAsyncMixin::FLoadingState::FAsyncStep::BindCompleteDelegate(const FSimpleD
 	{
 		Condition->BindCompleteDelegate(NewDelegate);
 	}
+	else if (LoadRequest)
+	{
+		LoadRequest->BindCompleteDelegate(NewDelegate);
+	}
 
 	bIsCompletionDelegateBound = true;
 
@@ -0,0 +1,88 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Containers/Ticker.h"
+#include "UObject/SoftObjectPath.h"
+
+class FAsyncLoadCoordinator;
+
+/**
+ * A load made through the FAsyncLoadCoordinator, complete once every path it asked for has loaded.  Paths are shared with
+ * any other request for them, so this only tracks what it is waiting on.
+ */
+class ASYNCMIXIN_API FAsyncLoadRequest : public TSharedFromThis<FAsyncLoadRequest>
+{
+public:
+	FAsyncLoadRequest();
+	~FAsyncLoadRequest();
+
+	bool IsComplete() const;
+
+	/** Calls the delegate once the request completes, returns false if it has already. */
+	bool BindCompleteDelegate(const FSimpleDelegate& NewDelegate);
+
+	/** Stops listening and releases the paths, they keep loading as long as another request wants them. */
+	void Cancel();
+
+private:
+	void TryComplete();
+
+	struct FPathLoad;
+	TArray<TSharedRef<FPathLoad>> PathLoads;
+	FSimpleDelegate CompleteDelegate;
+
+	friend FAsyncLoadCoordinator;
+};
+
+/**
+ * The FAsyncLoadCoordinator is used by every FAsyncMixin to load soft object paths.  Identical paths requested by different
+ * mix-ins share one load, and all of the paths requested during a frame are sent to the streamable manager as a single
+ * combined handle on the next tick, rather than one handle per async step.  Paths that are already loaded complete
+ * immediately, the same as a streamable handle for them would.
+ *
+ * Can be disabled with AsyncMixin.CoalesceLoads=0, async steps then request their own streamable handles again.
+ */
+class ASYNCMIXIN_API FAsyncLoadCoordinator : public FNoncopyable
+{
+public:
+	static FAsyncLoadCoordinator& Get();
+
+	/** Should async mix-ins load through the coordinator? */
+	static bool IsEnabled();
+
+	/** Requests the paths, they start loading on the next tick unless FlushPendingLoads is called first. */
+	TSharedRef<FAsyncLoadRequest> RequestLoad(TConstArrayView<FSoftObjectPath> SoftObjectPaths);
+
+	/** Sends everything requested since the last flush to the streamable manager as one handle. */
+	void FlushPendingLoads();
+
+	/** Number of streamable handles created for requests. */
+	int32 GetNumHandlesCreated() const { return NumHandlesCreated; }
+
+	/** Number of paths requested, and how many of those joined a load another request had already made. */
+	int32 GetNumPathsRequested() const { return NumPathsRequested; }
+	int32 GetNumPathsShared() const { return NumPathsShared; }
+
+	void ResetStats();
+
+private:
+	struct FLoadBatch;
+
+	void ScheduleFlush();
+	void CompleteBatch(const TSharedRef<FLoadBatch>& Batch);
+
+	// Every path that has a request waiting on it
+	TMap<FSoftObjectPath, TWeakPtr<FAsyncLoadRequest::FPathLoad>> PathLoads;
+
+	// Paths requested since the last flush
+	TArray<TWeakPtr<FAsyncLoadRequest::FPathLoad>> PendingPathLoads;
+
+	FTSTicker::FDelegateHandle FlushDelegateHandle;
+
+	int32 NumHandlesCreated = 0;
+	int32 NumPathsRequested = 0;
+	int32 NumPathsShared = 0;
+
+	friend FAsyncLoadRequest;
+};
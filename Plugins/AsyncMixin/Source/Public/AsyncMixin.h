@@ -6,6 +6,7 @@
 #include "UObject/SoftObjectPtr.h"
 
 class FAsyncCondition;
+class FAsyncLoadRequest;
 class FName;
 class UPrimaryDataAsset;
 struct FPrimaryAssetId;
@@ -249,6 +250,7 @@ private:
 			FAsyncStep(const FSimpleDelegate& InUserCallback);
 			FAsyncStep(const FSimpleDelegate& InUserCallback, const TSharedPtr<FStreamableHandle>& InStreamingHandle);
 			FAsyncStep(const FSimpleDelegate& InUserCallback, const TSharedPtr<FAsyncCondition>& InCondition);
+			FAsyncStep(const FSimpleDelegate& InUserCallback, const TSharedPtr<FAsyncLoadRequest>& InLoadRequest);
 
 			~FAsyncStep();
 
@@ -272,6 +274,7 @@ private:
 			// Possible Async 'thing'
 			TSharedPtr<FStreamableHandle> StreamingHandle;
 			TSharedPtr<FAsyncCondition> Condition;
+			TSharedPtr<FAsyncLoadRequest> LoadRequest;
 		};
 
 		bool bHasStarted = false;
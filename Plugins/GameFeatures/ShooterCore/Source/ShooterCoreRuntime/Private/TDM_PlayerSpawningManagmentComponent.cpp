@@ -67,7 +67,7 @@ AActor* UTDM_PlayerSpawningManagmentComponent::OnChoosePlayerStart(AController*
 							FallbackMaxDistance = Distance;
 						}
 					}
-					else if (PlayerStart->GetLocationOccupancy(Player) < ELyraPlayerStartLocationOccupancy::Full)
+					else if (GetCachedLocationOccupancy(PlayerStart, Player) < ELyraPlayerStartLocationOccupancy::Full)
 					{
 						if (BestPlayerStart == nullptr || Distance > MaxDistance)
 						{
@@ -0,0 +1,254 @@
+// Copyright Epic Games, Inc.All Rights Reserved.
+
+#include "CQTest.h"
+
+#if WITH_AUTOMATION_TESTS
+
+#include "AbilitySystem/Attributes/LyraHealthSet.h"
+#include "AbilitySystem/LyraAbilitySystemComponent.h"
+#include "AttributeSet.h"
+#include "Character/LyraCharacterWithAbilities.h"
+#include "Components/MapTestSpawner.h"
+#include "Engine/DataTable.h"
+#include "GameFeatures/GameFeatureAction_AddAbilities.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "Helpers/CQTestAssetHelper.h"
+#include "UObject/Package.h"
+
+/**
+ * Measures UGameFeatureAction_AddAbilities granting abilities and an initialized attribute set to many pawns at once.
+ *
+ * An action granting a few Blueprint abilities and a ULyraHealthSet initialized from a data table to ALyraCharacterWithAbilities is
+ * activated in the shooter test map, then 64 pawns are spawned. This is done once with Lyra.GameFeatures.PreloadAbilityGrants off so
+ * every pawn loads and parses what it's granted itself, and once with it on so the action loads and parses it when it activates.
+ * The time to spawn the pawns without the action is subtracted to get the time spent granting, and the synchronous package loads
+ * while spawning are counted. Pawns spawned while the preload is still running must be granted once it finishes.
+ *
+ * Each TEST_METHOD will register with the `AbilityGrantTest` test object and has the variables and methods from `AbilityGrantTest` available for use.
+ */
+TEST_CLASS_WITH_FLAGS(AbilityGrantTest, "Project.Functional Tests.ShooterTests.Performance.Abilities", EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+{
+	static constexpr int32 NumPawns = 64;
+	static constexpr int32 NumEarlyPawns = 8;
+	static constexpr float InitialHealth = 42.0f;
+
+	struct FSpawnResult
+	{
+		double SpawnMs = 0.0;
+		int32 NumSyncLoads = 0;
+	};
+
+	TUniquePtr<FMapTestSpawner> Spawner;
+	UGameFeatureAction_AddAbilities* Action{ nullptr };
+	UDataTable* InitializationData{ nullptr };
+	TArray<TSoftClassPtr<UGameplayAbility>> AbilityTypes;
+	TArray<TWeakObjectPtr<ALyraCharacterWithAbilities>> SpawnedPawns;
+	bool bSavedPreloadAbilityGrants = true;
+	int32 NumSpawned = 0;
+	FSpawnResult BaselineResult;
+	FSpawnResult SyncResult;
+	FSpawnResult PreloadResult;
+
+	IConsoleVariable* GetPreloadVariable()
+	{
+		IConsoleVariable* Variable = IConsoleManager::Get().FindConsoleVariable(TEXT("Lyra.GameFeatures.PreloadAbilityGrants"));
+		check(Variable);
+		return Variable;
+	}
+
+	void CreateAction()
+	{
+		// Rows are named the way UAttributeSet::InitFromMetaDataTable looks them up
+		InitializationData = NewObject<UDataTable>(GetTransientPackage(), TEXT("DT_ShooterTestsAbilityGrantInit"));
+		InitializationData->RowStruct = FAttributeMetaData::StaticStruct();
+		FAttributeMetaData Row;
+		Row.BaseValue = InitialHealth;
+		InitializationData->AddRow(TEXT("LyraHealthSet.Health"), Row);
+		InitializationData->AddRow(TEXT("LyraHealthSet.MaxHealth"), Row);
+		InitializationData->AddToRoot();
+
+		AbilityTypes.Add(TSoftClassPtr<UGameplayAbility>(FSoftObjectPath(TEXT("/Game/Characters/Heroes/Abilities/GA_Hero_Heal.GA_Hero_Heal_C"))));
+		AbilityTypes.Add(TSoftClassPtr<UGameplayAbility>(FSoftObjectPath(TEXT("/ShooterCore/Game/Emote/GA_Emote.GA_Emote_C"))));
+		AbilityTypes.Add(TSoftClassPtr<UGameplayAbility>(FSoftObjectPath(TEXT("/ShooterCore/Game/Melee/GA_Melee.GA_Melee_C"))));
+
+		FGameFeatureAbilitiesEntry Entry;
+		Entry.ActorClass = ALyraCharacterWithAbilities::StaticClass();
+		for (const TSoftClassPtr<UGameplayAbility>& AbilityType : AbilityTypes)
+		{
+			FLyraAbilityGrant& Grant = Entry.GrantedAbilities.AddDefaulted_GetRef();
+			Grant.AbilityType = AbilityType;
+		}
+
+		FLyraAttributeSetGrant& AttributeGrant = Entry.GrantedAttributes.AddDefaulted_GetRef();
+		AttributeGrant.AttributeSetType = ULyraHealthSet::StaticClass();
+		AttributeGrant.InitializationData = InitializationData;
+
+		Action = NewObject<UGameFeatureAction_AddAbilities>(GetTransientPackage());
+		Action->AbilitiesList.Add(Entry);
+		Action->AddToRoot();
+	}
+
+	void ActivateAction(bool bPreload)
+	{
+		GetPreloadVariable()->Set(bPreload, ECVF_SetByCode);
+
+		FGameFeatureActivatingContext ActivatingContext;
+		static_cast<UGameFeatureAction*>(Action)->OnGameFeatureActivating(ActivatingContext);
+	}
+
+	void DeactivateAction()
+	{
+		FGameFeatureDeactivatingContext DeactivatingContext(TEXT("ShooterTests"), [](FStringView) {});
+		static_cast<UGameFeatureAction*>(Action)->OnGameFeatureDeactivating(DeactivatingContext);
+	}
+
+	FSpawnResult SpawnPawns(int32 Count)
+	{
+		FSpawnResult Result;
+
+		FDelegateHandle SyncLoadHandle = FCoreUObjectDelegates::OnSyncLoadPackage.AddLambda([&Result](const FString&) { ++Result.NumSyncLoads; });
+
+		FActorSpawnParameters SpawnParameters;
+		SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+		const double StartTime = FPlatformTime::Seconds();
+		for (int32 Index = 0; Index < Count; ++Index)
+		{
+			const FVector Location(200.0 * (NumSpawned % 16), 200.0 * (NumSpawned / 16), 1000.0);
+			SpawnedPawns.Add(Spawner->GetWorld().SpawnActor<ALyraCharacterWithAbilities>(ALyraCharacterWithAbilities::StaticClass(), Location, FRotator::ZeroRotator, SpawnParameters));
+			++NumSpawned;
+		}
+		Result.SpawnMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+		FCoreUObjectDelegates::OnSyncLoadPackage.Remove(SyncLoadHandle);
+		return Result;
+	}
+
+	void DestroyPawns()
+	{
+		for (const TWeakObjectPtr<ALyraCharacterWithAbilities>& Pawn : SpawnedPawns)
+		{
+			if (Pawn.IsValid())
+			{
+				Pawn->Destroy();
+			}
+		}
+		SpawnedPawns.Reset();
+		NumSpawned = 0;
+	}
+
+	static bool HasGrants(const ALyraCharacterWithAbilities* Pawn, TConstArrayView<TSoftClassPtr<UGameplayAbility>> AbilityTypes)
+	{
+		const UAbilitySystemComponent* AbilitySystemComponent = Pawn ? Pawn->GetAbilitySystemComponent() : nullptr;
+		if (!AbilitySystemComponent)
+		{
+			return false;
+		}
+
+		for (const TSoftClassPtr<UGameplayAbility>& AbilityType : AbilityTypes)
+		{
+			if (!AbilityType.Get() || !AbilitySystemComponent->FindAbilitySpecFromClass(AbilityType.Get()))
+			{
+				return false;
+			}
+		}
+
+		// The granted set is added after the pawn's own, and is the only one initialized from the table
+		for (const UAttributeSet* AttributeSet : AbilitySystemComponent->GetSpawnedAttributes())
+		{
+			const ULyraHealthSet* HealthSet = Cast<ULyraHealthSet>(AttributeSet);
+			if (HealthSet && (HealthSet->GetHealth() == InitialHealth) && (HealthSet->GetMaxHealth() == InitialHealth))
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	bool AllPawnsHaveGrants()
+	{
+		for (const TWeakObjectPtr<ALyraCharacterWithAbilities>& Pawn : SpawnedPawns)
+		{
+			if (!HasGrants(Pawn.Get(), AbilityTypes))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	BEFORE_EACH()
+	{
+		bSavedPreloadAbilityGrants = GetPreloadVariable()->GetBool();
+
+		const FString LevelName = TEXT("L_ShooterTest_Basic");
+
+		TOptional<FString> PackagePath = CQTestAssetHelper::FindAssetPackagePathByName(LevelName);
+		ASSERT_THAT(IsTrue(PackagePath.IsSet(), "Could not find the level package."));
+		Spawner = MakeUnique<FMapTestSpawner>(PackagePath.GetValue(), LevelName);
+		Spawner->AddWaitUntilLoadedCommand(TestRunner);
+
+		const FTimespan LoadingScreenTimeout = FTimespan::FromSeconds(30);
+		TestCommandBuilder
+			.StartWhen([this]() { return nullptr != Spawner->FindFirstPlayerPawn(); }, LoadingScreenTimeout)
+			.Then([this]() { CreateAction(); });
+	}
+
+	AFTER_EACH()
+	{
+		GetPreloadVariable()->Set(bSavedPreloadAbilityGrants, ECVF_SetByCode);
+
+		if (Action)
+		{
+			Action->RemoveFromRoot();
+		}
+		if (InitializationData)
+		{
+			InitializationData->RemoveFromRoot();
+		}
+	}
+
+	TEST_METHOD(AbilityGrants_Spawn64Pawns_ReportsGrantTimeAndSyncLoads)
+	{
+		const FTimespan GrantTimeout = FTimespan::FromSeconds(30);
+
+		TestCommandBuilder
+			.Do([this]() {
+				BaselineResult = SpawnPawns(NumPawns);
+				DestroyPawns();
+			})
+			.Then([this]() {
+				ActivateAction(/*bPreload=*/ false);
+				SyncResult = SpawnPawns(NumPawns);
+				ASSERT_THAT(IsTrue(AllPawnsHaveGrants(), "Every pawn should be granted as it spawns when nothing is preloaded."));
+
+				DeactivateAction();
+				DestroyPawns();
+				CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+			})
+			.Then([this]() {
+				// These arrive while the preload may still be running, and wait for it
+				ActivateAction(/*bPreload=*/ true);
+				SpawnPawns(NumEarlyPawns);
+			})
+			.Until([this]() { return AllPawnsHaveGrants(); }, GrantTimeout)
+			.Then([this]() {
+				DestroyPawns();
+				PreloadResult = SpawnPawns(NumPawns);
+				ASSERT_THAT(IsTrue(AllPawnsHaveGrants(), "Every pawn should be granted as it spawns once the preload has finished."));
+				ASSERT_THAT(IsTrue(PreloadResult.NumSyncLoads <= SyncResult.NumSyncLoads, "Preloaded grants should not load more synchronously."));
+
+				DeactivateAction();
+				DestroyPawns();
+
+				const double SyncGrantMs = FMath::Max(0.0, SyncResult.SpawnMs - BaselineResult.SpawnMs) / NumPawns;
+				const double PreloadGrantMs = FMath::Max(0.0, PreloadResult.SpawnMs - BaselineResult.SpawnMs) / NumPawns;
+				TestRunner->AddInfo(FString::Printf(TEXT("Spawning %d pawns without grants: %.3f ms, %d synchronous loads"), NumPawns, BaselineResult.SpawnMs, BaselineResult.NumSyncLoads));
+				TestRunner->AddInfo(FString::Printf(TEXT("Loading and parsing per pawn: %.3f ms spawning, %.3f ms granting per pawn, %d synchronous loads"), SyncResult.SpawnMs, SyncGrantMs, SyncResult.NumSyncLoads));
+				TestRunner->AddInfo(FString::Printf(TEXT("Preloaded when activated: %.3f ms spawning, %.3f ms granting per pawn, %d synchronous loads"), PreloadResult.SpawnMs, PreloadGrantMs, PreloadResult.NumSyncLoads));
+			});
+	}
+};
+
+#endif // WITH_AUTOMATION_TESTS
@@ -0,0 +1,150 @@
+// Copyright Epic Games, Inc.All Rights Reserved.
+
+#include "CQTest.h"
+
+#if WITH_AUTOMATION_TESTS
+
+#include "AbilitySystemComponent.h"
+#include "Animation/LyraAnimInstance.h"
+#include "Async/ParallelFor.h"
+#include "Character/LyraCharacterWithAbilities.h"
+#include "Components/ActorTestSpawner.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/SkeletalMesh.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "LyraGameplayTags.h"
+
+/**
+ * Measures the game thread cost of updating ULyraAnimInstance for 100 characters, without rendering.
+ *
+ * A transient world hosts 100 falling characters with the mannequin mesh and a ULyraAnimInstance. Every frame each anim instance is
+ * updated the way a skeletal mesh component with a multithreaded animation update does it: the game thread part, then the parallel
+ * part spread over worker threads, then the game thread again. This is done with Lyra.Anim.ThreadSafeUpdate off, where the character
+ * is queried and the instance written in NativeUpdateAnimation, and with it on, where the proxy copies the character's state and
+ * NativeThreadSafeUpdateAnimation applies it. The test reports the game thread and worker time of each way, and checks both give the
+ * same ground distance and see the gameplay tags of the character.
+ *
+ * Each TEST_METHOD will register with the `AnimUpdateTest` test object and has the variables and methods from `AnimUpdateTest` available for use.
+ */
+TEST_CLASS_WITH_FLAGS(AnimUpdateTest, "Project.Functional Tests.ShooterTests.Performance.Animation", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+{
+	static constexpr int32 NumCharacters = 100;
+	static constexpr int32 NumFrames = 60;
+	static constexpr float DeltaSeconds = 1.0f / 30.0f;
+
+	struct FUpdateResult
+	{
+		double GameThreadMs = 0.0;
+		double WorkerMs = 0.0;
+		int32 NumFrames = 0;
+		FString GroundDistances;
+	};
+
+	FActorTestSpawner Spawner;
+	TArray<ULyraAnimInstance*> AnimInstances;
+	bool bSavedThreadSafeUpdate = true;
+	FUpdateResult GameThreadResult;
+	FUpdateResult ThreadSafeResult;
+
+	IConsoleVariable* GetThreadSafeVariable()
+	{
+		IConsoleVariable* Variable = IConsoleManager::Get().FindConsoleVariable(TEXT("Lyra.Anim.ThreadSafeUpdate"));
+		check(Variable);
+		return Variable;
+	}
+
+	static float GetGroundDistance(const ULyraAnimInstance* AnimInstance)
+	{
+		const FFloatProperty* Property = CastFieldChecked<FFloatProperty>(ULyraAnimInstance::StaticClass()->FindPropertyByName(TEXT("GroundDistance")));
+		return Property->GetPropertyValue_InContainer(AnimInstance);
+	}
+
+	// Runs one frame of animation updates, returns true once enough frames were measured
+	bool UpdateFrame(FUpdateResult& Result)
+	{
+		double StartTime = FPlatformTime::Seconds();
+		for (ULyraAnimInstance* AnimInstance : AnimInstances)
+		{
+			AnimInstance->UpdateAnimation(DeltaSeconds, false, UAnimInstance::EUpdateAnimationFlag::ForceParallelUpdate);
+		}
+		Result.GameThreadMs += (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+		StartTime = FPlatformTime::Seconds();
+		ParallelFor(AnimInstances.Num(), [this](int32 Index) { AnimInstances[Index]->ParallelUpdateAnimation(); });
+		Result.WorkerMs += (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+		StartTime = FPlatformTime::Seconds();
+		for (ULyraAnimInstance* AnimInstance : AnimInstances)
+		{
+			AnimInstance->PostUpdateAnimation();
+		}
+		Result.GameThreadMs += (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+		return ++Result.NumFrames >= NumFrames;
+	}
+
+	void VerifyUpdate(FUpdateResult& Result)
+	{
+		TArray<FString> GroundDistances;
+		for (ULyraAnimInstance* AnimInstance : AnimInstances)
+		{
+			GroundDistances.Add(FString::SanitizeFloat(GetGroundDistance(AnimInstance)));
+			ASSERT_THAT(IsTrue(AnimInstance->HasThreadSafeGameplayTag(LyraGameplayTags::Status_Crouching)));
+		}
+		Result.GroundDistances = FString::Join(GroundDistances, TEXT(","));
+	}
+
+	BEFORE_EACH()
+	{
+		bSavedThreadSafeUpdate = GetThreadSafeVariable()->GetBool();
+
+		USkeletalMesh* Mesh = LoadObject<USkeletalMesh>(nullptr, TEXT("/Game/Characters/Heroes/Mannequin/Meshes/SKM_Manny.SKM_Manny"));
+		ASSERT_THAT(IsNotNull(Mesh));
+
+		for (int32 Index = 0; Index < NumCharacters; ++Index)
+		{
+			ALyraCharacterWithAbilities& Character = Spawner.SpawnActor<ALyraCharacterWithAbilities>();
+			Character.SetActorLocation(FVector(150.0 * (Index % 10), 150.0 * (Index / 10), 1000.0));
+			Character.GetCharacterMovement()->SetMovementMode(MOVE_Falling);
+			Character.GetAbilitySystemComponent()->AddLooseGameplayTag(LyraGameplayTags::Status_Crouching);
+
+			USkeletalMeshComponent* MeshComponent = Character.GetMesh();
+			MeshComponent->SetSkeletalMesh(Mesh);
+			MeshComponent->SetAnimInstanceClass(ULyraAnimInstance::StaticClass());
+
+			ULyraAnimInstance* AnimInstance = Cast<ULyraAnimInstance>(MeshComponent->GetAnimInstance());
+			ASSERT_THAT(IsNotNull(AnimInstance));
+			AnimInstances.Add(AnimInstance);
+		}
+	}
+
+	AFTER_EACH()
+	{
+		GetThreadSafeVariable()->Set(bSavedThreadSafeUpdate, ECVF_SetByCode);
+	}
+
+	TEST_METHOD(AnimInstance_100Characters_ReportsGameThreadTime)
+	{
+		TestCommandBuilder
+			.Do([this]() { GetThreadSafeVariable()->Set(false, ECVF_SetByCode); })
+			.Until([this]() { return UpdateFrame(GameThreadResult); })
+			.Then([this]() {
+				VerifyUpdate(GameThreadResult);
+				GetThreadSafeVariable()->Set(true, ECVF_SetByCode);
+			})
+			.Until([this]() { return UpdateFrame(ThreadSafeResult); })
+			.Then([this]() {
+				VerifyUpdate(ThreadSafeResult);
+				ASSERT_THAT(AreEqual(GameThreadResult.GroundDistances, ThreadSafeResult.GroundDistances));
+
+				TestRunner->AddInfo(FString::Printf(TEXT("%d characters, game thread update: %.3f ms game thread, %.3f ms workers per frame"),
+					NumCharacters, GameThreadResult.GameThreadMs / NumFrames, GameThreadResult.WorkerMs / NumFrames));
+				TestRunner->AddInfo(FString::Printf(TEXT("%d characters, thread safe update: %.3f ms game thread, %.3f ms workers per frame"),
+					NumCharacters, ThreadSafeResult.GameThreadMs / NumFrames, ThreadSafeResult.WorkerMs / NumFrames));
+			});
+	}
+};
+
+#endif // WITH_AUTOMATION_TESTS
@@ -0,0 +1,269 @@
+// Copyright Epic Games, Inc.All Rights Reserved.
+
+#include "CQTest.h"
+
+#if WITH_AUTOMATION_TESTS
+
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "AsyncLoadCoordinator.h"
+#include "AsyncMixin.h"
+#include "Engine/Texture2D.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
+#include "UObject/UObjectGlobals.h"
+
+/** An async mix-in that records the order its steps called back in, and whether their paths were loaded by then. */
+class FShooterTestsAsyncLoader : public FAsyncMixin
+{
+public:
+	void AddLoadStep(const TArray<FSoftObjectPath>& Paths)
+	{
+		const int32 StepIndex = NumSteps++;
+		AsyncLoad(Paths, [this, Paths, StepIndex]()
+		{
+			CompletedSteps.Add(StepIndex);
+			NumUnloadedPaths += Paths.FilterByPredicate([](const FSoftObjectPath& Path) { return Path.ResolveObject() == nullptr; }).Num();
+		});
+	}
+
+	void AddEventStep()
+	{
+		const int32 StepIndex = NumSteps++;
+		AsyncEvent([this, StepIndex]() { CompletedSteps.Add(StepIndex); });
+	}
+
+	void Cancel()
+	{
+		CancelAsyncLoading();
+		NumCallbacksBeforeCancel = CompletedSteps.Num() + NumFinished;
+	}
+
+	int32 GetNumCallbacksAfterCancel() const
+	{
+		return CompletedSteps.Num() + NumFinished - NumCallbacksBeforeCancel;
+	}
+
+	using FAsyncMixin::StartAsyncLoading;
+	using FAsyncMixin::IsAsyncLoadingInProgress;
+
+	bool HasStepsInOrder() const
+	{
+		if (CompletedSteps.Num() != NumSteps)
+		{
+			return false;
+		}
+
+		for (int32 StepIndex = 0; StepIndex < NumSteps; ++StepIndex)
+		{
+			if (CompletedSteps[StepIndex] != StepIndex)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	int32 NumSteps = 0;
+	TArray<int32> CompletedSteps;
+	int32 NumUnloadedPaths = 0;
+	int32 NumFinished = 0;
+	int32 NumCallbacksBeforeCancel = 0;
+
+protected:
+	virtual void OnFinishedLoading() override
+	{
+		++NumFinished;
+	}
+};
+
+/**
+ * Measures 500 async mix-ins loading overlapping textures, as widgets and cosmetics do when a front end screen or a match opens.
+ *
+ * Each mix-in queues three loads of one to three textures from a shared pool followed by an event, and one in ten cancels right
+ * after starting. The same shape of requests runs on two disjoint halves of the pool, once with AsyncMixin.CoalesceLoads off so
+ * every load step requests its own streamable handle, and once with it on so FAsyncLoadCoordinator shares paths between mix-ins
+ * and sends each frame's requests as one handle. Both runs must call every step of the mix-ins that weren't canceled in order with
+ * its textures loaded, and nothing on the canceled ones after they cancel.
+ *
+ * Each TEST_METHOD will register with the `AsyncMixinLoadTest` test object and has the variables and methods from `AsyncMixinLoadTest` available for use.
+ */
+TEST_CLASS_WITH_FLAGS(AsyncMixinLoadTest, "Project.Functional Tests.ShooterTests.Performance.Loading", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+{
+	static constexpr int32 NumMixins = 500;
+	static constexpr int32 NumLoadStepsPerMixin = 3;
+	static constexpr int32 MaxPathsPerStep = 3;
+	static constexpr int32 CancelEveryNth = 10;
+	static constexpr int32 MaxPoolSize = 128;
+	static constexpr double TimeoutSeconds = 60.0;
+
+	struct FRunResult
+	{
+		double CompletionMs = 0.0;
+		int32 NumFrames = 0;
+		int32 NumHandles = 0;
+		int32 NumPathsShared = 0;
+		int32 NumOutOfOrder = 0;
+		int32 NumUnloadedPaths = 0;
+		int32 NumCanceledCallbacks = 0;
+		bool bTimedOut = false;
+	};
+
+	FRandomStream RandomStream{ 0x0A51 };
+	TArray<FSoftObjectPath> TexturePaths;
+	bool bSavedCoalesceLoads = true;
+
+	IConsoleVariable* GetCoalesceLoadsVariable()
+	{
+		IConsoleVariable* Variable = IConsoleManager::Get().FindConsoleVariable(TEXT("AsyncMixin.CoalesceLoads"));
+		check(Variable);
+		return Variable;
+	}
+
+	BEFORE_EACH()
+	{
+		bSavedCoalesceLoads = GetCoalesceLoadsVariable()->GetBool();
+
+		IAssetRegistry& AssetRegistry = FAssetRegistryModule::GetRegistry();
+		AssetRegistry.WaitForCompletion();
+
+		FARFilter Filter;
+		Filter.PackagePaths.Add(TEXT("/Game"));
+		Filter.bRecursivePaths = true;
+		Filter.ClassPaths.Add(UTexture2D::StaticClass()->GetClassPathName());
+
+		TArray<FAssetData> TextureAssets;
+		AssetRegistry.GetAssets(Filter, TextureAssets);
+		TextureAssets.Sort([](const FAssetData& A, const FAssetData& B) { return A.PackageName.LexicalLess(B.PackageName); });
+
+		// Textures nothing else has loaded yet, falling back to loaded ones which complete right away
+		for (const bool bAllowLoaded : { false, true })
+		{
+			for (const FAssetData& TextureAsset : TextureAssets)
+			{
+				if ((TexturePaths.Num() < MaxPoolSize) && (bAllowLoaded || !TextureAsset.IsAssetLoaded()))
+				{
+					TexturePaths.AddUnique(TextureAsset.GetSoftObjectPath());
+				}
+			}
+		}
+
+		ASSERT_THAT(IsTrue(TexturePaths.Num() >= 2));
+	}
+
+	AFTER_EACH()
+	{
+		GetCoalesceLoadsVariable()->Set(bSavedCoalesceLoads, ECVF_SetByCode);
+	}
+
+	FRunResult RunMixins(bool bCoalesceLoads, TConstArrayView<FSoftObjectPath> PoolPaths)
+	{
+		GetCoalesceLoadsVariable()->Set(bCoalesceLoads, ECVF_SetByCode);
+		FAsyncLoadCoordinator::Get().ResetStats();
+
+		FRunResult Result;
+
+		TArray<TUniquePtr<FShooterTestsAsyncLoader>> Loaders;
+		Loaders.Reserve(NumMixins);
+
+		const double StartTime = FPlatformTime::Seconds();
+
+		for (int32 MixinIndex = 0; MixinIndex < NumMixins; ++MixinIndex)
+		{
+			FShooterTestsAsyncLoader& Loader = *Loaders.Add_GetRef(MakeUnique<FShooterTestsAsyncLoader>());
+
+			for (int32 StepIndex = 0; StepIndex < NumLoadStepsPerMixin; ++StepIndex)
+			{
+				TArray<FSoftObjectPath> StepPaths;
+				const int32 NumStepPaths = RandomStream.RandRange(1, MaxPathsPerStep);
+				for (int32 PathIndex = 0; PathIndex < NumStepPaths; ++PathIndex)
+				{
+					StepPaths.Add(PoolPaths[RandomStream.RandHelper(PoolPaths.Num())]);
+				}
+				Loader.AddLoadStep(StepPaths);
+			}
+			Loader.AddEventStep();
+			Loader.StartAsyncLoading();
+
+			if ((MixinIndex % CancelEveryNth) == 0)
+			{
+				// Steps whose textures were already loaded may have called back while starting
+				Loader.Cancel();
+			}
+		}
+
+		// Without the coordinator every load step had its own handle
+		const int32 NumLoadSteps = NumMixins * NumLoadStepsPerMixin;
+
+		auto IsAnyLoading = [&Loaders]()
+		{
+			return Loaders.ContainsByPredicate([](const TUniquePtr<FShooterTestsAsyncLoader>& Loader) { return Loader->IsAsyncLoadingInProgress(); });
+		};
+
+		double LastTickTime = FPlatformTime::Seconds();
+		while (IsAnyLoading())
+		{
+			if ((FPlatformTime::Seconds() - StartTime) > TimeoutSeconds)
+			{
+				Result.bTimedOut = true;
+				break;
+			}
+
+			const double Now = FPlatformTime::Seconds();
+			FTSTicker::GetCoreTicker().Tick(static_cast<float>(Now - LastTickTime));
+			LastTickTime = Now;
+
+			ProcessAsyncLoading(/*bUseTimeLimit=*/ true, /*bUseFullTimeLimit=*/ false, 0.005);
+			++Result.NumFrames;
+		}
+
+		Result.CompletionMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+		Result.NumHandles = bCoalesceLoads ? FAsyncLoadCoordinator::Get().GetNumHandlesCreated() : NumLoadSteps;
+		Result.NumPathsShared = FAsyncLoadCoordinator::Get().GetNumPathsShared();
+
+		for (int32 MixinIndex = 0; MixinIndex < NumMixins; ++MixinIndex)
+		{
+			const FShooterTestsAsyncLoader& Loader = *Loaders[MixinIndex];
+			if ((MixinIndex % CancelEveryNth) == 0)
+			{
+				Result.NumCanceledCallbacks += Loader.GetNumCallbacksAfterCancel();
+			}
+			else
+			{
+				Result.NumOutOfOrder += (Loader.HasStepsInOrder() && (Loader.NumFinished == 1)) ? 0 : 1;
+				Result.NumUnloadedPaths += Loader.NumUnloadedPaths;
+			}
+		}
+
+		return Result;
+	}
+
+	TEST_METHOD(AsyncMixin_500MixinsWithOverlappingLoads_ReportsHandlesAndCompletionTime)
+	{
+		// Disjoint halves, so the second run can't find the first run's textures already loaded
+		const int32 HalfPoolSize = TexturePaths.Num() / 2;
+		const TConstArrayView<FSoftObjectPath> UncoalescedPaths = MakeArrayView(TexturePaths.GetData(), HalfPoolSize);
+		const TConstArrayView<FSoftObjectPath> CoalescedPaths = MakeArrayView(TexturePaths.GetData() + HalfPoolSize, HalfPoolSize);
+
+		const FRunResult UncoalescedResult = RunMixins(/*bCoalesceLoads=*/ false, UncoalescedPaths);
+		const FRunResult CoalescedResult = RunMixins(/*bCoalesceLoads=*/ true, CoalescedPaths);
+
+		for (const FRunResult* Result : { &UncoalescedResult, &CoalescedResult })
+		{
+			ASSERT_THAT(IsTrue(!Result->bTimedOut));
+			ASSERT_THAT(AreEqual(0, Result->NumOutOfOrder));
+			ASSERT_THAT(AreEqual(0, Result->NumUnloadedPaths));
+			ASSERT_THAT(AreEqual(0, Result->NumCanceledCallbacks));
+		}
+		ASSERT_THAT(IsTrue(CoalescedResult.NumHandles < UncoalescedResult.NumHandles));
+
+		TestRunner->AddInfo(FString::Printf(TEXT("%d mix-ins over %d textures, per step handles: %d handles, %.3f ms to complete over %d frames"),
+			NumMixins, HalfPoolSize, UncoalescedResult.NumHandles, UncoalescedResult.CompletionMs, UncoalescedResult.NumFrames));
+		TestRunner->AddInfo(FString::Printf(TEXT("%d mix-ins over %d textures, coalesced: %d handles (%d shared paths), %.3f ms to complete over %d frames"),
+			NumMixins, HalfPoolSize, CoalescedResult.NumHandles, CoalescedResult.NumPathsShared, CoalescedResult.CompletionMs, CoalescedResult.NumFrames));
+	}
+};
+
+#endif // WITH_AUTOMATION_TESTS
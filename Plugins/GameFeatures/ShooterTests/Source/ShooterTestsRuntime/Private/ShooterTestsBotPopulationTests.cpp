@@ -0,0 +1,127 @@
+// Copyright Epic Games, Inc.All Rights Reserved.
+
+#include "CQTest.h"
+
+#if WITH_AUTOMATION_TESTS
+
+#include "Components/MapTestSpawner.h"
+#include "EngineUtils.h"
+#include "GameModes/LyraBotCreationComponent.h"
+#include "GameModes/LyraExperienceManagerComponent.h"
+#include "HAL/PlatformMemory.h"
+#include "HAL/PlatformTime.h"
+#include "Helpers/CQTestAssetHelper.h"
+
+/**
+ * Measures ULyraBotCreationComponent while the bot population is changed at runtime.
+ *
+ * Loads the shooter performance map, clears the bots created by the experience, then raises the target population from 0 to 200
+ * and records the longest frame and the peak physical memory until every bot exists. The population is then halved and restored
+ * so the second ramp reuses pooled controllers and player states. Run with -nullrhi to measure a headless server.
+ *
+ * Each TEST_METHOD will register with the `BotPopulationRampTest` test object and has the variables and methods from `BotPopulationRampTest` available for use.
+ */
+TEST_CLASS_WITH_FLAGS(BotPopulationRampTest, "Project.Functional Tests.ShooterTests.Performance.Bots", EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+{
+	static constexpr int32 MaxBots = 200;
+
+	TUniquePtr<FMapTestSpawner> Spawner;
+	ULyraBotCreationComponent* BotComponent{ nullptr };
+
+	double LastFrameTime = 0.0;
+	double PeakFrameSeconds = 0.0;
+	uint64 PeakUsedPhysical = 0;
+	uint64 UsedPhysicalBeforeRamp = 0;
+	int32 NumFrames = 0;
+
+	bool HasExperienceLoaded()
+	{
+		AGameStateBase* GameState = Spawner->GetWorld().GetGameState();
+		ULyraExperienceManagerComponent* ExperienceComponent = GameState ? GameState->FindComponentByClass<ULyraExperienceManagerComponent>() : nullptr;
+		return ExperienceComponent && ExperienceComponent->IsExperienceLoaded();
+	}
+
+	int32 CountPawns()
+	{
+		int32 NumPawns = 0;
+		for (TActorIterator<APawn> It(&Spawner->GetWorld()); It; ++It)
+		{
+			++NumPawns;
+		}
+		return NumPawns;
+	}
+
+	void BeginRamp(int32 TargetBotCount)
+	{
+		LastFrameTime = FPlatformTime::Seconds();
+		PeakFrameSeconds = 0.0;
+		UsedPhysicalBeforeRamp = FPlatformMemory::GetStats().UsedPhysical;
+		PeakUsedPhysical = UsedPhysicalBeforeRamp;
+		NumFrames = 0;
+
+		BotComponent->SetTargetBotCount(TargetBotCount);
+	}
+
+	// Samples the frame that just finished, returns true once the population reached its target
+	bool SampleRampFrame()
+	{
+		const double Now = FPlatformTime::Seconds();
+		PeakFrameSeconds = FMath::Max(PeakFrameSeconds, Now - LastFrameTime);
+		LastFrameTime = Now;
+		PeakUsedPhysical = FMath::Max(PeakUsedPhysical, FPlatformMemory::GetStats().UsedPhysical);
+		++NumFrames;
+
+		return BotComponent->GetNumBots() == BotComponent->GetTargetBotCount();
+	}
+
+	void ReportRamp(const TCHAR* Label)
+	{
+		TestRunner->AddInfo(FString::Printf(TEXT("%s: %d frames, peak frame %.2f ms, peak used physical memory %.1f MB (+%.1f MB), %d pooled bots"),
+			Label, NumFrames, PeakFrameSeconds * 1000.0, PeakUsedPhysical / (1024.0 * 1024.0),
+			(static_cast<double>(PeakUsedPhysical) - static_cast<double>(UsedPhysicalBeforeRamp)) / (1024.0 * 1024.0), BotComponent->GetNumPooledBots()));
+	}
+
+	BEFORE_EACH()
+	{
+		const FString LevelName = TEXT("L_ShooterPerf");
+
+		TOptional<FString> PackagePath = CQTestAssetHelper::FindAssetPackagePathByName(LevelName);
+		ASSERT_THAT(IsTrue(PackagePath.IsSet(), "Could not find the level package."));
+		Spawner = MakeUnique<FMapTestSpawner>(PackagePath.GetValue(), LevelName);
+		Spawner->AddWaitUntilLoadedCommand(TestRunner);
+
+		const FTimespan LoadingScreenTimeout = FTimespan::FromSeconds(30);
+		TestCommandBuilder
+			.StartWhen([this]() { return HasExperienceLoaded(); }, LoadingScreenTimeout)
+			.Then([this]() {
+				BotComponent = Spawner->GetWorld().GetGameState()->FindComponentByClass<ULyraBotCreationComponent>();
+				ASSERT_THAT(IsNotNull(BotComponent, "The experience has no bot creation component."));
+				BotComponent->SetTargetBotCount(0);
+			})
+			.Until([this]() { return BotComponent->GetNumBots() == 0; });
+	}
+
+	TEST_METHOD(BotPopulation_RampTo200_ReportsPeakFrameTimeAndMemory)
+	{
+		const FTimespan RampTimeout = FTimespan::FromSeconds(120);
+
+		TestCommandBuilder
+			.Do([this]() { BeginRamp(MaxBots); })
+			.Until([this]() { return SampleRampFrame(); }, RampTimeout)
+			.Then([this]() {
+				ReportRamp(TEXT("0 to 200 bots"));
+				BotComponent->SetTargetBotCount(MaxBots / 2);
+			})
+			.Until([this]() { return BotComponent->GetNumBots() == (MaxBots / 2); }, RampTimeout)
+			// Pooled bots are only reused once their pawns finished dying
+			.Until([this]() { return (BotComponent->GetNumPooledBots() > 0) && (CountPawns() <= (MaxBots / 2) + 1); }, RampTimeout)
+			.Then([this]() { BeginRamp(MaxBots); })
+			.Until([this]() { return SampleRampFrame(); }, RampTimeout)
+			.Then([this]() {
+				ReportRamp(TEXT("100 to 200 bots, reusing pooled bots"));
+				ASSERT_THAT(AreEqual(MaxBots, BotComponent->GetNumBots()));
+			});
+	}
+};
+
+#endif // WITH_AUTOMATION_TESTS
@@ -0,0 +1,162 @@
+// Copyright Epic Games, Inc.All Rights Reserved.
+
+#include "CQTest.h"
+
+#if WITH_AUTOMATION_TESTS
+
+#include "Camera/LyraCameraComponent.h"
+#include "Camera/LyraCameraMode.h"
+#include "Components/ActorTestSpawner.h"
+#include "GameFramework/Character.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "UObject/UObjectHash.h"
+#include "Utilities/ShooterTestsCameraTestTypes.h"
+
+/**
+ * Measures camera updates per second of ULyraCameraModeStack with deep stacks.
+ *
+ * A character in a transient world gets a ULyraCameraComponent, and a stack is driven by pushing one of eight camera modes every
+ * frame, so all eight stay blended on the stack. Each run is done with Lyra.Camera.SkipUnchangedViews off, where every mode
+ * computes its view each frame as originally, and on, where modes only compute it again when their pivot or target changed.
+ * Both runs must produce the same view. Separate tests check that modes hidden under a finished blend are pruned, and that a
+ * mode whose field of view changed computes its view again.
+ *
+ * Each TEST_METHOD will register with the `CameraModeStackBenchmark` test object and has the variables and methods from `CameraModeStackBenchmark` available for use.
+ */
+TEST_CLASS_WITH_FLAGS(CameraModeStackBenchmark, "Project.Functional Tests.ShooterTests.Performance.Camera", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+{
+	static constexpr int32 NumFrames = 5000;
+	static constexpr float FrameTime = 1.0f / 60.0f;
+
+	FActorTestSpawner Spawner;
+	ACharacter* Character{ nullptr };
+	ULyraCameraComponent* CameraComponent{ nullptr };
+	TArray<TSubclassOf<ULyraCameraMode>> CameraModeClasses;
+	bool bSavedSkipUnchangedViews = true;
+
+	IConsoleVariable* GetSkipUnchangedViewsVariable()
+	{
+		IConsoleVariable* Variable = IConsoleManager::Get().FindConsoleVariable(TEXT("Lyra.Camera.SkipUnchangedViews"));
+		check(Variable);
+		return Variable;
+	}
+
+	BEFORE_EACH()
+	{
+		bSavedSkipUnchangedViews = GetSkipUnchangedViewsVariable()->GetBool();
+
+		Character = &Spawner.SpawnActor<ACharacter>();
+		CameraComponent = NewObject<ULyraCameraComponent>(Character);
+		CameraComponent->RegisterComponent();
+
+		CameraModeClasses = {
+			UShooterTestsCameraMode_A::StaticClass(), UShooterTestsCameraMode_B::StaticClass(), UShooterTestsCameraMode_C::StaticClass(), UShooterTestsCameraMode_D::StaticClass(),
+			UShooterTestsCameraMode_E::StaticClass(), UShooterTestsCameraMode_F::StaticClass(), UShooterTestsCameraMode_G::StaticClass(), UShooterTestsCameraMode_H::StaticClass()
+		};
+	}
+
+	AFTER_EACH()
+	{
+		GetSkipUnchangedViewsVariable()->Set(bSavedSkipUnchangedViews, ECVF_SetByCode);
+	}
+
+	// Pushes the next mode and evaluates the stack every frame, returns camera updates per second
+	double RunDeepStack(bool bSkipUnchangedViews, bool bMoveTarget, FLyraCameraModeView& OutView, int32& OutMinStackSize)
+	{
+		GetSkipUnchangedViewsVariable()->Set(bSkipUnchangedViews, ECVF_SetByCode);
+
+		ULyraCameraModeStack* Stack = NewObject<ULyraCameraModeStack>(CameraComponent);
+		Character->SetActorLocationAndRotation(FVector::ZeroVector, FRotator::ZeroRotator);
+		OutMinStackSize = MAX_int32;
+
+		const double StartTime = FPlatformTime::Seconds();
+		for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+		{
+			if (bMoveTarget)
+			{
+				Character->SetActorLocation(FVector(Frame * 5.0f, 0.0f, 0.0f));
+			}
+
+			Stack->PushCameraMode(CameraModeClasses[Frame % CameraModeClasses.Num()]);
+			Stack->EvaluateStack(FrameTime, OutView);
+
+			if (Frame >= CameraModeClasses.Num())
+			{
+				OutMinStackSize = FMath::Min(OutMinStackSize, Stack->GetStackSize());
+			}
+		}
+		const double ElapsedSeconds = FPlatformTime::Seconds() - StartTime;
+
+		return NumFrames / FMath::Max(ElapsedSeconds, UE_SMALL_NUMBER);
+	}
+
+	TEST_METHOD(CameraModeStack_DeepStack_ReportsUpdatesPerSecond)
+	{
+		for (const bool bMoveTarget : { false, true })
+		{
+			FLyraCameraModeView OriginalView;
+			FLyraCameraModeView CachedView;
+			int32 OriginalMinStackSize = 0;
+			int32 CachedMinStackSize = 0;
+
+			const double OriginalUpdatesPerSecond = RunDeepStack(/*bSkipUnchangedViews=*/ false, bMoveTarget, OriginalView, OriginalMinStackSize);
+			const double CachedUpdatesPerSecond = RunDeepStack(/*bSkipUnchangedViews=*/ true, bMoveTarget, CachedView, CachedMinStackSize);
+
+			ASSERT_THAT(IsTrue(CachedMinStackSize > 1));
+			ASSERT_THAT(AreEqual(OriginalMinStackSize, CachedMinStackSize));
+			ASSERT_THAT(IsTrue(OriginalView.Location.Equals(CachedView.Location, 0.01f)));
+			ASSERT_THAT(IsTrue(OriginalView.Rotation.Equals(CachedView.Rotation, 0.01f)));
+			ASSERT_THAT(IsNear(OriginalView.FieldOfView, CachedView.FieldOfView, 0.01f));
+
+			TestRunner->AddInfo(FString::Printf(TEXT("%d modes on the stack, %s target: %.0f camera updates per second computing every view, %.0f skipping unchanged views"),
+				CachedMinStackSize, bMoveTarget ? TEXT("moving") : TEXT("still"), OriginalUpdatesPerSecond, CachedUpdatesPerSecond));
+		}
+	}
+
+	TEST_METHOD(CameraModeStack_FinishedBlend_PrunesOccludedModes)
+	{
+		ULyraCameraModeStack* Stack = NewObject<ULyraCameraModeStack>(CameraComponent);
+		FLyraCameraModeView View;
+
+		for (const TSubclassOf<ULyraCameraMode>& CameraModeClass : CameraModeClasses)
+		{
+			Stack->PushCameraMode(CameraModeClass);
+			Stack->EvaluateStack(FrameTime, View);
+		}
+		ASSERT_THAT(AreEqual(CameraModeClasses.Num(), Stack->GetStackSize()));
+
+		// Once the top mode finished blending in nothing below it contributes
+		const int32 BlendFrames = FMath::CeilToInt(1.0f / FrameTime) + 1;
+		for (int32 Frame = 0; Frame < BlendFrames; ++Frame)
+		{
+			Stack->EvaluateStack(FrameTime, View);
+		}
+		ASSERT_THAT(AreEqual(1, Stack->GetStackSize()));
+	}
+
+	TEST_METHOD(CameraModeStack_FieldOfViewChanged_ComputesViewAgain)
+	{
+		GetSkipUnchangedViewsVariable()->Set(true, ECVF_SetByCode);
+
+		ULyraCameraModeStack* Stack = NewObject<ULyraCameraModeStack>(CameraComponent);
+		FLyraCameraModeView View;
+		Stack->PushCameraMode(UShooterTestsCameraMode_A::StaticClass());
+		Stack->EvaluateStack(FrameTime, View);
+		Stack->EvaluateStack(FrameTime, View);
+
+		// The stack creates its modes in the camera component
+		TArray<UObject*> CameraModes;
+		GetObjectsWithOuter(CameraComponent, CameraModes, /*bIncludeNestedObjects=*/ false);
+		UObject** CameraMode = CameraModes.FindByPredicate([](const UObject* Object) { return Object->IsA<UShooterTestsCameraMode_A>(); });
+		ASSERT_THAT(IsNotNull(CameraMode));
+
+		// Same pivot and target, only the field of view differs
+		const float NewFieldOfView = View.FieldOfView + 20.0f;
+		CastChecked<UShooterTestsCameraMode>(*CameraMode)->SetFieldOfView(NewFieldOfView);
+		Stack->EvaluateStack(FrameTime, View);
+		ASSERT_THAT(IsNear(NewFieldOfView, View.FieldOfView, 0.01f));
+	}
+};
+
+#endif // WITH_AUTOMATION_TESTS
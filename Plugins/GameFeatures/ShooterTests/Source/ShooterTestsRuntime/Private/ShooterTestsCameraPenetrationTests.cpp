@@ -0,0 +1,373 @@
+// Copyright Epic Games, Inc.All Rights Reserved.
+
+#include "CQTest.h"
+
+#if WITH_AUTOMATION_TESTS
+
+#include "Camera/LyraCameraPenetration.h"
+#include "Math/RandomStream.h"
+
+/**
+ * Deterministic harness for FLyraCameraPenetrationSolver, used by ULyraCameraMode_ThirdPerson to keep the camera out of the world.
+ *
+ * Recorded camera paths (a static camera behind a pillar, an orbit and a fast flick through a ring of pillars, and a strafe along
+ * a broken wall) are fed frame by frame through the solver, once with synchronous feeler sweeps as the camera mode originally did
+ * and once with async predictive sweeps whose results are used on the next frame. The world is a set of spheres that the sweeps are resolved
+ * against analytically, and async results only become available on the frame after they were started, as with UWorld async traces.
+ * The test compares the blocked distance and the number of sweeps of both paths, and checks neither puts the camera inside an obstacle.
+ *
+ * Each TEST_METHOD will register with the `CameraPenetrationTest` test object and has the variables and methods from `CameraPenetrationTest` available for use.
+ */
+TEST_CLASS_WITH_FLAGS(CameraPenetrationTest, "Project.Functional Tests.ShooterTests.Performance.Camera", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+{
+	static constexpr float FrameTime = 1.0f / 60.0f;
+	static constexpr float BoomLength = 300.0f;
+	static constexpr int32 NumCameras = 8;
+	static constexpr int32 MaxTracesPerFrame = 8;
+
+	struct FCameraPathFrame
+	{
+		FVector SafeLocation;
+		FVector DesiredCameraLocation;
+	};
+
+	struct FCameraPath
+	{
+		const TCHAR* Name;
+		TArray<FCameraPathFrame> Frames;
+	};
+
+	struct FPathResult
+	{
+		TArray<float> BlockedDistances;
+		TArray<FVector> CameraLocations;
+		int32 NumSyncTraces = 0;
+		int32 NumAsyncTraces = 0;
+	};
+
+	// Sweeps against sphere obstacles, async sweeps are resolved when started and handed out on the next frame
+	class FSphereWorldTracer : public ILyraCameraPenetrationTracer
+	{
+	public:
+		virtual FLyraCameraPenetrationHit SweepFeeler(const FVector& Start, const FVector& End, float Radius) override
+		{
+			return Sweep(Start, End, Radius);
+		}
+
+		virtual FTraceHandle StartAsyncSweepFeeler(const FVector& Start, const FVector& End, float Radius) override
+		{
+			FTraceHandle Handle;
+			Handle._Handle = ++NextTraceId;
+			PendingResults.Add(Handle._Handle, { Frame, Sweep(Start, End, Radius) });
+			return Handle;
+		}
+
+		virtual bool GetAsyncSweepResult(const FTraceHandle& Handle, FLyraCameraPenetrationHit& OutHit) override
+		{
+			FPendingResult Result;
+			if (!PendingResults.RemoveAndCopyValue(Handle._Handle, Result) || (Result.Frame + 1 != Frame))
+			{
+				return false;
+			}
+
+			OutHit = Result.Hit;
+			return true;
+		}
+
+		void BeginFrame(uint32 InFrame)
+		{
+			Frame = InFrame;
+
+			// Results that weren't picked up on the following frame are gone, as in UWorld
+			for (auto It = PendingResults.CreateIterator(); It; ++It)
+			{
+				if (It.Value().Frame + 1 < Frame)
+				{
+					It.RemoveCurrent();
+				}
+			}
+		}
+
+		bool IsInsideObstacle(const FVector& Location) const
+		{
+			for (const FSphere& Obstacle : Obstacles)
+			{
+				if (FVector::DistSquared(Location, Obstacle.Center) < FMath::Square(Obstacle.W))
+				{
+					return true;
+				}
+			}
+			return false;
+		}
+
+		TArray<FSphere> Obstacles;
+
+	private:
+		FLyraCameraPenetrationHit Sweep(const FVector& Start, const FVector& End, float Radius) const
+		{
+			FLyraCameraPenetrationHit Hit;
+
+			const FVector Delta = End - Start;
+			const double A = Delta.SizeSquared();
+			double BestTime = 2.0;
+
+			for (const FSphere& Obstacle : Obstacles)
+			{
+				// Sphere sweep against a sphere is a ray against the sphere grown by the sweep radius
+				const FVector ToStart = Start - Obstacle.Center;
+				const double C = ToStart.SizeSquared() - FMath::Square(Obstacle.W + Radius);
+				if (C <= 0.0)
+				{
+					BestTime = 0.0;
+					continue;
+				}
+
+				const double B = 2.0 * FVector::DotProduct(ToStart, Delta);
+				const double Discriminant = (B * B) - (4.0 * A * C);
+				if ((A > 0.0) && (Discriminant >= 0.0))
+				{
+					const double Time = (-B - FMath::Sqrt(Discriminant)) / (2.0 * A);
+					if ((Time >= 0.0) && (Time <= 1.0))
+					{
+						BestTime = FMath::Min(BestTime, Time);
+					}
+				}
+			}
+
+			if (BestTime <= 1.0)
+			{
+				Hit.bBlocked = true;
+				Hit.Location = Start + (Delta * BestTime);
+			}
+
+			return Hit;
+		}
+
+		struct FPendingResult
+		{
+			uint32 Frame = 0;
+			FLyraCameraPenetrationHit Hit;
+		};
+
+		TMap<uint64, FPendingResult> PendingResults;
+		uint32 Frame = 0;
+		uint64 NextTraceId = 0;
+	};
+
+	FSphereWorldTracer Tracer;
+	TArray<FCameraPath> Paths;
+
+	// The feelers ULyraCameraMode_ThirdPerson is created with
+	static TArray<FLyraPenetrationAvoidanceFeeler> MakeFeelers()
+	{
+		TArray<FLyraPenetrationAvoidanceFeeler> Feelers;
+		Feelers.Add(FLyraPenetrationAvoidanceFeeler(FRotator(+00.0f, +00.0f, 0.0f), 1.00f, 1.00f, 14.f, 0));
+		Feelers.Add(FLyraPenetrationAvoidanceFeeler(FRotator(+00.0f, +16.0f, 0.0f), 0.75f, 0.75f, 00.f, 3));
+		Feelers.Add(FLyraPenetrationAvoidanceFeeler(FRotator(+00.0f, -16.0f, 0.0f), 0.75f, 0.75f, 00.f, 3));
+		Feelers.Add(FLyraPenetrationAvoidanceFeeler(FRotator(+00.0f, +32.0f, 0.0f), 0.50f, 0.50f, 00.f, 5));
+		Feelers.Add(FLyraPenetrationAvoidanceFeeler(FRotator(+00.0f, -32.0f, 0.0f), 0.50f, 0.50f, 00.f, 5));
+		Feelers.Add(FLyraPenetrationAvoidanceFeeler(FRotator(+20.0f, +00.0f, 0.0f), 1.00f, 1.00f, 00.f, 4));
+		Feelers.Add(FLyraPenetrationAvoidanceFeeler(FRotator(-20.0f, +00.0f, 0.0f), 0.50f, 0.50f, 00.f, 4));
+		return Feelers;
+	}
+
+	static FCameraPath MakeOrbitPath(const TCHAR* Name, const FVector& Pivot, float StartYaw, float DegreesPerSecond, int32 NumFrames)
+	{
+		FCameraPath Path{ Name };
+		for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+		{
+			const float Yaw = StartYaw + (DegreesPerSecond * FrameTime * Frame);
+			Path.Frames.Add({ Pivot, Pivot - (FRotator(0.0f, Yaw, 0.0f).Vector() * BoomLength) });
+		}
+		return Path;
+	}
+
+	static FCameraPath MakeStrafePath(const TCHAR* Name, const FVector& Start, const FVector& Velocity, int32 NumFrames)
+	{
+		FCameraPath Path{ Name };
+		for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+		{
+			const FVector Pivot = Start + (Velocity * FrameTime * Frame);
+			Path.Frames.Add({ Pivot, Pivot - FVector(BoomLength, 0.0f, 0.0f) });
+		}
+		return Path;
+	}
+
+	BEFORE_EACH()
+	{
+		// A ring of pillars around the origin, between the pivot and the camera
+		for (int32 Index = 0; Index < 8; ++Index)
+		{
+			const float Angle = FMath::DegreesToRadians(45.0f * Index);
+			Tracer.Obstacles.Add(FSphere(FVector(FMath::Cos(Angle) * 180.0f, FMath::Sin(Angle) * 180.0f, 0.0f), 40.0f));
+		}
+
+		// A wall with gaps behind a strafing pawn
+		FRandomStream Random(57);
+		for (float Y = 4000.0f; Y < 6000.0f; Y += 100.0f)
+		{
+			if (Random.FRand() < 0.75f)
+			{
+				Tracer.Obstacles.Add(FSphere(FVector(-250.0f, Y, Random.FRandRange(-20.0f, 20.0f)), 60.0f));
+			}
+		}
+
+		Paths.Add(MakeOrbitPath(TEXT("Static behind a pillar"), FVector::ZeroVector, 0.0f, 0.0f, 120));
+		Paths.Add(MakeOrbitPath(TEXT("Orbit"), FVector::ZeroVector, 10.0f, 90.0f, 480));
+		Paths.Add(MakeOrbitPath(TEXT("Flick"), FVector::ZeroVector, 10.0f, 720.0f, 120));
+		Paths.Add(MakeStrafePath(TEXT("Strafe along a wall"), FVector(0.0f, 4000.0f, 0.0f), FVector(0.0f, 400.0f, 0.0f), 300));
+	}
+
+	FPathResult RunPath(const FCameraPath& Path, bool bUseAsyncTraces, int32 MaxTraces = 0)
+	{
+		FLyraCameraPenetrationSolver Solver;
+		TArray<FLyraPenetrationAvoidanceFeeler> Feelers = MakeFeelers();
+		FLyraCameraTraceBudget Budget;
+		Budget.MaxTracesPerFrame = MaxTraces;
+
+		FLyraCameraPenetrationSettings Settings;
+		Settings.bUseAsyncTraces = bUseAsyncTraces;
+
+		FPathResult Result;
+		float DistBlockedPct = 1.0f;
+
+		for (int32 Frame = 0; Frame < Path.Frames.Num(); ++Frame)
+		{
+			const FCameraPathFrame& PathFrame = Path.Frames[Frame];
+			const uint32 FrameNumber = Frame + 1;
+			Tracer.BeginFrame(FrameNumber);
+
+			// Camera modes reset their interpolation when they become active
+			Settings.bResetInterpolation = (Frame == 0);
+
+			FVector CameraLocation = PathFrame.DesiredCameraLocation;
+			Solver.Update(Feelers, PathFrame.SafeLocation, CameraLocation, FrameTime, DistBlockedPct, Settings, Tracer, Budget, FrameNumber);
+
+			Result.BlockedDistances.Add(DistBlockedPct * FVector::Dist(PathFrame.SafeLocation, PathFrame.DesiredCameraLocation));
+			Result.CameraLocations.Add(CameraLocation);
+		}
+
+		Result.NumSyncTraces = Solver.GetNumSyncTraces();
+		Result.NumAsyncTraces = Solver.GetNumAsyncTraces();
+		return Result;
+	}
+
+	TEST_METHOD(CameraPenetration_RecordedPaths_MatchSynchronousFeelers)
+	{
+		int32 TotalSyncPathTraces = 0;
+		int32 TotalAsyncPathSyncTraces = 0;
+
+		for (const FCameraPath& Path : Paths)
+		{
+			const FPathResult SyncResult = RunPath(Path, /*bUseAsyncTraces=*/ false);
+			const FPathResult AsyncResult = RunPath(Path, /*bUseAsyncTraces=*/ true);
+			const FPathResult AsyncRepeatResult = RunPath(Path, /*bUseAsyncTraces=*/ true);
+
+			ASSERT_THAT(IsTrue(AsyncResult.BlockedDistances == AsyncRepeatResult.BlockedDistances, TEXT("Async results are not deterministic.")));
+
+			// The main feeler is swept right away once per frame and never async
+			ASSERT_THAT(AreEqual(Path.Frames.Num(), AsyncResult.NumSyncTraces));
+
+			// The synchronous path is what the camera mode did before async traces, a budget doesn't hold it back
+			const FPathResult BudgetedSyncResult = RunPath(Path, /*bUseAsyncTraces=*/ false, /*MaxTraces=*/ 1);
+			ASSERT_THAT(IsTrue(SyncResult.BlockedDistances == BudgetedSyncResult.BlockedDistances, TEXT("The budget changed the synchronous path.")));
+			ASSERT_THAT(AreEqual(SyncResult.NumSyncTraces, BudgetedSyncResult.NumSyncTraces));
+
+			float MaxDifference = 0.0f;
+			double TotalDifference = 0.0;
+			for (int32 Frame = 0; Frame < Path.Frames.Num(); ++Frame)
+			{
+				ASSERT_THAT(IsFalse(Tracer.IsInsideObstacle(SyncResult.CameraLocations[Frame])));
+				ASSERT_THAT(IsFalse(Tracer.IsInsideObstacle(AsyncResult.CameraLocations[Frame])));
+
+				const float Difference = FMath::Abs(AsyncResult.BlockedDistances[Frame] - SyncResult.BlockedDistances[Frame]);
+				MaxDifference = FMath::Max(MaxDifference, Difference);
+				TotalDifference += Difference;
+			}
+
+			// Once the camera settles both paths agree, async results lag by a frame at most
+			if (Path.Frames[0].DesiredCameraLocation == Path.Frames.Last().DesiredCameraLocation)
+			{
+				ASSERT_THAT(IsNear(SyncResult.BlockedDistances.Last(), AsyncResult.BlockedDistances.Last(), 0.01f));
+			}
+
+			TotalSyncPathTraces += SyncResult.NumSyncTraces;
+			TotalAsyncPathSyncTraces += AsyncResult.NumSyncTraces;
+
+			TestRunner->AddInfo(FString::Printf(TEXT("%s (%d frames): synchronous %d sweeps; async %d sweeps started and %d synchronous sweeps; blocked distance difference max %.2f, mean %.2f"),
+				Path.Name, Path.Frames.Num(), SyncResult.NumSyncTraces, AsyncResult.NumAsyncTraces, AsyncResult.NumSyncTraces, MaxDifference, TotalDifference / Path.Frames.Num()));
+		}
+
+		// Only the main feeler is swept on the game thread
+		ASSERT_THAT(IsTrue(TotalAsyncPathSyncTraces < TotalSyncPathTraces));
+	}
+
+	TEST_METHOD(CameraPenetration_SharedBudget_CapsFeelerSweepsOfAllCameras)
+	{
+		const FCameraPath& Path = Paths[1];
+
+		// One budget for every camera, as ULyraCameraMode_ThirdPerson shares one per world
+		FLyraCameraTraceBudget Budget;
+		Budget.MaxTracesPerFrame = MaxTracesPerFrame;
+
+		TArray<FLyraCameraPenetrationSolver> Solvers;
+		TArray<TArray<FLyraPenetrationAvoidanceFeeler>> CameraFeelers;
+		TArray<float> CameraBlockedPcts;
+		Solvers.SetNum(NumCameras);
+		CameraBlockedPcts.Init(1.0f, NumCameras);
+		for (int32 CameraIndex = 0; CameraIndex < NumCameras; ++CameraIndex)
+		{
+			CameraFeelers.Add(MakeFeelers());
+		}
+
+		FLyraCameraPenetrationSettings Settings;
+		Settings.bUseAsyncTraces = true;
+
+		int32 PeakTracesPerFrame = 0;
+		int32 TotalTraces = 0;
+		int32 PreviousSyncTraces = 0;
+
+		for (int32 Frame = 0; Frame < Path.Frames.Num(); ++Frame)
+		{
+			const uint32 FrameNumber = Frame + 1;
+			Tracer.BeginFrame(FrameNumber);
+			Settings.bResetInterpolation = (Frame == 0);
+
+			// Spectators watching the same orbit from different points of it
+			for (int32 CameraIndex = 0; CameraIndex < NumCameras; ++CameraIndex)
+			{
+				const FCameraPathFrame& PathFrame = Path.Frames[(Frame + (CameraIndex * 30)) % Path.Frames.Num()];
+
+				FVector CameraLocation = PathFrame.DesiredCameraLocation;
+				Solvers[CameraIndex].Update(CameraFeelers[CameraIndex], PathFrame.SafeLocation, CameraLocation, FrameTime, CameraBlockedPcts[CameraIndex], Settings, Tracer, Budget, FrameNumber);
+				ASSERT_THAT(IsFalse(Tracer.IsInsideObstacle(CameraLocation)));
+			}
+
+			// The cap holds for the async sweeps of all cameras together
+			const int32 NumTraces = Budget.GetNumTraces(FrameNumber);
+			ASSERT_THAT(IsTrue(NumTraces <= MaxTracesPerFrame));
+			PeakTracesPerFrame = FMath::Max(PeakTracesPerFrame, NumTraces);
+			TotalTraces += NumTraces;
+
+			// Each main feeler is swept right away exactly once per frame, outside the budget
+			int32 NumSyncTraces = 0;
+			for (const FLyraCameraPenetrationSolver& Solver : Solvers)
+			{
+				NumSyncTraces += Solver.GetNumSyncTraces();
+			}
+			ASSERT_THAT(AreEqual(NumCameras, NumSyncTraces - PreviousSyncTraces));
+			PreviousSyncTraces = NumSyncTraces;
+		}
+
+		int32 MinCameraTraces = MAX_int32;
+		for (const FLyraCameraPenetrationSolver& Solver : Solvers)
+		{
+			MinCameraTraces = FMath::Min(MinCameraTraces, Solver.GetNumAsyncTraces());
+		}
+
+		TestRunner->AddInfo(FString::Printf(TEXT("%d cameras sharing a budget of %d async sweeps per frame: peak %d, mean %.1f async sweeps per frame, fewest started by one camera %d"),
+			NumCameras, MaxTracesPerFrame, PeakTracesPerFrame, static_cast<double>(TotalTraces) / Path.Frames.Num(), MinCameraTraces));
+	}
+};
+
+#endif // WITH_AUTOMATION_TESTS
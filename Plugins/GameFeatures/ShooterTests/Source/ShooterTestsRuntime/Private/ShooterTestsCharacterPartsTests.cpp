@@ -0,0 +1,169 @@
+// Copyright Epic Games, Inc.All Rights Reserved.
+
+#include "CQTest.h"
+
+#if WITH_AUTOMATION_TESTS
+
+#include "Components/ActorTestSpawner.h"
+#include "Cosmetics/LyraCharacterPartSpawner.h"
+#include "Cosmetics/LyraPawnComponent_CharacterParts.h"
+#include "GameFramework/Character.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "Utilities/ShooterTestsCharacterPartTestTypes.h"
+
+/**
+ * Measures the frame cost of a wave of 64 simultaneous respawns dressing their pawns through ULyraPawnComponent_CharacterParts.
+ *
+ * A transient world hosts 64 characters, each given three parts per respawn cycle after the previous parts were removed, as happens
+ * when the pawns of a wave die and respawn together. With Lyra.CharacterParts.SpawnBudgetMs set to 0 and pooling disabled every part
+ * is spawned in the frame it was added, as the original child actor component path did. With the defaults the parts are queued on
+ * ULyraCharacterPartSpawner, spawned within the per-frame budget and reused from the pool on later cycles. The test reports the
+ * longest frame of each path and checks both leave every pawn with the same parts and tags.
+ *
+ * Each TEST_METHOD will register with the `CharacterPartSpawnTest` test object and has the variables and methods from `CharacterPartSpawnTest` available for use.
+ */
+TEST_CLASS_WITH_FLAGS(CharacterPartSpawnTest, "Project.Functional Tests.ShooterTests.Performance.Cosmetics", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+{
+	static constexpr int32 NumPawns = 64;
+	static constexpr int32 PartsPerPawn = 3;
+	static constexpr int32 NumRespawnCycles = 5;
+
+	FActorTestSpawner Spawner;
+	ULyraCharacterPartSpawner* PartSpawner{ nullptr };
+	TArray<ULyraPawnComponent_CharacterParts*> PartComponents;
+
+	float SavedSpawnBudgetMs = 0.0f;
+	int32 SavedMaxPooledPerClass = 0;
+
+	IConsoleVariable* FindVariable(const TCHAR* Name)
+	{
+		IConsoleVariable* Variable = IConsoleManager::Get().FindConsoleVariable(Name);
+		check(Variable);
+		return Variable;
+	}
+
+	void SetSpawnSettings(float SpawnBudgetMs, int32 MaxPooledPerClass)
+	{
+		FindVariable(TEXT("Lyra.CharacterParts.SpawnBudgetMs"))->Set(SpawnBudgetMs, ECVF_SetByCode);
+		FindVariable(TEXT("Lyra.CharacterParts.MaxPooledPerClass"))->Set(MaxPooledPerClass, ECVF_SetByCode);
+	}
+
+	BEFORE_EACH()
+	{
+		SavedSpawnBudgetMs = FindVariable(TEXT("Lyra.CharacterParts.SpawnBudgetMs"))->GetFloat();
+		SavedMaxPooledPerClass = FindVariable(TEXT("Lyra.CharacterParts.MaxPooledPerClass"))->GetInt();
+
+		PartSpawner = Spawner.GetWorld().GetSubsystem<ULyraCharacterPartSpawner>();
+		ASSERT_THAT(IsNotNull(PartSpawner));
+
+		PartComponents.Reset(NumPawns);
+		for (int32 Index = 0; Index < NumPawns; ++Index)
+		{
+			ACharacter& Character = Spawner.SpawnActor<ACharacter>();
+
+			ULyraPawnComponent_CharacterParts* PartComponent = NewObject<ULyraPawnComponent_CharacterParts>(&Character);
+			PartComponent->RegisterComponent();
+			PartComponents.Add(PartComponent);
+		}
+	}
+
+	AFTER_EACH()
+	{
+		SetSpawnSettings(SavedSpawnBudgetMs, SavedMaxPooledPerClass);
+	}
+
+	// Removes and re-adds the parts of every pawn, then runs part spawner frames until nothing is pending. Returns the longest frame.
+	double RunRespawnCycle(int32& OutNumFrames)
+	{
+		FLyraCharacterPart Part;
+		Part.PartClass = AShooterTestsCharacterPartActor::StaticClass();
+
+		// The wave itself is one frame, along with the first part spawner tick
+		const double StartTime = FPlatformTime::Seconds();
+		for (ULyraPawnComponent_CharacterParts* PartComponent : PartComponents)
+		{
+			PartComponent->RemoveAllCharacterParts();
+			for (int32 PartIndex = 0; PartIndex < PartsPerPawn; ++PartIndex)
+			{
+				PartComponent->AddCharacterPart(Part);
+			}
+		}
+		PartSpawner->Tick(1.0f / 30.0f);
+		double PeakFrameSeconds = FPlatformTime::Seconds() - StartTime;
+		OutNumFrames = 1;
+
+		while (PartSpawner->GetNumPendingSpawns() > 0)
+		{
+			const double FrameStartTime = FPlatformTime::Seconds();
+			PartSpawner->Tick(1.0f / 30.0f);
+			PeakFrameSeconds = FMath::Max(PeakFrameSeconds, FPlatformTime::Seconds() - FrameStartTime);
+			++OutNumFrames;
+		}
+
+		return PeakFrameSeconds;
+	}
+
+	void VerifyParts()
+	{
+		for (ULyraPawnComponent_CharacterParts* PartComponent : PartComponents)
+		{
+			ASSERT_THAT(IsFalse(PartComponent->HasPendingParts()));
+			ASSERT_THAT(AreEqual(PartsPerPawn, PartComponent->GetCharacterPartActors().Num()));
+			ASSERT_THAT(IsTrue(PartComponent->GetCombinedTags(FGameplayTag()).HasTagExact(LyraGameplayTags::Status_Crouching)));
+
+			for (AActor* PartActor : PartComponent->GetCharacterPartActors())
+			{
+				ASSERT_THAT(IsTrue(PartActor->GetAttachParentActor() == PartComponent->GetOwner()));
+				ASSERT_THAT(IsFalse(PartActor->IsHidden()));
+			}
+		}
+	}
+
+	TEST_METHOD(CharacterParts_64SimultaneousRespawns_ReportsPeakFrameTime)
+	{
+		// Original behavior, every part spawned in the frame it was added and destroyed when removed
+		SetSpawnSettings(0.0f, 0);
+
+		double ImmediatePeakSeconds = 0.0;
+		for (int32 Cycle = 0; Cycle < NumRespawnCycles; ++Cycle)
+		{
+			int32 NumFrames = 0;
+			ImmediatePeakSeconds = FMath::Max(ImmediatePeakSeconds, RunRespawnCycle(NumFrames));
+			ASSERT_THAT(AreEqual(1, NumFrames));
+			VerifyParts();
+		}
+
+		for (ULyraPawnComponent_CharacterParts* PartComponent : PartComponents)
+		{
+			PartComponent->RemoveAllCharacterParts();
+		}
+		ASSERT_THAT(AreEqual(0, PartSpawner->GetNumPooledActors()));
+
+		// Queued and pooled, the first cycle fills the pool and later cycles reuse it
+		const int32 MaxPooledPerClass = NumPawns * PartsPerPawn;
+		SetSpawnSettings(1.0f, MaxPooledPerClass);
+
+		double QueuedPeakSeconds = 0.0;
+		int32 MaxFrames = 0;
+		for (int32 Cycle = 0; Cycle < NumRespawnCycles; ++Cycle)
+		{
+			int32 NumFrames = 0;
+			const double PeakSeconds = RunRespawnCycle(NumFrames);
+			if (Cycle > 0)
+			{
+				QueuedPeakSeconds = FMath::Max(QueuedPeakSeconds, PeakSeconds);
+				MaxFrames = FMath::Max(MaxFrames, NumFrames);
+			}
+			VerifyParts();
+		}
+
+		// The pool never grows past its cap, however many cycles released parts into it
+		ASSERT_THAT(IsTrue(PartSpawner->GetNumPooledActors() <= MaxPooledPerClass));
+
+		TestRunner->AddInfo(FString::Printf(TEXT("%d pawns x %d parts: immediate spawning peak frame %.3f ms, queued and pooled peak frame %.3f ms over up to %d frames"),
+			NumPawns, PartsPerPawn, ImmediatePeakSeconds * 1000.0, QueuedPeakSeconds * 1000.0, MaxFrames));
+	}
+};
+
+#endif // WITH_AUTOMATION_TESTS
@@ -0,0 +1,231 @@
+// Copyright Epic Games, Inc.All Rights Reserved.
+
+#include "CQTest.h"
+
+#if WITH_AUTOMATION_TESTS
+
+#include "Animation/AnimInstance.h"
+#include "Animation/AnimSequencerInstance.h"
+#include "Animation/AnimSingleNodeInstance.h"
+#include "Cosmetics/LyraCosmeticAnimationTypes.h"
+#include "Engine/SkeletalMesh.h"
+#include "HAL/PlatformTime.h"
+#include "LyraGameplayTags.h"
+#include "Math/RandomStream.h"
+#include "UObject/Package.h"
+
+/**
+ * Checks the compiled and memoized rule selection of FLyraAnimLayerSelectionSet and FLyraAnimBodyStyleSelectionSet against the
+ * original linear scan, and measures selections per second of both.
+ *
+ * Rule sets and cosmetic tag containers are generated from a fixed seed out of a pool of native tags that includes parent and child
+ * tags, so hierarchical matches are covered. Some rules have no layer or mesh and must never be selected. Every container is
+ * selected twice, once to compile and memoize the result and once to read it back.
+ *
+ * Each TEST_METHOD will register with the `CosmeticRuleSelectionTest` test object and has the variables and methods from `CosmeticRuleSelectionTest` available for use.
+ */
+TEST_CLASS_WITH_FLAGS(CosmeticRuleSelectionTest, "Project.Functional Tests.ShooterTests.Performance.Cosmetics", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+{
+	static constexpr int32 NumRuleSets = 200;
+	static constexpr int32 NumQueriesPerRuleSet = 100;
+	static constexpr int32 NumBenchmarkSelections = 100000;
+
+	FRandomStream RandomStream{ 0x1A7A };
+	TArray<FGameplayTag> TagPool;
+	TArray<TSubclassOf<UAnimInstance>> LayerPool;
+	TArray<USkeletalMesh*> MeshPool;
+
+	BEFORE_EACH()
+	{
+		TagPool = {
+			LyraGameplayTags::Status_Crouching, LyraGameplayTags::Status_AutoRunning, LyraGameplayTags::Status_Death,
+			LyraGameplayTags::Status_Death_Dying, LyraGameplayTags::Status_Death_Dead,
+			LyraGameplayTags::Movement_Mode_Walking, LyraGameplayTags::Movement_Mode_NavWalking, LyraGameplayTags::Movement_Mode_Falling,
+			LyraGameplayTags::Movement_Mode_Swimming, LyraGameplayTags::Movement_Mode_Flying, LyraGameplayTags::Movement_Mode_Custom,
+			LyraGameplayTags::InputTag_Move, LyraGameplayTags::InputTag_Crouch, LyraGameplayTags::InputTag_AutoRun,
+			LyraGameplayTags::Cheat_GodMode, LyraGameplayTags::Cheat_UnlimitedHealth
+		};
+
+		LayerPool = { UAnimInstance::StaticClass(), UAnimSequencerInstance::StaticClass(), UAnimSingleNodeInstance::StaticClass() };
+
+		MeshPool.Reset();
+		for (int32 MeshIndex = 0; MeshIndex < 8; ++MeshIndex)
+		{
+			MeshPool.Add(NewObject<USkeletalMesh>(GetTransientPackage(), NAME_None, RF_Transient));
+		}
+	}
+
+	AFTER_EACH()
+	{
+		MeshPool.Reset();
+	}
+
+	FGameplayTagContainer MakeRandomTags(int32 MaxTags)
+	{
+		FGameplayTagContainer Tags;
+		const int32 NumTags = RandomStream.RandRange(0, MaxTags);
+		for (int32 TagIndex = 0; TagIndex < NumTags; ++TagIndex)
+		{
+			Tags.AddTag(TagPool[RandomStream.RandHelper(TagPool.Num())]);
+		}
+		return Tags;
+	}
+
+	template <typename ResultType>
+	ResultType MakeRandomResult(const TArray<ResultType>& Pool)
+	{
+		// One rule in five has nothing to select and has to be skipped
+		return (RandomStream.FRand() < 0.2f) ? ResultType() : Pool[RandomStream.RandHelper(Pool.Num())];
+	}
+
+	void MakeRandomRuleSets(int32 NumRules, FLyraAnimLayerSelectionSet& OutLayerSet, FLyraAnimBodyStyleSelectionSet& OutBodyStyleSet)
+	{
+		for (int32 RuleIndex = 0; RuleIndex < NumRules; ++RuleIndex)
+		{
+			FLyraAnimLayerSelectionEntry& LayerRule = OutLayerSet.LayerRules.AddDefaulted_GetRef();
+			LayerRule.Layer = MakeRandomResult(LayerPool);
+			LayerRule.RequiredTags = MakeRandomTags(3);
+
+			FLyraAnimBodyStyleSelectionEntry& MeshRule = OutBodyStyleSet.MeshRules.AddDefaulted_GetRef();
+			MeshRule.Mesh = MakeRandomResult(MeshPool);
+			MeshRule.RequiredTags = MakeRandomTags(3);
+		}
+
+		OutLayerSet.DefaultLayer = LayerPool[0];
+		OutBodyStyleSet.DefaultMesh = MeshPool[0];
+	}
+
+	// The selection as it was before rules were compiled
+	static TSubclassOf<UAnimInstance> SelectBestLayerLinear(const FLyraAnimLayerSelectionSet& LayerSet, const FGameplayTagContainer& CosmeticTags)
+	{
+		for (const FLyraAnimLayerSelectionEntry& Rule : LayerSet.LayerRules)
+		{
+			if ((Rule.Layer != nullptr) && CosmeticTags.HasAll(Rule.RequiredTags))
+			{
+				return Rule.Layer;
+			}
+		}
+		return LayerSet.DefaultLayer;
+	}
+
+	static USkeletalMesh* SelectBestBodyStyleLinear(const FLyraAnimBodyStyleSelectionSet& BodyStyleSet, const FGameplayTagContainer& CosmeticTags)
+	{
+		for (const FLyraAnimBodyStyleSelectionEntry& Rule : BodyStyleSet.MeshRules)
+		{
+			if ((Rule.Mesh != nullptr) && CosmeticTags.HasAll(Rule.RequiredTags))
+			{
+				return Rule.Mesh;
+			}
+		}
+		return BodyStyleSet.DefaultMesh;
+	}
+
+	TEST_METHOD(RuleSelection_RandomTagSets_MatchesLinearSelection)
+	{
+		int32 NumMismatches = 0;
+
+		for (int32 RuleSetIndex = 0; RuleSetIndex < NumRuleSets; ++RuleSetIndex)
+		{
+			FLyraAnimLayerSelectionSet LayerSet;
+			FLyraAnimBodyStyleSelectionSet BodyStyleSet;
+			MakeRandomRuleSets(RandomStream.RandRange(1, 16), LayerSet, BodyStyleSet);
+
+			for (int32 QueryIndex = 0; QueryIndex < NumQueriesPerRuleSet; ++QueryIndex)
+			{
+				const FGameplayTagContainer CosmeticTags = MakeRandomTags(6);
+
+				for (int32 Repeat = 0; Repeat < 2; ++Repeat)
+				{
+					NumMismatches += (LayerSet.SelectBestLayer(CosmeticTags) != SelectBestLayerLinear(LayerSet, CosmeticTags)) ? 1 : 0;
+					NumMismatches += (BodyStyleSet.SelectBestBodyStyle(CosmeticTags) != SelectBestBodyStyleLinear(BodyStyleSet, CosmeticTags)) ? 1 : 0;
+				}
+			}
+		}
+
+		ASSERT_THAT(AreEqual(0, NumMismatches));
+	}
+
+	TEST_METHOD(RuleSelection_ReplacedRules_DropsMemoizedResults)
+	{
+		FLyraAnimBodyStyleSelectionSet BodyStyleSet;
+		BodyStyleSet.DefaultMesh = MeshPool[0];
+		BodyStyleSet.MeshRules.AddDefaulted_GetRef().Mesh = MeshPool[1];
+		BodyStyleSet.MeshRules[0].RequiredTags.AddTag(LyraGameplayTags::Status_Death);
+
+		const FGameplayTagContainer CosmeticTags(LyraGameplayTags::Status_Death_Dying);
+		ASSERT_THAT(IsTrue(BodyStyleSet.SelectBestBodyStyle(CosmeticTags) == MeshPool[1]));
+
+		// A copy starts without the memoized results of the set it was copied from
+		FLyraAnimBodyStyleSelectionSet ReplacedSet = BodyStyleSet;
+		ReplacedSet.MeshRules = { FLyraAnimBodyStyleSelectionEntry() };
+		ReplacedSet.MeshRules[0].Mesh = MeshPool[2];
+		ReplacedSet.MeshRules[0].RequiredTags.AddTag(LyraGameplayTags::Status_Death_Dead);
+
+		ASSERT_THAT(IsTrue(ReplacedSet.SelectBestBodyStyle(CosmeticTags) == MeshPool[0]));
+		ASSERT_THAT(IsTrue(BodyStyleSet.SelectBestBodyStyle(CosmeticTags) == MeshPool[1]));
+	}
+
+	TEST_METHOD(RuleSelection_RulesEditedInPlaceAndReset_DropsMemoizedResults)
+	{
+		FLyraAnimBodyStyleSelectionSet BodyStyleSet;
+		BodyStyleSet.DefaultMesh = MeshPool[0];
+		BodyStyleSet.MeshRules.AddDefaulted_GetRef().Mesh = MeshPool[1];
+		BodyStyleSet.MeshRules[0].RequiredTags.AddTag(LyraGameplayTags::Status_Death);
+
+		const FGameplayTagContainer CosmeticTags(LyraGameplayTags::Status_Death_Dying);
+		ASSERT_THAT(IsTrue(BodyStyleSet.SelectBestBodyStyle(CosmeticTags) == MeshPool[1]));
+
+		// Same array and rule count, as when a rule is edited in a details panel and the owner resets the selection
+		BodyStyleSet.MeshRules[0].RequiredTags.Reset();
+		BodyStyleSet.MeshRules[0].RequiredTags.AddTag(LyraGameplayTags::Status_Death_Dead);
+		BodyStyleSet.ResetRuleSelection();
+		ASSERT_THAT(IsTrue(BodyStyleSet.SelectBestBodyStyle(CosmeticTags) == MeshPool[0]));
+
+		// A rule that loses its result can't be selected anymore either
+		BodyStyleSet.MeshRules[0].RequiredTags.Reset();
+		BodyStyleSet.MeshRules[0].RequiredTags.AddTag(LyraGameplayTags::Status_Death_Dying);
+		BodyStyleSet.ResetRuleSelection();
+		ASSERT_THAT(IsTrue(BodyStyleSet.SelectBestBodyStyle(CosmeticTags) == MeshPool[1]));
+		BodyStyleSet.MeshRules[0].Mesh = nullptr;
+		BodyStyleSet.ResetRuleSelection();
+		ASSERT_THAT(IsTrue(BodyStyleSet.SelectBestBodyStyle(CosmeticTags) == MeshPool[0]));
+	}
+
+	TEST_METHOD(RuleSelection_RepeatedStates_ReportsSelectionsPerSecond)
+	{
+		FLyraAnimLayerSelectionSet LayerSet;
+		FLyraAnimBodyStyleSelectionSet BodyStyleSet;
+		MakeRandomRuleSets(32, LayerSet, BodyStyleSet);
+
+		// A handful of cosmetic and equipment states seen over and over, as with pawns changing weapons
+		TArray<FGameplayTagContainer> CosmeticStates;
+		for (int32 StateIndex = 0; StateIndex < 8; ++StateIndex)
+		{
+			CosmeticStates.Add(MakeRandomTags(6));
+		}
+
+		int32 NumLinearDefaults = 0;
+		const double LinearStartTime = FPlatformTime::Seconds();
+		for (int32 Selection = 0; Selection < NumBenchmarkSelections; ++Selection)
+		{
+			NumLinearDefaults += (SelectBestLayerLinear(LayerSet, CosmeticStates[Selection % CosmeticStates.Num()]) == LayerSet.DefaultLayer) ? 1 : 0;
+		}
+		const double LinearSeconds = FPlatformTime::Seconds() - LinearStartTime;
+
+		int32 NumCachedDefaults = 0;
+		const double CachedStartTime = FPlatformTime::Seconds();
+		for (int32 Selection = 0; Selection < NumBenchmarkSelections; ++Selection)
+		{
+			NumCachedDefaults += (LayerSet.SelectBestLayer(CosmeticStates[Selection % CosmeticStates.Num()]) == LayerSet.DefaultLayer) ? 1 : 0;
+		}
+		const double CachedSeconds = FPlatformTime::Seconds() - CachedStartTime;
+
+		ASSERT_THAT(AreEqual(NumLinearDefaults, NumCachedDefaults));
+
+		TestRunner->AddInfo(FString::Printf(TEXT("%d rules, %d cosmetic states: %.0f selections per second scanning the rules, %.0f memoized"),
+			LayerSet.LayerRules.Num(), CosmeticStates.Num(),
+			NumBenchmarkSelections / FMath::Max(LinearSeconds, UE_SMALL_NUMBER), NumBenchmarkSelections / FMath::Max(CachedSeconds, UE_SMALL_NUMBER)));
+	}
+};
+
+#endif // WITH_AUTOMATION_TESTS
@@ -0,0 +1,298 @@
+// Copyright Epic Games, Inc.All Rights Reserved.
+
+#include "CQTest.h"
+
+#if WITH_AUTOMATION_TESTS
+
+#include "Blueprint/WidgetTree.h"
+#include "CommonActivatableWidget.h"
+#include "CommonUIExtensions.h"
+#include "Components/MapTestSpawner.h"
+#include "GameSettingFilterState.h"
+#include "GameSettingValueDiscrete.h"
+#include "GameSettingValueScalar.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "Helpers/CQTestAssetHelper.h"
+#include "Player/LyraLocalPlayer.h"
+#include "Settings/LyraGameSettingRegistry.h"
+#include "Widgets/GameSettingPanel.h"
+
+/**
+ * Measures building ULyraGameSettingRegistry and refreshing every setting in it, as the settings screen does when it opens.
+ *
+ * The registry is created and initialized repeatedly, then every setting's editable state and value is refreshed repeatedly,
+ * once with GameSettings.CompiledDataSources off so every dynamic data source goes through PropertyPathHelpers and string
+ * conversion, and once with it on so they call their compiled getters and setters. Every setting must report the same value both ways.
+ *
+ * Each TEST_METHOD will register with the `GameSettingsRegistryTest` test object and has the variables and methods from `GameSettingsRegistryTest` available for use.
+ */
+TEST_CLASS_WITH_FLAGS(GameSettingsRegistryTest, "Project.Functional Tests.ShooterTests.Performance.Settings", EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+{
+	static constexpr int32 NumInitializations = 20;
+	static constexpr int32 NumRefreshes = 50;
+
+	struct FRunResult
+	{
+		double InitializeMs = 0.0;
+		double RefreshMs = 0.0;
+		int32 NumSettings = 0;
+		TMap<FName, FString> Values;
+	};
+
+	TUniquePtr<FMapTestSpawner> Spawner;
+	ULyraLocalPlayer* LocalPlayer{ nullptr };
+	bool bSavedCompiledDataSources = true;
+
+	IConsoleVariable* GetCompiledDataSourcesVariable()
+	{
+		IConsoleVariable* Variable = IConsoleManager::Get().FindConsoleVariable(TEXT("GameSettings.CompiledDataSources"));
+		check(Variable);
+		return Variable;
+	}
+
+	static void GetAllSettings(UGameSettingRegistry* Registry, TArray<UGameSetting*>& OutSettings)
+	{
+		FGameSettingFilterState FilterState;
+		FilterState.bIncludeDisabled = true;
+		FilterState.bIncludeHidden = true;
+		FilterState.bIncludeNestedPages = true;
+		Registry->GetSettingsForFilter(FilterState, OutSettings);
+	}
+
+	// What the settings screen reads for each row
+	static void RefreshSetting(UGameSetting* Setting)
+	{
+		Setting->RefreshEditableState(/*bNotifyEditConditionsChanged=*/ false);
+
+		if (const UGameSettingValueDiscrete* DiscreteSetting = Cast<UGameSettingValueDiscrete>(Setting))
+		{
+			DiscreteSetting->GetDiscreteOptionIndex();
+		}
+		else if (const UGameSettingValueScalar* ScalarSetting = Cast<UGameSettingValueScalar>(Setting))
+		{
+			ScalarSetting->GetValueNormalized();
+			ScalarSetting->GetFormattedText();
+		}
+	}
+
+	FRunResult RunRegistry(bool bCompiledDataSources)
+	{
+		GetCompiledDataSourcesVariable()->Set(bCompiledDataSources, ECVF_SetByCode);
+
+		FRunResult Result;
+
+		ULyraGameSettingRegistry* Registry = nullptr;
+		const double InitializeStartTime = FPlatformTime::Seconds();
+		for (int32 Index = 0; Index < NumInitializations; ++Index)
+		{
+			Registry = NewObject<ULyraGameSettingRegistry>(LocalPlayer);
+			Registry->Initialize(LocalPlayer);
+		}
+		Result.InitializeMs = (FPlatformTime::Seconds() - InitializeStartTime) * 1000.0 / NumInitializations;
+
+		TArray<UGameSetting*> Settings;
+		GetAllSettings(Registry, Settings);
+		Result.NumSettings = Settings.Num();
+
+		const double RefreshStartTime = FPlatformTime::Seconds();
+		for (int32 Index = 0; Index < NumRefreshes; ++Index)
+		{
+			for (UGameSetting* Setting : Settings)
+			{
+				RefreshSetting(Setting);
+			}
+		}
+		Result.RefreshMs = (FPlatformTime::Seconds() - RefreshStartTime) * 1000.0 / NumRefreshes;
+
+		for (const UGameSetting* Setting : Settings)
+		{
+			Result.Values.Add(Setting->GetDevName(), Setting->GetAnalyticsValue());
+		}
+
+		return Result;
+	}
+
+	BEFORE_EACH()
+	{
+		bSavedCompiledDataSources = GetCompiledDataSourcesVariable()->GetBool();
+
+		const FString LevelName = TEXT("L_ShooterTest_Basic");
+
+		TOptional<FString> PackagePath = CQTestAssetHelper::FindAssetPackagePathByName(LevelName);
+		ASSERT_THAT(IsTrue(PackagePath.IsSet(), "Could not find the level package."));
+		Spawner = MakeUnique<FMapTestSpawner>(PackagePath.GetValue(), LevelName);
+		Spawner->AddWaitUntilLoadedCommand(TestRunner);
+
+		const FTimespan LoadingScreenTimeout = FTimespan::FromSeconds(30);
+		TestCommandBuilder
+			.StartWhen([this]() { return nullptr != Spawner->FindFirstPlayerPawn(); }, LoadingScreenTimeout)
+			.Then([this]() {
+				LocalPlayer = Cast<ULyraLocalPlayer>(Spawner->GetWorld().GetFirstLocalPlayerFromController());
+				ASSERT_THAT(IsNotNull(LocalPlayer));
+			})
+			.Until([this]() { return LocalPlayer->GetSharedSettings() != nullptr; }, LoadingScreenTimeout);
+	}
+
+	AFTER_EACH()
+	{
+		GetCompiledDataSourcesVariable()->Set(bSavedCompiledDataSources, ECVF_SetByCode);
+	}
+
+	TEST_METHOD(GameSettings_InitializeAndRefreshRegistry_ReportsTimes)
+	{
+		TestCommandBuilder.Do([this]() {
+			const FRunResult StringResult = RunRegistry(/*bCompiledDataSources=*/ false);
+			const FRunResult CompiledResult = RunRegistry(/*bCompiledDataSources=*/ true);
+
+			ASSERT_THAT(AreEqual(StringResult.NumSettings, CompiledResult.NumSettings));
+			for (const TPair<FName, FString>& Pair : StringResult.Values)
+			{
+				const FString* CompiledValue = CompiledResult.Values.Find(Pair.Key);
+				ASSERT_THAT(IsNotNull(CompiledValue));
+				ASSERT_THAT(AreEqual(Pair.Value, *CompiledValue));
+			}
+
+			TestRunner->AddInfo(FString::Printf(TEXT("Property path data sources, %d settings: initialize %.3f ms, full refresh %.3f ms"), StringResult.NumSettings, StringResult.InitializeMs, StringResult.RefreshMs));
+			TestRunner->AddInfo(FString::Printf(TEXT("Compiled data sources, %d settings: initialize %.3f ms, full refresh %.3f ms"), CompiledResult.NumSettings, CompiledResult.InitializeMs, CompiledResult.RefreshMs));
+		});
+	}
+};
+
+/**
+ * Measures how long the settings screen takes to show its first list of settings after it's pushed, as it is when a player opens it mid-match.
+ *
+ * W_LyraSettingScreen is pushed to the menu layer twice, once with GameSettings.LazyRegistry and GameSettings.DeferEditConditions off
+ * so every tab is built and every edit condition evaluated up front, and once with them on so only the tab being shown is built and only
+ * the settings it shows evaluate their edit conditions. Both must show the same settings.
+ *
+ * Each TEST_METHOD will register with the `GameSettingsScreenTest` test object and has the variables and methods from `GameSettingsScreenTest` available for use.
+ */
+TEST_CLASS_WITH_FLAGS(GameSettingsScreenTest, "Project.Functional Tests.ShooterTests.Performance.Settings", EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+{
+	struct FOpenResult
+	{
+		double PushMs = 0.0;
+		double FirstFrameMs = 0.0;
+		int32 NumFrames = 0;
+		TArray<FName> VisibleSettings;
+	};
+
+	TUniquePtr<FMapTestSpawner> Spawner;
+	ULyraLocalPlayer* LocalPlayer{ nullptr };
+	TSubclassOf<UCommonActivatableWidget> SettingScreenClass;
+	UCommonActivatableWidget* SettingScreen{ nullptr };
+	bool bSavedLazyRegistry = true;
+	bool bSavedDeferEditConditions = true;
+	double OpenStartTime = 0.0;
+	uint64 OpenStartFrame = 0;
+	FOpenResult EagerResult;
+	FOpenResult LazyResult;
+
+	static IConsoleVariable* GetConsoleVariable(const TCHAR* Name)
+	{
+		IConsoleVariable* Variable = IConsoleManager::Get().FindConsoleVariable(Name);
+		check(Variable);
+		return Variable;
+	}
+
+	static UGameSettingPanel* FindSettingPanel(UCommonActivatableWidget* Screen)
+	{
+		UGameSettingPanel* Panel = nullptr;
+		if (Screen && Screen->WidgetTree)
+		{
+			Screen->WidgetTree->ForEachWidget([&Panel](UWidget* Widget) {
+				if (!Panel)
+				{
+					Panel = Cast<UGameSettingPanel>(Widget);
+				}
+			});
+		}
+		return Panel;
+	}
+
+	void AddOpenScreenCommands(bool bLazy, FOpenResult& OutResult)
+	{
+		const FTimespan OpenTimeout = FTimespan::FromSeconds(30);
+
+		TestCommandBuilder
+			.Do([this, bLazy, &OutResult]() {
+				GetConsoleVariable(TEXT("GameSettings.LazyRegistry"))->Set(bLazy, ECVF_SetByCode);
+				GetConsoleVariable(TEXT("GameSettings.DeferEditConditions"))->Set(bLazy, ECVF_SetByCode);
+
+				OpenStartFrame = GFrameCounter;
+				OpenStartTime = FPlatformTime::Seconds();
+				SettingScreen = UCommonUIExtensions::PushContentToLayer_ForPlayer(LocalPlayer, FGameplayTag::RequestGameplayTag(TEXT("UI.Layer.Menu")), SettingScreenClass);
+				OutResult.PushMs = (FPlatformTime::Seconds() - OpenStartTime) * 1000.0;
+				ASSERT_THAT(IsNotNull(SettingScreen));
+			})
+			.Until([this, &OutResult]() {
+				// The panel fills its list on the tick after the screen picks a tab, the first frame shows that list
+				const UGameSettingPanel* Panel = FindSettingPanel(SettingScreen);
+				if (!Panel || (Panel->GetVisibleSettings().Num() == 0))
+				{
+					return false;
+				}
+
+				OutResult.FirstFrameMs = (FPlatformTime::Seconds() - OpenStartTime) * 1000.0;
+				OutResult.NumFrames = static_cast<int32>(GFrameCounter - OpenStartFrame);
+				for (const UGameSetting* Setting : Panel->GetVisibleSettings())
+				{
+					OutResult.VisibleSettings.Add(Setting->GetDevName());
+				}
+				return true;
+			}, OpenTimeout)
+			.Then([this]() {
+				SettingScreen->DeactivateWidget();
+			})
+			.Until([this]() { return !SettingScreen->IsActivated(); }, OpenTimeout);
+	}
+
+	BEFORE_EACH()
+	{
+		bSavedLazyRegistry = GetConsoleVariable(TEXT("GameSettings.LazyRegistry"))->GetBool();
+		bSavedDeferEditConditions = GetConsoleVariable(TEXT("GameSettings.DeferEditConditions"))->GetBool();
+
+		// Load the screen up front, so loading it isn't part of either measurement
+		SettingScreenClass = TSoftClassPtr<UCommonActivatableWidget>(FSoftObjectPath(TEXT("/Game/UI/Settings/W_LyraSettingScreen.W_LyraSettingScreen_C"))).LoadSynchronous();
+		ASSERT_THAT(IsNotNull(SettingScreenClass.Get(), "Could not load the settings screen."));
+
+		const FString LevelName = TEXT("L_ShooterTest_Basic");
+
+		TOptional<FString> PackagePath = CQTestAssetHelper::FindAssetPackagePathByName(LevelName);
+		ASSERT_THAT(IsTrue(PackagePath.IsSet(), "Could not find the level package."));
+		Spawner = MakeUnique<FMapTestSpawner>(PackagePath.GetValue(), LevelName);
+		Spawner->AddWaitUntilLoadedCommand(TestRunner);
+
+		const FTimespan LoadingScreenTimeout = FTimespan::FromSeconds(30);
+		TestCommandBuilder
+			.StartWhen([this]() { return nullptr != Spawner->FindFirstPlayerPawn(); }, LoadingScreenTimeout)
+			.Then([this]() {
+				LocalPlayer = Cast<ULyraLocalPlayer>(Spawner->GetWorld().GetFirstLocalPlayerFromController());
+				ASSERT_THAT(IsNotNull(LocalPlayer));
+			})
+			.Until([this]() { return LocalPlayer->GetSharedSettings() != nullptr; }, LoadingScreenTimeout);
+	}
+
+	AFTER_EACH()
+	{
+		GetConsoleVariable(TEXT("GameSettings.LazyRegistry"))->Set(bSavedLazyRegistry, ECVF_SetByCode);
+		GetConsoleVariable(TEXT("GameSettings.DeferEditConditions"))->Set(bSavedDeferEditConditions, ECVF_SetByCode);
+	}
+
+	TEST_METHOD(GameSettings_OpenSettingsScreen_ReportsTimeToFirstFrame)
+	{
+		AddOpenScreenCommands(/*bLazy=*/ false, EagerResult);
+		AddOpenScreenCommands(/*bLazy=*/ true, LazyResult);
+
+		TestCommandBuilder.Then([this]() {
+			ASSERT_THAT(AreEqual(FString::JoinBy(EagerResult.VisibleSettings, TEXT(","), [](FName Name) { return Name.ToString(); }),
+				FString::JoinBy(LazyResult.VisibleSettings, TEXT(","), [](FName Name) { return Name.ToString(); })));
+
+			TestRunner->AddInfo(FString::Printf(TEXT("Eager registry, %d settings shown: push %.3f ms, first frame after %.3f ms (%d frames)"), EagerResult.VisibleSettings.Num(), EagerResult.PushMs, EagerResult.FirstFrameMs, EagerResult.NumFrames));
+			TestRunner->AddInfo(FString::Printf(TEXT("Lazy registry, %d settings shown: push %.3f ms, first frame after %.3f ms (%d frames)"), LazyResult.VisibleSettings.Num(), LazyResult.PushMs, LazyResult.FirstFrameMs, LazyResult.NumFrames));
+		});
+	}
+};
+
+#endif // WITH_AUTOMATION_TESTS
@@ -0,0 +1,108 @@
+// Copyright Epic Games, Inc.All Rights Reserved.
+
+#include "CQTest.h"
+
+#if WITH_AUTOMATION_TESTS
+
+#include "AbilitySystem/LyraGameplayCueManager.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "LyraGameplayTags.h"
+#include "UObject/Package.h"
+
+/**
+ * Checks the gameplay cue usage ULyraGameplayCueManager records for an experience and merges into its saved profile.
+ *
+ * The cues are played without a target, so they are only recorded and never spawned. Each test uses a manager of its own, so
+ * the recording doesn't mix with the manager the ability system uses, and deletes the profile it saved.
+ *
+ * Each TEST_METHOD will register with the `GameplayCueUsageTest` test object and has the variables and methods from `GameplayCueUsageTest` available for use.
+ */
+TEST_CLASS_WITH_FLAGS(GameplayCueUsageTest, "Project.Functional Tests.ShooterTests.GameplayCues", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+{
+	inline static const FName ExperienceName = TEXT("ShooterTestsGameplayCueUsage");
+
+	ULyraGameplayCueManager* CueManager{ nullptr };
+	bool bSavedRecordUsage = false;
+
+	IConsoleVariable* GetRecordUsageVariable()
+	{
+		IConsoleVariable* Variable = IConsoleManager::Get().FindConsoleVariable(TEXT("Lyra.GameplayCues.RecordUsage"));
+		check(Variable);
+		return Variable;
+	}
+
+	void DeleteProfile()
+	{
+		IFileManager::Get().Delete(*FLyraGameplayCueUsageProfile::GetProfileFilename(ExperienceName), /*RequireExists=*/ false, /*EvenReadOnly=*/ true);
+	}
+
+	// One session of the experience, Death is executed twice and Dying is added and removed once
+	void PlaySession()
+	{
+		CueManager->BeginExperienceCueUsage(ExperienceName);
+
+		const FGameplayCueParameters Parameters;
+		CueManager->HandleGameplayCue(nullptr, LyraGameplayTags::Status_Death, EGameplayCueEvent::Executed, Parameters);
+		CueManager->HandleGameplayCue(nullptr, LyraGameplayTags::Status_Death, EGameplayCueEvent::Executed, Parameters);
+		CueManager->HandleGameplayCue(nullptr, LyraGameplayTags::Status_Death_Dying, EGameplayCueEvent::OnActive, Parameters);
+		CueManager->HandleGameplayCue(nullptr, LyraGameplayTags::Status_Death_Dying, EGameplayCueEvent::WhileActive, Parameters);
+		CueManager->HandleGameplayCue(nullptr, LyraGameplayTags::Status_Death_Dying, EGameplayCueEvent::Removed, Parameters);
+	}
+
+	BEFORE_EACH()
+	{
+		bSavedRecordUsage = GetRecordUsageVariable()->GetBool();
+		DeleteProfile();
+
+		CueManager = NewObject<ULyraGameplayCueManager>(GetTransientPackage(), NAME_None, RF_Transient);
+		ASSERT_THAT(IsNotNull(CueManager));
+	}
+
+	AFTER_EACH()
+	{
+		GetRecordUsageVariable()->Set(bSavedRecordUsage, ECVF_SetByCode);
+		DeleteProfile();
+	}
+
+	TEST_METHOD(CueUsage_RecordUsageOff_RecordsNothing)
+	{
+		GetRecordUsageVariable()->Set(false, ECVF_SetByCode);
+
+		PlaySession();
+		ASSERT_THAT(AreEqual(0, CueManager->GetRecordedCueUsage().CueUsage.Num()));
+		CueManager->EndExperienceCueUsage(ExperienceName);
+
+		FLyraGameplayCueUsageProfile Profile;
+		ASSERT_THAT(IsFalse(Profile.LoadFromFile(ExperienceName)));
+	}
+
+	TEST_METHOD(CueUsage_RecordUsageOn_CountsUsesPerSessionAndMergesThemIntoTheProfile)
+	{
+		GetRecordUsageVariable()->Set(true, ECVF_SetByCode);
+
+		// WhileActive and Removed belong to the use started by OnActive
+		PlaySession();
+		const FLyraGameplayCueUsageProfile& RecordedUsage = CueManager->GetRecordedCueUsage();
+		ASSERT_THAT(IsTrue(RecordedUsage.ExperienceName == ExperienceName));
+		ASSERT_THAT(AreEqual(2, RecordedUsage.CueUsage.Num()));
+		ASSERT_THAT(AreEqual(2, RecordedUsage.CueUsage.FindChecked(LyraGameplayTags::Status_Death).NumExecutions));
+		ASSERT_THAT(AreEqual(1, RecordedUsage.CueUsage.FindChecked(LyraGameplayTags::Status_Death_Dying).NumExecutions));
+		ASSERT_THAT(AreEqual(0, RecordedUsage.CueUsage.FindChecked(LyraGameplayTags::Status_Death_Dying).NumLateLoads));
+		CueManager->EndExperienceCueUsage(ExperienceName);
+		ASSERT_THAT(AreEqual(0, CueManager->GetRecordedCueUsage().CueUsage.Num()));
+
+		// The next session starts from nothing and is added to the saved profile
+		PlaySession();
+		ASSERT_THAT(AreEqual(2, CueManager->GetRecordedCueUsage().CueUsage.FindChecked(LyraGameplayTags::Status_Death).NumExecutions));
+		CueManager->EndExperienceCueUsage(ExperienceName);
+
+		FLyraGameplayCueUsageProfile Profile;
+		ASSERT_THAT(IsTrue(Profile.LoadFromFile(ExperienceName)));
+		ASSERT_THAT(AreEqual(2, Profile.CueUsage.Num()));
+		ASSERT_THAT(AreEqual(4, Profile.CueUsage.FindChecked(LyraGameplayTags::Status_Death).NumExecutions));
+		ASSERT_THAT(AreEqual(2, Profile.CueUsage.FindChecked(LyraGameplayTags::Status_Death_Dying).NumExecutions));
+	}
+};
+
+#endif // WITH_AUTOMATION_TESTS
@@ -0,0 +1,205 @@
+// Copyright Epic Games, Inc.All Rights Reserved.
+
+#include "CQTest.h"
+
+#if WITH_AUTOMATION_TESTS
+
+#include "Character/LyraCharacter.h"
+#include "Character/LyraCharacterMovementComponent.h"
+#include "Components/CapsuleComponent.h"
+#include "Components/MapTestSpawner.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "Helpers/CQTestAssetHelper.h"
+
+/**
+ * Measures ULyraCharacterMovementComponent::GetGroundInfo for 100 characters falling at the same time.
+ *
+ * Loads the shooter test map and drops 100 characters from high above the player, calling GetGroundInfo for each of them every frame
+ * the way ULyraAnimInstance does, until they have all landed. This is done once with LyraCharacter.GroundInfo.UseAsyncTraces off, so
+ * every character traces the full LyraCharacter.GroundTraceDistance on the game thread every frame, and once with it on. The test
+ * reports the game thread time spent in GetGroundInfo and the traces of each way, and checks the predicted ground distance stays close
+ * to what a full trace finds once the ground is near. A third fall only asks for the ground info every few frames, as throttled anim
+ * updates do, and checks the async results still reach the characters. Run with -nullrhi to measure it headless.
+ *
+ * Each TEST_METHOD will register with the `GroundInfoTest` test object and has the variables and methods from `GroundInfoTest` available for use.
+ */
+TEST_CLASS_WITH_FLAGS(GroundInfoTest, "Project.Functional Tests.ShooterTests.Performance.Movement", EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+{
+	static constexpr int32 NumCharacters = 100;
+	static constexpr double DropHeight = 3000.0;
+
+	// Closer than this the anim graph reacts to the ground distance, so the prediction has to be accurate
+	static constexpr float NearGroundDistance = 500.0f;
+	static constexpr float MaxNearGroundError = 5.0f;
+
+	// Anim updates of characters that are far away or off screen can be throttled to every few frames
+	static constexpr int32 ThrottledUpdateInterval = 3;
+
+	struct FFallResult
+	{
+		double GroundInfoMs = 0.0;
+		int32 NumFrames = 0;
+		int32 NumSyncTraces = 0;
+		int32 NumAsyncTraces = 0;
+		float MaxNearGroundError = 0.0f;
+	};
+
+	TUniquePtr<FMapTestSpawner> Spawner;
+	TArray<ALyraCharacter*> Characters;
+	bool bSavedUseAsyncTraces = true;
+	FFallResult SyncResult;
+	FFallResult AsyncResult;
+	FFallResult ThrottledAsyncResult;
+
+	IConsoleVariable* GetAsyncVariable()
+	{
+		IConsoleVariable* Variable = IConsoleManager::Get().FindConsoleVariable(TEXT("LyraCharacter.GroundInfo.UseAsyncTraces"));
+		check(Variable);
+		return Variable;
+	}
+
+	void DropCharacters(bool bUseAsyncTraces)
+	{
+		GetAsyncVariable()->Set(bUseAsyncTraces, ECVF_SetByCode);
+
+		const FVector Origin = Spawner->FindFirstPlayerPawn()->GetActorLocation() + FVector(0.0, 0.0, DropHeight);
+
+		FActorSpawnParameters SpawnParameters;
+		SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+		for (int32 Index = 0; Index < NumCharacters; ++Index)
+		{
+			const FVector Location = Origin + FVector(150.0 * (Index % 10 - 5), 150.0 * (Index / 10 - 5), 0.0);
+			ALyraCharacter* Character = Spawner->GetWorld().SpawnActor<ALyraCharacter>(ALyraCharacter::StaticClass(), Location, FRotator::ZeroRotator, SpawnParameters);
+
+			// Nobody possesses them, they still have to fall
+			UCharacterMovementComponent* MoveComp = Character->GetCharacterMovement();
+			MoveComp->bRunPhysicsWithNoController = true;
+			MoveComp->SetMovementMode(MOVE_Falling);
+
+			Characters.Add(Character);
+		}
+	}
+
+	// Updates the ground info of every character as their anim instances would, returns true once they all landed
+	bool SampleFallFrame(FFallResult& Result, int32 UpdateInterval = 1)
+	{
+		if ((Result.NumFrames++ % UpdateInterval) != 0)
+		{
+			return false;
+		}
+
+		bool bAllLanded = true;
+
+		const double StartTime = FPlatformTime::Seconds();
+		for (ALyraCharacter* Character : Characters)
+		{
+			ULyraCharacterMovementComponent* MoveComp = CastChecked<ULyraCharacterMovementComponent>(Character->GetCharacterMovement());
+			MoveComp->GetGroundInfo();
+			bAllLanded &= MoveComp->IsMovingOnGround();
+		}
+		Result.GroundInfoMs += (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+		// Compare with the full length trace the original implementation did
+		for (ALyraCharacter* Character : Characters)
+		{
+			ULyraCharacterMovementComponent* MoveComp = CastChecked<ULyraCharacterMovementComponent>(Character->GetCharacterMovement());
+			if (MoveComp->IsMovingOnGround())
+			{
+				continue;
+			}
+
+			const float CapsuleHalfHeight = Character->GetCapsuleComponent()->GetUnscaledCapsuleHalfHeight();
+			const FVector TraceStart = Character->GetActorLocation();
+			const FVector TraceEnd = TraceStart - FVector(0.0, 0.0, 100000.0 + CapsuleHalfHeight);
+
+			FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(ShooterTestsGroundInfo), false, Character);
+			FCollisionResponseParams ResponseParams;
+			MoveComp->InitCollisionParams(QueryParams, ResponseParams);
+
+			FHitResult HitResult;
+			if (Spawner->GetWorld().LineTraceSingleByChannel(HitResult, TraceStart, TraceEnd, MoveComp->UpdatedComponent->GetCollisionObjectType(), QueryParams, ResponseParams))
+			{
+				const float ExpectedDistance = FMath::Max(HitResult.Distance - CapsuleHalfHeight, 0.0f);
+				if (ExpectedDistance < NearGroundDistance)
+				{
+					Result.MaxNearGroundError = FMath::Max(Result.MaxNearGroundError, FMath::Abs(ExpectedDistance - MoveComp->GetGroundInfo().GroundDistance));
+				}
+			}
+		}
+
+		return bAllLanded;
+	}
+
+	void FinishFall(FFallResult& Result)
+	{
+		for (ALyraCharacter* Character : Characters)
+		{
+			ULyraCharacterMovementComponent* MoveComp = CastChecked<ULyraCharacterMovementComponent>(Character->GetCharacterMovement());
+			Result.NumSyncTraces += MoveComp->GetNumSyncGroundTraces();
+			Result.NumAsyncTraces += MoveComp->GetNumAsyncGroundTraces();
+			Character->Destroy();
+		}
+		Characters.Reset();
+	}
+
+	void ReportFall(const TCHAR* Label, const FFallResult& Result)
+	{
+		TestRunner->AddInfo(FString::Printf(TEXT("%s: %d frames, %.3f ms in GetGroundInfo (%.3f ms per frame), %d game thread traces, %d async traces, max error near the ground %.2f"),
+			Label, Result.NumFrames, Result.GroundInfoMs, Result.GroundInfoMs / FMath::Max(Result.NumFrames, 1), Result.NumSyncTraces, Result.NumAsyncTraces, Result.MaxNearGroundError));
+	}
+
+	BEFORE_EACH()
+	{
+		bSavedUseAsyncTraces = GetAsyncVariable()->GetBool();
+
+		const FString LevelName = TEXT("L_ShooterTest_Basic");
+
+		TOptional<FString> PackagePath = CQTestAssetHelper::FindAssetPackagePathByName(LevelName);
+		ASSERT_THAT(IsTrue(PackagePath.IsSet(), "Could not find the level package."));
+		Spawner = MakeUnique<FMapTestSpawner>(PackagePath.GetValue(), LevelName);
+		Spawner->AddWaitUntilLoadedCommand(TestRunner);
+
+		const FTimespan LoadingScreenTimeout = FTimespan::FromSeconds(30);
+		TestCommandBuilder.StartWhen([this]() { return nullptr != Spawner->FindFirstPlayerPawn(); }, LoadingScreenTimeout);
+	}
+
+	AFTER_EACH()
+	{
+		GetAsyncVariable()->Set(bSavedUseAsyncTraces, ECVF_SetByCode);
+	}
+
+	TEST_METHOD(GroundInfo_100FallingCharacters_ReportsGameThreadTime)
+	{
+		const FTimespan FallTimeout = FTimespan::FromSeconds(30);
+
+		TestCommandBuilder
+			.Do([this]() { DropCharacters(/*bUseAsyncTraces=*/ false); })
+			.Until([this]() { return SampleFallFrame(SyncResult); }, FallTimeout)
+			.Then([this]() {
+				FinishFall(SyncResult);
+				DropCharacters(/*bUseAsyncTraces=*/ true);
+			})
+			.Until([this]() { return SampleFallFrame(AsyncResult); }, FallTimeout)
+			.Then([this]() {
+				FinishFall(AsyncResult);
+				DropCharacters(/*bUseAsyncTraces=*/ true);
+			})
+			.Until([this]() { return SampleFallFrame(ThrottledAsyncResult, ThrottledUpdateInterval); }, FallTimeout)
+			.Then([this]() {
+				FinishFall(ThrottledAsyncResult);
+
+				ReportFall(TEXT("Full length trace every frame"), SyncResult);
+				ReportFall(TEXT("Bounded async traces with prediction"), AsyncResult);
+				ReportFall(TEXT("Bounded async traces with throttled updates"), ThrottledAsyncResult);
+
+				ASSERT_THAT(IsTrue(SyncResult.MaxNearGroundError <= MaxNearGroundError));
+				ASSERT_THAT(IsTrue(AsyncResult.MaxNearGroundError <= MaxNearGroundError, "The predicted ground distance should match a full trace near the ground."));
+				ASSERT_THAT(IsTrue(AsyncResult.NumSyncTraces + AsyncResult.NumAsyncTraces < SyncResult.NumSyncTraces, "Fewer ground traces should be done."));
+				ASSERT_THAT(IsTrue(ThrottledAsyncResult.MaxNearGroundError <= MaxNearGroundError, "Async ground traces should refresh the ground of characters that don't update every frame."));
+			});
+	}
+};
+
+#endif // WITH_AUTOMATION_TESTS
@@ -0,0 +1,197 @@
+// Copyright Epic Games, Inc.All Rights Reserved.
+
+#include "CQTest.h"
+
+#if WITH_AUTOMATION_TESTS
+
+#include "AbilitySystem/Attributes/LyraHealthSet.h"
+#include "AbilitySystem/LyraAbilitySystemComponent.h"
+#include "Character/LyraHealthComponent.h"
+#include "Character/LyraHealthSubsystem.h"
+#include "Components/ActorTestSpawner.h"
+#include "GameplayEffect.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "LyraGameplayTags.h"
+#include "UObject/Package.h"
+#include "Utilities/ShooterTestsHealthTestTypes.h"
+
+/**
+ * Measures the frame cost of 200 pawns with ULyraHealthComponent under periodic damage.
+ *
+ * Every frame each pawn takes one to four ticks of damage, as from several damage over time effects, until it runs out of health.
+ * Pawns are staggered so a quarter of them die in the same frame. With Lyra.Health.BatchEvents off every tick broadcasts
+ * OnHealthChanged, as originally. With it on ULyraHealthSubsystem sends one coalesced notification per pawn and frame. Both runs
+ * must leave every pawn with its final health notified, one death event each sent in the frame it died, and no death event
+ * before the notification that took the pawn to zero health.
+ *
+ * Each TEST_METHOD will register with the `HealthBatchingTest` test object and has the variables and methods from `HealthBatchingTest` available for use.
+ */
+TEST_CLASS_WITH_FLAGS(HealthBatchingTest, "Project.Functional Tests.ShooterTests.Performance.Health", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+{
+	static constexpr int32 NumPawns = 200;
+	static constexpr int32 MaxDamageTicksPerFrame = 4;
+	static constexpr int32 MaxFrames = 120;
+	static constexpr float FrameTime = 1.0f / 60.0f;
+	static constexpr float DamagePerTick = 4.0f;
+
+	struct FTestPawn
+	{
+		ULyraAbilitySystemComponent* AbilitySystem = nullptr;
+		ULyraHealthComponent* HealthComponent = nullptr;
+		UShooterTestsHealthListener* Listener = nullptr;
+		int32 DamageTicksPerFrame = 1;
+	};
+
+	struct FRunResult
+	{
+		double AverageFrameMs = 0.0;
+		double MaxFrameMs = 0.0;
+		int32 NumFrames = 0;
+		int32 NumHealthChanged = 0;
+		int32 NumDeathEvents = 0;
+		int32 NumLateDeathEvents = 0;
+		int32 NumOutOfOrderEvents = 0;
+		int32 NumStaleHealth = 0;
+	};
+
+	FActorTestSpawner Spawner;
+	ULyraHealthSubsystem* HealthSubsystem{ nullptr };
+	UGameplayEffect* DamageEffect{ nullptr };
+	bool bSavedBatchEvents = true;
+
+	IConsoleVariable* GetBatchEventsVariable()
+	{
+		IConsoleVariable* Variable = IConsoleManager::Get().FindConsoleVariable(TEXT("Lyra.Health.BatchEvents"));
+		check(Variable);
+		return Variable;
+	}
+
+	BEFORE_EACH()
+	{
+		bSavedBatchEvents = GetBatchEventsVariable()->GetBool();
+
+		// The elimination and damage messages go through the game instance message router
+		Spawner.InitializeGameSubsystems();
+
+		HealthSubsystem = Spawner.GetWorld().GetSubsystem<ULyraHealthSubsystem>();
+		ASSERT_THAT(IsNotNull(HealthSubsystem));
+
+		// One tick of a damage over time effect
+		DamageEffect = NewObject<UGameplayEffect>(GetTransientPackage(), NAME_None, RF_Transient);
+		DamageEffect->DurationPolicy = EGameplayEffectDurationType::Instant;
+		FGameplayModifierInfo& DamageModifier = DamageEffect->Modifiers.AddDefaulted_GetRef();
+		DamageModifier.Attribute = ULyraHealthSet::GetDamageAttribute();
+		DamageModifier.ModifierOp = EGameplayModOp::Additive;
+		DamageModifier.ModifierMagnitude = FScalableFloat(DamagePerTick);
+	}
+
+	AFTER_EACH()
+	{
+		GetBatchEventsVariable()->Set(bSavedBatchEvents, ECVF_SetByCode);
+	}
+
+	TArray<FTestPawn> SpawnPawns()
+	{
+		TArray<FTestPawn> Pawns;
+		Pawns.Reserve(NumPawns);
+
+		for (int32 PawnIndex = 0; PawnIndex < NumPawns; ++PawnIndex)
+		{
+			AActor& Actor = Spawner.SpawnActor<AActor>();
+
+			FTestPawn& Pawn = Pawns.AddDefaulted_GetRef();
+			Pawn.DamageTicksPerFrame = 1 + (PawnIndex % MaxDamageTicksPerFrame);
+
+			Pawn.AbilitySystem = NewObject<ULyraAbilitySystemComponent>(&Actor);
+			Pawn.AbilitySystem->RegisterComponent();
+			Pawn.AbilitySystem->AddSpawnedAttribute(NewObject<ULyraHealthSet>(&Actor));
+			Pawn.AbilitySystem->InitAbilityActorInfo(&Actor, &Actor);
+
+			Pawn.Listener = NewObject<UShooterTestsHealthListener>(&Actor);
+			Pawn.AbilitySystem->GenericGameplayEventCallbacks.FindOrAdd(LyraGameplayTags::GameplayEvent_Death).AddUObject(Pawn.Listener, &UShooterTestsHealthListener::HandleDeathEvent);
+
+			Pawn.HealthComponent = NewObject<ULyraHealthComponent>(&Actor);
+			Pawn.HealthComponent->RegisterComponent();
+			Pawn.HealthComponent->OnHealthChanged.AddDynamic(Pawn.Listener, &UShooterTestsHealthListener::HandleHealthChanged);
+			Pawn.HealthComponent->InitializeWithAbilitySystem(Pawn.AbilitySystem);
+		}
+
+		return Pawns;
+	}
+
+	FRunResult RunPeriodicDamage(bool bBatchEvents)
+	{
+		GetBatchEventsVariable()->Set(bBatchEvents, ECVF_SetByCode);
+
+		TArray<FTestPawn> Pawns = SpawnPawns();
+		HealthSubsystem->FlushPendingEvents();
+
+		FRunResult Result;
+		double TotalSeconds = 0.0;
+
+		for (int32 Frame = 0; Frame < MaxFrames; ++Frame)
+		{
+			const bool bAnyAlive = Pawns.ContainsByPredicate([](const FTestPawn& Pawn) { return Pawn.HealthComponent->GetHealth() > 0.0f; });
+			if (!bAnyAlive && (HealthSubsystem->GetNumPendingEvents() == 0))
+			{
+				break;
+			}
+
+			const double FrameStartTime = FPlatformTime::Seconds();
+			for (const FTestPawn& Pawn : Pawns)
+			{
+				for (int32 DamageTick = 0; (DamageTick < Pawn.DamageTicksPerFrame) && (Pawn.HealthComponent->GetHealth() > 0.0f); ++DamageTick)
+				{
+					Pawn.AbilitySystem->ApplyGameplayEffectToSelf(DamageEffect, 1.0f, Pawn.AbilitySystem->MakeEffectContext());
+				}
+			}
+			HealthSubsystem->Tick(FrameTime);
+			const double FrameSeconds = FPlatformTime::Seconds() - FrameStartTime;
+
+			TotalSeconds += FrameSeconds;
+			Result.MaxFrameMs = FMath::Max(Result.MaxFrameMs, FrameSeconds * 1000.0);
+			++Result.NumFrames;
+
+			// Deaths are never batched, a pawn that ran out of health this frame has already been announced
+			for (const FTestPawn& Pawn : Pawns)
+			{
+				Result.NumLateDeathEvents += ((Pawn.HealthComponent->GetHealth() <= 0.0f) && (Pawn.Listener->NumDeathEvents == 0)) ? 1 : 0;
+			}
+		}
+
+		Result.AverageFrameMs = (TotalSeconds * 1000.0) / FMath::Max(Result.NumFrames, 1);
+
+		for (const FTestPawn& Pawn : Pawns)
+		{
+			Result.NumHealthChanged += Pawn.Listener->NumHealthChanged;
+			Result.NumDeathEvents += Pawn.Listener->NumDeathEvents;
+			Result.NumOutOfOrderEvents += Pawn.Listener->NumOutOfOrderEvents;
+			Result.NumStaleHealth += (Pawn.Listener->LastNotifiedHealth != Pawn.HealthComponent->GetHealth()) ? 1 : 0;
+		}
+
+		return Result;
+	}
+
+	TEST_METHOD(HealthEvents_PeriodicDamageOn200Pawns_ReportsFrameCost)
+	{
+		const FRunResult ImmediateResult = RunPeriodicDamage(/*bBatchEvents=*/ false);
+		const FRunResult BatchedResult = RunPeriodicDamage(/*bBatchEvents=*/ true);
+
+		for (const FRunResult* Result : { &ImmediateResult, &BatchedResult })
+		{
+			ASSERT_THAT(AreEqual(NumPawns, Result->NumDeathEvents));
+			ASSERT_THAT(AreEqual(0, Result->NumLateDeathEvents));
+			ASSERT_THAT(AreEqual(0, Result->NumOutOfOrderEvents));
+			ASSERT_THAT(AreEqual(0, Result->NumStaleHealth));
+		}
+		ASSERT_THAT(IsTrue(BatchedResult.NumHealthChanged < ImmediateResult.NumHealthChanged));
+
+		TestRunner->AddInfo(FString::Printf(TEXT("%d pawns, immediate: %.3f ms average and %.3f ms longest frame over %d frames, %d health notifications"),
+			NumPawns, ImmediateResult.AverageFrameMs, ImmediateResult.MaxFrameMs, ImmediateResult.NumFrames, ImmediateResult.NumHealthChanged));
+		TestRunner->AddInfo(FString::Printf(TEXT("%d pawns, batched: %.3f ms average and %.3f ms longest frame over %d frames, %d health notifications"),
+			NumPawns, BatchedResult.AverageFrameMs, BatchedResult.MaxFrameMs, BatchedResult.NumFrames, BatchedResult.NumHealthChanged));
+	}
+};
+
+#endif // WITH_AUTOMATION_TESTS
@@ -0,0 +1,227 @@
+// Copyright Epic Games, Inc.All Rights Reserved.
+
+#include "CQTest.h"
+
+#if WITH_AUTOMATION_TESTS
+
+#include "AbilitySystem/LyraAbilitySystemComponent.h"
+#include "Components/ActorTestSpawner.h"
+#include "HAL/PlatformTime.h"
+#include "Interaction/InteractionQuery.h"
+#include "Interaction/LyraInteractionOptionCache.h"
+#include "Math/RandomStream.h"
+#include "Utilities/ShooterTestsInteractionTestTypes.h"
+
+/**
+ * Compares FLyraInteractionOptionCache, used by UAbilityTask_WaitForInteractableTargets, with the original per-scan implementation
+ * that gathered, resolved and filtered every option of every target each scan.
+ *
+ * A transient world hosts a single actor with a ULyraAbilitySystemComponent and 20 candidate targets. The equivalence test drives
+ * both implementations through the same randomized sequence of target changes, tag changes and ability grants, and requires them
+ * to raise the same InteractableObjectsChanged events with the same options. The benchmark reports scans per second for each.
+ *
+ * Each TEST_METHOD will register with the `InteractionOptionCacheTest` test object and has the variables and methods from `InteractionOptionCacheTest` available for use.
+ */
+TEST_CLASS_WITH_FLAGS(InteractionOptionCacheTest, "Project.Functional Tests.ShooterTests.Performance.Interaction", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+{
+	static constexpr int32 NumCandidateTargets = 20;
+
+	FActorTestSpawner Spawner;
+	ULyraAbilitySystemComponent* AbilitySystem{ nullptr };
+	TArray<UShooterTestsInteractableTarget*> Targets;
+	TArray<TSubclassOf<UGameplayAbility>> AbilityClasses;
+	FInteractionQuery InteractionQuery;
+
+	// Original UpdateInteractableOptions, kept as the reference behavior
+	bool UpdateReference(const TArray<TScriptInterface<IInteractableTarget>>& InteractableTargets, TArray<FInteractionOption>& CurrentOptions)
+	{
+		TArray<FInteractionOption> NewOptions;
+
+		for (const TScriptInterface<IInteractableTarget>& InteractiveTarget : InteractableTargets)
+		{
+			TArray<FInteractionOption> TempOptions;
+			FInteractionOptionBuilder InteractionBuilder(InteractiveTarget, TempOptions);
+			InteractiveTarget->GatherInteractionOptions(InteractionQuery, InteractionBuilder);
+
+			for (FInteractionOption& Option : TempOptions)
+			{
+				FGameplayAbilitySpec* InteractionAbilitySpec = nullptr;
+
+				if (Option.TargetAbilitySystem && Option.TargetInteractionAbilityHandle.IsValid())
+				{
+					InteractionAbilitySpec = Option.TargetAbilitySystem->FindAbilitySpecFromHandle(Option.TargetInteractionAbilityHandle);
+				}
+				else if (Option.InteractionAbilityToGrant)
+				{
+					InteractionAbilitySpec = AbilitySystem->FindAbilitySpecFromClass(Option.InteractionAbilityToGrant);
+
+					if (InteractionAbilitySpec)
+					{
+						Option.TargetAbilitySystem = AbilitySystem;
+						Option.TargetInteractionAbilityHandle = InteractionAbilitySpec->Handle;
+					}
+				}
+
+				if (InteractionAbilitySpec)
+				{
+					if (InteractionAbilitySpec->Ability->CanActivateAbility(InteractionAbilitySpec->Handle, AbilitySystem->AbilityActorInfo.Get()))
+					{
+						NewOptions.Add(Option);
+					}
+				}
+			}
+		}
+
+		// The original only sorted when the counts matched; the cache always keeps options sorted
+		NewOptions.StableSort();
+		if (NewOptions == CurrentOptions)
+		{
+			return false;
+		}
+
+		CurrentOptions = NewOptions;
+		return true;
+	}
+
+	void GiveAbility(TSubclassOf<UGameplayAbility> AbilityClass)
+	{
+		FGameplayAbilitySpec Spec(AbilityClass, 1);
+		AbilitySystem->GiveAbility(Spec);
+	}
+
+	void SetTargetOption(UShooterTestsInteractableTarget* Target, TSubclassOf<UGameplayAbility> AbilityClass, int32 TextIndex)
+	{
+		Target->Options.Reset();
+		FInteractionOption& Option = Target->Options.AddDefaulted_GetRef();
+		Option.InteractionAbilityToGrant = AbilityClass;
+		Option.Text = FText::AsNumber(TextIndex);
+	}
+
+	BEFORE_EACH()
+	{
+		AActor& Owner = Spawner.SpawnActor<AActor>();
+
+		AbilitySystem = NewObject<ULyraAbilitySystemComponent>(&Owner);
+		AbilitySystem->RegisterComponent();
+		AbilitySystem->InitAbilityActorInfo(&Owner, &Owner);
+
+		InteractionQuery.RequestingAvatar = &Owner;
+
+		AbilityClasses = { UShooterTestsInteractAbility::StaticClass(), UShooterTestsBlockedInteractAbility::StaticClass(), UShooterTestsUngrantedInteractAbility::StaticClass() };
+		GiveAbility(UShooterTestsInteractAbility::StaticClass());
+		GiveAbility(UShooterTestsBlockedInteractAbility::StaticClass());
+
+		Targets.Reset();
+		for (int32 Index = 0; Index < NumCandidateTargets; ++Index)
+		{
+			UShooterTestsInteractableTarget* Target = NewObject<UShooterTestsInteractableTarget>(&Owner);
+			SetTargetOption(Target, AbilityClasses[Index % AbilityClasses.Num()], Index);
+			Targets.Add(Target);
+		}
+	}
+
+	// Drives both implementations through the same randomized scans and requires identical change events
+	TEST_METHOD(OptionCache_RandomizedScans_RaiseIdenticalEvents)
+	{
+		FRandomStream Random(4321);
+		FLyraInteractionOptionCache OptionCache;
+
+		TArray<FInteractionOption> ReferenceOptions;
+		TArray<FInteractionOption> CachedOptions;
+		TArray<TScriptInterface<IInteractableTarget>> ScanTargets;
+
+		int32 NumEvents = 0;
+		double Time = 0.0;
+
+		for (int32 Scan = 0; Scan < 2000; ++Scan)
+		{
+			Time += 0.1;
+
+			const int32 Action = Random.RandHelper(10);
+			if (Action == 0)
+			{
+				if (AbilitySystem->HasMatchingGameplayTag(LyraGameplayTags::Status_Crouching))
+				{
+					AbilitySystem->RemoveLooseGameplayTag(LyraGameplayTags::Status_Crouching);
+				}
+				else
+				{
+					AbilitySystem->AddLooseGameplayTag(LyraGameplayTags::Status_Crouching);
+				}
+			}
+			else if (Action == 1)
+			{
+				UShooterTestsInteractableTarget* Target = Targets[Random.RandHelper(Targets.Num())];
+				SetTargetOption(Target, AbilityClasses[Random.RandHelper(AbilityClasses.Num())], Random.RandHelper(4));
+			}
+			else if (Action == 2)
+			{
+				const TSubclassOf<UGameplayAbility> AbilityClass = AbilityClasses[Random.RandHelper(AbilityClasses.Num())];
+				if (FGameplayAbilitySpec* Spec = AbilitySystem->FindAbilitySpecFromClass(AbilityClass))
+				{
+					AbilitySystem->ClearAbility(Spec->Handle);
+				}
+				else
+				{
+					GiveAbility(AbilityClass);
+				}
+			}
+
+			// Look at a varying window of the candidates, like a trace sweeping across a cluster of interactables
+			ScanTargets.Reset();
+			const int32 FirstTarget = Random.RandHelper(Targets.Num());
+			const int32 NumScanTargets = Random.RandRange(0, 3);
+			for (int32 Offset = 0; Offset < NumScanTargets; ++Offset)
+			{
+				ScanTargets.Add(Targets[(FirstTarget + Offset) % Targets.Num()]);
+			}
+
+			const bool bReferenceChanged = UpdateReference(ScanTargets, ReferenceOptions);
+			const bool bCacheChanged = OptionCache.Update(*AbilitySystem, InteractionQuery, ScanTargets, Time, CachedOptions);
+
+			ASSERT_THAT(AreEqual(bReferenceChanged, bCacheChanged, FString::Printf(TEXT("Change event mismatch on scan %d"), Scan)));
+			ASSERT_THAT(IsTrue(ReferenceOptions == CachedOptions, FString::Printf(TEXT("Option mismatch on scan %d"), Scan)));
+
+			NumEvents += bCacheChanged ? 1 : 0;
+		}
+
+		TestRunner->AddInfo(FString::Printf(TEXT("2000 scans raised %d identical InteractableObjectsChanged events"), NumEvents));
+	}
+
+	// Reports scans per second with every candidate target in view and no state changes between scans
+	TEST_METHOD(OptionCache_TwentyTargets_ReportsScansPerSecond)
+	{
+		constexpr int32 NumScans = 20000;
+
+		TArray<TScriptInterface<IInteractableTarget>> ScanTargets;
+		for (UShooterTestsInteractableTarget* Target : Targets)
+		{
+			ScanTargets.Add(Target);
+		}
+
+		TArray<FInteractionOption> ReferenceOptions;
+		double StartTime = FPlatformTime::Seconds();
+		for (int32 Scan = 0; Scan < NumScans; ++Scan)
+		{
+			UpdateReference(ScanTargets, ReferenceOptions);
+		}
+		const double ReferenceSeconds = FPlatformTime::Seconds() - StartTime;
+
+		FLyraInteractionOptionCache OptionCache;
+		TArray<FInteractionOption> CachedOptions;
+		StartTime = FPlatformTime::Seconds();
+		for (int32 Scan = 0; Scan < NumScans; ++Scan)
+		{
+			OptionCache.Update(*AbilitySystem, InteractionQuery, ScanTargets, 0.0, CachedOptions);
+		}
+		const double CacheSeconds = FPlatformTime::Seconds() - StartTime;
+
+		ASSERT_THAT(IsTrue(ReferenceOptions == CachedOptions));
+		ASSERT_THAT(AreEqual(0, OptionCache.GetNumTargetsResolvedLastUpdate()));
+
+		TestRunner->AddInfo(FString::Printf(TEXT("%d candidate targets: original %.0f scans/sec, option cache %.0f scans/sec"),
+			NumCandidateTargets, NumScans / ReferenceSeconds, NumScans / CacheSeconds));
+	}
+};
+
+#endif // WITH_AUTOMATION_TESTS
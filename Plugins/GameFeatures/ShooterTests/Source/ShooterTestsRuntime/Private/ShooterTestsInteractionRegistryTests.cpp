@@ -0,0 +1,253 @@
+// Copyright Epic Games, Inc.All Rights Reserved.
+
+#include "CQTest.h"
+
+#if WITH_AUTOMATION_TESTS
+
+#include "AbilitySystem/LyraAbilitySystemComponent.h"
+#include "Components/ActorTestSpawner.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "Interaction/LyraInteractableRegistry.h"
+#include "Math/RandomStream.h"
+#include "Utilities/ShooterTestsInteractionTestTypes.h"
+
+/**
+ * Headless benchmark for the spatial hash backing ULyraInteractableRegistry.
+ *
+ * Scatters 5,000 interactables over a raid-sized area and walks 64 pawns through it at the default interaction scan rate,
+ * comparing the hash query and membership diff against a brute-force distance scan over every interactable.
+ * No world or rendering is required, so the test can be run with -nullrhi on a build machine.
+ *
+ * Each TEST_METHOD will register with the `InteractionRegistryBenchmark` test object and has the variables and methods from `InteractionRegistryBenchmark` available for use.
+ */
+TEST_CLASS_WITH_FLAGS(InteractionRegistryBenchmark, "Project.Functional Tests.ShooterTests.Performance.Interaction", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+{
+	static constexpr int32 NumInteractables = 5000;
+	static constexpr int32 NumPawns = 64;
+	static constexpr int32 NumScans = 600;
+	static constexpr float ScanRange = 500.0f;
+	static constexpr float InteractableRadius = 50.0f;
+	static constexpr float WorldExtent = 20000.0f;
+	static constexpr float PawnStepPerScan = 60.0f;
+
+	TArray<FVector> InteractableLocations;
+	TArray<FVector> PawnLocations;
+	TArray<FVector> PawnDirections;
+
+	BEFORE_EACH()
+	{
+		FRandomStream Random(1234);
+
+		InteractableLocations.Reset(NumInteractables);
+		for (int32 Index = 0; Index < NumInteractables; ++Index)
+		{
+			InteractableLocations.Add(FVector(Random.FRandRange(-WorldExtent, WorldExtent), Random.FRandRange(-WorldExtent, WorldExtent), Random.FRandRange(0.0f, 1000.0f)));
+		}
+
+		PawnLocations.Reset(NumPawns);
+		PawnDirections.Reset(NumPawns);
+		for (int32 Index = 0; Index < NumPawns; ++Index)
+		{
+			PawnLocations.Add(FVector(Random.FRandRange(-WorldExtent, WorldExtent), Random.FRandRange(-WorldExtent, WorldExtent), 100.0f));
+			const float Heading = Random.FRandRange(0.0f, UE_TWO_PI);
+			PawnDirections.Add(FVector(FMath::Cos(Heading), FMath::Sin(Heading), 0.0f));
+		}
+	}
+
+	void StepPawns()
+	{
+		for (int32 Index = 0; Index < NumPawns; ++Index)
+		{
+			PawnLocations[Index] += PawnDirections[Index] * PawnStepPerScan;
+			if (FMath::Abs(PawnLocations[Index].X) > WorldExtent || FMath::Abs(PawnLocations[Index].Y) > WorldExtent)
+			{
+				PawnDirections[Index] = -PawnDirections[Index];
+			}
+		}
+	}
+
+	void BruteForceQuery(const FVector& Origin, TArray<int32>& OutIds) const
+	{
+		for (int32 Id = 0; Id < InteractableLocations.Num(); ++Id)
+		{
+			if (FVector::DistSquared(Origin, InteractableLocations[Id]) <= FMath::Square(ScanRange + InteractableRadius))
+			{
+				OutIds.Add(Id);
+			}
+		}
+	}
+
+	// Verifies the hash returns exactly the interactables a brute-force scan finds, and reports the cost of both
+	TEST_METHOD(SpatialHash_MatchesBruteForce_AndReportsScanCost)
+	{
+		FLyraInteractableSpatialHash SpatialHash;
+		for (int32 Id = 0; Id < InteractableLocations.Num(); ++Id)
+		{
+			SpatialHash.Add(Id, InteractableLocations[Id], InteractableRadius);
+		}
+		ASSERT_THAT(AreEqual(NumInteractables, SpatialHash.Num()));
+
+		TArray<TArray<int32>> PreviousNearby;
+		PreviousNearby.SetNum(NumPawns);
+
+		TArray<int32> HashIds;
+		TArray<int32> BruteForceIds;
+		int64 MembershipChanges = 0;
+		double HashSeconds = 0.0;
+		double BruteForceSeconds = 0.0;
+
+		for (int32 Scan = 0; Scan < NumScans; ++Scan)
+		{
+			StepPawns();
+
+			for (int32 PawnIndex = 0; PawnIndex < NumPawns; ++PawnIndex)
+			{
+				HashIds.Reset();
+				double StartTime = FPlatformTime::Seconds();
+				SpatialHash.QuerySphere(PawnLocations[PawnIndex], ScanRange, HashIds);
+				if (HashIds != PreviousNearby[PawnIndex])
+				{
+					++MembershipChanges;
+					PreviousNearby[PawnIndex] = HashIds;
+				}
+				HashSeconds += FPlatformTime::Seconds() - StartTime;
+
+				BruteForceIds.Reset();
+				StartTime = FPlatformTime::Seconds();
+				BruteForceQuery(PawnLocations[PawnIndex], BruteForceIds);
+				BruteForceSeconds += FPlatformTime::Seconds() - StartTime;
+
+				ASSERT_THAT(IsTrue(BruteForceIds == HashIds, "Spatial hash query differs from brute force"));
+			}
+		}
+
+		const int32 NumQueries = NumPawns * NumScans;
+		TestRunner->AddInfo(FString::Printf(TEXT("%d interactables, %d pawns, %d scans: hash %.3f us/query, brute force %.3f us/query, %lld membership changes (%.1f%% of scans gather options)"),
+			NumInteractables, NumPawns, NumScans,
+			(HashSeconds * 1e6) / NumQueries, (BruteForceSeconds * 1e6) / NumQueries,
+			MembershipChanges, (100.0 * MembershipChanges) / NumQueries));
+	}
+
+	// Verifies moved and removed entries are reflected in subsequent queries
+	TEST_METHOD(SpatialHash_MoveAndRemove_UpdatesQueries)
+	{
+		FLyraInteractableSpatialHash SpatialHash;
+		SpatialHash.Add(0, FVector::ZeroVector, InteractableRadius);
+		SpatialHash.Add(1, FVector(5000.0f, 0.0f, 0.0f), InteractableRadius);
+
+		TArray<int32> Ids;
+		SpatialHash.QuerySphere(FVector::ZeroVector, ScanRange, Ids);
+		ASSERT_THAT(IsTrue(Ids == TArray<int32>{ 0 }));
+
+		SpatialHash.Move(1, FVector(100.0f, 0.0f, 0.0f));
+		Ids.Reset();
+		SpatialHash.QuerySphere(FVector::ZeroVector, ScanRange, Ids);
+		ASSERT_THAT(IsTrue(Ids == TArray<int32>{ 0, 1 }));
+
+		SpatialHash.Remove(0);
+		Ids.Reset();
+		SpatialHash.QuerySphere(FVector::ZeroVector, ScanRange, Ids);
+		ASSERT_THAT(IsTrue(Ids == TArray<int32>{ 1 }));
+	}
+};
+
+/**
+ * Drives UAbilityTask_GrantNearbyInteraction through ULyraInteractableRegistry in a transient world.
+ *
+ * A pawn with a ULyraAbilitySystemComponent runs the task while registered interactables move in and out of range and change their
+ * response to the interaction channel. Interaction abilities are only granted for interactables in range that the original overlap
+ * on Lyra_TraceChannel_Interaction would have found, and are removed again once no nearby interactable needs them.
+ *
+ * Each TEST_METHOD will register with the `GrantNearbyInteractionTest` test object and has the variables and methods from `GrantNearbyInteractionTest` available for use.
+ */
+TEST_CLASS_WITH_FLAGS(GrantNearbyInteractionTest, "Project.Functional Tests.ShooterTests.Interaction", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+{
+	static constexpr float FrameTime = 1.0f / 30.0f;
+
+	FActorTestSpawner Spawner;
+	ULyraInteractableRegistry* Registry{ nullptr };
+	ULyraAbilitySystemComponent* AbilitySystem{ nullptr };
+	bool bSavedUseRegistry = false;
+
+	IConsoleVariable* GetUseRegistryVariable()
+	{
+		IConsoleVariable* Variable = IConsoleManager::Get().FindConsoleVariable(TEXT("Lyra.Interaction.UseRegistry"));
+		check(Variable);
+		return Variable;
+	}
+
+	AShooterTestsInteractableActor& SpawnInteractable(const FVector& Location, TSubclassOf<UGameplayAbility> AbilityToGrant)
+	{
+		AShooterTestsInteractableActor& Interactable = Spawner.SpawnActor<AShooterTestsInteractableActor>();
+		Interactable.SetActorLocation(Location);
+		Interactable.Options.AddDefaulted_GetRef().InteractionAbilityToGrant = AbilityToGrant;
+		Registry->RegisterInteractableActor(&Interactable);
+		return Interactable;
+	}
+
+	bool HasAbility(TSubclassOf<UGameplayAbility> AbilityClass) const
+	{
+		return AbilitySystem->FindAbilitySpecFromClass(AbilityClass) != nullptr;
+	}
+
+	BEFORE_EACH()
+	{
+		bSavedUseRegistry = GetUseRegistryVariable()->GetBool();
+		GetUseRegistryVariable()->Set(true, ECVF_SetByCode);
+
+		Registry = Spawner.GetWorld().GetSubsystem<ULyraInteractableRegistry>();
+		ASSERT_THAT(IsNotNull(Registry));
+
+		AActor& Pawn = Spawner.SpawnActor<AActor>();
+		Pawn.SetRootComponent(NewObject<USceneComponent>(&Pawn));
+		Pawn.GetRootComponent()->RegisterComponent();
+
+		AbilitySystem = NewObject<ULyraAbilitySystemComponent>(&Pawn);
+		AbilitySystem->RegisterComponent();
+		AbilitySystem->InitAbilityActorInfo(&Pawn, &Pawn);
+	}
+
+	AFTER_EACH()
+	{
+		GetUseRegistryVariable()->Set(bSavedUseRegistry, ECVF_SetByCode);
+	}
+
+	TEST_METHOD(GrantNearbyInteraction_Registry_GrantsOnlyInRangeInteractablesOnTheInteractionChannel)
+	{
+		const FVector FarAway(10000.0f, 0.0f, 0.0f);
+
+		AShooterTestsInteractableActor& Nearby = SpawnInteractable(FVector(100.0f, 0.0f, 0.0f), UShooterTestsInteractAbility::StaticClass());
+		AShooterTestsInteractableActor& IgnoresChannel = SpawnInteractable(FVector(0.0f, 100.0f, 0.0f), UShooterTestsBlockedInteractAbility::StaticClass());
+		IgnoresChannel.Sphere->SetCollisionResponseToChannel(Lyra_TraceChannel_Interaction, ECR_Ignore);
+		SpawnInteractable(FarAway, UShooterTestsUngrantedInteractAbility::StaticClass());
+
+		FGameplayAbilitySpec Spec(UShooterTestsGrantNearbyInteractionAbility::StaticClass(), 1);
+		const FGameplayAbilitySpecHandle GrantHandle = AbilitySystem->GiveAbility(Spec);
+		ASSERT_THAT(IsTrue(AbilitySystem->TryActivateAbility(GrantHandle)));
+
+		Registry->Tick(FrameTime);
+		ASSERT_THAT(IsTrue(HasAbility(UShooterTestsInteractAbility::StaticClass())));
+		ASSERT_THAT(IsFalse(HasAbility(UShooterTestsBlockedInteractAbility::StaticClass()), TEXT("An interactable ignoring the interaction channel was granted.")));
+		ASSERT_THAT(IsFalse(HasAbility(UShooterTestsUngrantedInteractAbility::StaticClass()), TEXT("An out of range interactable was granted.")));
+
+		// Responding to the channel again is picked up by the next query
+		IgnoresChannel.Sphere->SetCollisionResponseToChannel(Lyra_TraceChannel_Interaction, ECR_Overlap);
+		Registry->UpdateInteractableActorLocation(&IgnoresChannel);
+		Registry->Tick(FrameTime);
+		ASSERT_THAT(IsTrue(HasAbility(UShooterTestsBlockedInteractAbility::StaticClass())));
+
+		// Leaving range removes the grant
+		Nearby.SetActorLocation(FarAway);
+		Registry->UpdateInteractableActorLocation(&Nearby);
+		Registry->Tick(FrameTime);
+		ASSERT_THAT(IsFalse(HasAbility(UShooterTestsInteractAbility::StaticClass())));
+		ASSERT_THAT(IsTrue(HasAbility(UShooterTestsBlockedInteractAbility::StaticClass())));
+
+		// Ending the task removes every remaining grant
+		AbilitySystem->CancelAbilityHandle(GrantHandle);
+		ASSERT_THAT(IsFalse(HasAbility(UShooterTestsBlockedInteractAbility::StaticClass())));
+	}
+};
+
+#endif // WITH_AUTOMATION_TESTS
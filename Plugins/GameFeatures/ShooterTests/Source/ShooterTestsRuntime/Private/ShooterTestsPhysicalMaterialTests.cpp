@@ -0,0 +1,222 @@
+// Copyright Epic Games, Inc.All Rights Reserved.
+
+#include "CQTest.h"
+
+#if WITH_AUTOMATION_TESTS
+
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "Engine/Blueprint.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "Physics/PhysicalMaterialWithTags.h"
+#include "PhysicalMaterials/PhysicalMaterial.h"
+#include "UObject/Package.h"
+#include "Weapons/LyraRangedWeaponInstance.h"
+
+/**
+ * Measures ULyraRangedWeaponInstance::GetPhysicalMaterialAttenuation, called for every hit a ranged weapon deals.
+ *
+ * Every shipped ranged weapon instance Blueprint is paired with every shipped physical material, plus one carrying all the tags the
+ * weapon has a multiplier for. The multiplier of each pair is computed with Lyra.Weapon.CachePhysicalMaterialMultipliers off, which
+ * combines the material's tags on every call, and with it on, which looks the combined multiplier up. The test checks both are the
+ * same for every pair and reports the time each way takes for many lookups. In the editor it also checks editing a material's tags
+ * is reflected by the cached multipliers.
+ *
+ * Each TEST_METHOD will register with the `PhysicalMaterialTest` test object and has the variables and methods from `PhysicalMaterialTest` available for use.
+ */
+TEST_CLASS_WITH_FLAGS(PhysicalMaterialTest, "Project.Functional Tests.ShooterTests.Performance.Weapons", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+{
+	static constexpr int32 NumLookups = 1000000;
+
+	TArray<ULyraRangedWeaponInstance*> Weapons;
+	TArray<UPhysicalMaterial*> Materials;
+	FGameplayTagContainer AllMultiplierTags;
+	bool bSavedCacheMultipliers = true;
+
+	IConsoleVariable* GetCacheVariable()
+	{
+		IConsoleVariable* Variable = IConsoleManager::Get().FindConsoleVariable(TEXT("Lyra.Weapon.CachePhysicalMaterialMultipliers"));
+		check(Variable);
+		return Variable;
+	}
+
+	// The tags a weapon has a damage multiplier for
+	static FGameplayTagContainer GetMultiplierTags(const ULyraRangedWeaponInstance* Weapon)
+	{
+		const FMapProperty* Property = CastFieldChecked<FMapProperty>(ULyraRangedWeaponInstance::StaticClass()->FindPropertyByName(TEXT("MaterialDamageMultiplier")));
+		FScriptMapHelper MapHelper(Property, Property->ContainerPtrToValuePtr<void>(Weapon));
+
+		FGameplayTagContainer Tags;
+		for (FScriptMapHelper::FIterator It(MapHelper); It; ++It)
+		{
+			Tags.AddTag(*reinterpret_cast<const FGameplayTag*>(MapHelper.GetKeyPtr(It)));
+		}
+		return Tags;
+	}
+
+	void FindWeapons(IAssetRegistry& AssetRegistry)
+	{
+		FARFilter Filter;
+		Filter.PackagePaths.Add(TEXT("/ShooterCore"));
+		Filter.PackagePaths.Add(TEXT("/Game"));
+		Filter.bRecursivePaths = true;
+		Filter.ClassPaths.Add(UBlueprint::StaticClass()->GetClassPathName());
+		Filter.TagsAndValues.Add(FBlueprintTags::NativeParentClassPath, FObjectPropertyBase::GetExportPath(ULyraRangedWeaponInstance::StaticClass()));
+
+		TArray<FAssetData> WeaponAssets;
+		AssetRegistry.GetAssets(Filter, WeaponAssets);
+
+		for (const FAssetData& WeaponAsset : WeaponAssets)
+		{
+			const FString GeneratedClassPath = WeaponAsset.GetTagValueRef<FString>(FBlueprintTags::GeneratedClassPath);
+			UClass* WeaponClass = LoadObject<UClass>(nullptr, *FPackageName::ExportTextPathToObjectPath(GeneratedClassPath));
+			if (WeaponClass && WeaponClass->IsChildOf(ULyraRangedWeaponInstance::StaticClass()) && !WeaponClass->HasAnyClassFlags(CLASS_Abstract))
+			{
+				ULyraRangedWeaponInstance* Weapon = NewObject<ULyraRangedWeaponInstance>(GetTransientPackage(), WeaponClass);
+				Weapon->AddToRoot();
+				Weapons.Add(Weapon);
+			}
+		}
+	}
+
+	void FindMaterials(IAssetRegistry& AssetRegistry)
+	{
+		FARFilter Filter;
+		Filter.PackagePaths.Add(TEXT("/Game"));
+		Filter.PackagePaths.Add(TEXT("/ShooterCore"));
+		Filter.bRecursivePaths = true;
+		Filter.ClassPaths.Add(UPhysicalMaterial::StaticClass()->GetClassPathName());
+		Filter.bRecursiveClasses = true;
+
+		TArray<FAssetData> MaterialAssets;
+		AssetRegistry.GetAssets(Filter, MaterialAssets);
+
+		for (const FAssetData& MaterialAsset : MaterialAssets)
+		{
+			if (UPhysicalMaterial* Material = Cast<UPhysicalMaterial>(MaterialAsset.GetAsset()))
+			{
+				Materials.Add(Material);
+			}
+		}
+	}
+
+	UPhysicalMaterialWithTags* CreateMaterial(const FGameplayTagContainer& Tags)
+	{
+		UPhysicalMaterialWithTags* Material = NewObject<UPhysicalMaterialWithTags>(GetTransientPackage());
+		Material->Tags = Tags;
+		Material->AddToRoot();
+		Materials.Add(Material);
+		return Material;
+	}
+
+	TArray<float> GetMultipliers(bool bCacheMultipliers)
+	{
+		GetCacheVariable()->Set(bCacheMultipliers, ECVF_SetByCode);
+
+		TArray<float> Multipliers;
+		for (const ULyraRangedWeaponInstance* Weapon : Weapons)
+		{
+			for (const UPhysicalMaterial* Material : Materials)
+			{
+				Multipliers.Add(Weapon->GetPhysicalMaterialAttenuation(Material));
+			}
+		}
+		return Multipliers;
+	}
+
+	double TimeLookups(bool bCacheMultipliers)
+	{
+		GetCacheVariable()->Set(bCacheMultipliers, ECVF_SetByCode);
+
+		float Total = 0.0f;
+		const double StartTime = FPlatformTime::Seconds();
+		for (int32 Index = 0; Index < NumLookups; ++Index)
+		{
+			const ULyraRangedWeaponInstance* Weapon = Weapons[Index % Weapons.Num()];
+			const UPhysicalMaterial* Material = Materials[(Index / Weapons.Num()) % Materials.Num()];
+			Total += Weapon->GetPhysicalMaterialAttenuation(Material);
+		}
+		const double ElapsedMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+		// Keep the lookups from being optimized away
+		ASSERT_THAT(IsTrue(Total > 0.0f));
+		return ElapsedMs;
+	}
+
+	BEFORE_EACH()
+	{
+		bSavedCacheMultipliers = GetCacheVariable()->GetBool();
+
+		IAssetRegistry& AssetRegistry = FAssetRegistryModule::GetRegistry();
+		AssetRegistry.WaitForCompletion();
+
+		FindWeapons(AssetRegistry);
+		ASSERT_THAT(IsTrue(Weapons.Num() > 0, "Could not find the ranged weapons."));
+
+		FindMaterials(AssetRegistry);
+		ASSERT_THAT(IsTrue(Materials.Num() > 0, "Could not find the physical materials."));
+
+		// One material hitting every multiplier of every weapon, so tags combine
+		for (const ULyraRangedWeaponInstance* Weapon : Weapons)
+		{
+			AllMultiplierTags.AppendTags(GetMultiplierTags(Weapon));
+		}
+		CreateMaterial(AllMultiplierTags);
+	}
+
+	AFTER_EACH()
+	{
+		GetCacheVariable()->Set(bSavedCacheMultipliers, ECVF_SetByCode);
+
+		for (ULyraRangedWeaponInstance* Weapon : Weapons)
+		{
+			Weapon->RemoveFromRoot();
+		}
+		for (UPhysicalMaterial* Material : Materials)
+		{
+			if (Material->GetOutermost() == GetTransientPackage())
+			{
+				Material->RemoveFromRoot();
+			}
+		}
+	}
+
+	TEST_METHOD(PhysicalMaterialAttenuation_AllWeaponsAndMaterials_MatchesAndReportsLookupTime)
+	{
+		const TArray<float> ComputedMultipliers = GetMultipliers(/*bCacheMultipliers=*/ false);
+		const TArray<float> FirstCachedMultipliers = GetMultipliers(/*bCacheMultipliers=*/ true);
+		const TArray<float> CachedMultipliers = GetMultipliers(/*bCacheMultipliers=*/ true);
+		ASSERT_THAT(AreEqual(ComputedMultipliers, FirstCachedMultipliers));
+		ASSERT_THAT(AreEqual(ComputedMultipliers, CachedMultipliers));
+
+		const double ComputedMs = TimeLookups(/*bCacheMultipliers=*/ false);
+		const double CachedMs = TimeLookups(/*bCacheMultipliers=*/ true);
+
+		TestRunner->AddInfo(FString::Printf(TEXT("%d weapons x %d physical materials, %d lookups: combining tags %.3f ms, cached %.3f ms"),
+			Weapons.Num(), Materials.Num(), NumLookups, ComputedMs, CachedMs));
+	}
+
+#if WITH_EDITOR
+	TEST_METHOD(PhysicalMaterialAttenuation_EditedMaterialTags_UpdatesCachedMultipliers)
+	{
+		GetCacheVariable()->Set(true, ECVF_SetByCode);
+
+		UPhysicalMaterialWithTags* Material = CreateMaterial(FGameplayTagContainer());
+		for (const ULyraRangedWeaponInstance* Weapon : Weapons)
+		{
+			ASSERT_THAT(AreEqual(1.0f, Weapon->GetPhysicalMaterialAttenuation(Material)));
+		}
+
+		Material->Tags = AllMultiplierTags;
+		FPropertyChangedEvent ChangedEvent(UPhysicalMaterialWithTags::StaticClass()->FindPropertyByName(GET_MEMBER_NAME_CHECKED(UPhysicalMaterialWithTags, Tags)));
+		Material->PostEditChangeProperty(ChangedEvent);
+
+		const TArray<float> CachedMultipliers = GetMultipliers(/*bCacheMultipliers=*/ true);
+		const TArray<float> ComputedMultipliers = GetMultipliers(/*bCacheMultipliers=*/ false);
+		ASSERT_THAT(AreEqual(ComputedMultipliers, CachedMultipliers));
+	}
+#endif
+};
+
+#endif // WITH_AUTOMATION_TESTS
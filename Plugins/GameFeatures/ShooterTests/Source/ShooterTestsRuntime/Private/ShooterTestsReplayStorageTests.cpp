@@ -0,0 +1,347 @@
+// Copyright Epic Games, Inc.All Rights Reserved.
+
+#include "CQTest.h"
+
+#if WITH_AUTOMATION_TESTS
+
+#include "Algo/Sort.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformTime.h"
+#include "LocalFileNetworkReplayStreaming.h"
+#include "Misc/NetworkVersion.h"
+#include "Misc/Paths.h"
+#include "Replays/LyraReplayStorageManager.h"
+
+/**
+ * Checks the budgets of FLyraReplayStoragePolicy against a list of streams, without touching any storage.
+ *
+ * Each TEST_METHOD will register with the `ReplayStoragePolicyTest` test object and has the variables and methods from `ReplayStoragePolicyTest` available for use.
+ */
+TEST_CLASS_WITH_FLAGS(ReplayStoragePolicyTest, "Project.Functional Tests.ShooterTests.Replay", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+{
+	static constexpr int64 MB = 1024 * 1024;
+
+	FDateTime Now{ 2024, 6, 1 };
+	TArray<FNetworkReplayStreamInfo> Streams;
+
+	// Adds a stream recorded DaysAgo days ago, streams are added oldest first in the tests but the policy sorts them
+	FNetworkReplayStreamInfo& AddStream(const TCHAR* Name, double DaysAgo, int64 SizeInMB)
+	{
+		FNetworkReplayStreamInfo& StreamInfo = Streams.AddDefaulted_GetRef();
+		StreamInfo.Name = Name;
+		StreamInfo.Timestamp = Now - FTimespan::FromDays(DaysAgo);
+		StreamInfo.SizeInBytes = SizeInMB * MB;
+		return StreamInfo;
+	}
+
+	FString Select(const FLyraReplayStoragePolicy& Policy, bool bReserveLiveStream = false)
+	{
+		TArray<FString> Names;
+		for (const FNetworkReplayStreamInfo& StreamInfo : FLyraReplayStorageManager::SelectStreamsToDelete(Streams, Policy, Now, bReserveLiveStream))
+		{
+			Names.Add(StreamInfo.Name);
+		}
+		Names.Sort();
+		return FString::Join(Names, TEXT(","));
+	}
+
+	BEFORE_EACH()
+	{
+		AddStream(TEXT("A"), 40.0, 300);
+		AddStream(TEXT("B"), 20.0, 200);
+		AddStream(TEXT("C"), 10.0, 100);
+		AddStream(TEXT("D"), 2.0, 100);
+		AddStream(TEXT("E"), 1.0, 100);
+	}
+
+	TEST_METHOD(Policy_CountLimit_DeletesOldest)
+	{
+		FLyraReplayStoragePolicy Policy;
+		Policy.MaxNumReplays = 3;
+		ASSERT_THAT(AreEqual(FString(TEXT("A,B")), Select(Policy)));
+	}
+
+	TEST_METHOD(Policy_CountLimitWhileRecording_ReservesLiveStream)
+	{
+		FLyraReplayStoragePolicy Policy;
+		Policy.MaxNumReplays = 3;
+		ASSERT_THAT(AreEqual(FString(TEXT("A,B,C")), Select(Policy, /*bReserveLiveStream=*/ true)));
+
+		// A live stream in the results counts itself and is never deleted
+		AddStream(TEXT("Live"), 0.0, 500).bIsLive = true;
+		ASSERT_THAT(AreEqual(FString(TEXT("A,B,C")), Select(Policy, /*bReserveLiveStream=*/ true)));
+	}
+
+	TEST_METHOD(Policy_SizeLimit_KeepsNewestThatFit)
+	{
+		FLyraReplayStoragePolicy Policy;
+		Policy.MaxTotalSizeInMB = 400;
+		ASSERT_THAT(AreEqual(FString(TEXT("A,B")), Select(Policy)));
+	}
+
+	TEST_METHOD(Policy_SizeLimit_DeletesSmallerOlderStreams)
+	{
+		Streams.Reset();
+		AddStream(TEXT("Old"), 5.0, 50);
+		AddStream(TEXT("Big"), 2.0, 350);
+		AddStream(TEXT("New"), 1.0, 100);
+
+		// Old would still fit after Big is deleted, but it's older than a stream that didn't
+		FLyraReplayStoragePolicy Policy;
+		Policy.MaxTotalSizeInMB = 400;
+		ASSERT_THAT(AreEqual(FString(TEXT("Big,Old")), Select(Policy)));
+	}
+
+	TEST_METHOD(Policy_SizeLimitWhileRecording_ReservesLiveStreamSize)
+	{
+		FLyraReplayStoragePolicy Policy;
+		Policy.MaxTotalSizeInMB = 350;
+		ASSERT_THAT(AreEqual(FString(TEXT("A,B")), Select(Policy)));
+
+		// The recording is budgeted as big as the newest finished stream
+		ASSERT_THAT(AreEqual(FString(TEXT("A,B,C")), Select(Policy, /*bReserveLiveStream=*/ true)));
+
+		// A live stream in the results uses its own size
+		AddStream(TEXT("Live"), 0.0, 250).bIsLive = true;
+		ASSERT_THAT(AreEqual(FString(TEXT("A,B,C,D")), Select(Policy, /*bReserveLiveStream=*/ true)));
+	}
+
+	TEST_METHOD(Policy_AgeLimit_DeletesOlderStreams)
+	{
+		FLyraReplayStoragePolicy Policy;
+		Policy.MaxAgeInDays = 14;
+		ASSERT_THAT(AreEqual(FString(TEXT("A,B")), Select(Policy)));
+	}
+
+	TEST_METHOD(Policy_KeepStreams_AreNeverDeleted)
+	{
+		Streams[0].bShouldKeep = true;
+
+		FLyraReplayStoragePolicy Policy;
+		Policy.MaxNumReplays = 1;
+		Policy.MaxAgeInDays = 5;
+		ASSERT_THAT(AreEqual(FString(TEXT("B,C,D")), Select(Policy)));
+	}
+
+	TEST_METHOD(Policy_NoLimits_DeletesNothing)
+	{
+		ASSERT_THAT(AreEqual(FString(), Select(FLyraReplayStoragePolicy())));
+	}
+};
+
+/**
+ * Measures cleaning up hundreds of local replays.
+ *
+ * Records a small replay with the local file streamer into a transient directory and copies it into 300 streams, then
+ * cleans down to 20 the way CleanupLocalReplays used to, deleting one stream and enumerating the directory again after each delete.
+ * The streams are then recreated and cleaned down to 20 again with FLyraReplayStorageManager, which enumerates once and queues
+ * every delete as one batch. Both must leave exactly 20 streams.
+ *
+ * Each TEST_METHOD will register with the `ReplayStorageCleanupTest` test object and has the variables and methods from `ReplayStorageCleanupTest` available for use.
+ */
+TEST_CLASS_WITH_FLAGS(ReplayStorageCleanupTest, "Project.Functional Tests.ShooterTests.Performance.Replay", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+{
+	static constexpr int32 NumStreams = 300;
+	static constexpr int32 NumStreamsToKeep = 20;
+	static constexpr int32 UserIndex = INDEX_NONE;
+
+	inline static const FString SeedStreamName = TEXT("ShooterTestsReplayStorageSeed");
+
+	FString DemoPath;
+	FString SeedFilename;
+	TSharedPtr<FLocalFileNetworkReplayStreamer> Streamer;
+	TSharedPtr<FLyraReplayStorageManager> StorageManager;
+
+	bool bOperationInFlight = false;
+	bool bDone = false;
+	int32 NumFoundStreams = INDEX_NONE;
+	int32 NumEnumerations = 0;
+	double StartTime = 0.0;
+	double PerStreamSeconds = 0.0;
+	FLyraReplayCleanupResult BatchResult;
+
+	FString GetStreamFilename(const FString& StreamName) const
+	{
+		return FPaths::Combine(DemoPath, StreamName + FNetworkReplayStreaming::GetReplayFileExtension());
+	}
+
+	void Enumerate(TFunction<void(const FEnumerateStreamsResult&)>&& OnEnumerated)
+	{
+		bOperationInFlight = true;
+		++NumEnumerations;
+		Streamer->EnumerateStreams(FNetworkReplayVersion(), UserIndex, FString(), TArray<FString>(), FEnumerateStreamsCallback::CreateLambda([this, OnEnumerated = MoveTemp(OnEnumerated)](const FEnumerateStreamsResult& Result)
+		{
+			bOperationInFlight = false;
+			NumFoundStreams = Result.WasSuccessful() ? Result.FoundStreams.Num() : INDEX_NONE;
+			OnEnumerated(Result);
+		}));
+	}
+
+	// Enumerates until the streamer has finished writing the seed stream
+	bool TickWaitForSeed()
+	{
+		if (!bOperationInFlight && (NumFoundStreams != 1))
+		{
+			Enumerate([](const FEnumerateStreamsResult&) {});
+		}
+		return !bOperationInFlight && (NumFoundStreams == 1);
+	}
+
+	// Keeps the seed outside of the demo directory, a cleanup may delete it
+	void SaveSeedStream()
+	{
+		SeedFilename = FPaths::Combine(FPaths::AutomationTransientDir(), SeedStreamName + FNetworkReplayStreaming::GetReplayFileExtension());
+		ASSERT_THAT(AreEqual(static_cast<uint32>(COPY_OK), IFileManager::Get().Copy(*SeedFilename, *GetStreamFilename(SeedStreamName))));
+	}
+
+	void CopySeedStreams()
+	{
+		IFileManager::Get().DeleteDirectory(*DemoPath, /*RequireExists=*/ false, /*Tree=*/ true);
+		IFileManager::Get().MakeDirectory(*DemoPath, /*Tree=*/ true);
+
+		for (int32 StreamIndex = 0; StreamIndex < NumStreams; ++StreamIndex)
+		{
+			const FString CopyFilename = GetStreamFilename(FString::Printf(TEXT("ShooterTestsReplayStorage_%03d"), StreamIndex));
+			ASSERT_THAT(AreEqual(static_cast<uint32>(COPY_OK), IFileManager::Get().Copy(*CopyFilename, *SeedFilename)));
+		}
+	}
+
+	// Deletes the oldest stream over the limit and enumerates again, as CleanupLocalReplays did before the storage manager
+	void DeleteNextStreamPerStream(const FEnumerateStreamsResult& Result)
+	{
+		TArray<FNetworkReplayStreamInfo> StreamsToDelete = Result.FoundStreams;
+		Algo::SortBy(StreamsToDelete, [](const FNetworkReplayStreamInfo& Data) { return Data.Timestamp.GetTicks(); }, TGreater<>());
+
+		if (!Result.WasSuccessful() || (StreamsToDelete.Num() <= NumStreamsToKeep))
+		{
+			PerStreamSeconds = FPlatformTime::Seconds() - StartTime;
+			bDone = true;
+			return;
+		}
+
+		bOperationInFlight = true;
+		Streamer->DeleteFinishedStream(StreamsToDelete[NumStreamsToKeep].Name, UserIndex, FDeleteFinishedStreamCallback::CreateLambda([this](const FDeleteFinishedStreamResult& DeleteResult)
+		{
+			bOperationInFlight = false;
+			if (DeleteResult.WasSuccessful())
+			{
+				Enumerate([this](const FEnumerateStreamsResult& NextResult) { DeleteNextStreamPerStream(NextResult); });
+			}
+			else
+			{
+				PerStreamSeconds = FPlatformTime::Seconds() - StartTime;
+				bDone = true;
+			}
+		}));
+	}
+
+	void CountRemainingStreams()
+	{
+		NumFoundStreams = INDEX_NONE;
+		Enumerate([](const FEnumerateStreamsResult&) {});
+	}
+
+	void RecordSeedStream()
+	{
+		FStartStreamingParameters Params;
+		Params.CustomName = SeedStreamName;
+		Params.FriendlyName = SeedStreamName;
+		Params.bRecord = true;
+		Params.ReplayVersion = FNetworkVersion::GetReplayVersion();
+
+		bOperationInFlight = true;
+		Streamer->StartStreaming(Params, FStartStreamingCallback::CreateLambda([this](const FStartStreamingResult& Result)
+		{
+			bOperationInFlight = false;
+			ASSERT_THAT(IsTrue(Result.WasSuccessful()));
+
+			// Some data so the copies have a size, like a short match
+			TArray<uint8> Payload;
+			Payload.SetNumZeroed(256 * 1024);
+			Streamer->GetHeaderArchive()->Serialize(Payload.GetData(), 1024);
+			Streamer->GetStreamingArchive()->Serialize(Payload.GetData(), Payload.Num());
+			Streamer->StopStreaming();
+		}));
+	}
+
+	void ResetCounters()
+	{
+		bDone = false;
+		NumFoundStreams = INDEX_NONE;
+		NumEnumerations = 0;
+	}
+
+	BEFORE_EACH()
+	{
+		DemoPath = FPaths::Combine(FPaths::AutomationTransientDir(), TEXT("ReplayStorage/"));
+		IFileManager::Get().DeleteDirectory(*DemoPath, /*RequireExists=*/ false, /*Tree=*/ true);
+		IFileManager::Get().MakeDirectory(*DemoPath, /*Tree=*/ true);
+
+		Streamer = MakeShared<FLocalFileNetworkReplayStreamer>(DemoPath);
+		StorageManager = MakeShared<FLyraReplayStorageManager>(Streamer);
+	}
+
+	AFTER_EACH()
+	{
+		StorageManager.Reset();
+		Streamer.Reset();
+		IFileManager::Get().DeleteDirectory(*DemoPath, /*RequireExists=*/ false, /*Tree=*/ true);
+		if (!SeedFilename.IsEmpty())
+		{
+			IFileManager::Get().Delete(*SeedFilename);
+		}
+	}
+
+	TEST_METHOD(ReplayStorage_Cleanup300Streams_ReportsPerStreamAndBatchedTime)
+	{
+		const FTimespan Timeout = FTimespan::FromSeconds(120);
+
+		FLyraReplayStoragePolicy Policy;
+		Policy.MaxNumReplays = NumStreamsToKeep;
+
+		TestCommandBuilder
+			.Do([this]() { RecordSeedStream(); })
+			.Until([this]() { return TickWaitForSeed(); }, Timeout)
+			// One delete and one enumeration at a time
+			.Then([this]() { SaveSeedStream(); })
+			.Then([this]() {
+				CopySeedStreams();
+				ResetCounters();
+				StartTime = FPlatformTime::Seconds();
+				Enumerate([this](const FEnumerateStreamsResult& Result) { DeleteNextStreamPerStream(Result); });
+			})
+			.Until([this]() { return bDone; }, Timeout)
+			.Then([this]() {
+				TestRunner->AddInfo(FString::Printf(TEXT("Per stream cleanup of %d streams down to %d: %.3f ms, %d enumerations"), NumStreams, NumStreamsToKeep, PerStreamSeconds * 1000.0, NumEnumerations));
+				CountRemainingStreams();
+			})
+			.Until([this]() { return !bOperationInFlight; }, Timeout)
+			.Then([this]() {
+				ASSERT_THAT(AreEqual(NumStreamsToKeep, NumFoundStreams));
+			})
+			// The storage manager's batch
+			.Then([this]() {
+				CopySeedStreams();
+				ResetCounters();
+				StorageManager->StartCleanup(UserIndex, Policy, /*bReserveLiveStream=*/ false, FLyraReplayCleanupComplete::CreateLambda([this](const FLyraReplayCleanupResult& Result)
+				{
+					BatchResult = Result;
+					bDone = true;
+				}));
+			})
+			.Until([this]() { return bDone; }, Timeout)
+			.Then([this]() {
+				ASSERT_THAT(IsFalse(BatchResult.bEnumerateFailed));
+				ASSERT_THAT(AreEqual(0, BatchResult.NumStreamsFailed));
+				TestRunner->AddInfo(FString::Printf(TEXT("Batched cleanup of %d streams down to %d: %.3f ms, 1 enumeration, %d deleted (%.1f MB)"),
+					BatchResult.NumStreamsFound, NumStreamsToKeep, BatchResult.Seconds * 1000.0, BatchResult.NumStreamsDeleted, BatchResult.BytesDeleted / (1024.0 * 1024.0)));
+				CountRemainingStreams();
+			})
+			.Until([this]() { return !bOperationInFlight; }, Timeout)
+			.Then([this]() {
+				ASSERT_THAT(AreEqual(NumStreamsToKeep, NumFoundStreams));
+			});
+	}
+};
+
+#endif // WITH_AUTOMATION_TESTS
@@ -0,0 +1,273 @@
+// Copyright Epic Games, Inc.All Rights Reserved.
+
+#include "CQTest.h"
+
+#if WITH_AUTOMATION_TESTS
+
+#include "AbilitySystem/LyraAbilitySystemComponent.h"
+#include "AbilitySystem/Attributes/LyraHealthSet.h"
+#include "Character/LyraHealthComponent.h"
+#include "Components/MapTestSpawner.h"
+#include "Engine/DemoNetDriver.h"
+#include "Engine/GameInstance.h"
+#include "EngineUtils.h"
+#include "GameModes/LyraBotCreationComponent.h"
+#include "GameModes/LyraExperienceManagerComponent.h"
+#include "HAL/PlatformTime.h"
+#include "Helpers/CQTestAssetHelper.h"
+#include "LyraGameplayTags.h"
+#include "Math/RandomStream.h"
+#include "Replays/LyraReplaySubsystem.h"
+#include "System/LyraAssetManager.h"
+#include "System/LyraGameData.h"
+
+/**
+ * Measures seeking to the gameplay events ULyraReplaySubsystem indexes while recording.
+ *
+ * Loads the shooter performance map with bots, records a replay with the local file streamer and eliminates a bot every few seconds
+ * until enough eliminations have been indexed. The replay is then played back, its event index read from the stream and every
+ * indexed event sought to in turn, followed by the same number of seeks to evenly spaced times for comparison. Every seek must
+ * succeed and land on the time it asked for. Run with -nullrhi to measure a headless client.
+ *
+ * Each TEST_METHOD will register with the `ReplayEventSeekTest` test object and has the variables and methods from `ReplayEventSeekTest` available for use.
+ */
+TEST_CLASS_WITH_FLAGS(ReplayEventSeekTest, "Project.Functional Tests.ShooterTests.Performance.Replay", EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+{
+	static constexpr int32 NumBots = 8;
+	static constexpr int32 NumEventsToRecord = 6;
+	static constexpr double SecondsBetweenEliminations = 4.0;
+	static constexpr double SecondsAfterLastEvent = 3.0;
+	static constexpr float SeekToleranceSeconds = 0.5f;
+
+	struct FSeekResult
+	{
+		float TargetTime = 0.0f;
+		float LandedTime = 0.0f;
+		double Milliseconds = 0.0;
+		bool bSucceeded = false;
+	};
+
+	inline static const FString ReplayName = TEXT("ShooterTestsReplayEventSeek");
+	inline static const TArray<FString> ReplayOptions = { TEXT("ReplayStreamerOverride=LocalFileNetworkReplayStreaming") };
+
+	TUniquePtr<FMapTestSpawner> Spawner;
+	UGameInstance* GameInstance{ nullptr };
+	ULyraReplaySubsystem* ReplaySubsystem{ nullptr };
+	FRandomStream RandomStream{ 0x5EE4 };
+
+	double NextEliminationTime = 0.0;
+	double LastEventTime = 0.0;
+
+	TArray<FSeekResult> EventSeeks;
+	TArray<FSeekResult> TimeSeeks;
+	int32 NextSeekIndex = 0;
+	bool bSeekInFlight = false;
+	double SeekStartTime = 0.0;
+
+	UDemoNetDriver* GetDemoDriver()
+	{
+		UWorld* World = GameInstance ? GameInstance->GetWorld() : nullptr;
+		return World ? World->GetDemoNetDriver() : nullptr;
+	}
+
+	bool HasExperienceLoaded()
+	{
+		AGameStateBase* GameState = Spawner->GetWorld().GetGameState();
+		ULyraExperienceManagerComponent* ExperienceComponent = GameState ? GameState->FindComponentByClass<ULyraExperienceManagerComponent>() : nullptr;
+		return ExperienceComponent && ExperienceComponent->IsExperienceLoaded();
+	}
+
+	// Kills a random living bot with the real damage path, which broadcasts the elimination message the replay indexes
+	void EliminateRandomBot()
+	{
+		TArray<ULyraAbilitySystemComponent*> Candidates;
+		for (TActorIterator<APawn> It(&Spawner->GetWorld()); It; ++It)
+		{
+			const ULyraHealthComponent* HealthComponent = ULyraHealthComponent::FindHealthComponent(*It);
+			ULyraAbilitySystemComponent* AbilitySystemComponent = HealthComponent ? Cast<ULyraAbilitySystemComponent>(It->FindComponentByClass<UAbilitySystemComponent>()) : nullptr;
+			if (!It->IsPlayerControlled() && AbilitySystemComponent && !HealthComponent->IsDeadOrDying() && !AbilitySystemComponent->HasMatchingGameplayTag(TAG_Gameplay_DamageImmunity))
+			{
+				Candidates.Add(AbilitySystemComponent);
+			}
+		}
+
+		if (Candidates.Num() == 0)
+		{
+			return;
+		}
+
+		ULyraAbilitySystemComponent* AbilitySystemComponent = Candidates[RandomStream.RandHelper(Candidates.Num())];
+		const TSubclassOf<UGameplayEffect> DamageEffect = ULyraAssetManager::GetSubclass(ULyraGameData::Get().DamageGameplayEffect_SetByCaller);
+		FGameplayEffectSpecHandle SpecHandle = AbilitySystemComponent->MakeOutgoingSpec(DamageEffect, 1.0, AbilitySystemComponent->MakeEffectContext());
+		ASSERT_THAT(IsTrue(SpecHandle.IsValid()));
+		SpecHandle.Data->SetSetByCallerMagnitude(LyraGameplayTags::SetByCaller_Damage, 10000.0);
+		AbilitySystemComponent->ApplyGameplayEffectSpecToSelf(*SpecHandle.Data.Get());
+	}
+
+	// Eliminates bots while recording, returns true once enough events were indexed and recorded past
+	bool TickRecording()
+	{
+		const double Now = FPlatformTime::Seconds();
+		if (ReplaySubsystem->GetReplayEvents().Num() >= NumEventsToRecord)
+		{
+			return (Now - LastEventTime) >= SecondsAfterLastEvent;
+		}
+
+		if (Now >= NextEliminationTime)
+		{
+			EliminateRandomBot();
+			NextEliminationTime = Now + SecondsBetweenEliminations;
+			LastEventTime = Now;
+		}
+		return false;
+	}
+
+	bool IsPlaybackIdle()
+	{
+		UDemoNetDriver* DemoDriver = GetDemoDriver();
+		return DemoDriver && DemoDriver->IsPlaying() && !DemoDriver->IsFastForwarding() && (DemoDriver->GetDemoTotalTime() > 0.0f);
+	}
+
+	void BuildSeeks()
+	{
+		const TArray<FLyraReplayEvent>& Events = ReplaySubsystem->GetReplayEvents();
+		for (const FLyraReplayEvent& Event : Events)
+		{
+			EventSeeks.AddDefaulted_GetRef().TargetTime = Event.TimeInSeconds;
+		}
+
+		// As many seeks again to times that ignore the index, spread over the whole replay
+		const float TotalTime = GetDemoDriver()->GetDemoTotalTime();
+		for (int32 SeekIndex = 0; SeekIndex < Events.Num(); ++SeekIndex)
+		{
+			TimeSeeks.AddDefaulted_GetRef().TargetTime = TotalTime * (SeekIndex + 0.5f) / Events.Num();
+		}
+	}
+
+	// Runs the event seeks and then the time seeks one after another, returns true once all have finished
+	bool TickSeeks()
+	{
+		if (bSeekInFlight)
+		{
+			return false;
+		}
+
+		const int32 NumSeeks = EventSeeks.Num() + TimeSeeks.Num();
+		if (NextSeekIndex >= NumSeeks)
+		{
+			return true;
+		}
+
+		const int32 SeekIndex = NextSeekIndex++;
+		const bool bEventSeek = SeekIndex < EventSeeks.Num();
+		FSeekResult* Result = bEventSeek ? &EventSeeks[SeekIndex] : &TimeSeeks[SeekIndex - EventSeeks.Num()];
+
+		bSeekInFlight = true;
+		SeekStartTime = FPlatformTime::Seconds();
+
+		auto OnSeekComplete = [this, Result](bool bWasSuccessful)
+		{
+			Result->Milliseconds = (FPlatformTime::Seconds() - SeekStartTime) * 1000.0;
+			Result->bSucceeded = bWasSuccessful;
+			Result->LandedTime = GetDemoDriver() ? GetDemoDriver()->GetDemoCurrentTime() : -1.0f;
+			bSeekInFlight = false;
+		};
+
+		if (bEventSeek)
+		{
+			if (!ReplaySubsystem->SeekToReplayEventWithCallback(SeekIndex, FLyraReplaySeekComplete::CreateLambda(OnSeekComplete)))
+			{
+				OnSeekComplete(false);
+			}
+		}
+		else
+		{
+			GetDemoDriver()->GotoTimeInSeconds(Result->TargetTime, FOnGotoTimeDelegate::CreateLambda(OnSeekComplete));
+		}
+		return false;
+	}
+
+	void ReportSeeks(const TCHAR* Label, const TArray<FSeekResult>& Seeks)
+	{
+		double TotalMilliseconds = 0.0;
+		double MaxMilliseconds = 0.0;
+		for (const FSeekResult& Seek : Seeks)
+		{
+			ASSERT_THAT(IsTrue(Seek.bSucceeded));
+			ASSERT_THAT(IsTrue(FMath::Abs(Seek.LandedTime - Seek.TargetTime) <= SeekToleranceSeconds));
+			TotalMilliseconds += Seek.Milliseconds;
+			MaxMilliseconds = FMath::Max(MaxMilliseconds, Seek.Milliseconds);
+		}
+
+		TestRunner->AddInfo(FString::Printf(TEXT("%s: %d seeks, average %.2f ms, longest %.2f ms"), Label, Seeks.Num(), TotalMilliseconds / FMath::Max(1, Seeks.Num()), MaxMilliseconds));
+	}
+
+	BEFORE_EACH()
+	{
+		const FString LevelName = TEXT("L_ShooterPerf");
+
+		TOptional<FString> PackagePath = CQTestAssetHelper::FindAssetPackagePathByName(LevelName);
+		ASSERT_THAT(IsTrue(PackagePath.IsSet(), "Could not find the level package."));
+		Spawner = MakeUnique<FMapTestSpawner>(PackagePath.GetValue(), LevelName);
+		Spawner->AddWaitUntilLoadedCommand(TestRunner);
+
+		const FTimespan LoadingScreenTimeout = FTimespan::FromSeconds(30);
+		TestCommandBuilder
+			.StartWhen([this]() { return HasExperienceLoaded(); }, LoadingScreenTimeout)
+			.Then([this]() {
+				GameInstance = Spawner->GetWorld().GetGameInstance();
+				ASSERT_THAT(IsNotNull(GameInstance));
+				ReplaySubsystem = GameInstance->GetSubsystem<ULyraReplaySubsystem>();
+				ASSERT_THAT(IsNotNull(ReplaySubsystem));
+
+				ULyraBotCreationComponent* BotComponent = Spawner->GetWorld().GetGameState()->FindComponentByClass<ULyraBotCreationComponent>();
+				ASSERT_THAT(IsNotNull(BotComponent, "The experience has no bot creation component."));
+				BotComponent->SetTargetBotCount(NumBots);
+			});
+	}
+
+	AFTER_EACH()
+	{
+		if (UDemoNetDriver* DemoDriver = GetDemoDriver())
+		{
+			if (DemoDriver->IsRecording())
+			{
+				GameInstance->StopRecordingReplay();
+			}
+		}
+	}
+
+	TEST_METHOD(Replay_SeekToIndexedEliminations_ReportsSeekLatency)
+	{
+		const FTimespan RecordTimeout = FTimespan::FromSeconds(120);
+		const FTimespan PlaybackTimeout = FTimespan::FromSeconds(30);
+		const FTimespan SeekTimeout = FTimespan::FromSeconds(60);
+
+		TestCommandBuilder
+			.Do([this]() {
+				GameInstance->StartRecordingReplay(ReplayName, ReplayName, ReplayOptions);
+			})
+			.Until([this]() { return GetDemoDriver() && GetDemoDriver()->IsRecording(); }, PlaybackTimeout)
+			.Then([this]() { NextEliminationTime = FPlatformTime::Seconds() + SecondsBetweenEliminations; })
+			.Until([this]() { return TickRecording(); }, RecordTimeout)
+			.Then([this]() {
+				TestRunner->AddInfo(FString::Printf(TEXT("Recorded %d indexed events over %.1f seconds"), ReplaySubsystem->GetReplayEvents().Num(), GetDemoDriver()->GetDemoCurrentTime()));
+				GameInstance->StopRecordingReplay();
+				GameInstance->PlayReplay(ReplayName, nullptr, ReplayOptions);
+			})
+			.Until([this]() { return IsPlaybackIdle(); }, PlaybackTimeout)
+			.Then([this]() { ReplaySubsystem->RefreshReplayEventIndex(); })
+			.Until([this]() { return ReplaySubsystem->GetReplayEvents().Num() > 0; }, PlaybackTimeout)
+			.Then([this]() {
+				ASSERT_THAT(IsTrue(ReplaySubsystem->GetReplayEvents().Num() >= NumEventsToRecord));
+				BuildSeeks();
+			})
+			.Until([this]() { return TickSeeks(); }, SeekTimeout)
+			.Then([this]() {
+				ReportSeeks(TEXT("Seeks to indexed events"), EventSeeks);
+				ReportSeeks(TEXT("Seeks to evenly spaced times"), TimeSeeks);
+			});
+	}
+};
+
+#endif // WITH_AUTOMATION_TESTS
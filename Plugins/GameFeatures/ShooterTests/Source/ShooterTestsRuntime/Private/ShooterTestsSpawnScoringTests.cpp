@@ -0,0 +1,220 @@
+// Copyright Epic Games, Inc.All Rights Reserved.
+
+#include "CQTest.h"
+
+#if WITH_AUTOMATION_TESTS
+
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
+#include "Player/LyraSpawnScoringService.h"
+
+/**
+ * Headless benchmark for FLyraSpawnScoringService, used by ULyraPlayerSpawningManagerComponent to choose player starts.
+ *
+ * Places 500 player starts over a large map with 64 live pawns on two teams, a few of them standing on starts, then spawns 64 players
+ * in a single frame. The original selection ran an occupancy query against every start for each spawn; the service ranks the starts
+ * from cached data and only queries the best few candidates, within the same per-frame budget the component uses.
+ * Occupancy queries are simulated against the pawn locations and counted, so no world or physics scene is required.
+ *
+ * Each TEST_METHOD will register with the `SpawnScoringBenchmark` test object and has the variables and methods from `SpawnScoringBenchmark` available for use.
+ */
+TEST_CLASS_WITH_FLAGS(SpawnScoringBenchmark, "Project.Functional Tests.ShooterTests.Performance.Spawning", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+{
+	static constexpr int32 NumStarts = 500;
+	static constexpr int32 NumPawns = 64;
+	static constexpr int32 NumSpawns = 64;
+	static constexpr int32 NumCandidates = 8;
+	static constexpr int32 OccupancyChecksPerFrame = 8;
+	static constexpr int32 WarmupFrames = 90;
+	static constexpr float WorldExtent = 40000.0f;
+
+	TArray<FVector> StartLocations;
+	TArray<FLyraSpawnScoringPawn> Pawns;
+	int32 NumOccupancyQueries = 0;
+
+	BEFORE_EACH()
+	{
+		FRandomStream Random(2024);
+
+		StartLocations.Reset(NumStarts);
+		for (int32 Index = 0; Index < NumStarts; ++Index)
+		{
+			StartLocations.Add(FVector(Random.FRandRange(-WorldExtent, WorldExtent), Random.FRandRange(-WorldExtent, WorldExtent), 100.0f));
+		}
+
+		Pawns.Reset(NumPawns);
+		for (int32 Index = 0; Index < NumPawns; ++Index)
+		{
+			FLyraSpawnScoringPawn& Pawn = Pawns.AddDefaulted_GetRef();
+			Pawn.Id = Index + 1;
+			Pawn.TeamId = Index % 2;
+
+			// Every fourth pawn camps a start so some of them are occupied
+			Pawn.Location = (Index % 4 == 0) ? StartLocations[Random.RandHelper(NumStarts)] : FVector(Random.FRandRange(-WorldExtent, WorldExtent), Random.FRandRange(-WorldExtent, WorldExtent), 100.0f);
+		}
+
+		NumOccupancyQueries = 0;
+	}
+
+	// Stands in for ALyraPlayerStart::GetLocationOccupancy, the pawns are the only blocking geometry
+	ELyraPlayerStartLocationOccupancy QueryOccupancy(const FVector& StartLocation)
+	{
+		++NumOccupancyQueries;
+
+		float NearestPawnDistance = MAX_flt;
+		for (const FLyraSpawnScoringPawn& Pawn : Pawns)
+		{
+			NearestPawnDistance = FMath::Min(NearestPawnDistance, static_cast<float>(FVector::Dist(StartLocation, Pawn.Location)));
+		}
+
+		if (NearestPawnDistance > 120.0f)
+		{
+			return ELyraPlayerStartLocationOccupancy::Empty;
+		}
+		return (NearestPawnDistance > 10.0f) ? ELyraPlayerStartLocationOccupancy::Partial : ELyraPlayerStartLocationOccupancy::Full;
+	}
+
+	TEST_METHOD(SpawnScoring_64SimultaneousSpawnsOver500Starts_ReportsQueriesAndTime)
+	{
+		// Original behavior, every spawn queries every start and picks a random empty one
+		double StartTime = FPlatformTime::Seconds();
+		for (int32 Spawn = 0; Spawn < NumSpawns; ++Spawn)
+		{
+			TArray<int32> EmptyStarts;
+			for (int32 StartIndex = 0; StartIndex < NumStarts; ++StartIndex)
+			{
+				if (QueryOccupancy(StartLocations[StartIndex]) == ELyraPlayerStartLocationOccupancy::Empty)
+				{
+					EmptyStarts.Add(StartIndex);
+				}
+			}
+			ASSERT_THAT(IsFalse(EmptyStarts.IsEmpty()));
+		}
+		const double OriginalSeconds = FPlatformTime::Seconds() - StartTime;
+		const int32 OriginalQueries = NumOccupancyQueries;
+
+		// The service keeps its data warm over a number of frames before the wave, as it would during play
+		FLyraSpawnScoringService Service;
+		for (const FVector& StartLocation : StartLocations)
+		{
+			Service.AddStart(StartLocation);
+		}
+
+		NumOccupancyQueries = 0;
+		double Time = 0.0;
+		for (int32 Frame = 0; Frame < WarmupFrames; ++Frame)
+		{
+			Time += 1.0 / 30.0;
+			Service.UpdatePawns(Pawns, Time);
+			Service.UpdateThreat(128);
+			Service.UpdateLineOfSight(8, [](const FVector& From, const FVector& To) { return false; });
+
+			int32 StaleStartIndex = INDEX_NONE;
+			for (int32 Check = 0; (Check < OccupancyChecksPerFrame) && Service.PopStaleOccupancy(StaleStartIndex); ++Check)
+			{
+				Service.SetOccupancy(StaleStartIndex, QueryOccupancy(StartLocations[StaleStartIndex]));
+			}
+		}
+		const int32 WarmupQueries = NumOccupancyQueries;
+
+		// Then the whole wave spawns in one frame, mirroring ULyraPlayerSpawningManagerComponent::ChooseScoredPlayerStart
+		NumOccupancyQueries = 0;
+		int32 ChecksThisFrame = 0;
+		int32 NumOverBudgetQueries = 0;
+		TArray<int32> Candidates;
+		TArray<int32> UncheckedCandidates;
+		TSet<int32> ChosenStarts;
+
+		StartTime = FPlatformTime::Seconds();
+		for (int32 Spawn = 0; Spawn < NumSpawns; ++Spawn)
+		{
+			Service.GetRankedStarts(Spawn % 2, NumCandidates, Candidates);
+			UncheckedCandidates.Reset();
+
+			int32 ChosenStart = INDEX_NONE;
+			int32 FallbackStart = INDEX_NONE;
+			for (const int32 StartIndex : Candidates)
+			{
+				if (!Service.IsOccupancyValid(StartIndex))
+				{
+					if (ChecksThisFrame >= OccupancyChecksPerFrame)
+					{
+						UncheckedCandidates.Add(StartIndex);
+						continue;
+					}
+
+					++ChecksThisFrame;
+					Service.SetOccupancy(StartIndex, QueryOccupancy(StartLocations[StartIndex]));
+				}
+
+				const ELyraPlayerStartLocationOccupancy Occupancy = Service.GetOccupancy(StartIndex);
+				if (Occupancy == ELyraPlayerStartLocationOccupancy::Empty)
+				{
+					ChosenStart = StartIndex;
+					break;
+				}
+				FallbackStart = ((FallbackStart == INDEX_NONE) && (Occupancy == ELyraPlayerStartLocationOccupancy::Partial)) ? StartIndex : FallbackStart;
+			}
+
+			// Unchecked starts are only queried over the budget when no checked candidate is empty
+			for (int32 UncheckedIndex = 0; (ChosenStart == INDEX_NONE) && (UncheckedIndex < UncheckedCandidates.Num()); ++UncheckedIndex)
+			{
+				const int32 StartIndex = UncheckedCandidates[UncheckedIndex];
+				++NumOverBudgetQueries;
+				Service.SetOccupancy(StartIndex, QueryOccupancy(StartLocations[StartIndex]));
+
+				const ELyraPlayerStartLocationOccupancy Occupancy = Service.GetOccupancy(StartIndex);
+				if (Occupancy == ELyraPlayerStartLocationOccupancy::Empty)
+				{
+					ChosenStart = StartIndex;
+				}
+				FallbackStart = ((FallbackStart == INDEX_NONE) && (Occupancy == ELyraPlayerStartLocationOccupancy::Partial)) ? StartIndex : FallbackStart;
+			}
+
+			ChosenStart = (ChosenStart != INDEX_NONE) ? ChosenStart : FallbackStart;
+			ASSERT_THAT(IsTrue(ChosenStart != INDEX_NONE));
+			Service.SetClaimed(ChosenStart, true);
+			ChosenStarts.Add(ChosenStart);
+		}
+		const double ServiceSeconds = FPlatformTime::Seconds() - StartTime;
+
+		ASSERT_THAT(IsTrue((NumOccupancyQueries - NumOverBudgetQueries) <= OccupancyChecksPerFrame));
+
+		// Nothing was spawned on a start a pawn is standing on
+		for (const int32 StartIndex : ChosenStarts)
+		{
+			ASSERT_THAT(IsTrue(QueryOccupancy(StartLocations[StartIndex]) != ELyraPlayerStartLocationOccupancy::Full));
+		}
+
+		TestRunner->AddInfo(FString::Printf(TEXT("%d spawns over %d starts: original %d occupancy queries in %.3f ms, scoring service %d queries (%d over budget) in %.3f ms (%d background queries over %d frames), %d distinct starts"),
+			NumSpawns, NumStarts, OriginalQueries, OriginalSeconds * 1000.0, NumOccupancyQueries, NumOverBudgetQueries, ServiceSeconds * 1000.0, WarmupQueries, WarmupFrames, ChosenStarts.Num()));
+	}
+
+	// Occupancy measured before the experience's pawn data loaded must be measured again
+	TEST_METHOD(SpawnScoring_InvalidateAllOccupancy_RequeuesEveryStart)
+	{
+		FLyraSpawnScoringService Service;
+		for (const FVector& StartLocation : StartLocations)
+		{
+			Service.AddStart(StartLocation);
+		}
+
+		int32 StaleStartIndex = INDEX_NONE;
+		while (Service.PopStaleOccupancy(StaleStartIndex))
+		{
+			Service.SetOccupancy(StaleStartIndex, ELyraPlayerStartLocationOccupancy::Empty);
+		}
+
+		Service.InvalidateAllOccupancy();
+
+		int32 NumStale = 0;
+		while (Service.PopStaleOccupancy(StaleStartIndex))
+		{
+			ASSERT_THAT(IsFalse(Service.IsOccupancyValid(StaleStartIndex)));
+			++NumStale;
+		}
+		ASSERT_THAT(AreEqual(NumStarts, NumStale));
+	}
+};
+
+#endif // WITH_AUTOMATION_TESTS
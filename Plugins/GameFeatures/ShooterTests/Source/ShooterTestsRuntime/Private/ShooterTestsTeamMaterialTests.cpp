@@ -0,0 +1,272 @@
+// Copyright Epic Games, Inc.All Rights Reserved.
+
+#include "CQTest.h"
+
+#if WITH_AUTOMATION_TESTS
+
+#include "Components/ActorTestSpawner.h"
+#include "Components/StaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/Texture.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "Materials/MaterialInstanceDynamic.h"
+#include "System/LyraSystemStatics.h"
+#include "Teams/LyraTeamDisplayAsset.h"
+#include "UObject/UObjectIterator.h"
+
+/**
+ * Measures ULyraTeamDisplayAsset applying team colors to 64 pawns, on the CPU side.
+ *
+ * A transient world hosts 64 actors with five mesh components each, standing in for a pawn, its cosmetic parts and its weapon, using
+ * the mannequin materials. The blue team display asset is applied to all of them once with Lyra.Teams.ShareMaterialInstances
+ * off, which creates a dynamic material instance for every material slot, and once with it on, which shares one per base material and
+ * sets custom primitive data where the materials read it. The test reports the instances created and the time to apply each way, and
+ * checks every slot ends up with the asset's parameters either way.
+ *
+ * Each TEST_METHOD will register with the `TeamMaterialTest` test object and has the variables and methods from `TeamMaterialTest` available for use.
+ */
+TEST_CLASS_WITH_FLAGS(TeamMaterialTest, "Project.Functional Tests.ShooterTests.Performance.Teams", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+{
+	static constexpr int32 NumPawns = 64;
+	static constexpr int32 NumMeshesPerPawn = 5;
+
+	FActorTestSpawner Spawner;
+	ULyraTeamDisplayAsset* DisplayAsset{ nullptr };
+	UStaticMesh* Mesh{ nullptr };
+	TArray<UMaterialInterface*> Materials;
+	bool bSavedShareMaterialInstances = true;
+
+	IConsoleVariable* GetShareVariable()
+	{
+		IConsoleVariable* Variable = IConsoleManager::Get().FindConsoleVariable(TEXT("Lyra.Teams.ShareMaterialInstances"));
+		check(Variable);
+		return Variable;
+	}
+
+	static int32 CountDynamicMaterials()
+	{
+		int32 Count = 0;
+		for (TObjectIterator<UMaterialInstanceDynamic> It; It; ++It)
+		{
+			++Count;
+		}
+		return Count;
+	}
+
+	// A pawn, three cosmetic parts and a weapon, each with one of the materials
+	TArray<AActor*> SpawnPawns()
+	{
+		TArray<AActor*> Pawns;
+		for (int32 PawnIndex = 0; PawnIndex < NumPawns; ++PawnIndex)
+		{
+			AActor& Pawn = Spawner.SpawnActor<AActor>();
+			for (int32 PartIndex = 0; PartIndex < NumMeshesPerPawn; ++PartIndex)
+			{
+				UStaticMeshComponent* MeshComponent = NewObject<UStaticMeshComponent>(&Pawn);
+				MeshComponent->SetStaticMesh(Mesh);
+				MeshComponent->SetMaterial(0, Materials[PartIndex % Materials.Num()]);
+				MeshComponent->RegisterComponent();
+			}
+			Pawns.Add(&Pawn);
+		}
+		return Pawns;
+	}
+
+	double ApplyToPawns(TConstArrayView<AActor*> Pawns)
+	{
+		const double StartTime = FPlatformTime::Seconds();
+		for (AActor* Pawn : Pawns)
+		{
+			DisplayAsset->ApplyToActor(Pawn);
+		}
+		return (FPlatformTime::Seconds() - StartTime) * 1000.0;
+	}
+
+	// Whether the component or its material gives each parameter of the display asset the material has the asset's value
+	void VerifyApplied(TConstArrayView<AActor*> Pawns)
+	{
+		for (AActor* Pawn : Pawns)
+		{
+			Pawn->ForEachComponent<UStaticMeshComponent>(false, [this](UStaticMeshComponent* MeshComponent)
+			{
+				UMaterialInterface* Material = MeshComponent->GetMaterial(0);
+				const TArray<float>& PrimitiveData = MeshComponent->GetCustomPrimitiveData().Data;
+
+				for (const TPair<FName, float>& Scalar : DisplayAsset->ScalarParameters)
+				{
+					FMaterialParameterMetadata Metadata;
+					if (Material->GetParameterValue(EMaterialParameterType::Scalar, FMemoryImageMaterialParameterInfo(Scalar.Key), Metadata))
+					{
+						const int32 DataIndex = Metadata.PrimitiveDataIndex;
+						const float Value = (DataIndex > INDEX_NONE) ? PrimitiveData[DataIndex] : Metadata.Value.AsScalar();
+						ASSERT_THAT(IsNear(Scalar.Value, Value, 0.0001f));
+					}
+				}
+
+				for (const TPair<FName, FLinearColor>& Color : DisplayAsset->ColorParameters)
+				{
+					FMaterialParameterMetadata Metadata;
+					if (Material->GetParameterValue(EMaterialParameterType::Vector, FMemoryImageMaterialParameterInfo(Color.Key), Metadata))
+					{
+						const int32 DataIndex = Metadata.PrimitiveDataIndex;
+						const FLinearColor Value = (DataIndex > INDEX_NONE) ? FLinearColor(PrimitiveData[DataIndex], PrimitiveData[DataIndex + 1], PrimitiveData[DataIndex + 2]) : Metadata.Value.AsLinearColor();
+						ASSERT_THAT(IsTrue(FVector(Color.Value).Equals(FVector(Value), 0.0001f)));
+					}
+				}
+
+				for (const TPair<FName, TObjectPtr<UTexture>>& Texture : DisplayAsset->TextureParameters)
+				{
+					UTexture* Value = nullptr;
+					if (Material->GetTextureParameterValue(FHashedMaterialParameterInfo(Texture.Key), Value))
+					{
+						ASSERT_THAT(IsTrue(Texture.Value == Value));
+					}
+				}
+			});
+		}
+	}
+
+	BEFORE_EACH()
+	{
+		bSavedShareMaterialInstances = GetShareVariable()->GetBool();
+
+		DisplayAsset = LoadObject<ULyraTeamDisplayAsset>(nullptr, TEXT("/Game/System/Teams/TeamDA_Blue.TeamDA_Blue"));
+		ASSERT_THAT(IsNotNull(DisplayAsset));
+
+		Mesh = LoadObject<UStaticMesh>(nullptr, TEXT("/Engine/BasicShapes/Cube.Cube"));
+		ASSERT_THAT(IsNotNull(Mesh));
+
+		const TCHAR* MaterialPaths[] = {
+			TEXT("/Game/Characters/Heroes/Mannequin/Materials/Instances/Manny/MI_Manny_01_Blue.MI_Manny_01_Blue"),
+			TEXT("/Game/Characters/Heroes/Mannequin/Materials/Instances/Quinn/MI_Quinn_01_Blue.MI_Quinn_01_Blue"),
+			TEXT("/Game/Characters/Heroes/Mannequin/Materials/Instances/Quinn/MI_Quinn_02_Blue.MI_Quinn_02_Blue"),
+			TEXT("/Game/Characters/Heroes/Mannequin/Materials/M_Mannequin.M_Mannequin")
+		};
+		for (const TCHAR* MaterialPath : MaterialPaths)
+		{
+			UMaterialInterface* Material = LoadObject<UMaterialInterface>(nullptr, MaterialPath);
+			ASSERT_THAT(IsNotNull(Material));
+			Materials.Add(Material);
+		}
+	}
+
+	AFTER_EACH()
+	{
+		GetShareVariable()->Set(bSavedShareMaterialInstances, ECVF_SetByCode);
+	}
+
+	TEST_METHOD(TeamDisplayAsset_ApplyTo64Pawns_ReportsMaterialInstancesAndApplyTime)
+	{
+		// Original behavior, an instance for each material slot
+		GetShareVariable()->Set(false, ECVF_SetByCode);
+		const TArray<AActor*> PerSlotPawns = SpawnPawns();
+		const int32 NumBeforePerSlot = CountDynamicMaterials();
+		const double PerSlotMs = ApplyToPawns(PerSlotPawns);
+		const int32 NumPerSlot = CountDynamicMaterials() - NumBeforePerSlot;
+		VerifyApplied(PerSlotPawns);
+
+		// Shared, the second wave is what respawns cost once the instances exist
+		GetShareVariable()->Set(true, ECVF_SetByCode);
+		const TArray<AActor*> SharedPawns = SpawnPawns();
+		const TArray<AActor*> RespawnedPawns = SpawnPawns();
+		const int32 NumBeforeShared = CountDynamicMaterials();
+		const double SharedMs = ApplyToPawns(SharedPawns);
+		const double RespawnedMs = ApplyToPawns(RespawnedPawns);
+		const int32 NumShared = CountDynamicMaterials() - NumBeforeShared;
+		VerifyApplied(SharedPawns);
+		VerifyApplied(RespawnedPawns);
+
+		ASSERT_THAT(IsTrue(NumShared <= Materials.Num(), "At most one instance per base material should be created."));
+
+		TestRunner->AddInfo(FString::Printf(TEXT("%d pawns x %d meshes: per slot instances %d created in %.3f ms"), NumPawns, NumMeshesPerPawn, NumPerSlot, PerSlotMs));
+		TestRunner->AddInfo(FString::Printf(TEXT("%d pawns x %d meshes: shared instances %d created in %.3f ms, respawned pawns applied in %.3f ms"), NumPawns, NumMeshesPerPawn, NumShared, SharedMs, RespawnedMs));
+	}
+};
+
+/**
+ * Checks that a material parameter set on one pawn doesn't reach another pawn of the same team through a shared team material instance.
+ *
+ * Each TEST_METHOD will register with the `TeamMaterialSharingTest` test object and has the variables and methods from `TeamMaterialSharingTest` available for use.
+ */
+TEST_CLASS_WITH_FLAGS(TeamMaterialSharingTest, "Project.Functional Tests.ShooterTests.Teams", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+{
+	FActorTestSpawner Spawner;
+	ULyraTeamDisplayAsset* DisplayAsset{ nullptr };
+	UStaticMesh* Mesh{ nullptr };
+	UMaterialInterface* Material{ nullptr };
+	bool bSavedShareMaterialInstances = true;
+
+	IConsoleVariable* GetShareVariable()
+	{
+		IConsoleVariable* Variable = IConsoleManager::Get().FindConsoleVariable(TEXT("Lyra.Teams.ShareMaterialInstances"));
+		check(Variable);
+		return Variable;
+	}
+
+	UStaticMeshComponent* SpawnPawn()
+	{
+		AActor& Pawn = Spawner.SpawnActor<AActor>();
+		UStaticMeshComponent* MeshComponent = NewObject<UStaticMeshComponent>(&Pawn);
+		MeshComponent->SetStaticMesh(Mesh);
+		MeshComponent->SetMaterial(0, Material);
+		MeshComponent->RegisterComponent();
+		DisplayAsset->ApplyToActor(&Pawn);
+		return MeshComponent;
+	}
+
+	static float GetScalarValue(UStaticMeshComponent* MeshComponent, FName ParameterName)
+	{
+		float Value = 0.0f;
+		MeshComponent->GetMaterial(0)->GetScalarParameterValue(FHashedMaterialParameterInfo(ParameterName), Value);
+		return Value;
+	}
+
+	BEFORE_EACH()
+	{
+		bSavedShareMaterialInstances = GetShareVariable()->GetBool();
+		GetShareVariable()->Set(true, ECVF_SetByCode);
+
+		DisplayAsset = LoadObject<ULyraTeamDisplayAsset>(nullptr, TEXT("/Game/System/Teams/TeamDA_Blue.TeamDA_Blue"));
+		ASSERT_THAT(IsNotNull(DisplayAsset));
+
+		Mesh = LoadObject<UStaticMesh>(nullptr, TEXT("/Engine/BasicShapes/Cube.Cube"));
+		ASSERT_THAT(IsNotNull(Mesh));
+
+		Material = LoadObject<UMaterialInterface>(nullptr, TEXT("/Game/Characters/Heroes/Mannequin/Materials/Instances/Manny/MI_Manny_01_Blue.MI_Manny_01_Blue"));
+		ASSERT_THAT(IsNotNull(Material));
+	}
+
+	AFTER_EACH()
+	{
+		GetShareVariable()->Set(bSavedShareMaterialInstances, ECVF_SetByCode);
+	}
+
+	TEST_METHOD(TeamDisplayAsset_ParameterSetOnOnePawn_LeavesOtherPawnUnchanged)
+	{
+		// Any scalar the material has, as a hit flash or fade would set
+		TArray<FMaterialParameterInfo> ScalarInfos;
+		TArray<FGuid> ScalarIds;
+		Material->GetAllScalarParameterInfo(ScalarInfos, ScalarIds);
+		const FMaterialParameterInfo* ScalarInfo = ScalarInfos.FindByPredicate([](const FMaterialParameterInfo& Info) { return Info.Association == EMaterialParameterAssociation::GlobalParameter; });
+		ASSERT_THAT(IsNotNull(ScalarInfo));
+
+		UStaticMeshComponent* HitPawnMesh = SpawnPawn();
+		UStaticMeshComponent* OtherPawnMesh = SpawnPawn();
+		const float OriginalValue = GetScalarValue(OtherPawnMesh, ScalarInfo->Name);
+		const float NewValue = OriginalValue + 1.0f;
+
+		ULyraSystemStatics::SetScalarParameterValueOnAllMeshComponents(HitPawnMesh->GetOwner(), ScalarInfo->Name, NewValue);
+
+		ASSERT_THAT(IsNear(NewValue, GetScalarValue(HitPawnMesh, ScalarInfo->Name), 0.0001f));
+		ASSERT_THAT(IsNear(OriginalValue, GetScalarValue(OtherPawnMesh, ScalarInfo->Name), 0.0001f));
+		ASSERT_THAT(IsTrue(HitPawnMesh->GetMaterial(0) != OtherPawnMesh->GetMaterial(0)));
+
+		// Applying the team again writes into the hit pawn's own instance, not back into the shared one
+		DisplayAsset->ApplyToActor(HitPawnMesh->GetOwner());
+		ASSERT_THAT(IsTrue(HitPawnMesh->GetMaterial(0) != OtherPawnMesh->GetMaterial(0)));
+		ASSERT_THAT(IsNear(OriginalValue, GetScalarValue(OtherPawnMesh, ScalarInfo->Name), 0.0001f));
+	}
+};
+
+#endif // WITH_AUTOMATION_TESTS
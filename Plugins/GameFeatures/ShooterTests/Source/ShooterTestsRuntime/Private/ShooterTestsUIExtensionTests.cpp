@@ -0,0 +1,203 @@
+// Copyright Epic Games, Inc.All Rights Reserved.
+
+#include "CQTest.h"
+
+#if WITH_AUTOMATION_TESTS
+
+#include "Blueprint/UserWidget.h"
+#include "Components/ActorTestSpawner.h"
+#include "Engine/DataAsset.h"
+#include "Engine/Texture2D.h"
+#include "GameplayTagsManager.h"
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
+#include "UIExtensionSystem.h"
+#include "UObject/Package.h"
+
+/**
+ * Measures registration in UUIExtensionSubsystem with 200 extension points and 1,000 extensions, as when the HUD and game
+ * features register at experience load.
+ *
+ * Points and extensions are spread over the project's gameplay tags, a few context objects and a few data classes, with exact
+ * and partial points. Each phase counts the callbacks the points receive and checks them against a brute force match of every
+ * point with every extension: extensions registered after the points, removing them again, and points registered after the
+ * extensions. Point registration walks the point's own tag and its parents, as the subsystem always did.
+ *
+ * Each TEST_METHOD will register with the `UIExtensionBenchmark` test object and has the variables and methods from `UIExtensionBenchmark` available for use.
+ */
+TEST_CLASS_WITH_FLAGS(UIExtensionBenchmark, "Project.Functional Tests.ShooterTests.Performance.UI", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+{
+	static constexpr int32 NumPoints = 200;
+	static constexpr int32 NumExtensions = 1000;
+	static constexpr int32 NumContexts = 4;
+
+	struct FTestPoint
+	{
+		FGameplayTag Tag;
+		UObject* ContextObject = nullptr;
+		EUIExtensionPointMatch MatchType = EUIExtensionPointMatch::ExactMatch;
+		TArray<UClass*> AllowedDataClasses;
+		FUIExtensionPointHandle Handle;
+	};
+
+	struct FTestExtension
+	{
+		FGameplayTag Tag;
+		UObject* ContextObject = nullptr;
+		UClass* DataClass = nullptr;
+		FUIExtensionHandle Handle;
+	};
+
+	FActorTestSpawner Spawner;
+	UUIExtensionSubsystem* ExtensionSubsystem{ nullptr };
+	FRandomStream RandomStream{ 0x0E47 };
+	TArray<FTestPoint> Points;
+	TArray<FTestExtension> Extensions;
+	int32 NumAddedCallbacks = 0;
+	int32 NumRemovedCallbacks = 0;
+
+	BEFORE_EACH()
+	{
+		ExtensionSubsystem = Spawner.GetWorld().GetSubsystem<UUIExtensionSubsystem>();
+		ASSERT_THAT(IsNotNull(ExtensionSubsystem));
+
+		FGameplayTagContainer AllTagsContainer;
+		UGameplayTagsManager::Get().RequestAllGameplayTags(AllTagsContainer, /*OnlyIncludeDictionaryTags=*/ false);
+		TArray<FGameplayTag> AllTags;
+		AllTagsContainer.GetGameplayTagArray(AllTags);
+		AllTags.Sort([](const FGameplayTag& A, const FGameplayTag& B) { return A.GetTagName().LexicalLess(B.GetTagName()); });
+		ASSERT_THAT(IsTrue(AllTags.Num() > 0));
+
+		// Points sit on a slice of the tags, extensions land on those tags and their children or parents
+		const int32 NumPointTags = FMath::Min(AllTags.Num(), 60);
+		const int32 FirstPointTag = RandomStream.RandHelper(AllTags.Num() - NumPointTags + 1);
+
+		TArray<UObject*> ContextObjects = { nullptr };
+		for (int32 ContextIndex = 0; ContextIndex < NumContexts; ++ContextIndex)
+		{
+			ContextObjects.Add(NewObject<UObject>(GetTransientPackage(), NAME_None, RF_Transient));
+		}
+
+		const TArray<UClass*> DataClasses = { UUserWidget::StaticClass(), UPrimaryDataAsset::StaticClass(), UTexture2D::StaticClass() };
+
+		Points.SetNum(NumPoints);
+		for (int32 PointIndex = 0; PointIndex < NumPoints; ++PointIndex)
+		{
+			FTestPoint& Point = Points[PointIndex];
+			Point.Tag = AllTags[FirstPointTag + RandomStream.RandHelper(NumPointTags)];
+			Point.ContextObject = ContextObjects[RandomStream.RandHelper(ContextObjects.Num())];
+			Point.MatchType = RandomStream.RandBool() ? EUIExtensionPointMatch::PartialMatch : EUIExtensionPointMatch::ExactMatch;
+
+			const int32 AllowedClasses = RandomStream.RandRange(1, 3);
+			if (AllowedClasses & 1)
+			{
+				Point.AllowedDataClasses.Add(UUserWidget::StaticClass());
+			}
+			if (AllowedClasses & 2)
+			{
+				Point.AllowedDataClasses.Add(UDataAsset::StaticClass());
+			}
+		}
+
+		Extensions.SetNum(NumExtensions);
+		for (FTestExtension& Extension : Extensions)
+		{
+			Extension.Tag = AllTags[FMath::Clamp(FirstPointTag + RandomStream.RandRange(-5, NumPointTags + 5), 0, AllTags.Num() - 1)];
+			Extension.ContextObject = ContextObjects[RandomStream.RandHelper(ContextObjects.Num())];
+			Extension.DataClass = DataClasses[RandomStream.RandHelper(DataClasses.Num())];
+		}
+	}
+
+	static bool PassesContract(const FTestPoint& Point, const FTestExtension& Extension)
+	{
+		return (Point.ContextObject == Extension.ContextObject) &&
+			Point.AllowedDataClasses.ContainsByPredicate([&Extension](const UClass* AllowedClass) { return Extension.DataClass->IsChildOf(AllowedClass); });
+	}
+
+	// Callbacks expected when the extension is registered or removed after the point
+	static bool ExpectsExtension(const FTestPoint& Point, const FTestExtension& Extension)
+	{
+		const bool bTagMatches = (Point.MatchType == EUIExtensionPointMatch::PartialMatch) ? Extension.Tag.MatchesTag(Point.Tag) : (Extension.Tag == Point.Tag);
+		return bTagMatches && PassesContract(Point, Extension);
+	}
+
+	// Callbacks expected when the point is registered after the extension
+	static bool ExpectsExistingExtension(const FTestPoint& Point, const FTestExtension& Extension)
+	{
+		const bool bTagMatches = (Point.MatchType == EUIExtensionPointMatch::PartialMatch) ? Point.Tag.MatchesTag(Extension.Tag) : (Extension.Tag == Point.Tag);
+		return bTagMatches && PassesContract(Point, Extension);
+	}
+
+	int32 CountExpected(bool (*ExpectsFunc)(const FTestPoint&, const FTestExtension&)) const
+	{
+		int32 NumExpected = 0;
+		for (const FTestPoint& Point : Points)
+		{
+			for (const FTestExtension& Extension : Extensions)
+			{
+				NumExpected += ExpectsFunc(Point, Extension) ? 1 : 0;
+			}
+		}
+		return NumExpected;
+	}
+
+	double RegisterPoints()
+	{
+		const double StartTime = FPlatformTime::Seconds();
+		for (FTestPoint& Point : Points)
+		{
+			Point.Handle = ExtensionSubsystem->RegisterExtensionPointForContext(Point.Tag, Point.ContextObject, Point.MatchType, Point.AllowedDataClasses,
+				FExtendExtensionPointDelegate::CreateLambda([this](EUIExtensionAction Action, const FUIExtensionRequest& Request)
+				{
+					((Action == EUIExtensionAction::Added) ? NumAddedCallbacks : NumRemovedCallbacks)++;
+				}));
+		}
+		return FPlatformTime::Seconds() - StartTime;
+	}
+
+	double RegisterExtensions()
+	{
+		const double StartTime = FPlatformTime::Seconds();
+		for (FTestExtension& Extension : Extensions)
+		{
+			Extension.Handle = ExtensionSubsystem->RegisterExtensionAsData(Extension.Tag, Extension.ContextObject, Extension.DataClass, INDEX_NONE);
+		}
+		return FPlatformTime::Seconds() - StartTime;
+	}
+
+	double UnregisterExtensions()
+	{
+		const double StartTime = FPlatformTime::Seconds();
+		for (FTestExtension& Extension : Extensions)
+		{
+			Extension.Handle.Unregister();
+		}
+		return FPlatformTime::Seconds() - StartTime;
+	}
+
+	TEST_METHOD(UIExtension_200PointsAnd1000Extensions_ReportsRegistrationTime)
+	{
+		RegisterPoints();
+		const double AddExtensionsSeconds = RegisterExtensions();
+		ASSERT_THAT(AreEqual(CountExpected(&ExpectsExtension), NumAddedCallbacks));
+		const int32 NumExtensionMatches = NumAddedCallbacks;
+
+		const double RemoveExtensionsSeconds = UnregisterExtensions();
+		ASSERT_THAT(AreEqual(NumExtensionMatches, NumRemovedCallbacks));
+
+		for (FTestPoint& Point : Points)
+		{
+			Point.Handle.Unregister();
+		}
+
+		NumAddedCallbacks = 0;
+		RegisterExtensions();
+		const double AddPointsSeconds = RegisterPoints();
+		ASSERT_THAT(AreEqual(CountExpected(&ExpectsExistingExtension), NumAddedCallbacks));
+
+		TestRunner->AddInfo(FString::Printf(TEXT("%d points, %d extensions, %d matches: %.3f ms registering extensions, %.3f ms removing them, %.3f ms registering points after the extensions (%d matches)"),
+			NumPoints, NumExtensions, NumExtensionMatches, AddExtensionsSeconds * 1000.0, RemoveExtensionsSeconds * 1000.0, AddPointsSeconds * 1000.0, NumAddedCallbacks));
+	}
+};
+
+#endif // WITH_AUTOMATION_TESTS
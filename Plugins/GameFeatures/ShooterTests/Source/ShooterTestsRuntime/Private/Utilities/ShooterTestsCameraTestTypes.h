@@ -0,0 +1,73 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Camera/LyraCameraMode.h"
+
+#include "ShooterTestsCameraTestTypes.generated.h"
+
+/** Camera mode with a long linear blend, so pushing modes in turn keeps all of them on the stack. */
+UCLASS(Abstract, Transient)
+class UShooterTestsCameraMode : public ULyraCameraMode
+{
+	GENERATED_BODY()
+
+public:
+	UShooterTestsCameraMode()
+	{
+		BlendTime = 1.0f;
+		BlendFunction = ELyraCameraModeBlendFunction::Linear;
+	}
+
+	void SetFieldOfView(float InFieldOfView) { FieldOfView = InFieldOfView; }
+};
+
+// The stack keeps one instance per class, so a deep stack needs as many classes
+
+UCLASS(Transient)
+class UShooterTestsCameraMode_A : public UShooterTestsCameraMode
+{
+	GENERATED_BODY()
+};
+
+UCLASS(Transient)
+class UShooterTestsCameraMode_B : public UShooterTestsCameraMode
+{
+	GENERATED_BODY()
+};
+
+UCLASS(Transient)
+class UShooterTestsCameraMode_C : public UShooterTestsCameraMode
+{
+	GENERATED_BODY()
+};
+
+UCLASS(Transient)
+class UShooterTestsCameraMode_D : public UShooterTestsCameraMode
+{
+	GENERATED_BODY()
+};
+
+UCLASS(Transient)
+class UShooterTestsCameraMode_E : public UShooterTestsCameraMode
+{
+	GENERATED_BODY()
+};
+
+UCLASS(Transient)
+class UShooterTestsCameraMode_F : public UShooterTestsCameraMode
+{
+	GENERATED_BODY()
+};
+
+UCLASS(Transient)
+class UShooterTestsCameraMode_G : public UShooterTestsCameraMode
+{
+	GENERATED_BODY()
+};
+
+UCLASS(Transient)
+class UShooterTestsCameraMode_H : public UShooterTestsCameraMode
+{
+	GENERATED_BODY()
+};
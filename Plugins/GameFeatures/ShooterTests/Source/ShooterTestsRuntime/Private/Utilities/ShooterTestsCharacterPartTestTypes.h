@@ -0,0 +1,31 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Components/SceneComponent.h"
+#include "GameFramework/Actor.h"
+#include "GameplayTagAssetInterface.h"
+#include "LyraGameplayTags.h"
+
+#include "ShooterTestsCharacterPartTestTypes.generated.h"
+
+/** Character part that owns a cosmetic tag, like the tagged parts used to pick a body style. */
+UCLASS(Transient)
+class AShooterTestsCharacterPartActor : public AActor, public IGameplayTagAssetInterface
+{
+	GENERATED_BODY()
+
+public:
+	AShooterTestsCharacterPartActor()
+	{
+		SetRootComponent(CreateDefaultSubobject<USceneComponent>(TEXT("Root")));
+		PartTags.AddTag(LyraGameplayTags::Status_Crouching);
+	}
+
+	virtual void GetOwnedGameplayTags(FGameplayTagContainer& TagContainer) const override
+	{
+		TagContainer.AppendTags(PartTags);
+	}
+
+	FGameplayTagContainer PartTags;
+};
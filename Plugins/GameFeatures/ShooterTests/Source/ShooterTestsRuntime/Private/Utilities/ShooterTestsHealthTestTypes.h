@@ -0,0 +1,40 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Abilities/GameplayAbilityTypes.h"
+#include "UObject/Object.h"
+
+#include "ShooterTestsHealthTestTypes.generated.h"
+
+class AActor;
+class ULyraHealthComponent;
+
+/** Records the health notifications and death gameplay events of one pawn, and whether they arrived in order. */
+UCLASS(Transient)
+class UShooterTestsHealthListener : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	UFUNCTION()
+	void HandleHealthChanged(ULyraHealthComponent* HealthComponent, float OldValue, float NewValue, AActor* Instigator)
+	{
+		++NumHealthChanged;
+		NumOutOfOrderEvents += (NumDeathEvents > 0) ? 1 : 0;
+		LastNotifiedHealth = NewValue;
+	}
+
+	void HandleDeathEvent(const FGameplayEventData* Payload)
+	{
+		++NumDeathEvents;
+
+		// The notification that took the pawn to zero health has to come first
+		NumOutOfOrderEvents += (LastNotifiedHealth > 0.0f) ? 1 : 0;
+	}
+
+	int32 NumHealthChanged = 0;
+	int32 NumDeathEvents = 0;
+	int32 NumOutOfOrderEvents = 0;
+	float LastNotifiedHealth = -1.0f;
+};
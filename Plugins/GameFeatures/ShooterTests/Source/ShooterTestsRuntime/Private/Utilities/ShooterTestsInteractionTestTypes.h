@@ -0,0 +1,111 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Abilities/GameplayAbility.h"
+#include "Components/SphereComponent.h"
+#include "GameFramework/Actor.h"
+#include "Interaction/IInteractableTarget.h"
+#include "Interaction/InteractionOption.h"
+#include "Interaction/Tasks/AbilityTask_GrantNearbyInteraction.h"
+#include "LyraGameplayTags.h"
+#include "Physics/LyraCollisionChannels.h"
+
+#include "ShooterTestsInteractionTestTypes.generated.h"
+
+/** Interactable target whose options are set directly by a test. */
+UCLASS(Transient)
+class UShooterTestsInteractableTarget : public UObject, public IInteractableTarget
+{
+	GENERATED_BODY()
+
+public:
+	virtual void GatherInteractionOptions(const FInteractionQuery& InteractQuery, FInteractionOptionBuilder& OptionBuilder) override
+	{
+		for (const FInteractionOption& Option : Options)
+		{
+			OptionBuilder.AddInteractionOption(Option);
+		}
+	}
+
+	TArray<FInteractionOption> Options;
+};
+
+/** Interaction ability that can always be activated. */
+UCLASS(Transient)
+class UShooterTestsInteractAbility : public UGameplayAbility
+{
+	GENERATED_BODY()
+};
+
+/** Interaction ability that is blocked while the owner is crouching. */
+UCLASS(Transient)
+class UShooterTestsBlockedInteractAbility : public UGameplayAbility
+{
+	GENERATED_BODY()
+
+public:
+	UShooterTestsBlockedInteractAbility()
+	{
+		ActivationBlockedTags.AddTag(LyraGameplayTags::Status_Crouching);
+	}
+};
+
+/** Interaction ability that is never granted, so its options are always filtered out. */
+UCLASS(Transient)
+class UShooterTestsUngrantedInteractAbility : public UGameplayAbility
+{
+	GENERATED_BODY()
+};
+
+/** Interactable actor with a sphere that overlaps the interaction channel, and options set directly by a test. */
+UCLASS(Transient)
+class AShooterTestsInteractableActor : public AActor, public IInteractableTarget
+{
+	GENERATED_BODY()
+
+public:
+	AShooterTestsInteractableActor()
+	{
+		Sphere = CreateDefaultSubobject<USphereComponent>(TEXT("Sphere"));
+		Sphere->InitSphereRadius(50.0f);
+		Sphere->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
+		Sphere->SetCollisionResponseToAllChannels(ECR_Ignore);
+		Sphere->SetCollisionResponseToChannel(Lyra_TraceChannel_Interaction, ECR_Overlap);
+		RootComponent = Sphere;
+	}
+
+	virtual void GatherInteractionOptions(const FInteractionQuery& InteractQuery, FInteractionOptionBuilder& OptionBuilder) override
+	{
+		for (const FInteractionOption& Option : Options)
+		{
+			OptionBuilder.AddInteractionOption(Option);
+		}
+	}
+
+	UPROPERTY()
+	TObjectPtr<USphereComponent> Sphere;
+
+	TArray<FInteractionOption> Options;
+};
+
+/** Runs UAbilityTask_GrantNearbyInteraction for as long as it is active, re-evaluating every registry tick. */
+UCLASS(Transient)
+class UShooterTestsGrantNearbyInteractionAbility : public UGameplayAbility
+{
+	GENERATED_BODY()
+
+public:
+	UShooterTestsGrantNearbyInteractionAbility()
+	{
+		InstancingPolicy = EGameplayAbilityInstancingPolicy::InstancedPerActor;
+	}
+
+	virtual void ActivateAbility(const FGameplayAbilitySpecHandle Handle, const FGameplayAbilityActorInfo* ActorInfo, const FGameplayAbilityActivationInfo ActivationInfo, const FGameplayEventData* TriggerEventData) override
+	{
+		UAbilityTask_GrantNearbyInteraction* Task = UAbilityTask_GrantNearbyInteraction::GrantAbilitiesForNearbyInteractors(this, ScanRange, /*InteractionScanRate=*/ 0.0f);
+		Task->ReadyForActivation();
+	}
+
+	static constexpr float ScanRange = 500.0f;
+};
@@ -29,6 +29,17 @@ public class ShooterTestsRuntime : ModuleRules
 				"EnhancedInput",
 				"CQTest",
 				"CQTestEnhancedInput",
+				"UIExtension",
+				"UMG",
+				"AsyncMixin",
+				"AssetRegistry",
+				"GameplayMessageRuntime",
+				"NetworkReplayStreaming",
+				"LocalFileNetworkReplayStreaming",
+				"GameSettings",
+				"CommonUI",
+				"CommonGame",
+				"GameFeatures",
 				// ... add private dependencies that you statically link with here ...	
 			}
 		);
@@ -3,6 +3,68 @@
 #include "DataSource/GameSettingDataSourceDynamic.h"
 
 #include "Engine/LocalPlayer.h"
+#include "HAL/IConsoleManager.h"
+#include "UObject/Class.h"
+#include "UObject/UnrealType.h"
+
+namespace GameSettingsConsoleVars
+{
+	static bool bCompiledDataSources = true;
+	static FAutoConsoleVariableRef CVarGameSettingsCompiledDataSources(
+		TEXT("GameSettings.CompiledDataSources"),
+		bCompiledDataSources,
+		TEXT("Should dynamic data sources call their getters and setters directly once their path is compiled?\n")
+		TEXT("  If false, every access resolves the property path and converts through strings"),
+		ECVF_Default);
+}
+
+namespace GameSettingDataSourceDynamic
+{
+	// Calls a function with a single parameter, which is either its return value or the value it's given
+	static void CallFunction(UObject* Object, UFunction* Function, FProperty* Parameter, TFunctionRef<void(void* ParameterPtr)> BeforeCall, TFunctionRef<void(void* ParameterPtr)> AfterCall)
+	{
+		uint8* Parameters = static_cast<uint8*>(FMemory_Alloca_Aligned(Function->ParmsSize, Function->GetMinAlignment()));
+		FMemory::Memzero(Parameters, Function->ParmsSize);
+		Parameter->InitializeValue_InContainer(Parameters);
+
+		void* ParameterPtr = Parameter->ContainerPtrToValuePtr<void>(Parameters);
+		BeforeCall(ParameterPtr);
+		Object->ProcessEvent(Function, Parameters);
+		AfterCall(ParameterPtr);
+
+		Parameter->DestroyValue_InContainer(Parameters);
+	}
+
+	static FProperty* GetOnlyParameter(const UFunction* Function)
+	{
+		if (Function->NumParms != 1)
+		{
+			return nullptr;
+		}
+
+		for (TFieldIterator<FProperty> It(Function); It && It->HasAnyPropertyFlags(CPF_Parm); ++It)
+		{
+			return *It;
+		}
+		return nullptr;
+	}
+
+	static UObject* ReadObject(UObject* Container, UFunction* Function, FProperty* Property)
+	{
+		const FObjectPropertyBase* ObjectProperty = CastFieldChecked<FObjectPropertyBase>(Property);
+
+		UObject* Result = nullptr;
+		if (Function)
+		{
+			CallFunction(Container, Function, Property, [](void*) {}, [ObjectProperty, &Result](void* ParameterPtr) { Result = ObjectProperty->GetObjectPropertyValue(ParameterPtr); });
+		}
+		else
+		{
+			Result = ObjectProperty->GetObjectPropertyValue_InContainer(Container);
+		}
+		return Result;
+	}
+}
 
 //--------------------------------------
 // FGameSettingDataSourceDynamic
@@ -11,27 +73,235 @@
 FGameSettingDataSourceDynamic::FGameSettingDataSourceDynamic(const TArray<FString>& InDynamicPath)
 	: DynamicPath(InDynamicPath)
 {
+	SegmentNames.Reserve(InDynamicPath.Num());
+	for (const FString& Segment : InDynamicPath)
+	{
+		// Array elements and other path syntax are left to PropertyPathHelpers
+		if (Segment.Contains(TEXT("[")) || Segment.Contains(TEXT(".")))
+		{
+			CompileState = ECompileState::Unsupported;
+		}
+		SegmentNames.Add(FName(*Segment));
+	}
 }
 
 bool FGameSettingDataSourceDynamic::Resolve(ULocalPlayer* InLocalPlayer)
 {
+	TryCompile(InLocalPlayer);
 	return DynamicPath.Resolve(InLocalPlayer);
 }
 
+bool FGameSettingDataSourceDynamic::TryCompile(ULocalPlayer* InLocalPlayer) const
+{
+	using namespace GameSettingDataSourceDynamic;
+
+	if (CompileState != ECompileState::NotCompiled)
+	{
+		return CompileState == ECompileState::Compiled;
+	}
+
+	if (!InLocalPlayer || (SegmentNames.Num() == 0))
+	{
+		return false;
+	}
+
+	TArray<FCompiledSegment> Segments;
+	Segments.Reserve(SegmentNames.Num());
+
+	// Walk the actual objects, so functions and properties are found on the classes they will be called on
+	UObject* Container = InLocalPlayer;
+	for (int32 SegmentIndex = 0; SegmentIndex < SegmentNames.Num(); ++SegmentIndex)
+	{
+		const bool bIsLastSegment = (SegmentIndex == SegmentNames.Num() - 1);
+
+		FCompiledSegment& Segment = Segments.AddDefaulted_GetRef();
+		Segment.ContainerClass = Container->GetClass();
+
+		if (UFunction* Function = Container->GetClass()->FindFunctionByName(SegmentNames[SegmentIndex]))
+		{
+			Segment.Function = Function;
+			Segment.Property = GetOnlyParameter(Function);
+		}
+		else
+		{
+			Segment.Property = Container->GetClass()->FindPropertyByName(SegmentNames[SegmentIndex]);
+			if (Segment.Property && (Segment.Property->ArrayDim != 1))
+			{
+				Segment.Property = nullptr;
+			}
+		}
+
+		if (Segment.Property == nullptr)
+		{
+			CompileState = ECompileState::Unsupported;
+			return false;
+		}
+
+		if (!bIsLastSegment)
+		{
+			// Everything before the value has to lead to the next object
+			const bool bReturnsValue = !Segment.Function.IsValid() || Segment.Property->HasAnyPropertyFlags(CPF_ReturnParm);
+			if (!bReturnsValue || !Segment.Property->IsA<FObjectPropertyBase>())
+			{
+				CompileState = ECompileState::Unsupported;
+				return false;
+			}
+
+			Container = ReadObject(Container, Segment.Function.Get(), Segment.Property);
+			if (Container == nullptr)
+			{
+				// Try again once the object exists
+				return false;
+			}
+		}
+	}
+
+	CompiledSegments = MoveTemp(Segments);
+	CompileState = ECompileState::Compiled;
+	return true;
+}
+
+bool FGameSettingDataSourceDynamic::VisitCompiledValue(ULocalPlayer* InLocalPlayer, bool bWrite, TFunctionRef<void(FProperty* ValueProperty, void* ValuePtr)> Visitor) const
+{
+	using namespace GameSettingDataSourceDynamic;
+
+	if (!GameSettingsConsoleVars::bCompiledDataSources || !TryCompile(InLocalPlayer))
+	{
+		return false;
+	}
+
+	UObject* Container = InLocalPlayer;
+	for (int32 SegmentIndex = 0; SegmentIndex < CompiledSegments.Num(); ++SegmentIndex)
+	{
+		const FCompiledSegment& Segment = CompiledSegments[SegmentIndex];
+
+		// A different class may override or hide what the path was compiled against
+		UClass* ContainerClass = Segment.ContainerClass.Get();
+		if (!Container || !ContainerClass || (Container->GetClass() != ContainerClass))
+		{
+			return false;
+		}
+
+		UFunction* Function = Segment.Function.Get();
+		if (!Function && !Segment.Function.IsExplicitlyNull())
+		{
+			return false;
+		}
+
+		if (SegmentIndex < CompiledSegments.Num() - 1)
+		{
+			Container = ReadObject(Container, Function, Segment.Property);
+			continue;
+		}
+
+		if (Function)
+		{
+			// Getters return the value, setters take it
+			const bool bIsGetter = Segment.Property->HasAnyPropertyFlags(CPF_ReturnParm);
+			if (bIsGetter == bWrite)
+			{
+				return false;
+			}
+
+			if (bWrite)
+			{
+				CallFunction(Container, Function, Segment.Property, [&Visitor, &Segment](void* ParameterPtr) { Visitor(Segment.Property, ParameterPtr); }, [](void*) {});
+			}
+			else
+			{
+				CallFunction(Container, Function, Segment.Property, [](void*) {}, [&Visitor, &Segment](void* ParameterPtr) { Visitor(Segment.Property, ParameterPtr); });
+			}
+		}
+		else
+		{
+			Visitor(Segment.Property, Segment.Property->ContainerPtrToValuePtr<void>(Container));
+		}
+	}
+
+	return true;
+}
+
 FString FGameSettingDataSourceDynamic::GetValueAsString(ULocalPlayer* InLocalPlayer) const
 {
 	FString OutStringValue;
 
-	const bool bSuccess = PropertyPathHelpers::GetPropertyValueAsString(InLocalPlayer, DynamicPath, OutStringValue);
-	ensure(bSuccess);
+	const bool bCompiled = VisitCompiledValue(InLocalPlayer, /*bWrite=*/ false, [&OutStringValue](FProperty* ValueProperty, void* ValuePtr)
+	{
+		ValueProperty->ExportTextItem_Direct(OutStringValue, ValuePtr, nullptr, nullptr, PPF_None);
+	});
+
+	if (!bCompiled)
+	{
+		const bool bSuccess = PropertyPathHelpers::GetPropertyValueAsString(InLocalPlayer, DynamicPath, OutStringValue);
+		ensure(bSuccess);
+	}
 
 	return OutStringValue;
 }
 
 void FGameSettingDataSourceDynamic::SetValue(ULocalPlayer* InLocalPlayer, const FString& InStringValue)
 {
-	const bool bSuccess = PropertyPathHelpers::SetPropertyValueFromString(InLocalPlayer, DynamicPath, InStringValue);
-	ensure(bSuccess);
+	bool bImported = true;
+	const bool bCompiled = VisitCompiledValue(InLocalPlayer, /*bWrite=*/ true, [&InStringValue, &bImported](FProperty* ValueProperty, void* ValuePtr)
+	{
+		bImported = (ValueProperty->ImportText_Direct(*InStringValue, ValuePtr, nullptr, PPF_None) != nullptr);
+	});
+
+	if (!bCompiled)
+	{
+		const bool bSuccess = PropertyPathHelpers::SetPropertyValueFromString(InLocalPlayer, DynamicPath, InStringValue);
+		ensure(bSuccess);
+	}
+	else
+	{
+		ensure(bImported);
+	}
+}
+
+bool FGameSettingDataSourceDynamic::GetValueAsDouble(ULocalPlayer* InLocalPlayer, double& OutValue) const
+{
+	bool bIsNumeric = false;
+	const bool bCompiled = VisitCompiledValue(InLocalPlayer, /*bWrite=*/ false, [&OutValue, &bIsNumeric](FProperty* ValueProperty, void* ValuePtr)
+	{
+		// Enums are left to the string path, which reads them by name
+		const FNumericProperty* NumericProperty = CastField<FNumericProperty>(ValueProperty);
+		if (NumericProperty && !NumericProperty->IsEnum())
+		{
+			OutValue = NumericProperty->IsFloatingPoint() ? NumericProperty->GetFloatingPointPropertyValue(ValuePtr) : static_cast<double>(NumericProperty->GetSignedIntPropertyValue(ValuePtr));
+			bIsNumeric = true;
+		}
+	});
+
+	return bCompiled && bIsNumeric;
+}
+
+bool FGameSettingDataSourceDynamic::SetValueFromDouble(ULocalPlayer* InLocalPlayer, double Value)
+{
+	// Check the type first, so a setter is never called with a value that wasn't written
+	bool bIsNumeric = false;
+	if (TryCompile(InLocalPlayer) && (CompiledSegments.Num() > 0))
+	{
+		const FNumericProperty* NumericProperty = CastField<FNumericProperty>(CompiledSegments.Last().Property);
+		bIsNumeric = NumericProperty && !NumericProperty->IsEnum();
+	}
+
+	if (!bIsNumeric)
+	{
+		return false;
+	}
+
+	return VisitCompiledValue(InLocalPlayer, /*bWrite=*/ true, [Value](FProperty* ValueProperty, void* ValuePtr)
+	{
+		const FNumericProperty* NumericProperty = CastFieldChecked<FNumericProperty>(ValueProperty);
+		if (NumericProperty->IsFloatingPoint())
+		{
+			NumericProperty->SetFloatingPointPropertyValue(ValuePtr, Value);
+		}
+		else
+		{
+			NumericProperty->SetIntPropertyValue(ValuePtr, static_cast<int64>(FMath::RoundHalfFromZero(Value)));
+		}
+	});
 }
 
 FString FGameSettingDataSourceDynamic::ToString() const
@@ -28,6 +28,14 @@ namespace GameSettingsConsoleVars
 		TEXT("  Note: Shipping builds always disable this"),
 		ECVF_Default);
 #endif
+
+	static bool bDeferEditConditions = true;
+	static FAutoConsoleVariableRef CVarGameSettingsDeferEditConditions(
+		TEXT("GameSettings.DeferEditConditions"),
+		bDeferEditConditions,
+		TEXT("Should settings wait to evaluate their edit conditions until their edit state is first needed?\n")
+		TEXT("  If false, every setting evaluates them as soon as it's initialized, even settings on pages that are never opened"),
+		ECVF_Default);
 }
 
 
@@ -99,7 +107,26 @@ void UGameSetting::Apply()
 void UGameSetting::OnInitialized()
 {
 	ensureMsgf(bReady, TEXT("OnInitialized called directly instead of via StartupComplete."));
-	EditableStateCache = ComputeEditableState();
+
+	if (GameSettingsConsoleVars::bDeferEditConditions)
+	{
+		bEditableStateDirty = true;
+	}
+	else
+	{
+		EditableStateCache = ComputeEditableState();
+	}
+}
+
+const FGameSettingEditableState& UGameSetting::GetEditState() const
+{
+	if (bEditableStateDirty)
+	{
+		bEditableStateDirty = false;
+		EditableStateCache = ComputeEditableState();
+	}
+
+	return EditableStateCache;
 }
 
 void UGameSetting::OnApply()
@@ -233,6 +260,7 @@ void UGameSetting::RefreshEditableState(bool bNotifyEditConditionsChanged)
 	{
 		TGuardValue<bool> Guard(bOnEditConditionsChangedEventGuard, true);
 	
+		bEditableStateDirty = false;
 		EditableStateCache = ComputeEditableState();
 
 		if (bNotifyEditConditionsChanged)
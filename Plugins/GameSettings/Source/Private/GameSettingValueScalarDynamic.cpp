@@ -161,9 +161,13 @@ void UGameSettingValueScalarDynamic::SetMaximumLimit(const TOptional<double>& In
 
 double UGameSettingValueScalarDynamic::GetValue() const
 {
-	const FString OutValue = Getter->GetValueAsString(LocalPlayer);
-
 	double Value;
+	if (Getter->GetValueAsDouble(LocalPlayer, Value))
+	{
+		return Value;
+	}
+
+	const FString OutValue = Getter->GetValueAsString(LocalPlayer);
 	LexFromString(Value, *OutValue);
 
 	return Value;
@@ -199,8 +203,11 @@ void UGameSettingValueScalarDynamic::SetValue(double InValue, EGameSettingChange
 		InValue = FMath::Min(Maximum.GetValue(), InValue);
 	}
 
-	const FString StringValue = LexToString(InValue);
-	Setter->SetValue(LocalPlayer, StringValue);
+	if (!Setter->SetValueFromDouble(LocalPlayer, InValue))
+	{
+		const FString StringValue = LexToString(InValue);
+		Setter->SetValue(LocalPlayer, StringValue);
+	}
 
 	NotifySettingChanged(Reason);
 }
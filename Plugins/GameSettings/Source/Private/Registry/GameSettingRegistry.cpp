@@ -4,12 +4,25 @@
 
 #include "GameSettingCollection.h"
 #include "GameSettingAction.h"
+#include "Algo/BinarySearch.h"
+#include "HAL/IConsoleManager.h"
 #include "UObject/WeakObjectPtr.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(GameSettingRegistry)
 
 #define LOCTEXT_NAMESPACE "GameSetting"
 
+namespace GameSettingsConsoleVars
+{
+	static bool bLazyRegistry = true;
+	static FAutoConsoleVariableRef CVarGameSettingsLazyRegistry(
+		TEXT("GameSettings.LazyRegistry"),
+		bLazyRegistry,
+		TEXT("Should registries build lazy top level settings the first time they're needed?\n")
+		TEXT("  If false, they're all built during Initialize"),
+		ECVF_Default);
+}
+
 //--------------------------------------
 // UGameSettingRegistry
 //--------------------------------------
@@ -33,7 +46,11 @@ void UGameSettingRegistry::Regenerate()
 		Setting->MarkAsGarbage();
 	}
 	RegisteredSettings.Reset();
+	RegisteredSettingsByDevName.Reset();
 	TopLevelSettings.Reset();
+	TopLevelSettingSlots.Reset();
+	PendingLazySettings.Reset();
+	NumTopLevelSlots = 0;
 
 	OnInitialize(OwningLocalPlayer);
 }
@@ -67,6 +84,8 @@ void UGameSettingRegistry::GetSettingsForFilter(const FGameSettingFilterState& F
 	}
 	else
 	{
+		// Filtering everything needs everything
+		BuildAllLazySettings();
 		RootSettings.Append(TopLevelSettings);
 	}
 
@@ -88,27 +107,88 @@ void UGameSettingRegistry::GetSettingsForFilter(const FGameSettingFilterState& F
 
 UGameSetting* UGameSettingRegistry::FindSettingByDevName(const FName& SettingDevName)
 {
-	for (UGameSetting* Setting : RegisteredSettings)
+	if (const TObjectPtr<UGameSetting>* Setting = RegisteredSettingsByDevName.Find(SettingDevName))
 	{
-		if (Setting->GetDevName() == SettingDevName)
-		{
-			return Setting;
-		}
+		return *Setting;
+	}
+
+	// Looking up a tab only builds that tab
+	const int32 PendingIndex = PendingLazySettings.IndexOfByPredicate([&SettingDevName](const FPendingLazySetting& Pending) { return Pending.DevName == SettingDevName; });
+	if (PendingIndex != INDEX_NONE)
+	{
+		BuildLazySetting(PendingIndex);
+	}
+	else if (PendingLazySettings.Num() > 0)
+	{
+		// We don't know which tab a nested setting lives in until it's built
+		BuildAllLazySettings();
+	}
+	else
+	{
+		return nullptr;
 	}
 
-	return nullptr;
+	const TObjectPtr<UGameSetting>* Setting = RegisteredSettingsByDevName.Find(SettingDevName);
+	return Setting ? Setting->Get() : nullptr;
 }
 
 void UGameSettingRegistry::RegisterSetting(UGameSetting* InSetting)
+{
+	RegisterSettingInSlot(InSetting, NumTopLevelSlots++);
+}
+
+void UGameSettingRegistry::RegisterSettingInSlot(UGameSetting* InSetting, int32 Slot)
 {
 	if (InSetting)
 	{
-		TopLevelSettings.Add(InSetting);
+		const int32 InsertIndex = Algo::LowerBound(TopLevelSettingSlots, Slot);
+		TopLevelSettings.Insert(InSetting, InsertIndex);
+		TopLevelSettingSlots.Insert(Slot, InsertIndex);
+
 		InSetting->SetRegistry(this);
 		RegisterInnerSettings(InSetting);
 	}
 }
 
+void UGameSettingRegistry::RegisterLazySetting(FName DevName, TFunction<UGameSetting*()> Factory)
+{
+	const int32 Slot = NumTopLevelSlots++;
+
+	if (!GameSettingsConsoleVars::bLazyRegistry)
+	{
+		RegisterSettingInSlot(Factory(), Slot);
+		return;
+	}
+
+	FPendingLazySetting& Pending = PendingLazySettings.AddDefaulted_GetRef();
+	Pending.DevName = DevName;
+	Pending.Slot = Slot;
+	Pending.Factory = MoveTemp(Factory);
+}
+
+void UGameSettingRegistry::BuildAllLazySettings()
+{
+	while (PendingLazySettings.Num() > 0)
+	{
+		BuildLazySetting(0);
+	}
+}
+
+void UGameSettingRegistry::BuildLazySetting(int32 PendingIndex)
+{
+	// Remove it first, the factory may look up other settings
+	FPendingLazySetting Pending = MoveTemp(PendingLazySettings[PendingIndex]);
+	PendingLazySettings.RemoveAt(PendingIndex);
+
+	UGameSetting* Setting = Pending.Factory();
+
+#if !UE_BUILD_SHIPPING
+	ensureAlwaysMsgf(!Setting || (Setting->GetDevName() == Pending.DevName), TEXT("Lazy setting %s was built with DevName %s!"), *Pending.DevName.ToString(), *Setting->GetDevName().ToString());
+#endif
+
+	RegisterSettingInSlot(Setting, Pending.Slot);
+}
+
 void UGameSettingRegistry::RegisterInnerSettings(UGameSetting* InSetting)
 {
 	InSetting->OnSettingChangedEvent.AddUObject(this, &ThisClass::HandleSettingChanged);
@@ -127,11 +207,16 @@ void UGameSettingRegistry::RegisterInnerSettings(UGameSetting* InSetting)
 	}
 
 #if !UE_BUILD_SHIPPING
-	ensureAlwaysMsgf(!RegisteredSettings.Contains(InSetting), TEXT("This setting has already been registered!"));
-	ensureAlwaysMsgf(nullptr == RegisteredSettings.FindByPredicate([&InSetting](UGameSetting* ExistingSetting) { return InSetting->GetDevName() == ExistingSetting->GetDevName(); }), TEXT("A setting with this DevName has already been registered!  DevNames must be unique within a registry."));
+	const TObjectPtr<UGameSetting>* ExistingSetting = RegisteredSettingsByDevName.Find(InSetting->GetDevName());
+	ensureAlwaysMsgf(!ExistingSetting || (*ExistingSetting != InSetting), TEXT("This setting has already been registered!"));
+	ensureAlwaysMsgf(!ExistingSetting || (*ExistingSetting == InSetting), TEXT("A setting with this DevName has already been registered!  DevNames must be unique within a registry."));
 #endif
 
 	RegisteredSettings.Add(InSetting);
+	if (!RegisteredSettingsByDevName.Contains(InSetting->GetDevName()))
+	{
+		RegisteredSettingsByDevName.Add(InSetting->GetDevName(), InSetting);
+	}
 
 	for (UGameSetting* ChildSetting : InSetting->GetChildSettings())
 	{
@@ -27,5 +27,12 @@ public:
 
 	virtual void SetValue(ULocalPlayer* InContext, const FString& Value) = 0;
 
+	/**
+	 * Numeric access that skips the string conversion, for sources that can provide it.  Returns false if the value
+	 * isn't numeric or the source doesn't support it, in which case the string functions should be used instead.
+	 */
+	virtual bool GetValueAsDouble(ULocalPlayer* InContext, double& OutValue) const { return false; }
+	virtual bool SetValueFromDouble(ULocalPlayer* InContext, double Value) { return false; }
+
 	virtual FString ToString() const = 0;
 };
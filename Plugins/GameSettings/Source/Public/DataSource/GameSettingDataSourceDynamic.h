@@ -4,13 +4,28 @@
 
 #include "GameSettingDataSource.h"
 #include "PropertyPathHelpers.h"
+#include "Templates/FunctionFwd.h"
+#include "UObject/WeakObjectPtr.h"
 
+class FProperty;
+class UClass;
+class UFunction;
 class ULocalPlayer;
+class UObject;
 
 //--------------------------------------
 // FGameSettingDataSourceDynamic
 //--------------------------------------
 
+/**
+ * Reads and writes a setting through a path of UFunctions and UProperties, starting at the local player.
+ *
+ * The first access compiles the path into the functions and properties it goes through, so later accesses call the
+ * getters and setters directly and convert only the final value, or don't convert it at all for numbers read through
+ * GetValueAsDouble.  Paths the compiled accessors don't support (array indices, struct members, functions with more
+ * than one parameter) and objects of a different class than the path was compiled for go through PropertyPathHelpers
+ * and string conversion as before.  GameSettings.CompiledDataSources=0 always uses PropertyPathHelpers.
+ */
 class GAMESETTINGS_API FGameSettingDataSourceDynamic : public FGameSettingDataSource
 {
 public:
@@ -22,8 +37,38 @@ public:
 
 	virtual void SetValue(ULocalPlayer* InLocalPlayer, const FString& Value) override;
 
+	virtual bool GetValueAsDouble(ULocalPlayer* InLocalPlayer, double& OutValue) const override;
+
+	virtual bool SetValueFromDouble(ULocalPlayer* InLocalPlayer, double Value) override;
+
 	virtual FString ToString() const override;
 
 private:
+	/** A function or property the path goes through, on objects of ContainerClass */
+	struct FCompiledSegment
+	{
+		TWeakObjectPtr<UClass> ContainerClass;
+		TWeakObjectPtr<UFunction> Function;
+
+		// The property itself, or the only parameter of the function
+		FProperty* Property = nullptr;
+	};
+
+	enum class ECompileState : uint8
+	{
+		NotCompiled,
+		Compiled,
+		Unsupported
+	};
+
+	bool TryCompile(ULocalPlayer* InLocalPlayer) const;
+
+	/** Calls Visitor with the final property and its value, while a getter's return value or a setter's parameter is alive */
+	bool VisitCompiledValue(ULocalPlayer* InLocalPlayer, bool bWrite, TFunctionRef<void(FProperty* ValueProperty, void* ValuePtr)> Visitor) const;
+
 	FCachedPropertyPath DynamicPath;
+
+	TArray<FName> SegmentNames;
+	mutable TArray<FCompiledSegment> CompiledSegments;
+	mutable ECompileState CompileState = ECompileState::NotCompiled;
 };
@@ -104,9 +104,9 @@ public:
 
 	/**
 	 * Gets the edit state of this property based on the current state of its edit conditions as well as any additional
-	 * filter state.
+	 * filter state.  The edit conditions are evaluated the first time this is called after the setting is initialized.
 	 */
-	const FGameSettingEditableState& GetEditState() const { return EditableStateCache; }
+	const FGameSettingEditableState& GetEditState() const;
 
 	/** Adds a new edit condition to this setting, allowing you to control the visibility and edit-ability of this setting. */
 	void AddEditCondition(const TSharedRef<FGameSettingEditCondition>& InEditCondition);
@@ -249,5 +249,8 @@ private:
 	bool bAdjustListViewPostRefresh = true;
 
 	/** We cache the editable state of a setting when it changes rather than reprocessing it any time it's needed.  */
-	FGameSettingEditableState EditableStateCache;
+	mutable FGameSettingEditableState EditableStateCache;
+
+	/** Set until the edit state is first needed, so settings that are never shown never evaluate their edit conditions. */
+	mutable bool bEditableStateDirty = false;
 };
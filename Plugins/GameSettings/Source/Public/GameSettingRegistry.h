@@ -19,7 +19,11 @@ struct FGameSettingFilterState;
 enum class EGameSettingChangeReason : uint8;
 
 /**
- * 
+ * Owns every setting shown by a settings screen, and indexes them by DevName.
+ *
+ * Top level settings registered with RegisterLazySetting are only built the first time they, or anything inside them,
+ * are looked up, so opening the screen on one tab doesn't build and initialize the settings on every other tab.
+ * GameSettings.LazyRegistry=0 builds them all during Initialize.
  */
 UCLASS(Abstract, BlueprintType)
 class GAMESETTINGS_API UGameSettingRegistry : public UObject
@@ -71,6 +75,18 @@ protected:
 	void RegisterSetting(UGameSetting* InSetting);
 	void RegisterInnerSettings(UGameSetting* InSetting);
 
+	/**
+	 * Registers a top level setting that Factory builds the first time it's needed.  DevName must match the DevName of
+	 * the setting Factory returns, and the setting keeps its place among the other top level settings.
+	 */
+	void RegisterLazySetting(FName DevName, TFunction<UGameSetting*()> Factory);
+
+	/** Builds and registers every lazy setting that hasn't been built yet. */
+	void BuildAllLazySettings();
+
+	/** Is any lazy setting still waiting to be built? */
+	bool HasPendingLazySettings() const { return PendingLazySettings.Num() > 0; }
+
 	// Internal event handlers.
 	void HandleSettingChanged(UGameSetting* Setting, EGameSettingChangeReason Reason);
 	void HandleSettingApplied(UGameSetting* Setting);
@@ -84,6 +100,28 @@ protected:
 	UPROPERTY(Transient)
 	TArray<TObjectPtr<UGameSetting>> RegisteredSettings;
 
+	/** The first registered setting with each DevName, so lookups don't scan RegisteredSettings. */
+	UPROPERTY(Transient)
+	TMap<FName, TObjectPtr<UGameSetting>> RegisteredSettingsByDevName;
+
 	UPROPERTY(Transient)
 	TObjectPtr<ULocalPlayer> OwningLocalPlayer;
+
+private:
+	struct FPendingLazySetting
+	{
+		FName DevName;
+		int32 Slot = INDEX_NONE;
+		TFunction<UGameSetting*()> Factory;
+	};
+
+	void RegisterSettingInSlot(UGameSetting* InSetting, int32 Slot);
+	void BuildLazySetting(int32 PendingIndex);
+
+	/** Lazy settings in registration order. */
+	TArray<FPendingLazySetting> PendingLazySettings;
+
+	/** The registration order of each entry in TopLevelSettings, so lazy settings are inserted where they were registered. */
+	TArray<int32> TopLevelSettingSlots;
+	int32 NumTopLevelSlots = 0;
 };
@@ -38,6 +38,8 @@ public class LyraExtTool : ModuleRules
 				"Engine",
 				"Slate",
 				"SlateCore",
+				"UnrealEd",
+				"AssetRegistry",
 				// ... add private dependencies that you statically link with here ...	
 			}
 			);
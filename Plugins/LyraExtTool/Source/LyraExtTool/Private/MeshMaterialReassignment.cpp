@@ -0,0 +1,103 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "MeshMaterialReassignment.h"
+
+#include "Engine/StaticMesh.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/ScopedSlowTask.h"
+#include "ScopedTransaction.h"
+#include "StaticMeshResources.h"
+#include "UObject/UObjectGlobals.h"
+
+#define LOCTEXT_NAMESPACE "LyraMeshMaterials"
+
+FLyraMeshMaterialReassignResult LyraMeshMaterials::ReassignStaticMeshMaterials(TConstArrayView<UStaticMesh*> Meshes, UMaterialInterface* Material, const FLyraMeshMaterialReassignOptions& Options)
+{
+	FLyraMeshMaterialReassignResult Result;
+	const double StartTime = FPlatformTime::Seconds();
+
+	// Find what actually changes first, so meshes that already match are never modified
+	TArray<UStaticMesh*> ChangedMeshes;
+	TSet<UStaticMesh*> SeenMeshes;
+	for (UStaticMesh* Mesh : Meshes)
+	{
+		bool bAlreadySeen = false;
+		SeenMeshes.Add(Mesh, &bAlreadySeen);
+		if (!Mesh || bAlreadySeen)
+		{
+			continue;
+		}
+
+		Result.NumMeshes++;
+
+		const bool bNeedsChange = Mesh->GetStaticMaterials().ContainsByPredicate([Material](const FStaticMaterial& StaticMaterial) { return StaticMaterial.MaterialInterface != Material; });
+		if (bNeedsChange)
+		{
+			ChangedMeshes.Add(Mesh);
+		}
+		else
+		{
+			Result.NumMeshesSkipped++;
+		}
+	}
+
+	Result.NumMeshesChanged = ChangedMeshes.Num();
+	if (ChangedMeshes.Num() == 0)
+	{
+		Result.Seconds = FPlatformTime::Seconds() - StartTime;
+		return Result;
+	}
+
+	FScopedSlowTask SlowTask(static_cast<float>(ChangedMeshes.Num() + 1), FText::Format(LOCTEXT("ReassignMaterials", "Reassigning materials on {0} meshes"), ChangedMeshes.Num()), Options.bShowProgress);
+	if (Options.bShowProgress)
+	{
+		SlowTask.MakeDialogDelayed(0.5f);
+	}
+
+	{
+		const FScopedTransaction Transaction(LOCTEXT("ReassignMaterialsTransaction", "Reassign Mesh Materials"), Options.bTransactional);
+
+		// Components using these meshes drop their render state here, and recreate it once when this goes out of scope
+		FStaticMeshComponentRecreateRenderStateContext RecreateRenderStateContext(ChangedMeshes, /*bUnbuildLighting=*/ false);
+
+		for (UStaticMesh* Mesh : ChangedMeshes)
+		{
+			SlowTask.EnterProgressFrame(1.0f, FText::Format(LOCTEXT("ReassignMaterialsMesh", "Reassigning materials on {0}"), FText::FromName(Mesh->GetFName())));
+
+			// Record the undo state without dirtying the package yet, every package is dirtied below
+			if (Options.bTransactional)
+			{
+				Mesh->Modify(/*bAlwaysMarkDirty=*/ false);
+			}
+
+			for (FStaticMaterial& StaticMaterial : Mesh->GetStaticMaterials())
+			{
+				if (StaticMaterial.MaterialInterface != Material)
+				{
+					StaticMaterial.MaterialInterface = Material;
+					Result.NumSlotsChanged++;
+				}
+			}
+
+			// The texture streaming data of each slot comes from its material, PostEditChange would update it too
+			Mesh->UpdateUVChannelData(/*bRebuildAll=*/ true);
+		}
+	}
+
+	SlowTask.EnterProgressFrame(1.0f, LOCTEXT("MarkPackagesDirty", "Marking packages dirty"));
+
+	// Let open editors know the materials changed, without the mesh rebuild PostEditChange would do
+	FProperty* StaticMaterialsProperty = FindFProperty<FProperty>(UStaticMesh::StaticClass(), UStaticMesh::GetStaticMaterialsMemberName());
+	for (UStaticMesh* Mesh : ChangedMeshes)
+	{
+		Mesh->MarkPackageDirty();
+
+		FPropertyChangedEvent PropertyChangedEvent(StaticMaterialsProperty, EPropertyChangeType::ValueSet);
+		FCoreUObjectDelegates::OnObjectPropertyChanged.Broadcast(Mesh, PropertyChangedEvent);
+	}
+
+	Result.Seconds = FPlatformTime::Seconds() - StartTime;
+	return Result;
+}
+
+#undef LOCTEXT_NAMESPACE
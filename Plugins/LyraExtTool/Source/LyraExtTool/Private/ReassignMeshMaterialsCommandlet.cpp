@@ -0,0 +1,217 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ReassignMeshMaterialsCommandlet.h"
+
+#include "AssetRegistry/ARFilter.h"
+#include "AssetRegistry/AssetData.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "Engine/StaticMesh.h"
+#include "FileHelpers.h"
+#include "HAL/PlatformTime.h"
+#include "Materials/MaterialInterface.h"
+#include "MeshMaterialReassignment.h"
+#include "UObject/Package.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(ReassignMeshMaterialsCommandlet)
+
+DEFINE_LOG_CATEGORY_STATIC(LogLyraMeshMaterials, Log, Log);
+
+namespace ReassignMeshMaterialsCommandlet
+{
+	static const TCHAR* DefaultSourceMesh = TEXT("/Engine/BasicShapes/Cube.Cube");
+	static const TCHAR* FirstBenchmarkMaterial = TEXT("/Engine/EngineMaterials/WorldGridMaterial.WorldGridMaterial");
+	static const TCHAR* SecondBenchmarkMaterial = TEXT("/Engine/EngineMaterials/DefaultMaterial.DefaultMaterial");
+
+	// What ChangeMeshMaterials used to do, rebuilding every mesh
+	static void ReassignWithPostEditChange(TConstArrayView<UStaticMesh*> Meshes, UMaterialInterface* Material)
+	{
+		for (UStaticMesh* Mesh : Meshes)
+		{
+			Mesh->Modify();
+			for (FStaticMaterial& StaticMaterial : Mesh->GetStaticMaterials())
+			{
+				StaticMaterial.MaterialInterface = Material;
+			}
+			Mesh->PostEditChange();
+		}
+	}
+
+	static bool AllSlotsUse(TConstArrayView<UStaticMesh*> Meshes, UMaterialInterface* Material)
+	{
+		for (UStaticMesh* Mesh : Meshes)
+		{
+			for (const FStaticMaterial& StaticMaterial : Mesh->GetStaticMaterials())
+			{
+				if (StaticMaterial.MaterialInterface != Material)
+				{
+					return false;
+				}
+			}
+		}
+		return true;
+	}
+}
+
+UReassignMeshMaterialsCommandlet::UReassignMeshMaterialsCommandlet(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+}
+
+int32 UReassignMeshMaterialsCommandlet::Main(const FString& FullCommandLine)
+{
+	using namespace ReassignMeshMaterialsCommandlet;
+
+	UE_LOG(LogLyraMeshMaterials, Display, TEXT("Running ReassignMeshMaterials commandlet..."));
+
+	TArray<FString> Tokens;
+	TArray<FString> Switches;
+	TMap<FString, FString> Params;
+	ParseCommandLine(*FullCommandLine, Tokens, Switches, Params);
+
+	if (const FString* BenchmarkString = Params.Find(TEXT("Benchmark")))
+	{
+		const FString* SourceMeshString = Params.Find(TEXT("SourceMesh"));
+		return RunBenchmark(FMath::Max(1, FCString::Atoi(**BenchmarkString)), (SourceMeshString && !SourceMeshString->IsEmpty()) ? *SourceMeshString : FString(DefaultSourceMesh));
+	}
+
+	const FString* MaterialString = Params.Find(TEXT("Material"));
+	UMaterialInterface* Material = MaterialString ? LoadObject<UMaterialInterface>(nullptr, **MaterialString) : nullptr;
+	if (!Material)
+	{
+		UE_LOG(LogLyraMeshMaterials, Error, TEXT("A valid -Material=/Path/To/Material.Material is required"));
+		return 1;
+	}
+
+	// Re-skinning every mesh in the project is never what was meant, so a path is required
+	const FString* InPathString = Params.Find(TEXT("InPath"));
+	if (!InPathString || InPathString->IsEmpty())
+	{
+		UE_LOG(LogLyraMeshMaterials, Error, TEXT("-InPath=/Game/Path+/Plugin/Path is required"));
+		return 1;
+	}
+
+	FAssetRegistryModule& AssetRegistryModule = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry");
+	IAssetRegistry& AssetRegistry = AssetRegistryModule.Get();
+	AssetRegistry.SearchAllAssets(true);
+
+	FARFilter Filter;
+	Filter.ClassPaths.Add(UStaticMesh::StaticClass()->GetClassPathName());
+	Filter.bRecursivePaths = true;
+	Filter.bIncludeOnlyOnDiskAssets = true;
+
+	TArray<FString> Paths;
+	InPathString->ParseIntoArray(Paths, TEXT("+"));
+	for (const FString& Path : Paths)
+	{
+		Filter.PackagePaths.Add(FName(*Path));
+	}
+
+	TArray<FAssetData> MeshAssets;
+	AssetRegistry.GetAssets(Filter, MeshAssets);
+	MeshAssets.Sort([](const FAssetData& A, const FAssetData& B) { return A.PackageName.LexicalLess(B.PackageName); });
+
+	UE_LOG(LogLyraMeshMaterials, Display, TEXT("Loading %d static meshes"), MeshAssets.Num());
+
+	const double LoadStartTime = FPlatformTime::Seconds();
+	TArray<UStaticMesh*> Meshes;
+	Meshes.Reserve(MeshAssets.Num());
+	for (const FAssetData& MeshAsset : MeshAssets)
+	{
+		if (UStaticMesh* Mesh = Cast<UStaticMesh>(MeshAsset.GetAsset()))
+		{
+			Meshes.Add(Mesh);
+		}
+		else
+		{
+			UE_LOG(LogLyraMeshMaterials, Warning, TEXT("Failed to load mesh asset %s"), *MeshAsset.GetObjectPathString());
+		}
+	}
+	const double LoadSeconds = FPlatformTime::Seconds() - LoadStartTime;
+
+	FLyraMeshMaterialReassignOptions Options;
+	Options.bTransactional = false;
+	const FLyraMeshMaterialReassignResult Result = LyraMeshMaterials::ReassignStaticMeshMaterials(Meshes, Material, Options);
+
+	UE_LOG(LogLyraMeshMaterials, Display, TEXT("Reassigned %d slots on %d of %d meshes to %s, %d already matched. Loading %.2fs, reassigning %.2fs"),
+		Result.NumSlotsChanged, Result.NumMeshesChanged, Result.NumMeshes, *Material->GetPathName(), Result.NumMeshesSkipped, LoadSeconds, Result.Seconds);
+
+	if (Switches.Contains(TEXT("NoSave")) || (Result.NumMeshesChanged == 0))
+	{
+		return 0;
+	}
+
+	TArray<UPackage*> PackagesToSave;
+	for (UStaticMesh* Mesh : Meshes)
+	{
+		if (Mesh->GetPackage()->IsDirty())
+		{
+			PackagesToSave.AddUnique(Mesh->GetPackage());
+		}
+	}
+
+	const double SaveStartTime = FPlatformTime::Seconds();
+	const bool bSaved = UEditorLoadingAndSavingUtils::SavePackages(PackagesToSave, /*bOnlyDirty=*/ true);
+	UE_LOG(LogLyraMeshMaterials, Display, TEXT("Saved %d packages in %.2fs"), PackagesToSave.Num(), FPlatformTime::Seconds() - SaveStartTime);
+
+	if (!bSaved)
+	{
+		UE_LOG(LogLyraMeshMaterials, Error, TEXT("Failed to save some of the changed meshes"));
+		return 1;
+	}
+
+	return 0;
+}
+
+int32 UReassignMeshMaterialsCommandlet::RunBenchmark(int32 NumMeshes, const FString& SourceMeshPath)
+{
+	using namespace ReassignMeshMaterialsCommandlet;
+
+	UStaticMesh* SourceMesh = LoadObject<UStaticMesh>(nullptr, *SourceMeshPath);
+	UMaterialInterface* FirstMaterial = LoadObject<UMaterialInterface>(nullptr, FirstBenchmarkMaterial);
+	UMaterialInterface* SecondMaterial = LoadObject<UMaterialInterface>(nullptr, SecondBenchmarkMaterial);
+	if (!SourceMesh || !FirstMaterial || !SecondMaterial)
+	{
+		UE_LOG(LogLyraMeshMaterials, Error, TEXT("Failed to load the benchmark mesh %s or materials"), *SourceMeshPath);
+		return 1;
+	}
+
+	UE_LOG(LogLyraMeshMaterials, Display, TEXT("Copying %s %d times"), *SourceMeshPath, NumMeshes);
+
+	TArray<UStaticMesh*> Meshes;
+	Meshes.Reserve(NumMeshes);
+	for (int32 MeshIndex = 0; MeshIndex < NumMeshes; ++MeshIndex)
+	{
+		UStaticMesh* Mesh = DuplicateObject<UStaticMesh>(SourceMesh, GetTransientPackage(), MakeUniqueObjectName(GetTransientPackage(), UStaticMesh::StaticClass(), TEXT("ReassignMeshMaterialsBenchmark")));
+		Mesh->AddToRoot();
+		Meshes.Add(Mesh);
+	}
+
+	const double PostEditChangeStartTime = FPlatformTime::Seconds();
+	ReassignWithPostEditChange(Meshes, FirstMaterial);
+	const double PostEditChangeSeconds = FPlatformTime::Seconds() - PostEditChangeStartTime;
+
+	FLyraMeshMaterialReassignOptions Options;
+	Options.bTransactional = false;
+	Options.bShowProgress = false;
+
+	const FLyraMeshMaterialReassignResult BatchResult = LyraMeshMaterials::ReassignStaticMeshMaterials(Meshes, SecondMaterial, Options);
+	const FLyraMeshMaterialReassignResult UnchangedResult = LyraMeshMaterials::ReassignStaticMeshMaterials(Meshes, SecondMaterial, Options);
+
+	const bool bAllReassigned = AllSlotsUse(Meshes, SecondMaterial) && (BatchResult.NumMeshesChanged == NumMeshes) && (UnchangedResult.NumMeshesSkipped == NumMeshes);
+
+	UE_LOG(LogLyraMeshMaterials, Display, TEXT("Reassigning materials on %d meshes: Modify and PostEditChange per mesh %.3fs, batched %.3fs (%d slots), batched with every mesh already matching %.3fs"),
+		NumMeshes, PostEditChangeSeconds, BatchResult.Seconds, BatchResult.NumSlotsChanged, UnchangedResult.Seconds);
+
+	for (UStaticMesh* Mesh : Meshes)
+	{
+		Mesh->RemoveFromRoot();
+	}
+
+	if (!bAllReassigned)
+	{
+		UE_LOG(LogLyraMeshMaterials, Error, TEXT("The batched reassignment left some slots unchanged"));
+		return 1;
+	}
+
+	return 0;
+}
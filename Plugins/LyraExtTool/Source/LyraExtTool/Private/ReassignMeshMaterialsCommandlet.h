@@ -0,0 +1,31 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Commandlets/Commandlet.h"
+
+#include "ReassignMeshMaterialsCommandlet.generated.h"
+
+/**
+ * Assigns a material to every material slot of the static meshes under the given paths, like ChangeMeshMaterials does
+ * for the meshes picked in EUW_MaterialTool, and saves the meshes that changed.
+ *
+ * With -Benchmark=N, nothing is loaded or saved. N copies of SourceMesh are made in the transient package instead, and
+ * the time to reassign their materials with a Modify and PostEditChange per mesh is compared with the batched reassignment.
+ *
+ * Usage: -run=ReassignMeshMaterials -Material=/Game/Path/M_Material.M_Material -InPath=/Game/Path+/Plugin/Path [-NoSave]
+ *        -run=ReassignMeshMaterials -Benchmark=1000 [-SourceMesh=/Engine/BasicShapes/Cube.Cube]
+ */
+UCLASS()
+class UReassignMeshMaterialsCommandlet : public UCommandlet
+{
+	GENERATED_UCLASS_BODY()
+
+public:
+	// Begin UCommandlet Interface
+	virtual int32 Main(const FString& Params) override;
+	// End UCommandlet Interface
+
+private:
+	int32 RunBenchmark(int32 NumMeshes, const FString& SourceMeshPath);
+};
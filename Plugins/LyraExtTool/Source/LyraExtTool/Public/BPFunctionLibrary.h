@@ -20,6 +20,7 @@ class UBPFunctionLibrary : public UBlueprintFunctionLibrary
 {
     GENERATED_BODY()
 
+    /** Assigns Material to every material slot of every mesh, skipping meshes that already use it. See LyraMeshMaterials::ReassignStaticMeshMaterials. */
     UFUNCTION(BlueprintCallable, Category="LyraExt")
     static bool ChangeMeshMaterials(TArray<UStaticMesh*> Mesh, UMaterialInterface* Material);
 };
@@ -0,0 +1,39 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Containers/ArrayView.h"
+
+class UMaterialInterface;
+class UStaticMesh;
+
+struct FLyraMeshMaterialReassignOptions
+{
+	/** Record the change in the undo buffer */
+	bool bTransactional = true;
+
+	/** Show a progress dialog in the editor, or progress in the log of a commandlet */
+	bool bShowProgress = true;
+};
+
+struct FLyraMeshMaterialReassignResult
+{
+	int32 NumMeshes = 0;
+	int32 NumMeshesChanged = 0;
+	int32 NumMeshesSkipped = 0;
+	int32 NumSlotsChanged = 0;
+	double Seconds = 0.0;
+};
+
+namespace LyraMeshMaterials
+{
+	/**
+	 * Assigns Material to every material slot of every mesh.
+	 *
+	 * Meshes whose slots already use Material are left untouched. Changing a slot's material doesn't change the mesh's
+	 * geometry, so the meshes aren't rebuilt like PostEditChange would, only their texture streaming UV data is updated for
+	 * the new material. Components using the changed meshes recreate their render state once for the whole batch, and the
+	 * packages are marked dirty together once every slot is assigned.
+	 */
+	LYRAEXTTOOL_API FLyraMeshMaterialReassignResult ReassignStaticMeshMaterials(TConstArrayView<UStaticMesh*> Meshes, UMaterialInterface* Material, const FLyraMeshMaterialReassignOptions& Options = FLyraMeshMaterialReassignOptions());
+}
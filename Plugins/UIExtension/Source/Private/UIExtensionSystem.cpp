@@ -45,19 +45,35 @@ bool FUIExtensionPoint::DoesExtensionPassContract(const FUIExtension* Extension)
 		{
 			// The data can either be the literal class of the data type, or a instance of the class type.
 			const UClass* DataClass = DataPtr->IsA(UClass::StaticClass()) ? Cast<UClass>(DataPtr) : DataPtr->GetClass();
-			for (const UClass* AllowedDataClass : AllowedDataClasses)
-			{
-				if (DataClass->IsChildOf(AllowedDataClass) || DataClass->ImplementsInterface(AllowedDataClass))
-				{
-					return true;
-				}
-			}
+			return DoesDataClassPassContract(DataClass);
 		}
 	}
 
 	return false;
 }
 
+bool FUIExtensionPoint::DoesDataClassPassContract(const UClass* DataClass) const
+{
+	const TObjectKey<UClass> DataClassKey(DataClass);
+	if (const bool* bCachedResult = DataClassContractResults.Find(DataClassKey))
+	{
+		return *bCachedResult;
+	}
+
+	bool bPassesContract = false;
+	for (const UClass* AllowedDataClass : AllowedDataClasses)
+	{
+		if (DataClass->IsChildOf(AllowedDataClass) || DataClass->ImplementsInterface(AllowedDataClass))
+		{
+			bPassesContract = true;
+			break;
+		}
+	}
+
+	DataClassContractResults.Add(DataClassKey, bPassesContract);
+	return bPassesContract;
+}
+
 //=========================================================
 
 void UUIExtensionSubsystem::AddReferencedObjects(UObject* InThis, FReferenceCollector& Collector)
@@ -68,7 +84,7 @@ void UUIExtensionSubsystem::AddReferencedObjects(UObject* InThis, FReferenceColl
 	{
 		for (auto MapIt = ExtensionSubsystem->ExtensionPointMap.CreateIterator(); MapIt; ++MapIt)
 		{
-			for (const TSharedPtr<FUIExtensionPoint>& ValueElement : MapIt.Value())
+			for (const TSharedPtr<FUIExtensionPoint>& ValueElement : MapIt.Value().Points)
 			{
 				Collector.AddReferencedObjects(ValueElement->AllowedDataClasses);
 			}
@@ -91,6 +107,8 @@ void UUIExtensionSubsystem::Initialize(FSubsystemCollectionBase& Collection)
 
 void UUIExtensionSubsystem::Deinitialize()
 {
+	TagChains.Reset();
+
 	Super::Deinitialize();
 }
 
@@ -119,9 +137,14 @@ FUIExtensionPointHandle UUIExtensionSubsystem::RegisterExtensionPointForContext(
 		return FUIExtensionPointHandle();
 	}
 
-	FExtensionPointList& List = ExtensionPointMap.FindOrAdd(ExtensionPointTag);
+	FExtensionPointBucket& Bucket = ExtensionPointMap.FindOrAdd(FExtensionBucketKey(ExtensionPointTag, ContextObject));
+
+	TSharedPtr<FUIExtensionPoint>& Entry = Bucket.Points.Add_GetRef(MakeShared<FUIExtensionPoint>());
+	if (ExtensionPointTagMatchType == EUIExtensionPointMatch::PartialMatch)
+	{
+		Bucket.PartialMatchPoints.Add(Entry);
+	}
 
-	TSharedPtr<FUIExtensionPoint>& Entry = List.Add_GetRef(MakeShared<FUIExtensionPoint>());
 	Entry->ExtensionPointTag = ExtensionPointTag;
 	Entry->ContextObject = ContextObject;
 	Entry->ExtensionPointTagMatchType = ExtensionPointTagMatchType;
@@ -159,7 +182,7 @@ FUIExtensionHandle UUIExtensionSubsystem::RegisterExtensionAsData(const FGamepla
 		return FUIExtensionHandle();
 	}
 
-	FExtensionList& List = ExtensionMap.FindOrAdd(ExtensionPointTag);
+	FExtensionList& List = ExtensionMap.FindOrAdd(FExtensionBucketKey(ExtensionPointTag, ContextObject));
 
 	TSharedPtr<FUIExtension>& Entry = List.Add_GetRef(MakeShared<FUIExtension>());
 	Entry->ExtensionPointTag = ExtensionPointTag;
@@ -181,11 +204,30 @@ FUIExtensionHandle UUIExtensionSubsystem::RegisterExtensionAsData(const FGamepla
 	return FUIExtensionHandle(this, Entry);
 }
 
+const UUIExtensionSubsystem::FTagChain& UUIExtensionSubsystem::GetTagChain(const FGameplayTag& Tag)
+{
+	if (const FTagChain* ExistingChain = TagChains.Find(Tag))
+	{
+		return *ExistingChain;
+	}
+
+	FTagChain NewChain;
+	for (FGameplayTag ParentTag = Tag; ParentTag.IsValid(); ParentTag = ParentTag.RequestDirectParent())
+	{
+		NewChain.Add(ParentTag);
+	}
+
+	return TagChains.Add(Tag, MoveTemp(NewChain));
+}
+
 void UUIExtensionSubsystem::NotifyExtensionPointOfExtensions(TSharedPtr<FUIExtensionPoint>& ExtensionPoint)
 {
-	for (FGameplayTag Tag = ExtensionPoint->ExtensionPointTag; Tag.IsValid(); Tag = Tag.RequestDirectParent())
+	// Copied since callbacks can register new tags
+	const FTagChain TagChain = GetTagChain(ExtensionPoint->ExtensionPointTag);
+
+	for (const FGameplayTag& Tag : TagChain)
 	{
-		if (const FExtensionList* ListPtr = ExtensionMap.Find(Tag))
+		if (const FExtensionList* ListPtr = ExtensionMap.Find(FExtensionBucketKey(Tag, ExtensionPoint->ContextObject)))
 		{
 			// Copy in case there are removals while handling callbacks
 			FExtensionList ExtensionArray(*ListPtr);
@@ -209,28 +251,25 @@ void UUIExtensionSubsystem::NotifyExtensionPointOfExtensions(TSharedPtr<FUIExten
 
 void UUIExtensionSubsystem::NotifyExtensionPointsOfExtension(EUIExtensionAction Action, TSharedPtr<FUIExtension>& Extension)
 {
-	bool bOnInitialTag = true;
-	for (FGameplayTag Tag = Extension->ExtensionPointTag; Tag.IsValid(); Tag = Tag.RequestDirectParent())
+	// Copied since callbacks can register new tags
+	const FTagChain TagChain = GetTagChain(Extension->ExtensionPointTag);
+
+	for (int32 TagIndex = 0; TagIndex < TagChain.Num(); ++TagIndex)
 	{
-		if (const FExtensionPointList* ListPtr = ExtensionPointMap.Find(Tag))
+		if (const FExtensionPointBucket* Bucket = ExtensionPointMap.Find(FExtensionBucketKey(TagChain[TagIndex], Extension->ContextObject)))
 		{
-			// Copy in case there are removals while handling callbacks
-			FExtensionPointList ExtensionPointArray(*ListPtr);
+			// Copy in case there are removals while handling callbacks, points registered on a parent tag only match partially
+			FExtensionPointList ExtensionPointArray((TagIndex == 0) ? Bucket->Points : Bucket->PartialMatchPoints);
 
 			for (const TSharedPtr<FUIExtensionPoint>& ExtensionPoint : ExtensionPointArray)
 			{
-				if (bOnInitialTag || (ExtensionPoint->ExtensionPointTagMatchType == EUIExtensionPointMatch::PartialMatch))
+				if (ExtensionPoint->DoesExtensionPassContract(Extension.Get()))
 				{
-					if (ExtensionPoint->DoesExtensionPassContract(Extension.Get()))
-					{
-						FUIExtensionRequest Request = CreateExtensionRequest(Extension);
-						ExtensionPoint->Callback.ExecuteIfBound(Action, Request);
-					}
+					FUIExtensionRequest Request = CreateExtensionRequest(Extension);
+					ExtensionPoint->Callback.ExecuteIfBound(Action, Request);
 				}
 			}
 		}
-		
-		bOnInitialTag = false;
 	}
 }
 
@@ -241,7 +280,8 @@ void UUIExtensionSubsystem::UnregisterExtension(const FUIExtensionHandle& Extens
 		checkf(ExtensionHandle.ExtensionSource == this, TEXT("Trying to unregister an extension that's not from this extension subsystem."));
 
 		TSharedPtr<FUIExtension> Extension = ExtensionHandle.DataPtr;
-		if (FExtensionList* ListPtr = ExtensionMap.Find(Extension->ExtensionPointTag))
+		const FExtensionBucketKey BucketKey(Extension->ExtensionPointTag, Extension->ContextObject);
+		if (FExtensionList* ListPtr = ExtensionMap.Find(BucketKey))
 		{
 			if (Extension->ContextObject.IsExplicitlyNull())
 			{
@@ -254,11 +294,16 @@ void UUIExtensionSubsystem::UnregisterExtension(const FUIExtensionHandle& Extens
 
 			NotifyExtensionPointsOfExtension(EUIExtensionAction::Removed, Extension);
 
-			ListPtr->RemoveSwap(Extension);
-			
-			if (ListPtr->Num() == 0)
+			// The callbacks may have changed the map
+			ListPtr = ExtensionMap.Find(BucketKey);
+			if (ListPtr)
 			{
-				ExtensionMap.Remove(Extension->ExtensionPointTag);
+				ListPtr->RemoveSwap(Extension);
+
+				if (ListPtr->Num() == 0)
+				{
+					ExtensionMap.Remove(BucketKey);
+				}
 			}
 		}
 	}
@@ -275,14 +320,16 @@ void UUIExtensionSubsystem::UnregisterExtensionPoint(const FUIExtensionPointHand
 		check(ExtensionPointHandle.ExtensionSource == this);
 
 		const TSharedPtr<FUIExtensionPoint> ExtensionPoint = ExtensionPointHandle.DataPtr;
-		if (FExtensionPointList* ListPtr = ExtensionPointMap.Find(ExtensionPoint->ExtensionPointTag))
+		const FExtensionBucketKey BucketKey(ExtensionPoint->ExtensionPointTag, ExtensionPoint->ContextObject);
+		if (FExtensionPointBucket* Bucket = ExtensionPointMap.Find(BucketKey))
 		{
 			UE_LOG(LogUIExtension, Verbose, TEXT("Extension Point [%s] Unregistered"), *ExtensionPoint->ExtensionPointTag.ToString());
 
-			ListPtr->RemoveSwap(ExtensionPoint);
-			if (ListPtr->Num() == 0)
+			Bucket->Points.RemoveSwap(ExtensionPoint);
+			Bucket->PartialMatchPoints.RemoveSwap(ExtensionPoint);
+			if (Bucket->Points.Num() == 0)
 			{
-				ExtensionPointMap.Remove(ExtensionPoint->ExtensionPointTag);
+				ExtensionPointMap.Remove(BucketKey);
 			}
 		}
 	}
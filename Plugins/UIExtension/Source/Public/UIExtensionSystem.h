@@ -5,6 +5,7 @@
 #include "GameplayTagContainer.h"
 #include "Kismet/BlueprintFunctionLibrary.h"
 #include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
 
 #include "UIExtensionSystem.generated.h"
 
@@ -68,6 +69,12 @@ public:
 	// Tests if the extension and the extension point match up, if they do then this extension point should learn
 	// about this extension.
 	bool DoesExtensionPassContract(const FUIExtension* Extension) const;
+
+private:
+	// Tests the data class against AllowedDataClasses, remembering the result for the next extension with the same class
+	bool DoesDataClassPassContract(const UClass* DataClass) const;
+
+	mutable TMap<TObjectKey<UClass>, bool> DataClassContractResults;
 };
 
 /**
@@ -242,11 +249,43 @@ protected:
 	FUIExtensionRequest CreateExtensionRequest(const TSharedPtr<FUIExtension>& Extension);
 
 private:
+	// Extension points and extensions are kept per tag and context object, so matching only looks at entries that can match
+	struct FExtensionBucketKey
+	{
+		FExtensionBucketKey(const FGameplayTag& InTag, const TWeakObjectPtr<UObject>& InContextObject) : Tag(InTag), ContextObject(InContextObject) {}
+
+		bool operator==(const FExtensionBucketKey& Other) const { return (Tag == Other.Tag) && ContextObject.HasSameIndexAndSerialNumber(Other.ContextObject); }
+
+		friend uint32 GetTypeHash(const FExtensionBucketKey& Key)
+		{
+			return HashCombine(GetTypeHash(Key.Tag), GetTypeHash(Key.ContextObject));
+		}
+
+		FGameplayTag Tag;
+		TWeakObjectPtr<UObject> ContextObject;
+	};
+
 	typedef TArray<TSharedPtr<FUIExtensionPoint>> FExtensionPointList;
-	TMap<FGameplayTag, FExtensionPointList> ExtensionPointMap;
+
+	struct FExtensionPointBucket
+	{
+		// Every point in registration order, notified for extensions on this exact tag
+		FExtensionPointList Points;
+
+		// The partial match points again, notified for extensions on child tags
+		FExtensionPointList PartialMatchPoints;
+	};
+
+	TMap<FExtensionBucketKey, FExtensionPointBucket> ExtensionPointMap;
 
 	typedef TArray<TSharedPtr<FUIExtension>> FExtensionList;
-	TMap<FGameplayTag, FExtensionList> ExtensionMap;
+	TMap<FExtensionBucketKey, FExtensionList> ExtensionMap;
+
+	// A tag followed by its parents up to the root, in the order matching walks them
+	typedef TArray<FGameplayTag, TInlineAllocator<8>> FTagChain;
+	const FTagChain& GetTagChain(const FGameplayTag& Tag);
+
+	TMap<FGameplayTag, FTagChain> TagChains;
 };
 
 
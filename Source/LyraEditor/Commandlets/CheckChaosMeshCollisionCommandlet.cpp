@@ -0,0 +1,246 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "CheckChaosMeshCollisionCommandlet.h"
+
+#include "AssetRegistry/ARFilter.h"
+#include "AssetRegistry/AssetData.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "Async/ParallelFor.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/StreamableManager.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "PhysicsEngine/BodySetup.h"
+#include "Utilities/CheckChaosMeshCollision.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(CheckChaosMeshCollisionCommandlet)
+
+DEFINE_LOG_CATEGORY_STATIC(LogLyraMeshCollision, Log, Log);
+
+namespace CheckChaosMeshCollisionCommandlet
+{
+	// Large meshes are split so a single mesh doesn't hold up the whole batch
+	static constexpr int32 TrianglesPerWorkItem = 16 * 1024;
+
+	struct FMeshResult
+	{
+		FSoftObjectPath MeshPath;
+		int32 BatchIndex = 0;
+		bool bLoaded = false;
+		int32 NumTriMeshes = 0;
+		int32 NumTriangles = 0;
+		int32 NumDegenerateTriangles = 0;
+		double CheckSeconds = 0.0;
+	};
+
+	struct FWorkItem
+	{
+		int32 MeshIndex = 0;
+		const Chaos::FTriangleMeshImplicitObject* TriMesh = nullptr;
+		int32 FirstTriangle = 0;
+		int32 NumTriangles = 0;
+		int32 NumDegenerateTriangles = 0;
+		double Seconds = 0.0;
+	};
+}
+
+UCheckChaosMeshCollisionCommandlet::UCheckChaosMeshCollisionCommandlet(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+}
+
+int32 UCheckChaosMeshCollisionCommandlet::Main(const FString& FullCommandLine)
+{
+	using namespace CheckChaosMeshCollisionCommandlet;
+
+	UE_LOG(LogLyraMeshCollision, Display, TEXT("Running CheckChaosMeshCollision commandlet..."));
+
+	const double StartTime = FPlatformTime::Seconds();
+
+	TArray<FString> Tokens;
+	TArray<FString> Switches;
+	TMap<FString, FString> Params;
+	ParseCommandLine(*FullCommandLine, Tokens, Switches, Params);
+
+	FAssetRegistryModule& AssetRegistryModule = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry");
+	IAssetRegistry& AssetRegistry = AssetRegistryModule.Get();
+	AssetRegistry.SearchAllAssets(true);
+
+	FARFilter Filter;
+	Filter.ClassPaths.Add(UStaticMesh::StaticClass()->GetClassPathName());
+	Filter.bRecursivePaths = true;
+	Filter.bIncludeOnlyOnDiskAssets = true;
+
+	FString* InPathString = Params.Find(TEXT("InPath"));
+	if (InPathString && !InPathString->IsEmpty())
+	{
+		TArray<FString> Paths;
+		InPathString->ParseIntoArray(Paths, TEXT("+"));
+		for (const FString& Path : Paths)
+		{
+			Filter.PackagePaths.Add(FName(*Path));
+		}
+	}
+
+	TArray<FAssetData> MeshAssets;
+	AssetRegistry.GetAssets(Filter, MeshAssets);
+	MeshAssets.Sort([](const FAssetData& A, const FAssetData& B) { return A.PackageName.LexicalLess(B.PackageName); });
+
+	int32 BatchSize = 64;
+	if (FString* BatchSizeString = Params.Find(TEXT("BatchSize")))
+	{
+		BatchSize = FMath::Max(1, FCString::Atoi(**BatchSizeString));
+	}
+
+	FString* ReportString = Params.Find(TEXT("Report"));
+	const FString ReportFilename = (ReportString && !ReportString->IsEmpty()) ? *ReportString : FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("ChaosMeshCollision"), TEXT("ChaosMeshCollision.csv"));
+
+	const int32 NumBatches = FMath::DivideAndRoundUp(MeshAssets.Num(), BatchSize);
+	UE_LOG(LogLyraMeshCollision, Display, TEXT("Checking %d static meshes in %d batches of %d"), MeshAssets.Num(), NumBatches, BatchSize);
+
+	TArray<FMeshResult> Results;
+	Results.SetNum(MeshAssets.Num());
+	for (int32 MeshIndex = 0; MeshIndex < MeshAssets.Num(); ++MeshIndex)
+	{
+		Results[MeshIndex].MeshPath = MeshAssets[MeshIndex].GetSoftObjectPath();
+		Results[MeshIndex].BatchIndex = MeshIndex / BatchSize;
+	}
+
+	FStreamableManager StreamableManager;
+	auto RequestBatch = [&StreamableManager, &Results, BatchSize](int32 BatchIndex)
+	{
+		TArray<FSoftObjectPath> BatchPaths;
+		for (int32 MeshIndex = BatchIndex * BatchSize; MeshIndex < FMath::Min((BatchIndex + 1) * BatchSize, Results.Num()); ++MeshIndex)
+		{
+			BatchPaths.Add(Results[MeshIndex].MeshPath);
+		}
+		return StreamableManager.RequestAsyncLoad(BatchPaths, FStreamableDelegate(), FStreamableManager::AsyncLoadHighPriority, false, false, TEXT("CheckChaosMeshCollision"));
+	};
+
+	double LoadSeconds = 0.0;
+	double CreatePhysicsMeshesSeconds = 0.0;
+	double CheckSeconds = 0.0;
+	double CheckWorkSeconds = 0.0;
+
+	TSharedPtr<FStreamableHandle> NextBatchHandle = (NumBatches > 0) ? RequestBatch(0) : nullptr;
+	for (int32 BatchIndex = 0; BatchIndex < NumBatches; ++BatchIndex)
+	{
+		const double LoadStartTime = FPlatformTime::Seconds();
+		TSharedPtr<FStreamableHandle> BatchHandle = NextBatchHandle;
+		if (BatchHandle.IsValid())
+		{
+			BatchHandle->WaitUntilComplete();
+		}
+		LoadSeconds += FPlatformTime::Seconds() - LoadStartTime;
+
+		// Request the next batch before checking this one, so the async loading thread can stream it in meanwhile
+		NextBatchHandle = (BatchIndex + 1 < NumBatches) ? RequestBatch(BatchIndex + 1) : nullptr;
+
+		// Building the collision data may go to the DDC and isn't thread safe, the triangle checks are
+		const double CreateStartTime = FPlatformTime::Seconds();
+		TArray<FWorkItem> WorkItems;
+		for (int32 MeshIndex = BatchIndex * BatchSize; MeshIndex < FMath::Min((BatchIndex + 1) * BatchSize, Results.Num()); ++MeshIndex)
+		{
+			FMeshResult& Result = Results[MeshIndex];
+
+			UStaticMesh* MeshAsset = Cast<UStaticMesh>(Result.MeshPath.ResolveObject());
+			Result.bLoaded = (MeshAsset != nullptr);
+			if (!MeshAsset)
+			{
+				UE_LOG(LogLyraMeshCollision, Warning, TEXT("Failed to load mesh asset %s"), *Result.MeshPath.ToString());
+				continue;
+			}
+
+			if (UBodySetup* BodySetup = MeshAsset->GetBodySetup())
+			{
+				BodySetup->CreatePhysicsMeshes();
+
+				for (const Chaos::FTriangleMeshImplicitObjectPtr& TriMesh : BodySetup->TriMeshGeometries)
+				{
+					if (const Chaos::FTriangleMeshImplicitObject* TriMeshData = TriMesh.GetReference())
+					{
+						const int32 NumTriangles = TriMeshData->Elements().GetNumTriangles();
+						Result.NumTriMeshes++;
+						Result.NumTriangles += NumTriangles;
+
+						for (int32 FirstTriangle = 0; FirstTriangle < NumTriangles; FirstTriangle += TrianglesPerWorkItem)
+						{
+							FWorkItem& WorkItem = WorkItems.AddDefaulted_GetRef();
+							WorkItem.MeshIndex = MeshIndex;
+							WorkItem.TriMesh = TriMeshData;
+							WorkItem.FirstTriangle = FirstTriangle;
+							WorkItem.NumTriangles = FMath::Min(TrianglesPerWorkItem, NumTriangles - FirstTriangle);
+						}
+					}
+				}
+			}
+		}
+		CreatePhysicsMeshesSeconds += FPlatformTime::Seconds() - CreateStartTime;
+
+		const double CheckStartTime = FPlatformTime::Seconds();
+		ParallelFor(WorkItems.Num(), [&WorkItems](int32 WorkItemIndex)
+		{
+			FWorkItem& WorkItem = WorkItems[WorkItemIndex];
+			const double WorkStartTime = FPlatformTime::Seconds();
+			WorkItem.NumDegenerateTriangles = LyraEditorUtilities::CountDegenerateTriangles(WorkItem.TriMesh->Particles(), WorkItem.TriMesh->Elements(), WorkItem.FirstTriangle, WorkItem.NumTriangles);
+			WorkItem.Seconds = FPlatformTime::Seconds() - WorkStartTime;
+		});
+		CheckSeconds += FPlatformTime::Seconds() - CheckStartTime;
+
+		for (const FWorkItem& WorkItem : WorkItems)
+		{
+			FMeshResult& Result = Results[WorkItem.MeshIndex];
+			Result.NumDegenerateTriangles += WorkItem.NumDegenerateTriangles;
+			Result.CheckSeconds += WorkItem.Seconds;
+			CheckWorkSeconds += WorkItem.Seconds;
+		}
+
+		for (int32 MeshIndex = BatchIndex * BatchSize; MeshIndex < FMath::Min((BatchIndex + 1) * BatchSize, Results.Num()); ++MeshIndex)
+		{
+			if (Results[MeshIndex].NumDegenerateTriangles > 0)
+			{
+				UE_LOG(LogLyraMeshCollision, Warning, TEXT("Mesh asset %s has %d degenerate triangles in collision data"), *Results[MeshIndex].MeshPath.ToString(), Results[MeshIndex].NumDegenerateTriangles);
+			}
+		}
+
+		// Let this batch go before the next one loads, the next batch's handle keeps it alive
+		WorkItems.Reset();
+		if (BatchHandle.IsValid())
+		{
+			BatchHandle->ReleaseHandle();
+		}
+		CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+
+		UE_LOG(LogLyraMeshCollision, Display, TEXT("Checked batch %d/%d"), BatchIndex + 1, NumBatches);
+	}
+
+	TArray<FString> ReportLines;
+	ReportLines.Reserve(Results.Num() + 1);
+	ReportLines.Add(TEXT("Mesh,Batch,Loaded,TriMeshes,Triangles,DegenerateTriangles,CheckMs"));
+
+	int32 NumTriangles = 0;
+	int32 NumMeshesWithProblems = 0;
+	for (const FMeshResult& Result : Results)
+	{
+		ReportLines.Add(FString::Printf(TEXT("%s,%d,%d,%d,%d,%d,%.3f"), *Result.MeshPath.ToString(), Result.BatchIndex, Result.bLoaded ? 1 : 0, Result.NumTriMeshes, Result.NumTriangles, Result.NumDegenerateTriangles, Result.CheckSeconds * 1000.0));
+		NumTriangles += Result.NumTriangles;
+		NumMeshesWithProblems += (Result.NumDegenerateTriangles > 0) ? 1 : 0;
+	}
+
+	int32 ReturnVal = (NumMeshesWithProblems > 0) ? 1 : 0;
+	if (FFileHelper::SaveStringArrayToFile(ReportLines, *ReportFilename))
+	{
+		UE_LOG(LogLyraMeshCollision, Display, TEXT("Wrote report to %s"), *ReportFilename);
+	}
+	else
+	{
+		UE_LOG(LogLyraMeshCollision, Error, TEXT("Failed to write report to %s"), *ReportFilename);
+		ReturnVal = 1;
+	}
+
+	UE_LOG(LogLyraMeshCollision, Display, TEXT("Checked %d meshes with %d triangles, %d have degenerate triangles. Loading %.2fs, creating physics meshes %.2fs, checking %.2fs (%.2fs of work), total %.2fs"),
+		Results.Num(), NumTriangles, NumMeshesWithProblems, LoadSeconds, CreatePhysicsMeshesSeconds, CheckSeconds, CheckWorkSeconds, FPlatformTime::Seconds() - StartTime);
+
+	return ReturnVal;
+}
@@ -0,0 +1,25 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Commandlets/Commandlet.h"
+
+#include "CheckChaosMeshCollisionCommandlet.generated.h"
+
+/**
+ * Checks the Chaos collision data of every static mesh in the asset registry for degenerate triangles, like
+ * Lyra.CheckChaosMeshCollision does for loaded meshes. Meshes are streamed in batches, the next batch loading while
+ * the current one is checked in parallel, and a CSV report with per mesh results and timings is written.
+ *
+ * Usage: -run=CheckChaosMeshCollision [-InPath=/Game/Path+/Plugin/Path] [-BatchSize=64] [-Report=File.csv]
+ */
+UCLASS()
+class UCheckChaosMeshCollisionCommandlet : public UCommandlet
+{
+	GENERATED_UCLASS_BODY()
+
+public:
+	// Begin UCommandlet Interface
+	virtual int32 Main(const FString& Params) override;
+	// End UCommandlet Interface
+};
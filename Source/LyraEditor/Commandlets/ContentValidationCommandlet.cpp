@@ -5,10 +5,17 @@
 #include "AssetRegistry/ARFilter.h"
 #include "AssetRegistry/AssetData.h"
 #include "AssetRegistry/AssetRegistryModule.h"
+#include "Async/ParallelFor.h"
 #include "DataValidationModule.h"
+#include "HAL/PlatformTime.h"
 #include "Interfaces/IPluginManager.h"
 #include "Misc/CommandLine.h"
 #include "Misc/ConfigCacheIni.h"
+#include "Misc/EngineVersion.h"
+#include "Misc/FileHelper.h"
+#include "Misc/PackageName.h"
+#include "Misc/SecureHash.h"
+#include "Modules/ModuleManager.h"
 #include "ShaderCompiler.h"
 #include "SourceControlHelpers.h"
 #include "Validation/EditorValidator.h"
@@ -17,6 +24,12 @@
 
 DEFINE_LOG_CATEGORY_STATIC(LogLyraContentValidation, Log, Log);
 
+namespace LyraContentValidation
+{
+	// Bump to invalidate every validation cache, e.g., when validation changes in a way the hashed modules and config don't capture
+	static constexpr int32 ValidationCacheVersion = 1;
+}
+
 class FScopedContentValidationMessageGatherer : public FOutputDevice
 {
 public:
@@ -43,6 +56,69 @@ public:
 	bool bAtLeastOneError;
 };
 
+/** Remembers the hash of every package that passed validation, so a later run can skip the ones that haven't changed since */
+class FContentValidationCache
+{
+public:
+	explicit FContentValidationCache(const FString& InFilename)
+		: Filename(InFilename)
+	{
+		TArray<FString> Lines;
+		if (FFileHelper::LoadFileToStringArray(Lines, *Filename))
+		{
+			for (const FString& Line : Lines)
+			{
+				FString PackageName;
+				FString PackageHash;
+				if (Line.Split(TEXT(" "), &PackageName, &PackageHash))
+				{
+					PassedPackageHashes.Add(PackageName, PackageHash);
+				}
+			}
+		}
+	}
+
+	bool HasPassed(const FString& PackageName, const FString& PackageHash) const
+	{
+		const FString* PassedHash = PassedPackageHashes.Find(PackageName);
+		return PassedHash && (*PassedHash == PackageHash);
+	}
+
+	void SetPassed(const FString& PackageName, const FString& PackageHash, bool bPassed)
+	{
+		if (bPassed)
+		{
+			PassedPackageHashes.Add(PackageName, PackageHash);
+		}
+		else
+		{
+			PassedPackageHashes.Remove(PackageName);
+		}
+	}
+
+	bool Save() const
+	{
+		TArray<FString> Lines;
+		Lines.Reserve(PassedPackageHashes.Num());
+		for (const TPair<FString, FString>& PassedPackageHash : PassedPackageHashes)
+		{
+			Lines.Add(PassedPackageHash.Key + TEXT(" ") + PassedPackageHash.Value);
+		}
+		Lines.Sort();
+
+		return FFileHelper::SaveStringArrayToFile(Lines, *Filename);
+	}
+
+	int32 Num() const
+	{
+		return PassedPackageHashes.Num();
+	}
+
+private:
+	FString Filename;
+	TMap<FString, FString> PassedPackageHashes;
+};
+
 UContentValidationCommandlet::UContentValidationCommandlet(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
 {
@@ -51,6 +127,8 @@ UContentValidationCommandlet::UContentValidationCommandlet(const FObjectInitiali
 int32 UContentValidationCommandlet::Main(const FString& FullCommandLine)
 {
 	UE_LOG(LogLyraContentValidation, Display, TEXT("Running ContentValidationCommandlet commandlet..."));
+
+	const double StartTime = FPlatformTime::Seconds();
 	
 	TArray<FString> Tokens;
 	TArray<FString> Switches;
@@ -65,13 +143,14 @@ int32 UContentValidationCommandlet::Main(const FString& FullCommandLine)
 
 	TArray<FString> ChangedPackageNames;
 	TArray<FString> DeletedPackageNames;
+	TArray<FString> PackagesForChangedCode;
 	TArray<FString> ChangedCode;
 	TArray<FString> ChangedOtherFiles;
 	FString* P4FilterString = Params.Find(TEXT("P4Filter"));
 	if (P4FilterString && !P4FilterString->IsEmpty())
 	{
 		FString P4CmdString = TEXT("files ") + *P4FilterString;
-		if (!GetAllChangedFiles(AssetRegistry, P4CmdString, ChangedPackageNames, DeletedPackageNames, ChangedCode, ChangedOtherFiles))
+		if (!GetAllChangedFiles(AssetRegistry, P4CmdString, ChangedPackageNames, DeletedPackageNames, PackagesForChangedCode, ChangedCode, ChangedOtherFiles))
 		{
 			UE_LOG(LogLyraContentValidation, Display, TEXT("ContentValidation returning 1. Failed to get changed files."));
 			ReturnVal = 1;
@@ -82,7 +161,7 @@ int32 UContentValidationCommandlet::Main(const FString& FullCommandLine)
 	if (P4ChangelistString && !P4ChangelistString->IsEmpty())
 	{
 		FString P4CmdString = TEXT("opened -c ") + *P4ChangelistString;
-		if (!GetAllChangedFiles(AssetRegistry, P4CmdString, ChangedPackageNames, DeletedPackageNames, ChangedCode, ChangedOtherFiles))
+		if (!GetAllChangedFiles(AssetRegistry, P4CmdString, ChangedPackageNames, DeletedPackageNames, PackagesForChangedCode, ChangedCode, ChangedOtherFiles))
 		{
 			UE_LOG(LogLyraContentValidation, Display, TEXT("ContentValidation returning 1. Failed to get changed files."));
 			ReturnVal = 1;
@@ -110,7 +189,7 @@ int32 UContentValidationCommandlet::Main(const FString& FullCommandLine)
 		if (!Workspace.IsEmpty())
 		{
 			FString P4CmdString = FString::Printf(TEXT("-c%s opened"), *Workspace);
-			if (!GetAllChangedFiles(AssetRegistry, P4CmdString, ChangedPackageNames, DeletedPackageNames, ChangedCode, ChangedOtherFiles))
+			if (!GetAllChangedFiles(AssetRegistry, P4CmdString, ChangedPackageNames, DeletedPackageNames, PackagesForChangedCode, ChangedCode, ChangedOtherFiles))
 			{
 				UE_LOG(LogLyraContentValidation, Display, TEXT("ContentValidation returning 1. Failed to get changed files."));
 				ReturnVal = 1;
@@ -124,6 +203,45 @@ int32 UContentValidationCommandlet::Main(const FString& FullCommandLine)
 		}
 	}
 
+	// Changed files from a list (one path per line, or the output of git diff --name-status) or straight from git, for machines without Perforce
+	bool bIncremental = (P4FilterString && !P4FilterString->IsEmpty()) || (P4ChangelistString && !P4ChangelistString->IsEmpty()) || bP4Opened;
+
+	FString* ChangedFileListString = Params.Find(TEXT("ChangedFileList"));
+	if (ChangedFileListString && !ChangedFileListString->IsEmpty())
+	{
+		TArray<FString> ChangedFileLines;
+		if (FFileHelper::LoadFileToStringArray(ChangedFileLines, **ChangedFileListString))
+		{
+			AddChangedFiles(AssetRegistry, ChangedFileLines, ChangedPackageNames, DeletedPackageNames, PackagesForChangedCode, ChangedCode, ChangedOtherFiles);
+			bIncremental = true;
+		}
+		else
+		{
+			UE_LOG(LogLyraContentValidation, Error, TEXT("Failed to read the changed file list %s"), **ChangedFileListString);
+			UE_LOG(LogLyraContentValidation, Display, TEXT("ContentValidation returning 1. Failed to get changed files."));
+			ReturnVal = 1;
+		}
+	}
+
+	FString* GitDiffString = Params.Find(TEXT("GitDiff"));
+	if (GitDiffString && !GitDiffString->IsEmpty())
+	{
+		FString* GitPathString = Params.Find(TEXT("GitPath"));
+		const FString GitPath = GitPathString ? *GitPathString : (PLATFORM_WINDOWS ? TEXT("git.exe") : TEXT("/usr/bin/git"));
+
+		TArray<FString> ChangedFileLines;
+		if (GetChangedFilesFromGit(GitPath, *GitDiffString, ChangedFileLines))
+		{
+			AddChangedFiles(AssetRegistry, ChangedFileLines, ChangedPackageNames, DeletedPackageNames, PackagesForChangedCode, ChangedCode, ChangedOtherFiles);
+			bIncremental = true;
+		}
+		else
+		{
+			UE_LOG(LogLyraContentValidation, Display, TEXT("ContentValidation returning 1. Failed to get changed files."));
+			ReturnVal = 1;
+		}
+	}
+
 	int32 MaxPackagesToLoad = 2000;
 
 	FString* InPathString = Params.Find(TEXT("InPath"));
@@ -160,8 +278,80 @@ int32 UContentValidationCommandlet::Main(const FString& FullCommandLine)
 		MaxPackagesToLoad = FCString::Atoi(**InMaxPackagesToLoadString);
 	}
 
+	// Packages that hard reference a changed package can break with it, validate them too
+	if (Switches.Contains(TEXT("Referencers")))
+	{
+		AddReferencerClosure(AssetRegistry, DeletedPackageNames, MaxPackagesToLoad, ChangedPackageNames);
+	}
+
+	{
+		TSet<FString> UniquePackageNames;
+		ChangedPackageNames.RemoveAll([&UniquePackageNames](const FString& PackageName)
+		{
+			bool bAlreadyInSet = false;
+			UniquePackageNames.Add(PackageName, &bAlreadyInSet);
+			return bAlreadyInSet;
+		});
+	}
+
+	const double GatherEndTime = FPlatformTime::Seconds();
+
+	// Skip packages that passed last time and haven't changed since, by their own file, the files they hard reference directly or
+	// indirectly, and the validators. Packages brought in by a code change are always validated, the code isn't part of their hash.
+	TUniquePtr<FContentValidationCache> ValidationCache;
+	TMap<FString, FString> PackageHashes;
+	int32 NumPackagesSkipped = 0;
+	FString* ValidationCacheString = Params.Find(TEXT("ValidationCache"));
+	if ((ValidationCacheString && !ValidationCacheString->IsEmpty()) || Switches.Contains(TEXT("ValidationCache")))
+	{
+		const FString ValidationCacheFilename = (ValidationCacheString && !ValidationCacheString->IsEmpty()) ? *ValidationCacheString : FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("ContentValidation"), TEXT("ValidationCache.txt"));
+		ValidationCache = MakeUnique<FContentValidationCache>(ValidationCacheFilename);
+
+		ComputePackageHashes(AssetRegistry, ChangedPackageNames, ComputeValidatorVersion(), PackageHashes);
+
+		const TSet<FString> PackagesForChangedCodeSet(PackagesForChangedCode);
+		NumPackagesSkipped = ChangedPackageNames.RemoveAll([&ValidationCache, &PackageHashes, &PackagesForChangedCodeSet](const FString& PackageName)
+		{
+			if (PackagesForChangedCodeSet.Contains(PackageName))
+			{
+				return false;
+			}
+
+			const FString* PackageHash = PackageHashes.Find(PackageName);
+			return PackageHash && ValidationCache->HasPassed(PackageName, *PackageHash);
+		});
+	}
+
+	const double HashEndTime = FPlatformTime::Seconds();
+
 	TArray<FString> AllWarningsAndErrors;
-	UEditorValidator::ValidatePackages(ChangedPackageNames, DeletedPackageNames, MaxPackagesToLoad, AllWarningsAndErrors, EDataValidationUsecase::Commandlet);
+	TArray<FString> ValidatedPackageNames;
+	const bool bPreloadInParallel = Switches.Contains(TEXT("ParallelPreload"));
+	const bool bPackagesPassed = UEditorValidator::ValidatePackages(ChangedPackageNames, DeletedPackageNames, MaxPackagesToLoad, AllWarningsAndErrors, EDataValidationUsecase::Commandlet, bPreloadInParallel, &ValidatedPackageNames);
+
+	const double ValidateEndTime = FPlatformTime::Seconds();
+
+	// Validation results aren't attributed to packages, so only a clean run can vouch for them. Packages it skipped, all of them when
+	// there were too many with the referencers of deleted packages, keep what the cache had.
+	if (ValidationCache.IsValid() && (ValidatedPackageNames.Num() > 0))
+	{
+		for (const FString& PackageName : ValidatedPackageNames)
+		{
+			if (const FString* PackageHash = PackageHashes.Find(PackageName))
+			{
+				ValidationCache->SetPassed(PackageName, *PackageHash, bPackagesPassed);
+			}
+		}
+
+		if (!ValidationCache->Save())
+		{
+			UE_LOG(LogLyraContentValidation, Warning, TEXT("Failed to save the validation cache."));
+		}
+	}
+
+	UE_LOG(LogLyraContentValidation, Display, TEXT("ContentValidation (%s) validated %d packages, %d unchanged since they last passed were skipped. Gathering %.2fs, hashing %.2fs, validating %.2fs, total %.2fs"),
+		bIncremental ? TEXT("incremental") : TEXT("full"), ValidatedPackageNames.Num(), NumPackagesSkipped,
+		GatherEndTime - StartTime, HashEndTime - GatherEndTime, ValidateEndTime - HashEndTime, ValidateEndTime - StartTime);
 
 	if (!UEditorValidator::ValidateProjectSettings())
 	{
@@ -171,7 +361,7 @@ int32 UContentValidationCommandlet::Main(const FString& FullCommandLine)
 	return ReturnVal;
 }
 
-bool UContentValidationCommandlet::GetAllChangedFiles(IAssetRegistry& AssetRegistry, const FString& P4CmdString, TArray<FString>& OutChangedPackageNames, TArray<FString>& DeletedPackageNames, TArray<FString>& OutChangedCode, TArray<FString>& OutChangedOtherFiles) const
+bool UContentValidationCommandlet::GetAllChangedFiles(IAssetRegistry& AssetRegistry, const FString& P4CmdString, TArray<FString>& OutChangedPackageNames, TArray<FString>& DeletedPackageNames, TArray<FString>& OutPackagesForChangedCode, TArray<FString>& OutChangedCode, TArray<FString>& OutChangedOtherFiles) const
 {
 	TArray<FString> Results;
 	int32 ReturnCode = 0;
@@ -270,7 +460,9 @@ bool UContentValidationCommandlet::GetAllChangedFiles(IAssetRegistry& AssetRegis
 								FString ChangedHeaderLocalFilename = GetLocalPathFromDepotPath(DepotPathName);
 								if (!ChangedHeaderLocalFilename.IsEmpty())
 								{
+									const int32 FirstCodePackageIndex = OutChangedPackageNames.Num();
 									UEditorValidator::GetChangedAssetsForCode(AssetRegistry, ChangedHeaderLocalFilename, OutChangedPackageNames);
+									OutPackagesForChangedCode.Append(TArrayView<const FString>(OutChangedPackageNames).RightChop(FirstCodePackageIndex));
 								}
 							}
 							else
@@ -427,3 +619,264 @@ FString UContentValidationCommandlet::GetLocalPathFromDepotPath(const FString& D
 	return ReturnString;
 }
 
+bool UContentValidationCommandlet::GetChangedFilesFromGit(const FString& GitPath, const FString& DiffBase, TArray<FString>& OutChangedFileLines) const
+{
+	// Paths relative to the project, changes against the base including uncommitted ones
+	const FString ProjectDir = FPaths::ConvertRelativePathToFull(FPaths::ProjectDir());
+	const FString GitArgs = FString::Printf(TEXT("-C \"%s\" diff --name-status --no-renames --relative %s"), *ProjectDir, *DiffBase);
+
+	int32 ReturnCode = -1;
+	FString StdOut;
+	FString StdErr;
+	if (!FPlatformProcess::ExecProcess(*GitPath, *GitArgs, &ReturnCode, &StdOut, &StdErr))
+	{
+		UE_LOG(LogLyraContentValidation, Error, TEXT("Failed to launch git at %s. Use -GitPath= to point at it."), *GitPath);
+		return false;
+	}
+
+	if (ReturnCode != 0)
+	{
+		UE_LOG(LogLyraContentValidation, Error, TEXT("git diff returned non-zero return code %d: %s"), ReturnCode, *StdErr);
+		return false;
+	}
+
+	StdOut.ParseIntoArrayLines(OutChangedFileLines);
+	return true;
+}
+
+void UContentValidationCommandlet::AddChangedFiles(IAssetRegistry& AssetRegistry, const TArray<FString>& ChangedFileLines, TArray<FString>& OutChangedPackageNames, TArray<FString>& OutDeletedPackageNames, TArray<FString>& OutPackagesForChangedCode, TArray<FString>& OutChangedCode, TArray<FString>& OutChangedOtherFiles) const
+{
+	const FString ProjectDir = FPaths::ConvertRelativePathToFull(FPaths::ProjectDir());
+
+	for (const FString& ChangedFileLine : ChangedFileLines)
+	{
+		// Either a bare path, or a git --name-status line such as "M<tab>Content/Foo.uasset"
+		FString Status;
+		FString RelativeFilename = ChangedFileLine.TrimStartAndEnd();
+		ChangedFileLine.Split(TEXT("\t"), &Status, &RelativeFilename);
+		RelativeFilename.TrimStartAndEndInline();
+
+		if (RelativeFilename.IsEmpty())
+		{
+			continue;
+		}
+
+		FString Filename = FPaths::IsRelative(RelativeFilename) ? FPaths::Combine(ProjectDir, RelativeFilename) : RelativeFilename;
+		FPaths::NormalizeFilename(Filename);
+		FPaths::CollapseRelativeDirectories(Filename);
+
+		if (FPackageName::IsPackageFilename(Filename))
+		{
+			FString PackageName;
+			if (FPackageName::TryConvertFilenameToLongPackageName(Filename, PackageName) && !UEditorValidator::IsInUncookedFolder(PackageName))
+			{
+				if (Status.StartsWith(TEXT("D")))
+				{
+					OutDeletedPackageNames.AddUnique(PackageName);
+				}
+				else
+				{
+					OutChangedPackageNames.AddUnique(PackageName);
+				}
+			}
+		}
+		else if (Filename.EndsWith(TEXT(".h")))
+		{
+			OutChangedCode.Add(RelativeFilename);
+
+			// Source code header changes for classes may cause issues in assets based on those classes
+			if (!Status.StartsWith(TEXT("D")))
+			{
+				const int32 FirstCodePackageIndex = OutChangedPackageNames.Num();
+				UEditorValidator::GetChangedAssetsForCode(AssetRegistry, Filename, OutChangedPackageNames);
+				OutPackagesForChangedCode.Append(TArrayView<const FString>(OutChangedPackageNames).RightChop(FirstCodePackageIndex));
+			}
+		}
+		else if (Filename.EndsWith(TEXT(".cpp")))
+		{
+			OutChangedCode.Add(RelativeFilename);
+		}
+		else
+		{
+			OutChangedOtherFiles.Add(RelativeFilename);
+		}
+	}
+}
+
+void UContentValidationCommandlet::AddReferencerClosure(IAssetRegistry& AssetRegistry, const TArray<FString>& DeletedPackageNames, int32 MaxPackageNames, TArray<FString>& InOutPackageNames) const
+{
+	TSet<FName> VisitedPackages;
+	TArray<FName> PackagesToVisit;
+	for (const FString& PackageName : InOutPackageNames)
+	{
+		const FName PackageFName(*PackageName);
+		VisitedPackages.Add(PackageFName);
+		PackagesToVisit.Add(PackageFName);
+	}
+
+	const int32 NumChangedPackages = InOutPackageNames.Num();
+
+	// Stop once over the limit, ValidatePackages skips the whole run at that point anyway
+	for (int32 VisitIndex = 0; (VisitIndex < PackagesToVisit.Num()) && (InOutPackageNames.Num() <= MaxPackageNames); ++VisitIndex)
+	{
+		TArray<FName> PackageReferencers;
+		AssetRegistry.GetReferencers(PackagesToVisit[VisitIndex], PackageReferencers, UE::AssetRegistry::EDependencyCategory::Package, UE::AssetRegistry::EDependencyQuery::Hard);
+
+		for (const FName& Referencer : PackageReferencers)
+		{
+			bool bAlreadyVisited = false;
+			VisitedPackages.Add(Referencer, &bAlreadyVisited);
+			if (!bAlreadyVisited)
+			{
+				const FString ReferencerString = Referencer.ToString();
+				if (!DeletedPackageNames.Contains(ReferencerString) && FPackageName::IsValidLongPackageName(ReferencerString) && !UEditorValidator::IsInUncookedFolder(ReferencerString))
+				{
+					InOutPackageNames.Add(ReferencerString);
+					PackagesToVisit.Add(Referencer);
+				}
+			}
+		}
+	}
+
+	UE_LOG(LogLyraContentValidation, Display, TEXT("Added %d referencers of %d changed packages to be verified"), InOutPackageNames.Num() - NumChangedPackages, NumChangedPackages);
+}
+
+FString UContentValidationCommandlet::ComputeValidatorVersion() const
+{
+	FMD5 VersionMD5;
+	auto AddString = [&VersionMD5](const FString& String)
+	{
+		VersionMD5.Update(reinterpret_cast<const uint8*>(*String), String.Len() * sizeof(TCHAR));
+	};
+	auto AddFile = [&VersionMD5, &AddString](const FString& Filename)
+	{
+		AddString(FPaths::GetCleanFilename(Filename));
+
+		const FMD5Hash FileHash = FMD5Hash::HashFile(*Filename);
+		if (FileHash.IsValid())
+		{
+			VersionMD5.Update(FileHash.GetBytes(), FileHash.GetSize());
+		}
+	};
+
+	AddString(LexToString(LyraContentValidation::ValidationCacheVersion));
+	AddString(FEngineVersion::Current().ToString());
+
+	// The native validators and the code they check assets against
+	for (const TCHAR* ModuleName : { TEXT("LyraEditor"), TEXT("LyraGame"), TEXT("DataValidation") })
+	{
+		const FString ModuleFilename = FModuleManager::Get().GetModuleFilename(ModuleName);
+		if (!ModuleFilename.IsEmpty())
+		{
+			AddFile(ModuleFilename);
+		}
+	}
+
+	// Validator settings
+	AddFile(FPaths::Combine(FPaths::ProjectConfigDir(), TEXT("DefaultEditor.ini")));
+	AddFile(FPaths::Combine(FPaths::ProjectConfigDir(), TEXT("DefaultGame.ini")));
+
+	FMD5Hash VersionHash;
+	VersionHash.Set(VersionMD5);
+	return LexToString(VersionHash);
+}
+
+void UContentValidationCommandlet::ComputePackageHashes(IAssetRegistry& AssetRegistry, const TArray<FString>& PackageNames, const FString& ValidatorVersion, TMap<FString, FString>& OutPackageHashes) const
+{
+	// Validators load a package along with everything it hard references, directly or not, so its hash covers all of those files
+	TMap<FName, TArray<FName>> DirectDependencies;
+	auto GetDirectDependencies = [&AssetRegistry, &DirectDependencies](const FName& PackageName) -> const TArray<FName>&
+	{
+		if (const TArray<FName>* Dependencies = DirectDependencies.Find(PackageName))
+		{
+			return *Dependencies;
+		}
+
+		TArray<FName> Dependencies;
+		AssetRegistry.GetDependencies(PackageName, Dependencies, UE::AssetRegistry::EDependencyCategory::Package, UE::AssetRegistry::EDependencyQuery::Hard);
+		return DirectDependencies.Add(PackageName, MoveTemp(Dependencies));
+	};
+
+	TMap<FName, TArray<FName>> PackageDependencies;
+	TSet<FName> PackagesToHash;
+	for (const FString& PackageName : PackageNames)
+	{
+		const FName PackageFName(*PackageName);
+		TArray<FName>& Dependencies = PackageDependencies.Add(PackageFName);
+
+		TSet<FName> VisitedPackages;
+		VisitedPackages.Add(PackageFName);
+		TArray<FName> PackagesToVisit;
+		PackagesToVisit.Add(PackageFName);
+		while (PackagesToVisit.Num() > 0)
+		{
+			const FName VisitedPackage = PackagesToVisit.Pop(EAllowShrinking::No);
+			for (const FName& Dependency : GetDirectDependencies(VisitedPackage))
+			{
+				bool bAlreadyVisited = false;
+				VisitedPackages.Add(Dependency, &bAlreadyVisited);
+				if (!bAlreadyVisited)
+				{
+					Dependencies.Add(Dependency);
+					PackagesToVisit.Add(Dependency);
+				}
+			}
+		}
+		Dependencies.Sort(FNameLexicalLess());
+
+		PackagesToHash.Add(PackageFName);
+		PackagesToHash.Append(Dependencies);
+	}
+	const TArray<FName> PackagesToHashArray = PackagesToHash.Array();
+	TArray<FString> Filenames;
+	Filenames.SetNum(PackagesToHashArray.Num());
+	for (int32 PackageIndex = 0; PackageIndex < PackagesToHashArray.Num(); ++PackageIndex)
+	{
+		FPackageName::DoesPackageExist(PackagesToHashArray[PackageIndex].ToString(), &Filenames[PackageIndex]);
+	}
+
+	// Reading the files is the expensive part and is safe to spread over the task graph
+	TArray<FMD5Hash> FileHashes;
+	FileHashes.SetNum(PackagesToHashArray.Num());
+	ParallelFor(PackagesToHashArray.Num(), [&Filenames, &FileHashes](int32 PackageIndex)
+	{
+		if (!Filenames[PackageIndex].IsEmpty())
+		{
+			FileHashes[PackageIndex] = FMD5Hash::HashFile(*Filenames[PackageIndex]);
+		}
+	});
+
+	TMap<FName, FMD5Hash> FileHashesByPackage;
+	for (int32 PackageIndex = 0; PackageIndex < PackagesToHashArray.Num(); ++PackageIndex)
+	{
+		FileHashesByPackage.Add(PackagesToHashArray[PackageIndex], FileHashes[PackageIndex]);
+	}
+
+	for (const TPair<FName, TArray<FName>>& PackageAndDependencies : PackageDependencies)
+	{
+		FMD5 PackageMD5;
+		PackageMD5.Update(reinterpret_cast<const uint8*>(*ValidatorVersion), ValidatorVersion.Len() * sizeof(TCHAR));
+
+		auto AddPackage = [&PackageMD5, &FileHashesByPackage](const FName& PackageName)
+		{
+			const FString PackageNameString = PackageName.ToString();
+			PackageMD5.Update(reinterpret_cast<const uint8*>(*PackageNameString), PackageNameString.Len() * sizeof(TCHAR));
+
+			const FMD5Hash& FileHash = FileHashesByPackage.FindChecked(PackageName);
+			if (FileHash.IsValid())
+			{
+				PackageMD5.Update(FileHash.GetBytes(), FileHash.GetSize());
+			}
+		};
+
+		AddPackage(PackageAndDependencies.Key);
+		for (const FName& Dependency : PackageAndDependencies.Value)
+		{
+			AddPackage(Dependency);
+		}
+
+		FMD5Hash PackageHash;
+		PackageHash.Set(PackageMD5);
+		OutPackageHashes.Add(PackageAndDependencies.Key.ToString(), LexToString(PackageHash));
+	}
+}
@@ -27,9 +27,16 @@ private:
 
 private:
 	/** Helper functions */
-	bool GetAllChangedFiles(IAssetRegistry& AssetRegistry, const FString& P4CmdString, TArray<FString>& OutChangedPackageNames, TArray<FString>& DeletedPackageNames, TArray<FString>& OutChangedCode, TArray<FString>& OutChangedOtherFiles) const;
+	bool GetAllChangedFiles(IAssetRegistry& AssetRegistry, const FString& P4CmdString, TArray<FString>& OutChangedPackageNames, TArray<FString>& DeletedPackageNames, TArray<FString>& OutPackagesForChangedCode, TArray<FString>& OutChangedCode, TArray<FString>& OutChangedOtherFiles) const;
 	void GetAllPackagesInPath(IAssetRegistry& AssetRegistry, const FString& InPathString, TArray<FString>& OutPackageNames) const;
 	void GetAllPackagesOfType(const FString& OfTypeString, TArray<FString>& OutPackageNames) const;
 	bool LaunchP4(const FString& Args, TArray<FString>& Output, int32& OutReturnCode) const;
 	FString GetLocalPathFromDepotPath(const FString& DepotPathName) const;
+
+	/** Helper functions for validating without source control */
+	bool GetChangedFilesFromGit(const FString& GitPath, const FString& DiffBase, TArray<FString>& OutChangedFileLines) const;
+	void AddChangedFiles(IAssetRegistry& AssetRegistry, const TArray<FString>& ChangedFileLines, TArray<FString>& OutChangedPackageNames, TArray<FString>& OutDeletedPackageNames, TArray<FString>& OutPackagesForChangedCode, TArray<FString>& OutChangedCode, TArray<FString>& OutChangedOtherFiles) const;
+	void AddReferencerClosure(IAssetRegistry& AssetRegistry, const TArray<FString>& DeletedPackageNames, int32 MaxPackageNames, TArray<FString>& InOutPackageNames) const;
+	FString ComputeValidatorVersion() const;
+	void ComputePackageHashes(IAssetRegistry& AssetRegistry, const TArray<FString>& PackageNames, const FString& ValidatorVersion, TMap<FString, FString>& OutPackageHashes) const;
 };
@@ -1,6 +1,7 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
-#include "Chaos/TriangleMeshImplicitObject.h"
+#include "CheckChaosMeshCollision.h"
+
 #include "Engine/StaticMesh.h"
 #include "PhysicsEngine/BodySetup.h"
 #include "UObject/UObjectIterator.h"
@@ -13,41 +14,58 @@ namespace LyraEditorUtilities
 
 //////////////////////////////////////////////////////////////////////////
 
-// returns true if the mesh has one or more degenerate triangles
-bool CheckMeshDataForProblem(const Chaos::FTriangleMeshImplicitObject::ParticlesType& Particles, const Chaos::FTrimeshIndexBuffer& Elements)
+// Internal helper because the index buffer type is templated
+template <typename IndexBufferType>
+static int32 CountDegenerateTris(const Chaos::FTriangleMeshImplicitObject::ParticlesType& Particles, const IndexBufferType& Elements, int32 FirstTriangle, int32 NumTriangles, bool bStopAtFirst)
 {
-	// Internal helper because the index buffer type is templated
-	auto CheckTris = [&](const auto& Elements, int32 NumTriangles)
-	{
-		using VecType = Chaos::FTriangleMeshImplicitObject::ParticleVecType;
+	using VecType = Chaos::FTriangleMeshImplicitObject::ParticleVecType;
 
-		for (int32 FaceIdx = 0; FaceIdx < NumTriangles; ++FaceIdx)
-		{
-			const VecType& A = Particles.GetX(Elements[FaceIdx][0]);
-			const VecType& B = Particles.GetX(Elements[FaceIdx][1]);
-			const VecType& C = Particles.GetX(Elements[FaceIdx][2]);
+	int32 NumDegenerate = 0;
+	for (int32 FaceIdx = FirstTriangle; FaceIdx < FirstTriangle + NumTriangles; ++FaceIdx)
+	{
+		const VecType& A = Particles.GetX(Elements[FaceIdx][0]);
+		const VecType& B = Particles.GetX(Elements[FaceIdx][1]);
+		const VecType& C = Particles.GetX(Elements[FaceIdx][2]);
 
-			const VecType AB = B - A;
-			const VecType AC = C - A;
-			VecType Normal = VecType::CrossProduct(AB, AC);
+		const VecType AB = B - A;
+		const VecType AC = C - A;
+		VecType Normal = VecType::CrossProduct(AB, AC);
 
-			if (Normal.SafeNormalize() < SMALL_NUMBER)
+		if (Normal.SafeNormalize() < SMALL_NUMBER)
+		{
+			++NumDegenerate;
+			if (bStopAtFirst)
 			{
-				return true;
+				break;
 			}
 		}
+	}
 
-		return false;
-	};
+	return NumDegenerate;
+}
 
+bool CheckMeshDataForProblem(const Chaos::FTriangleMeshImplicitObject::ParticlesType& Particles, const Chaos::FTrimeshIndexBuffer& Elements)
+{
 	const int32 NumTriangles = Elements.GetNumTriangles();
 	if (Elements.RequiresLargeIndices())
 	{
-		return CheckTris(Elements.GetLargeIndexBuffer(), NumTriangles);
+		return CountDegenerateTris(Particles, Elements.GetLargeIndexBuffer(), 0, NumTriangles, /*bStopAtFirst=*/ true) > 0;
+	}
+	else
+	{
+		return CountDegenerateTris(Particles, Elements.GetSmallIndexBuffer(), 0, NumTriangles, /*bStopAtFirst=*/ true) > 0;
+	}
+}
+
+int32 CountDegenerateTriangles(const Chaos::FTriangleMeshImplicitObject::ParticlesType& Particles, const Chaos::FTrimeshIndexBuffer& Elements, int32 FirstTriangle, int32 NumTriangles)
+{
+	if (Elements.RequiresLargeIndices())
+	{
+		return CountDegenerateTris(Particles, Elements.GetLargeIndexBuffer(), FirstTriangle, NumTriangles, /*bStopAtFirst=*/ false);
 	}
 	else
 	{
-		return CheckTris(Elements.GetSmallIndexBuffer(), NumTriangles);
+		return CountDegenerateTris(Particles, Elements.GetSmallIndexBuffer(), FirstTriangle, NumTriangles, /*bStopAtFirst=*/ false);
 	}
 }
 
@@ -0,0 +1,16 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Chaos/TriangleMeshImplicitObject.h"
+
+namespace LyraEditorUtilities
+{
+
+// returns true if the mesh has one or more degenerate triangles
+bool CheckMeshDataForProblem(const Chaos::FTriangleMeshImplicitObject::ParticlesType& Particles, const Chaos::FTrimeshIndexBuffer& Elements);
+
+// returns the number of degenerate triangles in [FirstTriangle, FirstTriangle + NumTriangles), safe to call from worker threads
+int32 CountDegenerateTriangles(const Chaos::FTriangleMeshImplicitObject::ParticlesType& Particles, const Chaos::FTrimeshIndexBuffer& Elements, int32 FirstTriangle, int32 NumTriangles);
+
+}; // End of namespace
@@ -158,7 +158,7 @@ void UEditorValidator::ValidateCheckedOutContent(bool bInteractive, const EDataV
 	}
 }
 
-bool UEditorValidator::ValidatePackages(const TArray<FString>& ExistingPackageNames, const TArray<FString>& DeletedPackageNames, int32 MaxPackagesToLoad, TArray<FString>& OutAllWarningsAndErrors, const EDataValidationUsecase InValidationUsecase)
+bool UEditorValidator::ValidatePackages(const TArray<FString>& ExistingPackageNames, const TArray<FString>& DeletedPackageNames, int32 MaxPackagesToLoad, TArray<FString>& OutAllWarningsAndErrors, const EDataValidationUsecase InValidationUsecase, bool bPreloadInParallel, TArray<FString>* OutValidatedPackageNames)
 {
 	bool bAnyIssuesFound = false;
 
@@ -205,7 +205,11 @@ bool UEditorValidator::ValidatePackages(const TArray<FString>& ExistingPackageNa
 			{
 				int32 OldNumAssets = AssetsToCheck.Num();
 				AssetRegistry.GetAssetsByPackageName(FName(*PackageName), AssetsToCheck, true);
-				if (AssetsToCheck.Num() == OldNumAssets)
+				if ((AssetsToCheck.Num() > OldNumAssets) && OutValidatedPackageNames)
+				{
+					OutValidatedPackageNames->Add(PackageName);
+				}
+				else if (AssetsToCheck.Num() == OldNumAssets)
 				{
 					FString WarningMessage;
 					// See if the file exists at all. Otherwise, the package contains no assets.
@@ -248,6 +252,40 @@ bool UEditorValidator::ValidatePackages(const TArray<FString>& ExistingPackageNa
 		if (AssetsToCheck.Num() > 0)
 		{
 			// Preload all assets to check, so load warnings can be handled separately from validation warnings
+			if (bPreloadInParallel)
+			{
+				// Request every package at once so the async loader overlaps their IO and serialization, load warnings are reported for the whole batch
+				TSet<FName> PackagesToPreload;
+				for (const FAssetData& AssetToCheck : AssetsToCheck)
+				{
+					if (!AssetToCheck.IsAssetLoaded())
+					{
+						PackagesToPreload.Add(AssetToCheck.PackageName);
+					}
+				}
+
+				UE_LOG(LogLyraEditor, Display, TEXT("Preloading %d packages..."), PackagesToPreload.Num());
+
+				FLyraValidationMessageGatherer ScopedPreloadMessageGatherer;
+
+				for (const FName& PackageToPreload : PackagesToPreload)
+				{
+					LoadPackageAsync(PackageToPreload.ToString());
+				}
+				FlushAsyncLoading();
+
+				if (ScopedPreloadMessageGatherer.GetAllWarningsAndErrors().Num() > 0)
+				{
+					for (const FString& LoadWarning : ScopedPreloadMessageGatherer.GetAllWarnings())
+					{
+						UE_LOG(LogLyraEditor, Error, TEXT("%s"), *LoadWarning);
+					}
+
+					OutAllWarningsAndErrors.Append(ScopedPreloadMessageGatherer.GetAllWarningsAndErrors());
+					bAnyIssuesFound = true;
+				}
+			}
+			else
 			{
 				for (const FAssetData& AssetToCheck : AssetsToCheck)
 				{
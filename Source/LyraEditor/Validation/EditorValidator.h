@@ -86,7 +86,8 @@ public:
 	UEditorValidator();
 
 	static void ValidateCheckedOutContent(bool bInteractive, const EDataValidationUsecase InValidationUsecase);
-	static bool ValidatePackages(const TArray<FString>& ExistingPackageNames, const TArray<FString>& DeletedPackageNames, int32 MaxPackagesToLoad, TArray<FString>& OutAllWarningsAndErrors, const EDataValidationUsecase InValidationUsecase);
+	/** OutValidatedPackageNames gets the packages whose assets were checked, none when there were more than MaxPackagesToLoad to validate */
+	static bool ValidatePackages(const TArray<FString>& ExistingPackageNames, const TArray<FString>& DeletedPackageNames, int32 MaxPackagesToLoad, TArray<FString>& OutAllWarningsAndErrors, const EDataValidationUsecase InValidationUsecase, bool bPreloadInParallel = false, TArray<FString>* OutValidatedPackageNames = nullptr);
 	static bool ValidateProjectSettings();
 
 	static bool IsInUncookedFolder(const FString& PackageName, FString* OutUncookedFolderName = nullptr);
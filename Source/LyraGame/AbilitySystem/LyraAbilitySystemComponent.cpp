@@ -321,6 +321,8 @@ void ULyraAbilitySystemComponent::NotifyAbilityActivated(const FGameplayAbilityS
 {
 	Super::NotifyAbilityActivated(Handle, Ability);
 
+	++ActivationStateRevision;
+
 	if (ULyraGameplayAbility* LyraAbility = Cast<ULyraGameplayAbility>(Ability))
 	{
 		AddAbilityToActivationGroup(LyraAbility->GetActivationGroup(), LyraAbility);
@@ -347,6 +349,8 @@ void ULyraAbilitySystemComponent::NotifyAbilityEnded(FGameplayAbilitySpecHandle
 {
 	Super::NotifyAbilityEnded(Handle, Ability, bWasCancelled);
 
+	++ActivationStateRevision;
+
 	if (ULyraGameplayAbility* LyraAbility = Cast<ULyraGameplayAbility>(Ability))
 	{
 		RemoveAbilityFromActivationGroup(LyraAbility->GetActivationGroup(), LyraAbility);
@@ -366,6 +370,8 @@ void ULyraAbilitySystemComponent::ApplyAbilityBlockAndCancelTags(const FGameplay
 
 	Super::ApplyAbilityBlockAndCancelTags(AbilityTags, RequestingAbility, bEnableBlockTags, ModifiedBlockTags, bExecuteCancelTags, ModifiedCancelTags);
 
+	++ActivationStateRevision;
+
 	//@TODO: Apply any special logic like blocking input or movement
 }
 
@@ -376,6 +382,29 @@ void ULyraAbilitySystemComponent::HandleChangeAbilityCanBeCanceled(const FGamepl
 	//@TODO: Apply any special logic like blocking input or movement
 }
 
+void ULyraAbilitySystemComponent::OnGiveAbility(FGameplayAbilitySpec& AbilitySpec)
+{
+	Super::OnGiveAbility(AbilitySpec);
+
+	++AbilitySpecRevision;
+	++ActivationStateRevision;
+}
+
+void ULyraAbilitySystemComponent::OnRemoveAbility(FGameplayAbilitySpec& AbilitySpec)
+{
+	Super::OnRemoveAbility(AbilitySpec);
+
+	++AbilitySpecRevision;
+	++ActivationStateRevision;
+}
+
+void ULyraAbilitySystemComponent::OnTagUpdated(const FGameplayTag& Tag, bool TagExists)
+{
+	Super::OnTagUpdated(Tag, TagExists);
+
+	++ActivationStateRevision;
+}
+
 void ULyraAbilitySystemComponent::GetAdditionalActivationTagRequirements(const FGameplayTagContainer& AbilityTags, FGameplayTagContainer& OutActivationRequired, FGameplayTagContainer& OutActivationBlocked) const
 {
 	if (TagRelationshipMapping)
@@ -387,6 +416,7 @@ void ULyraAbilitySystemComponent::GetAdditionalActivationTagRequirements(const F
 void ULyraAbilitySystemComponent::SetTagRelationshipMapping(ULyraAbilityTagRelationshipMapping* NewMapping)
 {
 	TagRelationshipMapping = NewMapping;
+	++ActivationStateRevision;
 }
 
 void ULyraAbilitySystemComponent::ClientNotifyAbilityFailed_Implementation(const UGameplayAbility* Ability, const FGameplayTagContainer& FailureReason)
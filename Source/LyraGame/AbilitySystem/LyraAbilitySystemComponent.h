@@ -68,6 +68,12 @@ public:
 	/** Looks at ability tags and gathers additional required and blocking tags */
 	void GetAdditionalActivationTagRequirements(const FGameplayTagContainer& AbilityTags, FGameplayTagContainer& OutActivationRequired, FGameplayTagContainer& OutActivationBlocked) const;
 
+	/** Changes whenever an ability spec is given or removed, so callers can cache spec lookups */
+	uint32 GetAbilitySpecRevision() const { return AbilitySpecRevision; }
+
+	/** Changes whenever owned tags, blocked tags, specs or active abilities change, so callers can cache CanActivateAbility results */
+	uint32 GetActivationStateRevision() const { return ActivationStateRevision; }
+
 protected:
 
 	void TryActivateAbilitiesOnSpawn();
@@ -80,6 +86,9 @@ protected:
 	virtual void NotifyAbilityEnded(FGameplayAbilitySpecHandle Handle, UGameplayAbility* Ability, bool bWasCancelled) override;
 	virtual void ApplyAbilityBlockAndCancelTags(const FGameplayTagContainer& AbilityTags, UGameplayAbility* RequestingAbility, bool bEnableBlockTags, const FGameplayTagContainer& BlockTags, bool bExecuteCancelTags, const FGameplayTagContainer& CancelTags) override;
 	virtual void HandleChangeAbilityCanBeCanceled(const FGameplayTagContainer& AbilityTags, UGameplayAbility* RequestingAbility, bool bCanBeCanceled) override;
+	virtual void OnGiveAbility(FGameplayAbilitySpec& AbilitySpec) override;
+	virtual void OnRemoveAbility(FGameplayAbilitySpec& AbilitySpec) override;
+	virtual void OnTagUpdated(const FGameplayTag& Tag, bool TagExists) override;
 
 	/** Notify client that an ability failed to activate */
 	UFUNCTION(Client, Unreliable)
@@ -103,4 +112,10 @@ protected:
 
 	// Number of abilities running in each activation group.
 	int32 ActivationGroupCounts[(uint8)ELyraAbilityActivationGroup::MAX];
+
+	// See GetAbilitySpecRevision
+	uint32 AbilitySpecRevision = 0;
+
+	// See GetActivationStateRevision
+	uint32 ActivationStateRevision = 0;
 };
@@ -8,6 +8,12 @@
 #include "GameplayTagsManager.h"
 #include "UObject/UObjectThreadContext.h"
 #include "Async/Async.h"
+#include "Dom/JsonObject.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(LyraGameplayCueManager)
 
@@ -34,6 +40,28 @@ namespace LyraGameplayCueManagerCvars
 		TEXT("Shows all assets that were loaded via LyraGameplayCueManager and are currently in memory."),
 		FConsoleCommandWithArgsDelegate::CreateStatic(ULyraGameplayCueManager::DumpGameplayCues));
 
+	static FAutoConsoleCommand CVarDumpGameplayCueUsage(
+		TEXT("Lyra.DumpGameplayCueUsage"),
+		TEXT("Shows the gameplay cues used by the current experience, the ones that were loaded late, and the memory held by loaded cues."),
+		FConsoleCommandWithArgsDelegate::CreateStatic(ULyraGameplayCueManager::DumpGameplayCueUsage));
+
+#if !UE_BUILD_SHIPPING
+	// Off by default, recording is for profiling sessions and the end of each one walks every loaded cue to measure its memory
+	static bool bRecordCueUsage = false;
+	static FAutoConsoleVariableRef CVarRecordCueUsage(
+		TEXT("Lyra.GameplayCues.RecordUsage"),
+		bRecordCueUsage,
+		TEXT("If true, the gameplay cues executed during an experience and the ones loaded late are saved to the experience's usage profile when it ends. Read when the experience begins."),
+		ECVF_Default);
+#endif // !UE_BUILD_SHIPPING
+
+	static bool bPreloadProfiledCues = true;
+	static FAutoConsoleVariableRef CVarPreloadProfiledCues(
+		TEXT("Lyra.GameplayCues.PreloadProfiledCues"),
+		bPreloadProfiledCues,
+		TEXT("If true, the gameplay cues an experience's usage profile says it uses are preloaded when the experience loads."),
+		ECVF_Default);
+
 	static ELyraEditorLoadMode LoadMode = ELyraEditorLoadMode::LoadUpfront;
 }
 
@@ -49,6 +77,98 @@ struct FGameplayCueTagThreadSynchronizeGraphTask : public FAsyncGraphTaskBase
 	ENamedThreads::Type GetDesiredThread() { return ENamedThreads::GameThread; }
 };
 
+//////////////////////////////////////////////////////////////////////
+// FLyraGameplayCueUsageProfile
+
+FString FLyraGameplayCueUsageProfile::GetProfileFilename(FName ExperienceName)
+{
+	// Under Content so the profiles are checked in and staged with the game (see DirectoriesToAlwaysStageAsUFS in DefaultGame.ini),
+	// packaged builds, shipping ones included, read them but can't record them
+	return FPaths::Combine(FPaths::ProjectContentDir(), TEXT("GameplayCueUsage"), FPaths::MakeValidFileName(ExperienceName.ToString()) + TEXT(".json"));
+}
+
+bool FLyraGameplayCueUsageProfile::LoadFromFile(FName InExperienceName)
+{
+	ExperienceName = InExperienceName;
+	CueUsage.Reset();
+
+	FString JsonString;
+	if (!FFileHelper::LoadFileToString(JsonString, *GetProfileFilename(ExperienceName)))
+	{
+		return false;
+	}
+
+	TSharedPtr<FJsonObject> RootObject;
+	if (!FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(JsonString), RootObject) || !RootObject.IsValid())
+	{
+		UE_LOG(LogLyra, Warning, TEXT("Failed to parse gameplay cue usage profile %s"), *GetProfileFilename(ExperienceName));
+		return false;
+	}
+
+	const TArray<TSharedPtr<FJsonValue>>* CueValues = nullptr;
+	if (RootObject->TryGetArrayField(TEXT("Cues"), CueValues))
+	{
+		UGameplayTagsManager& TagManager = UGameplayTagsManager::Get();
+
+		for (const TSharedPtr<FJsonValue>& CueValue : *CueValues)
+		{
+			const TSharedPtr<FJsonObject>* CueObject = nullptr;
+			FString TagName;
+			if (CueValue->TryGetObject(CueObject) && (*CueObject)->TryGetStringField(TEXT("Tag"), TagName))
+			{
+				// Cues removed since the profile was recorded are dropped
+				const FGameplayTag CueTag = TagManager.RequestGameplayTag(FName(*TagName), /*ErrorIfNotFound=*/ false);
+				if (CueTag.IsValid())
+				{
+					FLyraGameplayCueUsage& Usage = CueUsage.FindOrAdd(CueTag);
+					(*CueObject)->TryGetNumberField(TEXT("Executions"), Usage.NumExecutions);
+					(*CueObject)->TryGetNumberField(TEXT("LateLoads"), Usage.NumLateLoads);
+				}
+			}
+		}
+	}
+
+	return true;
+}
+
+bool FLyraGameplayCueUsageProfile::SaveToFile() const
+{
+	TArray<FGameplayTag> CueTags;
+	CueUsage.GenerateKeyArray(CueTags);
+	CueTags.Sort([](const FGameplayTag& A, const FGameplayTag& B) { return A.GetTagName().LexicalLess(B.GetTagName()); });
+
+	TArray<TSharedPtr<FJsonValue>> CueValues;
+	for (const FGameplayTag& CueTag : CueTags)
+	{
+		const FLyraGameplayCueUsage& Usage = CueUsage.FindChecked(CueTag);
+
+		TSharedRef<FJsonObject> CueObject = MakeShared<FJsonObject>();
+		CueObject->SetStringField(TEXT("Tag"), CueTag.ToString());
+		CueObject->SetNumberField(TEXT("Executions"), Usage.NumExecutions);
+		CueObject->SetNumberField(TEXT("LateLoads"), Usage.NumLateLoads);
+		CueValues.Add(MakeShared<FJsonValueObject>(CueObject));
+	}
+
+	TSharedRef<FJsonObject> RootObject = MakeShared<FJsonObject>();
+	RootObject->SetStringField(TEXT("Experience"), ExperienceName.ToString());
+	RootObject->SetArrayField(TEXT("Cues"), CueValues);
+
+	FString JsonString;
+	FJsonSerializer::Serialize(RootObject, TJsonWriterFactory<>::Create(&JsonString));
+
+	return FFileHelper::SaveStringToFile(JsonString, *GetProfileFilename(ExperienceName));
+}
+
+void FLyraGameplayCueUsageProfile::Append(const FLyraGameplayCueUsageProfile& Other)
+{
+	for (const TPair<FGameplayTag, FLyraGameplayCueUsage>& KVP : Other.CueUsage)
+	{
+		FLyraGameplayCueUsage& Usage = CueUsage.FindOrAdd(KVP.Key);
+		Usage.NumExecutions += KVP.Value.NumExecutions;
+		Usage.NumLateLoads += KVP.Value.NumLateLoads;
+	}
+}
+
 //////////////////////////////////////////////////////////////////////
 
 ULyraGameplayCueManager::ULyraGameplayCueManager(const FObjectInitializer& ObjectInitializer)
@@ -123,6 +243,269 @@ bool ULyraGameplayCueManager::ShouldAsyncLoadMissingGameplayCues() const
 	return true;
 }
 
+void ULyraGameplayCueManager::HandleGameplayCue(AActor* TargetActor, FGameplayTag GameplayCueTag, EGameplayCueEvent::Type EventType, const FGameplayCueParameters& Parameters, EGameplayCueExecutionOptions Options)
+{
+#if !UE_BUILD_SHIPPING
+	// WhileActive and Removed belong to the same use of the cue as OnActive
+	if (bRecordingCueUsage && ((EventType == EGameplayCueEvent::OnActive) || (EventType == EGameplayCueEvent::Executed)))
+	{
+		RecordedCueUsage.CueUsage.FindOrAdd(GameplayCueTag).NumExecutions++;
+	}
+#endif // !UE_BUILD_SHIPPING
+
+	Super::HandleGameplayCue(TargetActor, GameplayCueTag, EventType, Parameters, Options);
+}
+
+bool ULyraGameplayCueManager::HandleMissingGameplayCue(UGameplayCueSet* OwningSet, struct FGameplayCueNotifyData& CueData, AActor* TargetActor, EGameplayCueEvent::Type EventType, FGameplayCueParameters& Parameters)
+{
+#if !UE_BUILD_SHIPPING
+	if (bRecordingCueUsage)
+	{
+		UE_LOG(LogLyra, Verbose, TEXT("Gameplay cue %s was not loaded when it was played, loading it now"), *CueData.GameplayCueTag.ToString());
+		RecordedCueUsage.CueUsage.FindOrAdd(CueData.GameplayCueTag).NumLateLoads++;
+	}
+#endif // !UE_BUILD_SHIPPING
+
+	return Super::HandleMissingGameplayCue(OwningSet, CueData, TargetActor, EventType, Parameters);
+}
+
+void ULyraGameplayCueManager::BeginExperienceCueUsage(FName ExperienceName)
+{
+	check(!ExperienceName.IsNone());
+
+	if (NumExperienceCueUsers > 0)
+	{
+		// Another world in this process (e.g., a PIE client) is playing the same experience
+		if (RecordedCueUsage.ExperienceName == ExperienceName)
+		{
+			NumExperienceCueUsers++;
+			return;
+		}
+
+		SaveCueUsage();
+	}
+
+	NumExperienceCueUsers = 1;
+	RecordedCueUsage = FLyraGameplayCueUsageProfile();
+	RecordedCueUsage.ExperienceName = ExperienceName;
+	ExperiencePreloadedCues.Reset();
+	NumExperiencePreloadsPlanned = 0;
+	RetainedCueMemoryAtBegin = 0;
+
+#if !UE_BUILD_SHIPPING
+	bRecordingCueUsage = LyraGameplayCueManagerCvars::bRecordCueUsage;
+	if (bRecordingCueUsage)
+	{
+		RetainedCueMemoryAtBegin = GetRetainedCueMemory();
+	}
+#endif // !UE_BUILD_SHIPPING
+
+	// Nothing to plan when every cue is loaded up front
+	if (!LyraGameplayCueManagerCvars::bPreloadProfiledCues || ShouldAsyncLoadRuntimeObjectLibraries() || !RuntimeGameplayCueObjectLibrary.CueSet)
+	{
+		return;
+	}
+
+	FLyraGameplayCueUsageProfile Profile;
+	if (!Profile.LoadFromFile(ExperienceName))
+	{
+		UE_LOG(LogLyra, Log, TEXT("No gameplay cue usage profile for experience %s yet, cues will load as they are referenced"), *ExperienceName.ToString());
+		return;
+	}
+
+	TArray<FSoftObjectPath> PathsToLoad;
+	for (const TPair<FGameplayTag, FLyraGameplayCueUsage>& KVP : Profile.CueUsage)
+	{
+		int32* DataIdx = (KVP.Value.NumExecutions > 0) ? RuntimeGameplayCueObjectLibrary.CueSet->GameplayCueDataMap.Find(KVP.Key) : nullptr;
+		if (DataIdx && RuntimeGameplayCueObjectLibrary.CueSet->GameplayCueData.IsValidIndex(*DataIdx))
+		{
+			const FSoftObjectPath& CuePath = RuntimeGameplayCueObjectLibrary.CueSet->GameplayCueData[*DataIdx].GameplayCueNotifyObj;
+			NumExperiencePreloadsPlanned++;
+
+			if (UClass* LoadedGameplayCueClass = FindObject<UClass>(nullptr, *CuePath.ToString()))
+			{
+				ExperiencePreloadedCues.Add(LoadedGameplayCueClass);
+			}
+			else
+			{
+				PathsToLoad.Add(CuePath);
+			}
+		}
+	}
+
+	UE_LOG(LogLyra, Log, TEXT("Preloading %d gameplay cues for experience %s from its usage profile (%d already loaded)"),
+		NumExperiencePreloadsPlanned, *ExperienceName.ToString(), NumExperiencePreloadsPlanned - PathsToLoad.Num());
+
+	if (PathsToLoad.Num() > 0)
+	{
+		StreamableManager.RequestAsyncLoad(PathsToLoad, FStreamableDelegate::CreateUObject(this, &ThisClass::OnExperienceCuePreloadComplete, PathsToLoad, ExperienceName), FStreamableManager::AsyncLoadHighPriority, false, false, TEXT("GameplayCueManager"));
+	}
+}
+
+void ULyraGameplayCueManager::OnExperienceCuePreloadComplete(TArray<FSoftObjectPath> Paths, FName ExperienceName)
+{
+	// The experience may have ended while the cues were loading
+	if ((NumExperienceCueUsers > 0) && (RecordedCueUsage.ExperienceName == ExperienceName))
+	{
+		for (const FSoftObjectPath& Path : Paths)
+		{
+			if (UClass* LoadedGameplayCueClass = Cast<UClass>(Path.ResolveObject()))
+			{
+				ExperiencePreloadedCues.Add(LoadedGameplayCueClass);
+			}
+		}
+	}
+}
+
+void ULyraGameplayCueManager::EndExperienceCueUsage(FName ExperienceName)
+{
+	if ((NumExperienceCueUsers == 0) || (RecordedCueUsage.ExperienceName != ExperienceName))
+	{
+		return;
+	}
+
+	if (--NumExperienceCueUsers == 0)
+	{
+		SaveCueUsage();
+	}
+}
+
+void ULyraGameplayCueManager::SaveCueUsage()
+{
+#if !UE_BUILD_SHIPPING
+	if (bRecordingCueUsage)
+	{
+		int32 NumExecutions = 0;
+		int32 NumLateLoads = 0;
+		for (const TPair<FGameplayTag, FLyraGameplayCueUsage>& KVP : RecordedCueUsage.CueUsage)
+		{
+			NumExecutions += KVP.Value.NumExecutions;
+			NumLateLoads += KVP.Value.NumLateLoads;
+		}
+
+		UE_LOG(LogLyra, Log, TEXT("Experience %s played %d gameplay cues %d times, %d late loads, %d cues preloaded from its profile, %.1f KB held by loaded cues at the start and %.1f KB at the end"),
+			*RecordedCueUsage.ExperienceName.ToString(), RecordedCueUsage.CueUsage.Num(), NumExecutions, NumLateLoads, NumExperiencePreloadsPlanned,
+			RetainedCueMemoryAtBegin / 1024.0, GetRetainedCueMemory() / 1024.0);
+
+		if (RecordedCueUsage.CueUsage.Num() > 0)
+		{
+			FLyraGameplayCueUsageProfile Profile;
+			Profile.LoadFromFile(RecordedCueUsage.ExperienceName);
+			Profile.Append(RecordedCueUsage);
+
+			if (!Profile.SaveToFile())
+			{
+				UE_LOG(LogLyra, Warning, TEXT("Failed to save gameplay cue usage profile %s"), *FLyraGameplayCueUsageProfile::GetProfileFilename(Profile.ExperienceName));
+			}
+		}
+	}
+#endif // !UE_BUILD_SHIPPING
+
+	NumExperienceCueUsers = 0;
+	bRecordingCueUsage = false;
+	RecordedCueUsage = FLyraGameplayCueUsageProfile();
+	ExperiencePreloadedCues.Reset();
+}
+
+int64 ULyraGameplayCueManager::GetRetainedCueMemory() const
+{
+	// Cue notifies are small, the memory is in the effects and sounds they reference
+	TSet<UObject*> CountedObjects;
+	int64 NumBytes = 0;
+
+	auto CountObject = [&CountedObjects, &NumBytes](UObject* Object)
+	{
+		bool bAlreadyCounted = false;
+		CountedObjects.Add(Object, &bAlreadyCounted);
+		if (!bAlreadyCounted)
+		{
+			NumBytes += Object->GetResourceSizeBytes(EResourceSizeMode::EstimatedTotal);
+		}
+	};
+
+	auto CountCue = [&CountObject](UClass* CueClass)
+	{
+		if (CueClass)
+		{
+			CountObject(CueClass);
+			if (UObject* CueCDO = CueClass->GetDefaultObject(false))
+			{
+				TArray<UObject*> ReferencedObjects;
+				FReferenceFinder ReferenceFinder(ReferencedObjects, nullptr, /*bRequireDirectOuter=*/ false, /*bShouldIgnoreArchetype=*/ true);
+				ReferenceFinder.FindReferences(CueCDO);
+
+				for (UObject* ReferencedObject : ReferencedObjects)
+				{
+					if (ReferencedObject && ReferencedObject->IsAsset())
+					{
+						CountObject(ReferencedObject);
+					}
+				}
+			}
+		}
+	};
+
+	for (UClass* CueClass : AlwaysLoadedCues)
+	{
+		CountCue(CueClass);
+	}
+	for (UClass* CueClass : PreloadedCues)
+	{
+		CountCue(CueClass);
+	}
+	for (UClass* CueClass : ExperiencePreloadedCues)
+	{
+		CountCue(CueClass);
+	}
+	if (RuntimeGameplayCueObjectLibrary.CueSet)
+	{
+		for (const FGameplayCueNotifyData& CueData : RuntimeGameplayCueObjectLibrary.CueSet->GameplayCueData)
+		{
+			CountCue(CueData.LoadedGameplayCueClass);
+		}
+	}
+
+	return NumBytes;
+}
+
+void ULyraGameplayCueManager::DumpGameplayCueUsage(const TArray<FString>& Args)
+{
+	ULyraGameplayCueManager* GCM = Get();
+	if (!GCM)
+	{
+		UE_LOG(LogLyra, Error, TEXT("DumpGameplayCueUsage failed. No ULyraGameplayCueManager found."));
+		return;
+	}
+
+	if (!GCM->bRecordingCueUsage)
+	{
+		UE_LOG(LogLyra, Log, TEXT("No experience is recording gameplay cue usage, set Lyra.GameplayCues.RecordUsage before it begins."));
+		return;
+	}
+
+	TArray<FGameplayTag> CueTags;
+	GCM->RecordedCueUsage.CueUsage.GenerateKeyArray(CueTags);
+	CueTags.Sort([GCM](const FGameplayTag& A, const FGameplayTag& B)
+	{
+		return GCM->RecordedCueUsage.CueUsage[A].NumLateLoads > GCM->RecordedCueUsage.CueUsage[B].NumLateLoads;
+	});
+
+	UE_LOG(LogLyra, Log, TEXT("=========== Gameplay Cue Usage for %s ==========="), *GCM->RecordedCueUsage.ExperienceName.ToString());
+	int32 NumLateLoads = 0;
+	for (const FGameplayTag& CueTag : CueTags)
+	{
+		const FLyraGameplayCueUsage& Usage = GCM->RecordedCueUsage.CueUsage[CueTag];
+		NumLateLoads += Usage.NumLateLoads;
+		UE_LOG(LogLyra, Log, TEXT("  %s (%d executions, %d late loads)"), *CueTag.ToString(), Usage.NumExecutions, Usage.NumLateLoads);
+	}
+
+	UE_LOG(LogLyra, Log, TEXT("=========== Gameplay Cue Usage summary ==========="));
+	UE_LOG(LogLyra, Log, TEXT("  ... %d cues played"), CueTags.Num());
+	UE_LOG(LogLyra, Log, TEXT("  ... %d late loads"), NumLateLoads);
+	UE_LOG(LogLyra, Log, TEXT("  ... %d cues planned from the usage profile, %d loaded"), GCM->NumExperiencePreloadsPlanned, GCM->ExperiencePreloadedCues.Num());
+	UE_LOG(LogLyra, Log, TEXT("  ... %.1f KB held by loaded cues when the experience began, %.1f KB now"), GCM->RetainedCueMemoryAtBegin / 1024.0, GCM->GetRetainedCueMemory() / 1024.0);
+}
+
 void ULyraGameplayCueManager::DumpGameplayCues(const TArray<FString>& Args)
 {
 	ULyraGameplayCueManager* GCM = Cast<ULyraGameplayCueManager>(UAbilitySystemGlobals::Get().GetGameplayCueManager());
@@ -331,6 +714,11 @@ void ULyraGameplayCueManager::HandlePostLoadMap(UWorld* NewWorld)
 		{
 			RuntimeGameplayCueObjectLibrary.CueSet->RemoveLoadedClass(CueClass);
 		}
+
+		for (UClass* CueClass : ExperiencePreloadedCues)
+		{
+			RuntimeGameplayCueObjectLibrary.CueSet->RemoveLoadedClass(CueClass);
+		}
 	}
 
 	for (auto CueIt = PreloadedCues.CreateIterator(); CueIt; ++CueIt)
@@ -8,17 +8,43 @@
 
 class FString;
 class UClass;
+class UGameplayCueSet;
 class UObject;
 class UWorld;
 struct FObjectKey;
 
+/** How often a gameplay cue was used during an experience, and how often it had to be loaded when it was first needed */
+struct FLyraGameplayCueUsage
+{
+	int32 NumExecutions = 0;
+	int32 NumLateLoads = 0;
+};
+
+/**
+ * FLyraGameplayCueUsageProfile
+ *
+ * The gameplay cues used by an experience, accumulated over every session played with it and saved under Content/GameplayCueUsage
+ */
+struct LYRAGAME_API FLyraGameplayCueUsageProfile
+{
+	FName ExperienceName;
+	TMap<FGameplayTag, FLyraGameplayCueUsage> CueUsage;
+
+	static FString GetProfileFilename(FName ExperienceName);
+
+	bool LoadFromFile(FName InExperienceName);
+	bool SaveToFile() const;
+
+	void Append(const FLyraGameplayCueUsageProfile& Other);
+};
+
 /**
  * ULyraGameplayCueManager
  *
  * Game-specific manager for gameplay cues
  */
 UCLASS()
-class ULyraGameplayCueManager : public UGameplayCueManager
+class LYRAGAME_API ULyraGameplayCueManager : public UGameplayCueManager
 {
 	GENERATED_BODY()
 
@@ -32,9 +58,24 @@ public:
 	virtual bool ShouldAsyncLoadRuntimeObjectLibraries() const override;
 	virtual bool ShouldSyncLoadMissingGameplayCues() const override;
 	virtual bool ShouldAsyncLoadMissingGameplayCues() const override;
+	virtual void HandleGameplayCue(AActor* TargetActor, FGameplayTag GameplayCueTag, EGameplayCueEvent::Type EventType, const FGameplayCueParameters& Parameters, EGameplayCueExecutionOptions Options = EGameplayCueExecutionOptions::Default) override;
+	virtual bool HandleMissingGameplayCue(UGameplayCueSet* OwningSet, struct FGameplayCueNotifyData& CueData, AActor* TargetActor, EGameplayCueEvent::Type EventType, FGameplayCueParameters& Parameters) override;
 	//~End of UGameplayCueManager interface
 
 	static void DumpGameplayCues(const TArray<FString>& Args);
+	static void DumpGameplayCueUsage(const TArray<FString>& Args);
+
+	// Preloads the cues the experience's saved profile says it uses, and starts recording its cue usage if Lyra.GameplayCues.RecordUsage is set
+	void BeginExperienceCueUsage(FName ExperienceName);
+
+	// Saves the cue usage recorded for the experience and releases the cues preloaded for it
+	void EndExperienceCueUsage(FName ExperienceName);
+
+	// Usage recorded since the current experience began, no cues are listed if it isn't being recorded
+	const FLyraGameplayCueUsageProfile& GetRecordedCueUsage() const { return RecordedCueUsage; }
+
+	// Bytes held by the gameplay cue classes this manager keeps loaded
+	int64 GetRetainedCueMemory() const;
 
 	// When delay loading cues, this will load the cues that must be always loaded anyway
 	void LoadAlwaysLoadedCues();
@@ -52,6 +93,8 @@ private:
 	void HandlePostLoadMap(UWorld* NewWorld);
 	void UpdateDelayLoadDelegateListeners();
 	bool ShouldDelayLoadGameplayCues() const;
+	void OnExperienceCuePreloadComplete(TArray<FSoftObjectPath> Paths, FName ExperienceName);
+	void SaveCueUsage();
 
 private:
 	struct FLoadedGameplayTagToProcessData
@@ -73,6 +116,17 @@ private:
 	UPROPERTY(transient)
 	TSet<TObjectPtr<UClass>> AlwaysLoadedCues;
 
+	// Cues preloaded because the usage profile of the current experience says it uses them
+	UPROPERTY(transient)
+	TSet<TObjectPtr<UClass>> ExperiencePreloadedCues;
+
+	// Usage recorded since the current experience began, merged into its profile when it ends
+	FLyraGameplayCueUsageProfile RecordedCueUsage;
+	bool bRecordingCueUsage = false;
+	int32 NumExperienceCueUsers = 0;
+	int32 NumExperiencePreloadsPlanned = 0;
+	int64 RetainedCueMemoryAtBegin = 0;
+
 	TArray<FLoadedGameplayTagToProcessData> LoadedGameplayTagsToProcess;
 	FCriticalSection LoadedGameplayTagsToProcessCS;
 	bool bProcessLoadedTagsAfterGC = false;
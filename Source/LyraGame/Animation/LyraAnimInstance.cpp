@@ -1,9 +1,11 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "LyraAnimInstance.h"
+#include "AbilitySystemComponent.h"
 #include "AbilitySystemGlobals.h"
 #include "Character/LyraCharacter.h"
 #include "Character/LyraCharacterMovementComponent.h"
+#include "HAL/IConsoleManager.h"
 
 #if WITH_EDITOR
 #include "Misc/DataValidation.h"
@@ -11,6 +13,64 @@
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(LyraAnimInstance)
 
+namespace LyraAnim
+{
+	static bool bThreadSafeUpdate = true;
+	static FAutoConsoleVariableRef CVarThreadSafeUpdate(
+		TEXT("Lyra.Anim.ThreadSafeUpdate"),
+		bThreadSafeUpdate,
+		TEXT("Should Lyra anim instances copy character state on the game thread and apply it in the thread safe animation update?\n")
+		TEXT("  If false, the character is queried and the anim instance updated in NativeUpdateAnimation on the game thread"),
+		ECVF_Default);
+}
+
+//////////////////////////////////////////////////////////////////////
+// FLyraAnimInstanceProxy
+
+void FLyraAnimInstanceProxy::Initialize(UAnimInstance* InAnimInstance)
+{
+	Super::Initialize(InAnimInstance);
+
+	MovementComponent.Reset();
+	if (const ALyraCharacter* Character = Cast<ALyraCharacter>(InAnimInstance->GetOwningActor()))
+	{
+		MovementComponent = Cast<ULyraCharacterMovementComponent>(Character->GetCharacterMovement());
+	}
+}
+
+void FLyraAnimInstanceProxy::PreUpdate(UAnimInstance* InAnimInstance, float DeltaSeconds)
+{
+	Super::PreUpdate(InAnimInstance, DeltaSeconds);
+
+	if (LyraAnim::bThreadSafeUpdate)
+	{
+		GatherGameThreadState(CastChecked<ULyraAnimInstance>(InAnimInstance));
+	}
+}
+
+void FLyraAnimInstanceProxy::GatherGameThreadState(ULyraAnimInstance* AnimInstance)
+{
+	if (ULyraCharacterMovementComponent* CharMoveComp = MovementComponent.Get())
+	{
+		GroundDistance = CharMoveComp->GetGroundInfo().GroundDistance;
+		Velocity = CharMoveComp->Velocity;
+	}
+
+	if (AnimInstance->bGameplayTagsChanged)
+	{
+		AnimInstance->bGameplayTagsChanged = false;
+
+		GameplayTags.Reset();
+		if (const UAbilitySystemComponent* ASC = AnimInstance->AbilitySystemComponent.Get())
+		{
+			ASC->GetOwnedGameplayTags(GameplayTags);
+		}
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+// ULyraAnimInstance
+
 
 ULyraAnimInstance::ULyraAnimInstance(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
@@ -22,6 +82,30 @@ void ULyraAnimInstance::InitializeWithAbilitySystem(UAbilitySystemComponent* ASC
 	check(ASC);
 
 	GameplayTagPropertyMap.Initialize(this, ASC);
+
+	if (UAbilitySystemComponent* OldASC = AbilitySystemComponent.Get())
+	{
+		OldASC->RegisterGenericGameplayTagEvent().Remove(GameplayTagChangedHandle);
+	}
+
+	AbilitySystemComponent = ASC;
+	GameplayTagChangedHandle = ASC->RegisterGenericGameplayTagEvent().AddUObject(this, &ThisClass::OnGameplayTagChanged);
+	bGameplayTagsChanged = true;
+}
+
+void ULyraAnimInstance::OnGameplayTagChanged(const FGameplayTag Tag, int32 NewCount)
+{
+	bGameplayTagsChanged = true;
+}
+
+FVector ULyraAnimInstance::GetThreadSafeVelocity() const
+{
+	return GetProxyOnAnyThread<FLyraAnimInstanceProxy>().Velocity;
+}
+
+bool ULyraAnimInstance::HasThreadSafeGameplayTag(FGameplayTag Tag) const
+{
+	return GetProxyOnAnyThread<FLyraAnimInstanceProxy>().GameplayTags.HasTag(Tag);
 }
 
 #if WITH_EDITOR
@@ -52,6 +136,14 @@ void ULyraAnimInstance::NativeUpdateAnimation(float DeltaSeconds)
 {
 	Super::NativeUpdateAnimation(DeltaSeconds);
 
+	if (LyraAnim::bThreadSafeUpdate)
+	{
+		// Gathered by the proxy, applied in NativeThreadSafeUpdateAnimation
+		return;
+	}
+
+	GetProxyOnGameThread<FLyraAnimInstanceProxy>().GatherGameThreadState(this);
+
 	const ALyraCharacter* Character = Cast<ALyraCharacter>(GetOwningActor());
 	if (!Character)
 	{
@@ -63,3 +155,28 @@ void ULyraAnimInstance::NativeUpdateAnimation(float DeltaSeconds)
 	GroundDistance = GroundInfo.GroundDistance;
 }
 
+void ULyraAnimInstance::NativeThreadSafeUpdateAnimation(float DeltaSeconds)
+{
+	Super::NativeThreadSafeUpdateAnimation(DeltaSeconds);
+
+	if (LyraAnim::bThreadSafeUpdate)
+	{
+		GroundDistance = GetProxyOnAnyThread<FLyraAnimInstanceProxy>().GroundDistance;
+	}
+}
+
+void ULyraAnimInstance::BeginDestroy()
+{
+	if (UAbilitySystemComponent* ASC = AbilitySystemComponent.Get())
+	{
+		ASC->RegisterGenericGameplayTagEvent().Remove(GameplayTagChangedHandle);
+	}
+	AbilitySystemComponent.Reset();
+
+	Super::BeginDestroy();
+}
+
+FAnimInstanceProxy* ULyraAnimInstance::CreateAnimInstanceProxy()
+{
+	return new FLyraAnimInstanceProxy(this);
+}
@@ -3,19 +3,56 @@
 #pragma once
 
 #include "Animation/AnimInstance.h"
+#include "Animation/AnimInstanceProxy.h"
 #include "GameplayEffectTypes.h"
 #include "LyraAnimInstance.generated.h"
 
 class UAbilitySystemComponent;
+class ULyraCharacterMovementComponent;
+
+
+/**
+ * FLyraAnimInstanceProxy
+ *
+ *	Copies the game state ULyraAnimInstance needs on the game thread, before the animation update that may run on a worker thread.
+ */
+USTRUCT()
+struct FLyraAnimInstanceProxy : public FAnimInstanceProxy
+{
+	GENERATED_BODY()
+
+	FLyraAnimInstanceProxy() {}
+	FLyraAnimInstanceProxy(UAnimInstance* InAnimInstance) : FAnimInstanceProxy(InAnimInstance) {}
+
+	//~FAnimInstanceProxy interface
+	virtual void Initialize(UAnimInstance* InAnimInstance) override;
+	virtual void PreUpdate(UAnimInstance* InAnimInstance, float DeltaSeconds) override;
+	//~End of FAnimInstanceProxy interface
+
+	// Copies the state below, called on the game thread
+	void GatherGameThreadState(ULyraAnimInstance* AnimInstance);
+
+	// Game thread state, as of the start of this update
+	float GroundDistance = -1.0f;
+	FVector Velocity = FVector::ZeroVector;
+	FGameplayTagContainer GameplayTags;
+
+private:
+	TWeakObjectPtr<ULyraCharacterMovementComponent> MovementComponent;
+};
 
 
 /**
  * ULyraAnimInstance
  *
  *	The base game animation instance class used by this project.
+ *
+ *	The character's ground distance, velocity and gameplay tags are copied by FLyraAnimInstanceProxy on the game thread and applied
+ *	in NativeThreadSafeUpdateAnimation, so the animation update can run on a worker thread.  Lyra.Anim.ThreadSafeUpdate=0 reads
+ *	them in NativeUpdateAnimation on the game thread instead.
  */
 UCLASS(Config = Game)
-class ULyraAnimInstance : public UAnimInstance
+class LYRAGAME_API ULyraAnimInstance : public UAnimInstance
 {
 	GENERATED_BODY()
 
@@ -25,6 +62,14 @@ public:
 
 	virtual void InitializeWithAbilitySystem(UAbilitySystemComponent* ASC);
 
+	// Returns the owning character's velocity at the start of this update
+	UFUNCTION(BlueprintPure, Category = "Character State Data", meta = (BlueprintThreadSafe))
+	FVector GetThreadSafeVelocity() const;
+
+	// Returns whether the owner's ability system had a gameplay tag matching Tag at the start of this update
+	UFUNCTION(BlueprintPure, Category = "Character State Data", meta = (BlueprintThreadSafe))
+	bool HasThreadSafeGameplayTag(FGameplayTag Tag) const;
+
 protected:
 
 #if WITH_EDITOR
@@ -33,6 +78,12 @@ protected:
 
 	virtual void NativeInitializeAnimation() override;
 	virtual void NativeUpdateAnimation(float DeltaSeconds) override;
+	virtual void NativeThreadSafeUpdateAnimation(float DeltaSeconds) override;
+	virtual void BeginDestroy() override;
+
+	virtual FAnimInstanceProxy* CreateAnimInstanceProxy() override;
+
+	void OnGameplayTagChanged(const FGameplayTag Tag, int32 NewCount);
 
 protected:
 
@@ -43,4 +94,12 @@ protected:
 
 	UPROPERTY(BlueprintReadOnly, Category = "Character State Data")
 	float GroundDistance = -1.0f;
+
+private:
+	friend struct FLyraAnimInstanceProxy;
+
+	// The proxy only copies the gameplay tags after they changed
+	TWeakObjectPtr<UAbilitySystemComponent> AbilitySystemComponent;
+	FDelegateHandle GameplayTagChangedHandle;
+	bool bGameplayTagsChanged = true;
 };
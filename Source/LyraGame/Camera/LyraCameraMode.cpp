@@ -5,11 +5,25 @@
 #include "Components/CapsuleComponent.h"
 #include "Engine/Canvas.h"
 #include "GameFramework/Character.h"
+#include "HAL/IConsoleManager.h"
 #include "LyraCameraComponent.h"
 #include "LyraPlayerCameraManager.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(LyraCameraMode)
 
+namespace LyraCameraMode
+{
+	static bool bSkipUnchangedViews = true;
+	static FAutoConsoleVariableRef CVarSkipUnchangedViews(
+		TEXT("Lyra.Camera.SkipUnchangedViews"),
+		bSkipUnchangedViews,
+		TEXT("If true, camera modes only compute their view again when their pivot or view target changed."),
+		ECVF_Default);
+
+	// Modes whose contribution to the blended view is below this are removed from the stack
+	static constexpr float OccludedWeightThreshold = 1.e-4f;
+}
+
 
 //////////////////////////////////////////////////////////////////////////
 // FLyraCameraModeView
@@ -137,12 +151,40 @@ void ULyraCameraMode::UpdateView(float DeltaTime)
 
 	PivotRotation.Pitch = FMath::ClampAngle(PivotRotation.Pitch, ViewPitchMin, ViewPitchMax);
 
+	if (!HaveViewInputsChanged(PivotLocation, PivotRotation))
+	{
+		// View still holds the result for these inputs
+		return;
+	}
+
 	View.Location = PivotLocation;
 	View.Rotation = PivotRotation;
 	View.ControlRotation = View.Rotation;
 	View.FieldOfView = FieldOfView;
 }
 
+bool ULyraCameraMode::HaveViewInputsChanged(const FVector& PivotLocation, const FRotator& PivotRotation, const FVector& PivotOffset)
+{
+	const AActor* TargetActor = GetTargetActor();
+
+	// Everything the view is derived from, the field of view can be changed on a live mode, e.g., from the details panel
+	const bool bChanged = !LyraCameraMode::bSkipUnchangedViews || !bHasViewInputs || bResetInterpolation || (LastViewTarget.Get() != TargetActor) ||
+		!LastPivotLocation.Equals(PivotLocation, UE_KINDA_SMALL_NUMBER) || !LastPivotRotation.Equals(PivotRotation, UE_KINDA_SMALL_NUMBER) ||
+		!LastPivotOffset.Equals(PivotOffset, UE_KINDA_SMALL_NUMBER) || (LastFieldOfView != FieldOfView);
+
+	if (bChanged)
+	{
+		LastViewTarget = TargetActor;
+		LastPivotLocation = PivotLocation;
+		LastPivotRotation = PivotRotation;
+		LastPivotOffset = PivotOffset;
+		LastFieldOfView = FieldOfView;
+		bHasViewInputs = true;
+	}
+
+	return bChanged;
+}
+
 void ULyraCameraMode::SetBlendWeight(float Weight)
 {
 	BlendWeight = FMath::Clamp(Weight, 0.0f, 1.0f);
@@ -345,21 +387,15 @@ ULyraCameraMode* ULyraCameraModeStack::GetCameraModeInstance(TSubclassOf<ULyraCa
 	check(CameraModeClass);
 
 	// First see if we already created one.
-	for (ULyraCameraMode* CameraMode : CameraModeInstances)
+	TObjectPtr<ULyraCameraMode>& CameraMode = CameraModeInstances.FindOrAdd(CameraModeClass);
+	if (CameraMode == nullptr)
 	{
-		if ((CameraMode != nullptr) && (CameraMode->GetClass() == CameraModeClass))
-		{
-			return CameraMode;
-		}
+		// Not found, so we need to create it.
+		CameraMode = NewObject<ULyraCameraMode>(GetOuter(), CameraModeClass, NAME_None, RF_NoFlags);
+		check(CameraMode);
 	}
 
-	// Not found, so we need to create it.
-	ULyraCameraMode* NewCameraMode = NewObject<ULyraCameraMode>(GetOuter(), CameraModeClass, NAME_None, RF_NoFlags);
-	check(NewCameraMode);
-
-	CameraModeInstances.Add(NewCameraMode);
-
-	return NewCameraMode;
+	return CameraMode;
 }
 
 void ULyraCameraModeStack::UpdateStack(float DeltaTime)
@@ -373,6 +409,9 @@ void ULyraCameraModeStack::UpdateStack(float DeltaTime)
 	int32 RemoveCount = 0;
 	int32 RemoveIndex = INDEX_NONE;
 
+	// How much the modes below the current one still contribute to the blended view
+	float RemainingWeight = 1.0f;
+
 	for (int32 StackIndex = 0; StackIndex < StackSize; ++StackIndex)
 	{
 		ULyraCameraMode* CameraMode = CameraModeStack[StackIndex];
@@ -380,7 +419,9 @@ void ULyraCameraModeStack::UpdateStack(float DeltaTime)
 
 		CameraMode->UpdateCameraMode(DeltaTime);
 
-		if (CameraMode->GetBlendWeight() >= 1.0f)
+		RemainingWeight *= (1.0f - CameraMode->GetBlendWeight());
+
+		if ((CameraMode->GetBlendWeight() >= 1.0f) || (RemainingWeight <= LyraCameraMode::OccludedWeightThreshold))
 		{
 			// Everything below this mode is now irrelevant and can be removed.
 			RemoveIndex = (StackIndex + 1);
@@ -401,6 +442,9 @@ void ULyraCameraModeStack::UpdateStack(float DeltaTime)
 		}
 
 		CameraModeStack.RemoveAt(RemoveIndex, RemoveCount);
+
+		// The mode that occluded them is now the bottom of the stack, which is always weighted 100%.
+		CameraModeStack.Last()->SetBlendWeight(1.0f);
 	}
 }
 
@@ -106,6 +106,9 @@ protected:
 	virtual void UpdateView(float DeltaTime);
 	virtual void UpdateBlending(float DeltaTime);
 
+	// Returns true if the view has to be computed again, because the pivot, the offset from it, the field of view or the view target changed since it was last computed
+	bool HaveViewInputsChanged(const FVector& PivotLocation, const FRotator& PivotRotation, const FVector& PivotOffset = FVector::ZeroVector);
+
 protected:
 	// A tag that can be queried by gameplay code that cares when a kind of camera mode is active
 	// without having to ask about a specific mode (e.g., when aiming downsights to get more accuracy)
@@ -145,6 +148,14 @@ protected:
 	// Blend weight calculated using the blend alpha and function.
 	float BlendWeight;
 
+	// Inputs the view was last computed from.
+	TWeakObjectPtr<const AActor> LastViewTarget;
+	FVector LastPivotLocation = FVector::ZeroVector;
+	FRotator LastPivotRotation = FRotator::ZeroRotator;
+	FVector LastPivotOffset = FVector::ZeroVector;
+	float LastFieldOfView = 0.0f;
+	bool bHasViewInputs = false;
+
 protected:
 	/** If true, skips all interpolation and puts camera in ideal location.  Automatically set to false next frame. */
 	UPROPERTY(transient)
@@ -158,7 +169,7 @@ protected:
  *	Stack used for blending camera modes.
  */
 UCLASS()
-class ULyraCameraModeStack : public UObject
+class LYRAGAME_API ULyraCameraModeStack : public UObject
 {
 	GENERATED_BODY()
 
@@ -180,6 +191,8 @@ public:
 	// Gets the tag associated with the top layer and the blend weight of it
 	void GetBlendInfo(float& OutWeightOfTopLayer, FGameplayTag& OutTagOfTopLayer) const;
 
+	int32 GetStackSize() const { return CameraModeStack.Num(); }
+
 protected:
 
 	ULyraCameraMode* GetCameraModeInstance(TSubclassOf<ULyraCameraMode> CameraModeClass);
@@ -192,7 +205,7 @@ protected:
 	bool bIsActive;
 
 	UPROPERTY()
-	TArray<TObjectPtr<ULyraCameraMode>> CameraModeInstances;
+	TMap<TSubclassOf<ULyraCameraMode>, TObjectPtr<ULyraCameraMode>> CameraModeInstances;
 
 	UPROPERTY()
 	TArray<TObjectPtr<ULyraCameraMode>> CameraModeStack;
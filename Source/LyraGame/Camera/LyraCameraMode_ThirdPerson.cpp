@@ -6,19 +6,168 @@
 #include "Camera/LyraPenetrationAvoidanceFeeler.h"
 #include "Curves/CurveVector.h"
 #include "Engine/Canvas.h"
+#include "Engine/World.h"
 #include "GameFramework/CameraBlockingVolume.h"
 #include "LyraCameraAssistInterface.h"
 #include "GameFramework/Controller.h"
 #include "GameFramework/Character.h"
-#include "Math/RotationMatrix.h"
+#include "HAL/IConsoleManager.h"
+#include "UObject/ObjectKey.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(LyraCameraMode_ThirdPerson)
 
 namespace LyraCameraMode_ThirdPerson_Statics
 {
 	static const FName NAME_IgnoreCameraCollision = TEXT("IgnoreCameraCollision");
+
+	static bool bUseAsyncPenetrationTraces = true;
+	static FAutoConsoleVariableRef CVarUseAsyncPenetrationTraces(
+		TEXT("Lyra.Camera.Penetration.UseAsyncTraces"),
+		bUseAsyncPenetrationTraces,
+		TEXT("If true, predictive camera penetration feelers are swept as async traces and their results are used on the next frame. The main feeler is always swept right away."),
+		ECVF_Default);
+
+	static int32 MaxPenetrationTracesPerFrame = 24;
+	static FAutoConsoleVariableRef CVarMaxPenetrationTracesPerFrame(
+		TEXT("Lyra.Camera.Penetration.MaxTracesPerFrame"),
+		MaxPenetrationTracesPerFrame,
+		TEXT("Async predictive camera penetration feeler sweeps all cameras in a world may start per frame, when Lyra.Camera.Penetration.UseAsyncTraces is on. 0 or less for no limit."),
+		ECVF_Default);
+
+	// Shared by every third person camera in a world, so split screen players and spectators don't each get a full budget
+	static TMap<TObjectKey<UWorld>, FLyraCameraTraceBudget> PenetrationTraceBudgets;
+
+	static FLyraCameraTraceBudget& GetPenetrationTraceBudget(const UWorld* World)
+	{
+		static FDelegateHandle WorldCleanupHandle = FWorldDelegates::OnWorldCleanup.AddLambda([](UWorld* CleanedUpWorld, bool /*bSessionEnded*/, bool /*bCleanupResources*/)
+		{
+			PenetrationTraceBudgets.Remove(CleanedUpWorld);
+		});
+
+		FLyraCameraTraceBudget& Budget = PenetrationTraceBudgets.FindOrAdd(World);
+		Budget.MaxTracesPerFrame = MaxPenetrationTracesPerFrame;
+		return Budget;
+	}
 }
 
+// Sweeps the penetration feelers of a third person camera against the world
+class FLyraCameraModeThirdPersonTracer : public ILyraCameraPenetrationTracer
+{
+public:
+	FLyraCameraModeThirdPersonTracer(ULyraCameraMode_ThirdPerson& InCameraMode, const AActor& InViewTarget)
+		: CameraMode(InCameraMode)
+		, ViewTarget(InViewTarget)
+		, World(InCameraMode.GetWorld())
+		, SphereParams(SCENE_QUERY_STAT(CameraPen), false, nullptr/*PlayerCamera*/)
+	{
+		SphereParams.AddIgnoredActor(&ViewTarget);
+
+		//TODO ILyraCameraTarget.GetIgnoredActorsForCameraPentration();
+		//if (IgnoreActorForCameraPenetration)
+		//{
+		//	SphereParams.AddIgnoredActor(IgnoreActorForCameraPenetration);
+		//}
+	}
+
+	virtual FLyraCameraPenetrationHit SweepFeeler(const FVector& Start, const FVector& End, float Radius) override
+	{
+		// MT-> passing camera as actor so that camerablockingvolumes know when it's the camera doing traces
+		FHitResult Hit;
+		const bool bHit = World->SweepSingleByChannel(Hit, Start, End, FQuat::Identity, TraceChannel, FCollisionShape::MakeSphere(Radius), SphereParams);
+		return ResolveHit(Start, End, Radius, bHit ? &Hit : nullptr);
+	}
+
+	virtual FTraceHandle StartAsyncSweepFeeler(const FVector& Start, const FVector& End, float Radius) override
+	{
+		return World->AsyncSweepByChannel(EAsyncTraceType::Single, Start, End, FQuat::Identity, TraceChannel, FCollisionShape::MakeSphere(Radius), SphereParams);
+	}
+
+	virtual bool GetAsyncSweepResult(const FTraceHandle& Handle, FLyraCameraPenetrationHit& OutHit) override
+	{
+		FTraceDatum TraceData;
+		if (!World->QueryTraceData(Handle, TraceData))
+		{
+			return false;
+		}
+
+		const FHitResult* Hit = ((TraceData.OutHits.Num() > 0) && TraceData.OutHits[0].bBlockingHit) ? &TraceData.OutHits[0] : nullptr;
+		OutHit = ResolveHit(TraceData.Start, TraceData.End, TraceData.CollisionParams.CollisionShape.GetSphereRadius(), Hit);
+		return true;
+	}
+
+private:
+	FLyraCameraPenetrationHit ResolveHit(const FVector& Start, const FVector& End, float Radius, const FHitResult* Hit)
+	{
+#if ENABLE_DRAW_DEBUG
+		if (World->TimeSince(CameraMode.LastDrawDebugTime) < 1.f)
+		{
+			DrawDebugSphere(World, Start, Radius, 8, FColor::Red);
+			DrawDebugSphere(World, Hit ? Hit->Location : End, Radius, 8, FColor::Red);
+			DrawDebugLine(World, Start, Hit ? Hit->Location : End, FColor::Red);
+		}
+#endif // ENABLE_DRAW_DEBUG
+
+		FLyraCameraPenetrationHit Result;
+
+		const AActor* HitActor = Hit ? Hit->GetActor() : nullptr;
+		if (HitActor == nullptr)
+		{
+			return Result;
+		}
+
+		bool bIgnoreHit = false;
+
+		if (HitActor->ActorHasTag(LyraCameraMode_ThirdPerson_Statics::NAME_IgnoreCameraCollision))
+		{
+			bIgnoreHit = true;
+			SphereParams.AddIgnoredActor(HitActor);
+		}
+
+		// Ignore CameraBlockingVolume hits that occur in front of the ViewTarget.
+		if (!bIgnoreHit && HitActor->IsA<ACameraBlockingVolume>())
+		{
+			const FVector ViewTargetForwardXY = ViewTarget.GetActorForwardVector().GetSafeNormal2D();
+			const FVector ViewTargetLocation = ViewTarget.GetActorLocation();
+			const FVector HitOffset = Hit->Location - ViewTargetLocation;
+			const FVector HitDirectionXY = HitOffset.GetSafeNormal2D();
+			const float DotHitDirection = FVector::DotProduct(ViewTargetForwardXY, HitDirectionXY);
+			if (DotHitDirection > 0.0f)
+			{
+				bIgnoreHit = true;
+				// Ignore this CameraBlockingVolume on the remaining sweeps.
+				SphereParams.AddIgnoredActor(HitActor);
+			}
+			else
+			{
+#if ENABLE_DRAW_DEBUG
+				CameraMode.DebugActorsHitDuringCameraPenetration.AddUnique(TObjectPtr<const AActor>(HitActor));
+#endif
+			}
+		}
+
+		if (!bIgnoreHit)
+		{
+			Result.bBlocked = true;
+			Result.Location = Hit->Location;
+
+#if ENABLE_DRAW_DEBUG
+			CameraMode.DebugActorsHitDuringCameraPenetration.AddUnique(TObjectPtr<const AActor>(HitActor));
+#endif
+		}
+
+		return Result;
+	}
+
+	// cast for world and pawn hits separately.  this is so we can safely ignore the
+	// camera's target pawn
+	static constexpr ECollisionChannel TraceChannel = ECC_Camera;		//(Feeler.PawnWeight > 0.f) ? ECC_Pawn : ECC_Camera;
+
+	ULyraCameraMode_ThirdPerson& CameraMode;
+	const AActor& ViewTarget;
+	UWorld* World;
+	FCollisionQueryParams SphereParams;
+};
+
 ULyraCameraMode_ThirdPerson::ULyraCameraMode_ThirdPerson()
 {
 	TargetOffsetCurve = nullptr;
@@ -42,32 +191,39 @@ void ULyraCameraMode_ThirdPerson::UpdateView(float DeltaTime)
 
 	PivotRotation.Pitch = FMath::ClampAngle(PivotRotation.Pitch, ViewPitchMin, ViewPitchMax);
 
-	View.Location = PivotLocation;
-	View.Rotation = PivotRotation;
-	View.ControlRotation = View.Rotation;
-	View.FieldOfView = FieldOfView;
-
 	// Apply third person offset using pitch.
+	FVector TargetOffset(0.0f);
 	if (!bUseRuntimeFloatCurves)
 	{
 		if (TargetOffsetCurve)
 		{
-			const FVector TargetOffset = TargetOffsetCurve->GetVectorValue(PivotRotation.Pitch);
-			View.Location = PivotLocation + PivotRotation.RotateVector(TargetOffset);
+			TargetOffset = TargetOffsetCurve->GetVectorValue(PivotRotation.Pitch);
 		}
 	}
 	else
 	{
-		FVector TargetOffset(0.0f);
-
 		TargetOffset.X = TargetOffsetX.GetRichCurveConst()->Eval(PivotRotation.Pitch);
 		TargetOffset.Y = TargetOffsetY.GetRichCurveConst()->Eval(PivotRotation.Pitch);
 		TargetOffset.Z = TargetOffsetZ.GetRichCurveConst()->Eval(PivotRotation.Pitch);
+	}
 
+	// The crouch offset is part of the pivot and the target offset is compared too, so edited curves are picked up
+	if (HaveViewInputsChanged(PivotLocation, PivotRotation, TargetOffset))
+	{
 		View.Location = PivotLocation + PivotRotation.RotateVector(TargetOffset);
+		View.Rotation = PivotRotation;
+		View.ControlRotation = View.Rotation;
+		View.FieldOfView = FieldOfView;
+
+		DesiredViewLocation = View.Location;
+	}
+	else
+	{
+		// Penetration avoidance moved the view last frame, start again from where the camera wants to be
+		View.Location = DesiredViewLocation;
 	}
 
-	// Adjust final desired camera location to prevent any penetration
+	// Adjust final desired camera location to prevent any penetration, every frame since the world around the camera can change
 	UpdatePreventPenetration(DeltaTime);
 }
 
@@ -176,177 +332,18 @@ void ULyraCameraMode_ThirdPerson::PreventCameraPenetration(class AActor const& V
 	DebugActorsHitDuringCameraPenetration.Reset();
 #endif
 
-	float HardBlockedPct = DistBlockedPct;
-	float SoftBlockedPct = DistBlockedPct;
-
-	FVector BaseRay = CameraLoc - SafeLoc;
-	FRotationMatrix BaseRayMatrix(BaseRay.Rotation());
-	FVector BaseRayLocalUp, BaseRayLocalFwd, BaseRayLocalRight;
-
-	BaseRayMatrix.GetScaledAxes(BaseRayLocalFwd, BaseRayLocalRight, BaseRayLocalUp);
-
-	float DistBlockedPctThisFrame = 1.f;
-
-	int32 const NumRaysToShoot = bSingleRayOnly ? FMath::Min(1, PenetrationAvoidanceFeelers.Num()) : PenetrationAvoidanceFeelers.Num();
-	FCollisionQueryParams SphereParams(SCENE_QUERY_STAT(CameraPen), false, nullptr/*PlayerCamera*/);
-
-	SphereParams.AddIgnoredActor(&ViewTarget);
-
-	//TODO ILyraCameraTarget.GetIgnoredActorsForCameraPentration();
-	//if (IgnoreActorForCameraPenetration)
-	//{
-	//	SphereParams.AddIgnoredActor(IgnoreActorForCameraPenetration);
-	//}
-
-	FCollisionShape SphereShape = FCollisionShape::MakeSphere(0.f);
-	UWorld* World = GetWorld();
-
-	for (int32 RayIdx = 0; RayIdx < NumRaysToShoot; ++RayIdx)
-	{
-		FLyraPenetrationAvoidanceFeeler& Feeler = PenetrationAvoidanceFeelers[RayIdx];
-		if (Feeler.FramesUntilNextTrace <= 0)
-		{
-			// calc ray target
-			FVector RayTarget;
-			{
-				FVector RotatedRay = BaseRay.RotateAngleAxis(Feeler.AdjustmentRot.Yaw, BaseRayLocalUp);
-				RotatedRay = RotatedRay.RotateAngleAxis(Feeler.AdjustmentRot.Pitch, BaseRayLocalRight);
-				RayTarget = SafeLoc + RotatedRay;
-			}
-
-			// cast for world and pawn hits separately.  this is so we can safely ignore the 
-			// camera's target pawn
-			SphereShape.Sphere.Radius = Feeler.Extent;
-			ECollisionChannel TraceChannel = ECC_Camera;		//(Feeler.PawnWeight > 0.f) ? ECC_Pawn : ECC_Camera;
-
-			// do multi-line check to make sure the hits we throw out aren't
-			// masking real hits behind (these are important rays).
-
-			// MT-> passing camera as actor so that camerablockingvolumes know when it's the camera doing traces
-			FHitResult Hit;
-			const bool bHit = World->SweepSingleByChannel(Hit, SafeLoc, RayTarget, FQuat::Identity, TraceChannel, SphereShape, SphereParams);
-#if ENABLE_DRAW_DEBUG
-			if (World->TimeSince(LastDrawDebugTime) < 1.f)
-			{
-				DrawDebugSphere(World, SafeLoc, SphereShape.Sphere.Radius, 8, FColor::Red);
-				DrawDebugSphere(World, bHit ? Hit.Location : RayTarget, SphereShape.Sphere.Radius, 8, FColor::Red);
-				DrawDebugLine(World, SafeLoc, bHit ? Hit.Location : RayTarget, FColor::Red);
-			}
-#endif // ENABLE_DRAW_DEBUG
-
-			Feeler.FramesUntilNextTrace = Feeler.TraceInterval;
-
-			const AActor* HitActor = Hit.GetActor();
-
-			if (bHit && HitActor)
-			{
-				bool bIgnoreHit = false;
-
-				if (HitActor->ActorHasTag(LyraCameraMode_ThirdPerson_Statics::NAME_IgnoreCameraCollision))
-				{
-					bIgnoreHit = true;
-					SphereParams.AddIgnoredActor(HitActor);
-				}
-
-				// Ignore CameraBlockingVolume hits that occur in front of the ViewTarget.
-				if (!bIgnoreHit && HitActor->IsA<ACameraBlockingVolume>())
-				{
-					const FVector ViewTargetForwardXY = ViewTarget.GetActorForwardVector().GetSafeNormal2D();
-					const FVector ViewTargetLocation = ViewTarget.GetActorLocation();
-					const FVector HitOffset = Hit.Location - ViewTargetLocation;
-					const FVector HitDirectionXY = HitOffset.GetSafeNormal2D();
-					const float DotHitDirection = FVector::DotProduct(ViewTargetForwardXY, HitDirectionXY);
-					if (DotHitDirection > 0.0f)
-					{
-						bIgnoreHit = true;
-						// Ignore this CameraBlockingVolume on the remaining sweeps.
-						SphereParams.AddIgnoredActor(HitActor);
-					}
-					else
-					{
-#if ENABLE_DRAW_DEBUG
-						DebugActorsHitDuringCameraPenetration.AddUnique(TObjectPtr<const AActor>(HitActor));
-#endif
-					}
-				}
-				
-				if (!bIgnoreHit)
-				{
-					float const Weight = Cast<APawn>(Hit.GetActor()) ? Feeler.PawnWeight : Feeler.WorldWeight;
-					float NewBlockPct = Hit.Time;
-					NewBlockPct += (1.f - NewBlockPct) * (1.f - Weight);
-
-					// Recompute blocked pct taking into account pushout distance.
-					NewBlockPct = ((Hit.Location - SafeLoc).Size() - CollisionPushOutDistance) / (RayTarget - SafeLoc).Size();
-					DistBlockedPctThisFrame = FMath::Min(NewBlockPct, DistBlockedPctThisFrame);
+	FLyraCameraPenetrationSettings Settings;
+	Settings.PenetrationBlendInTime = PenetrationBlendInTime;
+	Settings.PenetrationBlendOutTime = PenetrationBlendOutTime;
+	Settings.CollisionPushOutDistance = CollisionPushOutDistance;
+	Settings.bResetInterpolation = bResetInterpolation;
+	Settings.bSingleRayOnly = bSingleRayOnly;
+	Settings.bUseAsyncTraces = LyraCameraMode_ThirdPerson_Statics::bUseAsyncPenetrationTraces;
 
-					// This feeler got a hit, so do another trace next frame
-					Feeler.FramesUntilNextTrace = 0;
+	FLyraCameraTraceBudget& TraceBudget = LyraCameraMode_ThirdPerson_Statics::GetPenetrationTraceBudget(GetWorld());
 
-#if ENABLE_DRAW_DEBUG
-					DebugActorsHitDuringCameraPenetration.AddUnique(TObjectPtr<const AActor>(HitActor));
-#endif
-				}
-			}
-
-			if (RayIdx == 0)
-			{
-				// don't interpolate toward this one, snap to it
-				// assumes ray 0 is the center/main ray 
-				HardBlockedPct = DistBlockedPctThisFrame;
-			}
-			else
-			{
-				SoftBlockedPct = DistBlockedPctThisFrame;
-			}
-		}
-		else
-		{
-			--Feeler.FramesUntilNextTrace;
-		}
-	}
-
-	if (bResetInterpolation)
-	{
-		DistBlockedPct = DistBlockedPctThisFrame;
-	}
-	else if (DistBlockedPct < DistBlockedPctThisFrame)
-	{
-		// interpolate smoothly out
-		if (PenetrationBlendOutTime > DeltaTime)
-		{
-			DistBlockedPct = DistBlockedPct + DeltaTime / PenetrationBlendOutTime * (DistBlockedPctThisFrame - DistBlockedPct);
-		}
-		else
-		{
-			DistBlockedPct = DistBlockedPctThisFrame;
-		}
-	}
-	else
-	{
-		if (DistBlockedPct > HardBlockedPct)
-		{
-			DistBlockedPct = HardBlockedPct;
-		}
-		else if (DistBlockedPct > SoftBlockedPct)
-		{
-			// interpolate smoothly in
-			if (PenetrationBlendInTime > DeltaTime)
-			{
-				DistBlockedPct = DistBlockedPct - DeltaTime / PenetrationBlendInTime * (DistBlockedPct - SoftBlockedPct);
-			}
-			else
-			{
-				DistBlockedPct = SoftBlockedPct;
-			}
-		}
-	}
-
-	DistBlockedPct = FMath::Clamp<float>(DistBlockedPct, 0.f, 1.f);
-	if (DistBlockedPct < (1.f - ZERO_ANIMWEIGHT_THRESH))
-	{
-		CameraLoc = SafeLoc + (CameraLoc - SafeLoc) * DistBlockedPct;
-	}
+	FLyraCameraModeThirdPersonTracer Tracer(*this, ViewTarget);
+	PenetrationSolver.Update(PenetrationAvoidanceFeelers, SafeLoc, CameraLoc, DeltaTime, DistBlockedPct, Settings, Tracer, TraceBudget, GFrameCounter);
 }
 
 void ULyraCameraMode_ThirdPerson::SetTargetCrouchOffset(FVector NewTargetOffset)
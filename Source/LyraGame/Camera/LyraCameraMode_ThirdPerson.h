@@ -4,6 +4,7 @@
 
 #include "LyraCameraMode.h"
 #include "Curves/CurveFloat.h"
+#include "LyraCameraPenetration.h"
 #include "LyraPenetrationAvoidanceFeeler.h"
 #include "DrawDebugHelpers.h"
 #include "LyraCameraMode_ThirdPerson.generated.h"
@@ -97,6 +98,9 @@ public:
 	UPROPERTY(Transient)
 	TArray<TObjectPtr<const AActor>> DebugActorsHitDuringCameraPenetration;
 
+	// Runs the feeler sweeps, keeping track of the async sweeps started on the previous frame
+	FLyraCameraPenetrationSolver PenetrationSolver;
+
 #if ENABLE_DRAW_DEBUG
 	mutable float LastDrawDebugTime = -MAX_FLT;
 #endif
@@ -110,5 +114,8 @@ protected:
 	FVector TargetCrouchOffset = FVector::ZeroVector;
 	float CrouchOffsetBlendPct = 1.0f;
 	FVector CurrentCrouchOffset = FVector::ZeroVector;
+
+	// View location from the target offset, before penetration avoidance moved it
+	FVector DesiredViewLocation = FVector::ZeroVector;
 	
 };
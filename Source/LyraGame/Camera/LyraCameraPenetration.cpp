@@ -0,0 +1,203 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Camera/LyraCameraPenetration.h"
+
+#include "Animation/AnimTypes.h"
+#include "Math/RotationMatrix.h"
+
+//////////////////////////////////////////////////////////////////////
+
+void FLyraCameraTraceBudget::BeginFrame(uint64 FrameNumber)
+{
+	if (Frame != FrameNumber)
+	{
+		Frame = FrameNumber;
+		NumTraces = 0;
+	}
+}
+
+bool FLyraCameraTraceBudget::TryConsume(uint64 FrameNumber)
+{
+	BeginFrame(FrameNumber);
+
+	if ((MaxTracesPerFrame > 0) && (NumTraces >= MaxTracesPerFrame))
+	{
+		return false;
+	}
+
+	++NumTraces;
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////
+
+void FLyraCameraPenetrationSolver::Reset()
+{
+	FeelerStates.Reset();
+}
+
+void FLyraCameraPenetrationSolver::Update(TArrayView<FLyraPenetrationAvoidanceFeeler> Feelers, const FVector& SafeLoc, FVector& CameraLoc, float DeltaTime, float& DistBlockedPct,
+	const FLyraCameraPenetrationSettings& Settings, ILyraCameraPenetrationTracer& Tracer, FLyraCameraTraceBudget& Budget, uint64 FrameNumber)
+{
+	float HardBlockedPct = DistBlockedPct;
+	float SoftBlockedPct = DistBlockedPct;
+
+	FVector BaseRay = CameraLoc - SafeLoc;
+	FRotationMatrix BaseRayMatrix(BaseRay.Rotation());
+	FVector BaseRayLocalUp, BaseRayLocalFwd, BaseRayLocalRight;
+
+	BaseRayMatrix.GetScaledAxes(BaseRayLocalFwd, BaseRayLocalRight, BaseRayLocalUp);
+
+	float DistBlockedPctThisFrame = 1.f;
+
+	int32 const NumRaysToShoot = Settings.bSingleRayOnly ? FMath::Min(1, Feelers.Num()) : Feelers.Num();
+
+	FeelerStates.SetNum(Feelers.Num());
+
+	for (int32 RayIdx = 0; RayIdx < NumRaysToShoot; ++RayIdx)
+	{
+		FLyraPenetrationAvoidanceFeeler& Feeler = Feelers[RayIdx];
+		FFeelerState& FeelerState = FeelerStates[RayIdx];
+		const bool bMainFeeler = (RayIdx == 0);
+
+		// calc ray target
+		FVector RayTarget;
+		{
+			FVector RotatedRay = BaseRay.RotateAngleAxis(Feeler.AdjustmentRot.Yaw, BaseRayLocalUp);
+			RotatedRay = RotatedRay.RotateAngleAxis(Feeler.AdjustmentRot.Pitch, BaseRayLocalRight);
+			RayTarget = SafeLoc + RotatedRay;
+		}
+
+		FLyraCameraPenetrationHit Hit;
+		bool bHasResult = false;
+		bool bResultFromCurrentRay = false;
+
+		if (Settings.bUseAsyncTraces && !bMainFeeler)
+		{
+			// Pick up the sweep started last frame
+			if (FeelerState.PendingTrace.IsValid())
+			{
+				bHasResult = Tracer.GetAsyncSweepResult(FeelerState.PendingTrace, /*out*/ Hit);
+				FeelerState.PendingTrace.Invalidate();
+			}
+
+			// This feeler got a hit, so do another trace
+			if (bHasResult && Hit.bBlocked)
+			{
+				Feeler.FramesUntilNextTrace = 0;
+			}
+
+			if (Feeler.FramesUntilNextTrace <= 0)
+			{
+				// Out of budget, the feeler stays due and tries again next frame
+				if (Budget.TryConsume(FrameNumber))
+				{
+					FeelerState.PendingTrace = Tracer.StartAsyncSweepFeeler(SafeLoc, RayTarget, Feeler.Extent);
+					++NumAsyncTraces;
+
+					Feeler.FramesUntilNextTrace = Feeler.TraceInterval;
+				}
+			}
+			else
+			{
+				--Feeler.FramesUntilNextTrace;
+			}
+		}
+		else
+		{
+			// The main feeler snaps the camera in, so it is always swept right away and never held back by the budget
+			if (Feeler.FramesUntilNextTrace <= 0)
+			{
+				Hit = Tracer.SweepFeeler(SafeLoc, RayTarget, Feeler.Extent);
+				++NumSyncTraces;
+				bHasResult = true;
+				bResultFromCurrentRay = true;
+
+				// This feeler got a hit, so do another trace next frame
+				Feeler.FramesUntilNextTrace = Hit.bBlocked ? 0 : Feeler.TraceInterval;
+			}
+			else
+			{
+				--Feeler.FramesUntilNextTrace;
+			}
+		}
+
+		if (!bHasResult)
+		{
+			continue;
+		}
+
+		if (Hit.bBlocked)
+		{
+			float NewBlockPct;
+			if (bResultFromCurrentRay)
+			{
+				// Recompute blocked pct taking into account pushout distance.
+				NewBlockPct = ((Hit.Location - SafeLoc).Size() - Settings.CollisionPushOutDistance) / (RayTarget - SafeLoc).Size();
+			}
+			else
+			{
+				// The sweep started last frame, predict where the obstruction is along the current ray
+				const FVector Ray = RayTarget - SafeLoc;
+				const float RayLength = Ray.Size();
+				const float HitDistance = FMath::Max(0.0f, static_cast<float>(FVector::DotProduct(Hit.Location - SafeLoc, Ray.GetSafeNormal())));
+				NewBlockPct = (RayLength > UE_KINDA_SMALL_NUMBER) ? ((HitDistance - Settings.CollisionPushOutDistance) / RayLength) : 0.0f;
+			}
+
+			DistBlockedPctThisFrame = FMath::Min(NewBlockPct, DistBlockedPctThisFrame);
+		}
+
+		if (bMainFeeler)
+		{
+			// don't interpolate toward this one, snap to it
+			// assumes ray 0 is the center/main ray
+			HardBlockedPct = DistBlockedPctThisFrame;
+		}
+		else
+		{
+			SoftBlockedPct = DistBlockedPctThisFrame;
+		}
+	}
+
+	if (Settings.bResetInterpolation)
+	{
+		DistBlockedPct = DistBlockedPctThisFrame;
+	}
+	else if (DistBlockedPct < DistBlockedPctThisFrame)
+	{
+		// interpolate smoothly out
+		if (Settings.PenetrationBlendOutTime > DeltaTime)
+		{
+			DistBlockedPct = DistBlockedPct + DeltaTime / Settings.PenetrationBlendOutTime * (DistBlockedPctThisFrame - DistBlockedPct);
+		}
+		else
+		{
+			DistBlockedPct = DistBlockedPctThisFrame;
+		}
+	}
+	else
+	{
+		if (DistBlockedPct > HardBlockedPct)
+		{
+			DistBlockedPct = HardBlockedPct;
+		}
+		else if (DistBlockedPct > SoftBlockedPct)
+		{
+			// interpolate smoothly in
+			if (Settings.PenetrationBlendInTime > DeltaTime)
+			{
+				DistBlockedPct = DistBlockedPct - DeltaTime / Settings.PenetrationBlendInTime * (DistBlockedPct - SoftBlockedPct);
+			}
+			else
+			{
+				DistBlockedPct = SoftBlockedPct;
+			}
+		}
+	}
+
+	DistBlockedPct = FMath::Clamp<float>(DistBlockedPct, 0.f, 1.f);
+	if (DistBlockedPct < (1.f - ZERO_ANIMWEIGHT_THRESH))
+	{
+		CameraLoc = SafeLoc + (CameraLoc - SafeLoc) * DistBlockedPct;
+	}
+}
@@ -0,0 +1,109 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Camera/LyraPenetrationAvoidanceFeeler.h"
+#include "WorldCollision.h"
+
+/** Result of a feeler sweep, after the tracer applied its ignore rules */
+struct FLyraCameraPenetrationHit
+{
+	bool bBlocked = false;
+
+	// Location of the sweep shape when it was blocked
+	FVector Location = FVector::ZeroVector;
+};
+
+/** Performs the feeler sweeps for FLyraCameraPenetrationSolver */
+class ILyraCameraPenetrationTracer
+{
+public:
+	virtual ~ILyraCameraPenetrationTracer() = default;
+
+	/** Sweeps a sphere from Start to End right away */
+	virtual FLyraCameraPenetrationHit SweepFeeler(const FVector& Start, const FVector& End, float Radius) = 0;
+
+	/** Starts a sweep whose result can be fetched with GetAsyncSweepResult from the next frame on */
+	virtual FTraceHandle StartAsyncSweepFeeler(const FVector& Start, const FVector& End, float Radius) = 0;
+
+	/** Returns false if the result of the sweep isn't available (not finished yet, or too old) */
+	virtual bool GetAsyncSweepResult(const FTraceHandle& Handle, FLyraCameraPenetrationHit& OutHit) = 0;
+};
+
+/**
+ * FLyraCameraTraceBudget
+ *
+ * Caps the number of async predictive feeler sweeps the cameras sharing it start per frame, ULyraCameraMode_ThirdPerson shares
+ * one per world. The main feeler is swept synchronously and isn't counted, and the synchronous path doesn't use the budget at all.
+ */
+struct LYRAGAME_API FLyraCameraTraceBudget
+{
+	/** Returns true and consumes a trace if there is budget left for FrameNumber */
+	bool TryConsume(uint64 FrameNumber);
+
+	int32 GetNumTraces(uint64 FrameNumber) const { return (Frame == FrameNumber) ? NumTraces : 0; }
+
+	// Traces allowed per frame, 0 or less for no limit
+	int32 MaxTracesPerFrame = 0;
+
+private:
+	void BeginFrame(uint64 FrameNumber);
+
+	uint64 Frame = 0;
+	int32 NumTraces = 0;
+};
+
+struct FLyraCameraPenetrationSettings
+{
+	float PenetrationBlendInTime = 0.1f;
+	float PenetrationBlendOutTime = 0.15f;
+	float CollisionPushOutDistance = 2.0f;
+
+	// Snap to the blocked distance instead of blending
+	bool bResetInterpolation = false;
+
+	// Only sweep the main feeler
+	bool bSingleRayOnly = false;
+
+	// Start the predictive feeler sweeps as async traces and use their results on the next frame
+	bool bUseAsyncTraces = false;
+};
+
+/**
+ * FLyraCameraPenetrationSolver
+ *
+ * Moves a camera in along the line from a safe location inside the view target so it doesn't end up inside the world, using a set
+ * of feeler sweeps. The main feeler snaps the camera in, the other feelers predict nearby obstructions and blend it in smoothly.
+ *
+ * With async traces a predictive feeler's sweep is started on one frame and used on the next, within the trace budget it is given. The
+ * blocked distance is predicted for the current ray by projecting the hit location onto it, so a camera that moved a little since the
+ * sweep started still stops at the obstruction. The main feeler is always swept synchronously, so the camera never clips into walls.
+ */
+class LYRAGAME_API FLyraCameraPenetrationSolver
+{
+public:
+	/**
+	 * Updates DistBlockedPct and pulls CameraLoc in towards SafeLoc.
+	 * Feelers holds the feeler rays with their trace intervals, the first one being the main feeler.
+	 */
+	void Update(TArrayView<FLyraPenetrationAvoidanceFeeler> Feelers, const FVector& SafeLoc, FVector& CameraLoc, float DeltaTime, float& DistBlockedPct,
+		const FLyraCameraPenetrationSettings& Settings, ILyraCameraPenetrationTracer& Tracer, FLyraCameraTraceBudget& Budget, uint64 FrameNumber);
+
+	/** Forgets pending async sweeps, e.g., when the view target changed */
+	void Reset();
+
+	// Sweeps done on the calling thread and async sweeps started, since the solver was created
+	int32 GetNumSyncTraces() const { return NumSyncTraces; }
+	int32 GetNumAsyncTraces() const { return NumAsyncTraces; }
+
+private:
+	struct FFeelerState
+	{
+		FTraceHandle PendingTrace;
+	};
+
+	TArray<FFeelerState> FeelerStates;
+
+	int32 NumSyncTraces = 0;
+	int32 NumAsyncTraces = 0;
+};
@@ -7,6 +7,8 @@
 #include "Components/CapsuleComponent.h"
 #include "Engine/World.h"
 #include "GameFramework/Character.h"
+#include "HAL/IConsoleManager.h"
+#include "UObject/ObjectKey.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(LyraCharacterMovementComponent)
 
@@ -16,6 +18,59 @@ namespace LyraCharacter
 {
 	static float GroundTraceDistance = 100000.0f;
 	FAutoConsoleVariableRef CVar_GroundTraceDistance(TEXT("LyraCharacter.GroundTraceDistance"), GroundTraceDistance, TEXT("Distance to trace down when generating ground information."), ECVF_Cheat);
+
+	static bool bUseAsyncGroundTraces = true;
+	FAutoConsoleVariableRef CVar_UseAsyncGroundTraces(TEXT("LyraCharacter.GroundInfo.UseAsyncTraces"), bUseAsyncGroundTraces, TEXT("Should ground info be found with short async traces and predicted in between, instead of a full length trace every frame?"), ECVF_Default);
+
+	static float GroundTraceLookaheadTime = 1.0f;
+	FAutoConsoleVariableRef CVar_GroundTraceLookaheadTime(TEXT("LyraCharacter.GroundInfo.LookaheadTime"), GroundTraceLookaheadTime, TEXT("Async ground traces are long enough to cover how far the character falls in this many seconds."), ECVF_Default);
+
+	static float MinGroundTraceDistance = 500.0f;
+	FAutoConsoleVariableRef CVar_MinGroundTraceDistance(TEXT("LyraCharacter.GroundInfo.MinTraceDistance"), MinGroundTraceDistance, TEXT("Shortest distance an async ground trace goes below the capsule."), ECVF_Default);
+
+	static float MaxGroundDrift = 50.0f;
+	FAutoConsoleVariableRef CVar_MaxGroundDrift(TEXT("LyraCharacter.GroundInfo.MaxHorizontalDrift"), MaxGroundDrift, TEXT("How far the character may move horizontally from where the ground was last traced before it is traced again."), ECVF_Default);
+
+	static float GroundTraceInterval = 0.1f;
+	FAutoConsoleVariableRef CVar_GroundTraceInterval(TEXT("LyraCharacter.GroundInfo.TraceInterval"), GroundTraceInterval, TEXT("Seconds between ground traces of locally controlled or recently rendered characters that haven't moved enough to need one sooner."), ECVF_Default);
+
+	static float InsignificantGroundTraceInterval = 0.5f;
+	FAutoConsoleVariableRef CVar_InsignificantGroundTraceInterval(TEXT("LyraCharacter.GroundInfo.InsignificantTraceInterval"), InsignificantGroundTraceInterval, TEXT("Seconds between ground traces of other characters that haven't moved enough to need one sooner."), ECVF_Default);
+
+	static int32 MaxGroundTracesPerFrame = 16;
+	FAutoConsoleVariableRef CVar_MaxGroundTracesPerFrame(TEXT("LyraCharacter.GroundInfo.MaxTracesPerFrame"), MaxGroundTracesPerFrame, TEXT("Async ground traces started per frame by all characters, 0 or less for no limit.  Locally controlled characters are never held back."), ECVF_Default);
+
+	struct FGroundTraceBudget
+	{
+		uint64 Frame = 0;
+		int32 NumTraces = 0;
+	};
+
+	// Shared by every character in a world, so a crowd of falling characters spreads its traces over several frames
+	static TMap<TObjectKey<UWorld>, FGroundTraceBudget> GroundTraceBudgets;
+
+	static bool ConsumeGroundTrace(const UWorld* World, bool bForce)
+	{
+		static FDelegateHandle WorldCleanupHandle = FWorldDelegates::OnWorldCleanup.AddLambda([](UWorld* CleanedUpWorld, bool /*bSessionEnded*/, bool /*bCleanupResources*/)
+		{
+			GroundTraceBudgets.Remove(CleanedUpWorld);
+		});
+
+		FGroundTraceBudget& Budget = GroundTraceBudgets.FindOrAdd(World);
+		if (Budget.Frame != GFrameCounter)
+		{
+			Budget.Frame = GFrameCounter;
+			Budget.NumTraces = 0;
+		}
+
+		if (!bForce && (MaxGroundTracesPerFrame > 0) && (Budget.NumTraces >= MaxGroundTracesPerFrame))
+		{
+			return false;
+		}
+
+		++Budget.NumTraces;
+		return true;
+	}
 };
 
 
@@ -62,40 +117,162 @@ const FLyraCharacterGroundInfo& ULyraCharacterMovementComponent::GetGroundInfo()
 	{
 		CachedGroundInfo.GroundHitResult = CurrentFloor.HitResult;
 		CachedGroundInfo.GroundDistance = 0.0f;
+
+		// The floor is where falling starts predicting from
+		PendingGroundTrace.Invalidate();
+		GroundSampleLocation = GetActorLocation();
+		GroundSampleTime = GetWorld()->GetTimeSeconds();
+		GroundClearToZ = GroundSampleLocation.Z;
+		bHasGroundSample = CurrentFloor.HitResult.bBlockingHit;
+	}
+	else if (!LyraCharacter::bUseAsyncGroundTraces)
+	{
+		bHasGroundSample = false;
+		TraceGround(/*bAsync=*/ false);
 	}
 	else
 	{
-		const UCapsuleComponent* CapsuleComp = CharacterOwner->GetCapsuleComponent();
-		check(CapsuleComp);
+		if (!bHasGroundSample)
+		{
+			// Nothing to predict from yet, e.g., spawned in the air
+			LyraCharacter::ConsumeGroundTrace(GetWorld(), /*bForce=*/ true);
+			TraceGround(/*bAsync=*/ false);
+		}
+		else if (!PendingGroundTrace.IsValid() && IsGroundTraceDue() && LyraCharacter::ConsumeGroundTrace(GetWorld(), CharacterOwner->IsLocallyControlled()))
+		{
+			TraceGround(/*bAsync=*/ true);
+		}
 
-		const float CapsuleHalfHeight = CapsuleComp->GetUnscaledCapsuleHalfHeight();
-		const ECollisionChannel CollisionChannel = (UpdatedComponent ? UpdatedComponent->GetCollisionObjectType() : ECC_Pawn);
-		const FVector TraceStart(GetActorLocation());
-		const FVector TraceEnd(TraceStart.X, TraceStart.Y, (TraceStart.Z - LyraCharacter::GroundTraceDistance - CapsuleHalfHeight));
+		UpdatePredictedGroundInfo();
+	}
 
-		FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(LyraCharacterMovementComponent_GetGroundInfo), false, CharacterOwner);
-		FCollisionResponseParams ResponseParam;
-		InitCollisionParams(QueryParams, ResponseParam);
+	CachedGroundInfo.LastUpdateFrame = GFrameCounter;
 
-		FHitResult HitResult;
-		GetWorld()->LineTraceSingleByChannel(HitResult, TraceStart, TraceEnd, CollisionChannel, QueryParams, ResponseParam);
+	return CachedGroundInfo;
+}
 
-		CachedGroundInfo.GroundHitResult = HitResult;
-		CachedGroundInfo.GroundDistance = LyraCharacter::GroundTraceDistance;
+void ULyraCharacterMovementComponent::OnGroundTraceDone(const FTraceHandle& TraceHandle, FTraceDatum& TraceData)
+{
+	// Delivered whether or not the ground info is asked for on that frame, so characters whose anim doesn't update every frame still
+	// get their samples. Results of traces that were superseded, e.g., by landing, are ignored.
+	if (!PendingGroundTrace.IsValid() || !(PendingGroundTrace == TraceHandle))
+	{
+		return;
+	}
 
-		if (MovementMode == MOVE_NavWalking)
-		{
-			CachedGroundInfo.GroundDistance = 0.0f;
-		}
-		else if (HitResult.bBlockingHit)
+	PendingGroundTrace.Invalidate();
+
+	const FHitResult* HitResult = TraceData.OutHits.FindByPredicate([](const FHitResult& Hit) { return Hit.bBlockingHit; });
+	SetGroundSample(HitResult ? *HitResult : FHitResult(TraceData.Start, TraceData.End), TraceData.Start, TraceData.End);
+}
+
+void ULyraCharacterMovementComponent::UpdatePredictedGroundInfo()
+{
+	// Assume the ground found by the last trace is still below the character, the trace is redone before it drifts far from it
+	const UCapsuleComponent* CapsuleComp = CharacterOwner->GetCapsuleComponent();
+	check(CapsuleComp);
+
+	const float CapsuleHalfHeight = CapsuleComp->GetUnscaledCapsuleHalfHeight();
+	const FHitResult& HitResult = CachedGroundInfo.GroundHitResult;
+
+	CachedGroundInfo.GroundDistance = LyraCharacter::GroundTraceDistance;
+
+	if (MovementMode == MOVE_NavWalking)
+	{
+		CachedGroundInfo.GroundDistance = 0.0f;
+	}
+	else if (HitResult.bBlockingHit)
+	{
+		CachedGroundInfo.GroundDistance = FMath::Max(static_cast<float>(GetActorLocation().Z - HitResult.ImpactPoint.Z) - CapsuleHalfHeight, 0.0f);
+	}
+}
+
+bool ULyraCharacterMovementComponent::IsGroundTraceDue() const
+{
+	const FVector ActorLocation = GetActorLocation();
+
+	// The ground below may be different
+	if (FVector::DistSquared2D(ActorLocation, GroundSampleLocation) > FMath::Square(LyraCharacter::MaxGroundDrift))
+	{
+		return true;
+	}
+
+	// Fell past where the last trace found nothing, the faster the fall the sooner this happens
+	if (!CachedGroundInfo.GroundHitResult.bBlockingHit)
+	{
+		const float CapsuleHalfHeight = CharacterOwner->GetCapsuleComponent()->GetUnscaledCapsuleHalfHeight();
+		const double FallLookahead = FMath::Max(-Velocity.Z, 0.0) * LyraCharacter::GroundTraceInterval;
+		if ((ActorLocation.Z - CapsuleHalfHeight - FallLookahead) < GroundClearToZ)
 		{
-			CachedGroundInfo.GroundDistance = FMath::Max((HitResult.Distance - CapsuleHalfHeight), 0.0f);
+			return true;
 		}
 	}
 
-	CachedGroundInfo.LastUpdateFrame = GFrameCounter;
+	// Otherwise refresh now and then, in case the ground itself moved
+	const bool bIsSignificant = CharacterOwner->IsLocallyControlled() || CharacterOwner->WasRecentlyRendered();
+	const float TraceInterval = bIsSignificant ? LyraCharacter::GroundTraceInterval : LyraCharacter::InsignificantGroundTraceInterval;
+	return (GetWorld()->GetTimeSeconds() - GroundSampleTime) >= TraceInterval;
+}
 
-	return CachedGroundInfo;
+void ULyraCharacterMovementComponent::TraceGround(bool bAsync)
+{
+	const UCapsuleComponent* CapsuleComp = CharacterOwner->GetCapsuleComponent();
+	check(CapsuleComp);
+
+	const float CapsuleHalfHeight = CapsuleComp->GetUnscaledCapsuleHalfHeight();
+	const ECollisionChannel CollisionChannel = (UpdatedComponent ? UpdatedComponent->GetCollisionObjectType() : ECC_Pawn);
+	const FVector TraceStart(GetActorLocation());
+
+	float TraceDistance = LyraCharacter::GroundTraceDistance;
+	if (LyraCharacter::bUseAsyncGroundTraces)
+	{
+		// Long enough to cover the fall until well after the next trace
+		const float LookaheadTime = LyraCharacter::GroundTraceLookaheadTime;
+		const float FallSpeed = FMath::Max(static_cast<float>(-Velocity.Z), 0.0f);
+		const float FallDistance = (FallSpeed * LookaheadTime) + (0.5f * FMath::Abs(GetGravityZ()) * FMath::Square(LookaheadTime));
+		TraceDistance = FMath::Clamp(FallDistance, LyraCharacter::MinGroundTraceDistance, LyraCharacter::GroundTraceDistance);
+	}
+
+	const FVector TraceEnd(TraceStart.X, TraceStart.Y, (TraceStart.Z - TraceDistance - CapsuleHalfHeight));
+
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(LyraCharacterMovementComponent_GetGroundInfo), false, CharacterOwner);
+	FCollisionResponseParams ResponseParam;
+	InitCollisionParams(QueryParams, ResponseParam);
+
+	if (bAsync)
+	{
+		FTraceDelegate OnTraceDone = FTraceDelegate::CreateUObject(this, &ThisClass::OnGroundTraceDone);
+		PendingGroundTrace = GetWorld()->AsyncLineTraceByChannel(EAsyncTraceType::Single, TraceStart, TraceEnd, CollisionChannel, QueryParams, ResponseParam, &OnTraceDone);
+		++NumAsyncGroundTraces;
+		return;
+	}
+
+	FHitResult HitResult;
+	GetWorld()->LineTraceSingleByChannel(HitResult, TraceStart, TraceEnd, CollisionChannel, QueryParams, ResponseParam);
+	++NumSyncGroundTraces;
+
+	SetGroundSample(HitResult, TraceStart, TraceEnd);
+
+	CachedGroundInfo.GroundDistance = LyraCharacter::GroundTraceDistance;
+
+	if (MovementMode == MOVE_NavWalking)
+	{
+		CachedGroundInfo.GroundDistance = 0.0f;
+	}
+	else if (HitResult.bBlockingHit)
+	{
+		CachedGroundInfo.GroundDistance = FMath::Max((HitResult.Distance - CapsuleHalfHeight), 0.0f);
+	}
+}
+
+void ULyraCharacterMovementComponent::SetGroundSample(const FHitResult& HitResult, const FVector& TraceStart, const FVector& TraceEnd)
+{
+	CachedGroundInfo.GroundHitResult = HitResult;
+
+	GroundSampleLocation = TraceStart;
+	GroundSampleTime = GetWorld()->GetTimeSeconds();
+	GroundClearToZ = TraceEnd.Z;
+	bHasGroundSample = true;
 }
 
 void ULyraCharacterMovementComponent::SetReplicatedAcceleration(const FVector& InAcceleration)
@@ -4,6 +4,7 @@
 
 #include "GameFramework/CharacterMovementComponent.h"
 #include "NativeGameplayTags.h"
+#include "WorldCollision.h"
 
 #include "LyraCharacterMovementComponent.generated.h"
 
@@ -56,9 +57,15 @@ public:
 	virtual bool CanAttemptJump() const override;
 
 	// Returns the current ground info.  Calling this will update the ground info if it's out of date.
+	// While the character isn't walking, the ground is found by short async traces started as it moves, and its distance is predicted
+	// from the last one in between.  Traces that find nothing within their length report LyraCharacter.GroundTraceDistance.
 	UFUNCTION(BlueprintCallable, Category = "Lyra|CharacterMovement")
 	const FLyraCharacterGroundInfo& GetGroundInfo();
 
+	// Ground traces done on the game thread and async ground traces started, since the component was created
+	int32 GetNumSyncGroundTraces() const { return NumSyncGroundTraces; }
+	int32 GetNumAsyncGroundTraces() const { return NumAsyncGroundTraces; }
+
 	void SetReplicatedAcceleration(const FVector& InAcceleration);
 
 	//~UMovementComponent interface
@@ -70,6 +77,12 @@ protected:
 
 	virtual void InitializeComponent() override;
 
+	void OnGroundTraceDone(const FTraceHandle& TraceHandle, FTraceDatum& TraceData);
+	void UpdatePredictedGroundInfo();
+	bool IsGroundTraceDue() const;
+	void TraceGround(bool bAsync);
+	void SetGroundSample(const FHitResult& HitResult, const FVector& TraceStart, const FVector& TraceEnd);
+
 protected:
 
 	// Cached ground info for the character.  Do not access this directly!  It's only updated when accessed via GetGroundInfo().
@@ -77,4 +90,17 @@ protected:
 
 	UPROPERTY(Transient)
 	bool bHasReplicatedAcceleration = false;
+
+private:
+	// The async ground trace in flight, its result is applied by OnGroundTraceDone
+	FTraceHandle PendingGroundTrace;
+
+	// Where the ground in CachedGroundInfo was last found, and how far below that there is known to be no ground if nothing was hit
+	FVector GroundSampleLocation = FVector::ZeroVector;
+	double GroundSampleTime = 0.0;
+	double GroundClearToZ = 0.0;
+	bool bHasGroundSample = false;
+
+	int32 NumSyncGroundTraces = 0;
+	int32 NumAsyncGroundTraces = 0;
 };
@@ -11,6 +11,7 @@
 #include "GameplayEffectExtension.h"
 #include "AbilitySystem/LyraAbilitySystemComponent.h"
 #include "AbilitySystem/Attributes/LyraHealthSet.h"
+#include "Character/LyraHealthSubsystem.h"
 #include "Messages/LyraVerbMessage.h"
 #include "Messages/LyraVerbMessageHelpers.h"
 #include "GameFramework/GameplayMessageSubsystem.h"
@@ -90,6 +91,12 @@ void ULyraHealthComponent::InitializeWithAbilitySystem(ULyraAbilitySystemCompone
 
 void ULyraHealthComponent::UninitializeFromAbilitySystem()
 {
+	// Send what is still batched while the ability system is around
+	if (ULyraHealthSubsystem* HealthSubsystem = ULyraHealthSubsystem::GetForBatching(this))
+	{
+		HealthSubsystem->FlushPendingEvents(this);
+	}
+
 	ClearGameplayTags();
 
 	if (HealthSet)
@@ -137,11 +144,23 @@ float ULyraHealthComponent::GetHealthNormalized() const
 
 void ULyraHealthComponent::HandleHealthChanged(AActor* DamageInstigator, AActor* DamageCauser, const FGameplayEffectSpec* DamageEffectSpec, float DamageMagnitude, float OldValue, float NewValue)
 {
+	if (ULyraHealthSubsystem* HealthSubsystem = ULyraHealthSubsystem::GetForBatching(this))
+	{
+		HealthSubsystem->QueueHealthChanged(this, OldValue, NewValue, DamageInstigator);
+		return;
+	}
+
 	OnHealthChanged.Broadcast(this, OldValue, NewValue, DamageInstigator);
 }
 
 void ULyraHealthComponent::HandleMaxHealthChanged(AActor* DamageInstigator, AActor* DamageCauser, const FGameplayEffectSpec* DamageEffectSpec, float DamageMagnitude, float OldValue, float NewValue)
 {
+	if (ULyraHealthSubsystem* HealthSubsystem = ULyraHealthSubsystem::GetForBatching(this))
+	{
+		HealthSubsystem->QueueMaxHealthChanged(this, OldValue, NewValue, DamageInstigator);
+		return;
+	}
+
 	OnMaxHealthChanged.Broadcast(this, OldValue, NewValue, DamageInstigator);
 }
 
@@ -150,6 +169,12 @@ void ULyraHealthComponent::HandleOutOfHealth(AActor* DamageInstigator, AActor* D
 #if WITH_SERVER_CODE
 	if (AbilitySystemComponent && DamageEffectSpec)
 	{
+		// Deaths are never batched, but the notifications that took the pawn to zero health go out before them
+		if (ULyraHealthSubsystem* HealthSubsystem = ULyraHealthSubsystem::GetForBatching(this))
+		{
+			HealthSubsystem->FlushPendingEvents(this);
+		}
+
 		// Send the "GameplayEvent.Death" gameplay event through the owner's ability system.  This can be used to trigger a death gameplay ability.
 		{
 			FGameplayEventData Payload;
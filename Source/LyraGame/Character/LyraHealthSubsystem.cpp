@@ -0,0 +1,153 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Character/LyraHealthSubsystem.h"
+
+#include "Character/LyraHealthComponent.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(LyraHealthSubsystem)
+
+namespace LyraHealthSubsystem
+{
+	static bool bBatchHealthEvents = true;
+	static FAutoConsoleVariableRef CVarBatchHealthEvents(
+		TEXT("Lyra.Health.BatchEvents"),
+		bBatchHealthEvents,
+		TEXT("If true, health and max health change notifications are coalesced and sent once per frame. If false, they are sent when they happen. Out of health events are always sent when they happen."),
+		ECVF_Default);
+}
+
+//////////////////////////////////////////////////////////////////////
+
+bool ULyraHealthSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void ULyraHealthSubsystem::Deinitialize()
+{
+	PendingEvents.Reset();
+	MergeableHealthEvents.Reset();
+	MergeableMaxHealthEvents.Reset();
+
+	Super::Deinitialize();
+}
+
+TStatId ULyraHealthSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(ULyraHealthSubsystem, STATGROUP_Tickables);
+}
+
+void ULyraHealthSubsystem::Tick(float DeltaTime)
+{
+	if (PendingEvents.Num() > 0)
+	{
+		FlushPendingEvents();
+	}
+}
+
+ULyraHealthSubsystem* ULyraHealthSubsystem::GetForBatching(const UObject* WorldContextObject)
+{
+	if (!LyraHealthSubsystem::bBatchHealthEvents)
+	{
+		return nullptr;
+	}
+
+	const UWorld* World = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::ReturnNull);
+	return World ? World->GetSubsystem<ULyraHealthSubsystem>() : nullptr;
+}
+
+void ULyraHealthSubsystem::QueueHealthChanged(ULyraHealthComponent* Component, float OldValue, float NewValue, AActor* Instigator)
+{
+	QueueAttributeChanged(EPendingEventType::HealthChanged, Component, OldValue, NewValue, Instigator);
+}
+
+void ULyraHealthSubsystem::QueueMaxHealthChanged(ULyraHealthComponent* Component, float OldValue, float NewValue, AActor* Instigator)
+{
+	QueueAttributeChanged(EPendingEventType::MaxHealthChanged, Component, OldValue, NewValue, Instigator);
+}
+
+void ULyraHealthSubsystem::QueueAttributeChanged(EPendingEventType Type, ULyraHealthComponent* Component, float OldValue, float NewValue, AActor* Instigator)
+{
+	check(Component);
+
+	TMap<const ULyraHealthComponent*, int32>& MergeableEvents = (Type == EPendingEventType::HealthChanged) ? MergeableHealthEvents : MergeableMaxHealthEvents;
+
+	if (const int32* EventIndex = MergeableEvents.Find(Component))
+	{
+		// Keep the value from before the first change, so listeners see the whole change of the frame
+		FPendingHealthEvent& PendingEvent = PendingEvents[*EventIndex];
+		PendingEvent.NewValue = NewValue;
+		PendingEvent.Instigator = Instigator;
+		return;
+	}
+
+	MergeableEvents.Add(Component, PendingEvents.Num());
+
+	FPendingHealthEvent& NewEvent = PendingEvents.AddDefaulted_GetRef();
+	NewEvent.Component = Component;
+	NewEvent.Type = Type;
+	NewEvent.OldValue = OldValue;
+	NewEvent.NewValue = NewValue;
+	NewEvent.Instigator = Instigator;
+}
+
+void ULyraHealthSubsystem::FlushPendingEvents(ULyraHealthComponent* Component)
+{
+	// A component has at most one pending event of each type, both indexed by the mergeable maps
+	int32 HealthEventIndex = INDEX_NONE;
+	int32 MaxHealthEventIndex = INDEX_NONE;
+	MergeableHealthEvents.RemoveAndCopyValue(Component, HealthEventIndex);
+	MergeableMaxHealthEvents.RemoveAndCopyValue(Component, MaxHealthEventIndex);
+
+	// Sent in the order they were queued
+	int32 EventIndices[] = { HealthEventIndex, MaxHealthEventIndex };
+	if (EventIndices[0] > EventIndices[1])
+	{
+		Swap(EventIndices[0], EventIndices[1]);
+	}
+
+	// Sent events stay in the queue without a component and are skipped when it is processed. The component check covers a listener
+	// of the first event flushing the whole queue.
+	for (const int32 EventIndex : EventIndices)
+	{
+		if (PendingEvents.IsValidIndex(EventIndex) && (PendingEvents[EventIndex].Component.Get() == Component))
+		{
+			const FPendingHealthEvent Event = PendingEvents[EventIndex];
+			PendingEvents[EventIndex].Component.Reset();
+			SendEvent(*Component, Event);
+		}
+	}
+}
+
+void ULyraHealthSubsystem::FlushPendingEvents()
+{
+	// Events queued by listeners while these are sent go to the next frame
+	TArray<FPendingHealthEvent> EventsToSend = MoveTemp(PendingEvents);
+	PendingEvents.Reset();
+	MergeableHealthEvents.Reset();
+	MergeableMaxHealthEvents.Reset();
+
+	for (const FPendingHealthEvent& Event : EventsToSend)
+	{
+		if (ULyraHealthComponent* Component = Event.Component.Get())
+		{
+			SendEvent(*Component, Event);
+		}
+	}
+}
+
+void ULyraHealthSubsystem::SendEvent(ULyraHealthComponent& Component, const FPendingHealthEvent& Event) const
+{
+	switch (Event.Type)
+	{
+	case EPendingEventType::HealthChanged:
+		Component.OnHealthChanged.Broadcast(&Component, Event.OldValue, Event.NewValue, Event.Instigator.Get());
+		break;
+	case EPendingEventType::MaxHealthChanged:
+		Component.OnMaxHealthChanged.Broadcast(&Component, Event.OldValue, Event.NewValue, Event.Instigator.Get());
+		break;
+	}
+}
@@ -0,0 +1,80 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Subsystems/WorldSubsystem.h"
+
+#include "LyraHealthSubsystem.generated.h"
+
+class AActor;
+class ULyraHealthComponent;
+class UObject;
+
+/**
+ * ULyraHealthSubsystem
+ *
+ * Batches the health work of every ULyraHealthComponent in the world. Health and max health change notifications are held until
+ * the end of the frame and repeated changes to the same pawn are coalesced into one broadcast, so damage over time on hundreds
+ * of pawns doesn't broadcast OnHealthChanged for every tick of every effect. Only these cosmetic notifications are batched, the death
+ * gameplay event and elimination message are sent by the component when the pawn runs out of health, right after its pending
+ * notifications are flushed, so notifications of a single pawn never arrive after its death.
+ */
+UCLASS()
+class LYRAGAME_API ULyraHealthSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	//~USubsystem interface
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	virtual void Deinitialize() override;
+	//~End of USubsystem interface
+
+	//~FTickableGameObject interface
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	//~End of FTickableGameObject interface
+
+	/** Returns the subsystem of the component's world if health events should be batched, or nullptr if they are sent immediately */
+	static ULyraHealthSubsystem* GetForBatching(const UObject* WorldContextObject);
+
+	/** Queues a health change notification, merged with a pending notification of the same component if there is one */
+	void QueueHealthChanged(ULyraHealthComponent* Component, float OldValue, float NewValue, AActor* Instigator);
+
+	/** Queues a max health change notification, merged with a pending notification of the same component if there is one */
+	void QueueMaxHealthChanged(ULyraHealthComponent* Component, float OldValue, float NewValue, AActor* Instigator);
+
+	/** Sends the pending events of one component right away, e.g. before it is uninitialized */
+	void FlushPendingEvents(ULyraHealthComponent* Component);
+
+	/** Sends every pending event right away, events queued by their listeners are left for the next frame */
+	void FlushPendingEvents();
+
+	int32 GetNumPendingEvents() const { return PendingEvents.Num(); }
+
+private:
+	enum class EPendingEventType : uint8
+	{
+		HealthChanged,
+		MaxHealthChanged
+	};
+
+	struct FPendingHealthEvent
+	{
+		TWeakObjectPtr<ULyraHealthComponent> Component;
+		EPendingEventType Type = EPendingEventType::HealthChanged;
+		float OldValue = 0.0f;
+		float NewValue = 0.0f;
+		TWeakObjectPtr<AActor> Instigator;
+	};
+
+	void QueueAttributeChanged(EPendingEventType Type, ULyraHealthComponent* Component, float OldValue, float NewValue, AActor* Instigator);
+	void SendEvent(ULyraHealthComponent& Component, const FPendingHealthEvent& Event) const;
+
+	// Events in the order they happened
+	TArray<FPendingHealthEvent> PendingEvents;
+
+	// Index in PendingEvents of the notification that later changes of a component are merged into
+	TMap<const ULyraHealthComponent*, int32> MergeableHealthEvents;
+	TMap<const ULyraHealthComponent*, int32> MergeableMaxHealthEvents;
+};
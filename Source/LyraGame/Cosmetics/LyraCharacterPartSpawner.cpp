@@ -0,0 +1,223 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Cosmetics/LyraCharacterPartSpawner.h"
+
+#include "Cosmetics/LyraPawnComponent_CharacterParts.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(LyraCharacterPartSpawner)
+
+namespace LyraCharacterPartSpawner
+{
+	static float SpawnBudgetMs = 1.0f;
+	static FAutoConsoleVariableRef CVarSpawnBudgetMs(
+		TEXT("Lyra.CharacterParts.SpawnBudgetMs"),
+		SpawnBudgetMs,
+		TEXT("Milliseconds per frame spent spawning queued character parts (at least one part is spawned per frame). 0 or less spawns parts immediately when they are added."),
+		ECVF_Default);
+
+	static int32 MaxPooledPerClass = 32;
+	static FAutoConsoleVariableRef CVarMaxPooledPerClass(
+		TEXT("Lyra.CharacterParts.MaxPooledPerClass"),
+		MaxPooledPerClass,
+		TEXT("How many released character part actors of each class are kept for reuse. 0 destroys released parts."),
+		ECVF_Default);
+}
+
+//////////////////////////////////////////////////////////////////////
+
+void ULyraCharacterPartSpawner::Deinitialize()
+{
+	HighPrioritySpawns.Reset();
+	PendingSpawns.Reset();
+	HighPriorityHead = 0;
+	PendingHead = 0;
+	ChangedComponents.Reset();
+
+	// The pooled actors belong to the world and go away with it
+	ActorPools.Reset();
+
+	Super::Deinitialize();
+}
+
+TStatId ULyraCharacterPartSpawner::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(ULyraCharacterPartSpawner, STATGROUP_Tickables);
+}
+
+void ULyraCharacterPartSpawner::Tick(float DeltaTime)
+{
+	if (GetNumPendingSpawns() > 0)
+	{
+		const double EndTime = FPlatformTime::Seconds() + (FMath::Max(LyraCharacterPartSpawner::SpawnBudgetMs, 0.0f) / 1000.0);
+		ProcessPendingSpawns(EndTime);
+	}
+}
+
+bool ULyraCharacterPartSpawner::ShouldQueueSpawns()
+{
+	return LyraCharacterPartSpawner::SpawnBudgetMs > 0.0f;
+}
+
+void ULyraCharacterPartSpawner::QueuePartSpawn(ULyraPawnComponent_CharacterParts* Component, int32 SpawnId, bool bHighPriority)
+{
+	FPendingPartSpawn& NewSpawn = bHighPriority ? HighPrioritySpawns.AddDefaulted_GetRef() : PendingSpawns.AddDefaulted_GetRef();
+	NewSpawn.Component = Component;
+	NewSpawn.SpawnId = SpawnId;
+}
+
+void ULyraCharacterPartSpawner::FlushPendingSpawns()
+{
+	ProcessPendingSpawns(TNumericLimits<double>::Max());
+}
+
+int32 ULyraCharacterPartSpawner::GetNumPooledActors() const
+{
+	int32 NumPooled = 0;
+	for (const auto& KVP : ActorPools)
+	{
+		NumPooled += KVP.Value.Actors.Num();
+	}
+	return NumPooled;
+}
+
+void ULyraCharacterPartSpawner::ProcessPendingSpawns(double EndTime)
+{
+	// Always make progress, even when a single spawn is over budget
+	bool bSpawnedAny = false;
+
+	FPendingPartSpawn PendingSpawn;
+	while ((!bSpawnedAny || (FPlatformTime::Seconds() < EndTime)) && PopPendingSpawn(/*out*/ PendingSpawn))
+	{
+		// The component may have gone away, or the entry may have been removed or respawned since it was queued
+		if (ULyraPawnComponent_CharacterParts* Component = PendingSpawn.Component.Get())
+		{
+			if (Component->SpawnPendingPart(PendingSpawn.SpawnId))
+			{
+				ChangedComponents.AddUnique(Component);
+				bSpawnedAny = true;
+			}
+		}
+	}
+
+	BroadcastChangedComponents();
+}
+
+bool ULyraCharacterPartSpawner::PopPendingSpawn(FPendingPartSpawn& OutSpawn)
+{
+	auto PopFromQueue = [&OutSpawn](TArray<FPendingPartSpawn>& Queue, int32& Head)
+	{
+		if (Head < Queue.Num())
+		{
+			OutSpawn = Queue[Head++];
+			if (Head == Queue.Num())
+			{
+				Queue.Reset();
+				Head = 0;
+			}
+			return true;
+		}
+		return false;
+	};
+
+	return PopFromQueue(HighPrioritySpawns, HighPriorityHead) || PopFromQueue(PendingSpawns, PendingHead);
+}
+
+void ULyraCharacterPartSpawner::BroadcastChangedComponents()
+{
+	// Observers (body style selection, team colors, etc...) only need to hear about each pawn once, however many parts it got this frame
+	TArray<TWeakObjectPtr<ULyraPawnComponent_CharacterParts>> ComponentsToBroadcast = MoveTemp(ChangedComponents);
+	ChangedComponents.Reset();
+
+	for (const TWeakObjectPtr<ULyraPawnComponent_CharacterParts>& ComponentPtr : ComponentsToBroadcast)
+	{
+		if (ULyraPawnComponent_CharacterParts* Component = ComponentPtr.Get())
+		{
+			Component->BroadcastChanged();
+		}
+	}
+}
+
+AActor* ULyraCharacterPartSpawner::AcquirePartActor(TSubclassOf<AActor> PartClass, AActor* Owner, const FTransform& SpawnTransform, bool& bOutReused)
+{
+	bOutReused = false;
+
+	if (FLyraCharacterPartActorPool* Pool = ActorPools.Find(PartClass))
+	{
+		while (Pool->Actors.Num() > 0)
+		{
+			AActor* PooledActor = Pool->Actors.Pop(EAllowShrinking::No);
+			if (IsValid(PooledActor))
+			{
+				const AActor* DefaultActor = PooledActor->GetClass()->GetDefaultObject<AActor>();
+
+				PooledActor->SetActorTransform(SpawnTransform, /*bSweep=*/ false, /*OutSweepHitResult=*/ nullptr, ETeleportType::ResetPhysics);
+				PooledActor->SetOwner(Owner);
+				PooledActor->SetActorHiddenInGame(DefaultActor->IsHidden());
+				PooledActor->SetActorEnableCollision(DefaultActor->GetActorEnableCollision());
+				PooledActor->SetActorTickEnabled(DefaultActor->PrimaryActorTick.bStartWithTickEnabled);
+				PooledActor->ForEachComponent(/*bIncludeFromChildActors=*/ false, [](UActorComponent* Component)
+				{
+					Component->SetComponentTickEnabled(Component->PrimaryComponentTick.bStartWithTickEnabled);
+				});
+
+				bOutReused = true;
+				return PooledActor;
+			}
+		}
+	}
+
+	UWorld* World = GetWorld();
+	if (World == nullptr || PartClass == nullptr)
+	{
+		return nullptr;
+	}
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.Owner = Owner;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	SpawnParams.ObjectFlags |= RF_Transient;
+
+	return World->SpawnActor<AActor>(PartClass, SpawnTransform, SpawnParams);
+}
+
+void ULyraCharacterPartSpawner::ReleasePartActor(AActor* PartActor)
+{
+	if (!IsValid(PartActor))
+	{
+		return;
+	}
+
+	if (USceneComponent* PartRootComponent = PartActor->GetRootComponent())
+	{
+		if (USceneComponent* AttachParent = PartRootComponent->GetAttachParent())
+		{
+			PartRootComponent->RemoveTickPrerequisiteComponent(AttachParent);
+		}
+	}
+
+	UWorld* World = GetWorld();
+	FLyraCharacterPartActorPool& Pool = ActorPools.FindOrAdd(PartActor->GetClass());
+	const bool bCanPool = (World != nullptr) && !World->bIsTearingDown && (Pool.Actors.Num() < LyraCharacterPartSpawner::MaxPooledPerClass);
+
+	if (!bCanPool)
+	{
+		PartActor->Destroy();
+		return;
+	}
+
+	PartActor->DetachFromActor(FDetachmentTransformRules::KeepWorldTransform);
+	PartActor->SetActorHiddenInGame(true);
+	PartActor->SetActorEnableCollision(false);
+	PartActor->SetActorTickEnabled(false);
+	PartActor->ForEachComponent(/*bIncludeFromChildActors=*/ false, [](UActorComponent* Component)
+	{
+		Component->SetComponentTickEnabled(false);
+	});
+	PartActor->SetOwner(nullptr);
+
+	Pool.Actors.Add(PartActor);
+}
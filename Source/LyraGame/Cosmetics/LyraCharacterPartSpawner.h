@@ -0,0 +1,85 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Subsystems/WorldSubsystem.h"
+
+#include "LyraCharacterPartSpawner.generated.h"
+
+class AActor;
+class ULyraPawnComponent_CharacterParts;
+class UObject;
+
+// Part actors of a single class that are waiting to be reused
+USTRUCT()
+struct FLyraCharacterPartActorPool
+{
+	GENERATED_BODY()
+
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<AActor>> Actors;
+};
+
+/**
+ * ULyraCharacterPartSpawner
+ *
+ * Spawns the cosmetic part actors requested by ULyraPawnComponent_CharacterParts a few at a time within a per-frame budget,
+ * so a wave of respawns doesn't spawn every part in the same frame. Part actors released by a pawn (e.g., when it dies) are
+ * hidden and kept per class for the next pawn that needs one.
+ */
+UCLASS()
+class LYRAGAME_API ULyraCharacterPartSpawner : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	//~USubsystem interface
+	virtual void Deinitialize() override;
+	//~End of USubsystem interface
+
+	//~FTickableGameObject interface
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	//~End of FTickableGameObject interface
+
+	/** Returns true if part spawns should go through the queue rather than happen immediately */
+	static bool ShouldQueueSpawns();
+
+	/** Queues a pending part of Component to be spawned on a later frame, high priority requests (e.g., the local player) go first */
+	void QueuePartSpawn(ULyraPawnComponent_CharacterParts* Component, int32 SpawnId, bool bHighPriority);
+
+	/** Returns a pooled actor of PartClass moved to SpawnTransform, or spawns a new one. bOutReused is set if it came from the pool. */
+	AActor* AcquirePartActor(TSubclassOf<AActor> PartClass, AActor* Owner, const FTransform& SpawnTransform, bool& bOutReused);
+
+	/** Detaches and hides PartActor until it is acquired again, or destroys it if it can't be pooled */
+	void ReleasePartActor(AActor* PartActor);
+
+	/** Spawns everything in the queue right away */
+	void FlushPendingSpawns();
+
+	int32 GetNumPendingSpawns() const { return (HighPrioritySpawns.Num() - HighPriorityHead) + (PendingSpawns.Num() - PendingHead); }
+	int32 GetNumPooledActors() const;
+
+private:
+	struct FPendingPartSpawn
+	{
+		TWeakObjectPtr<ULyraPawnComponent_CharacterParts> Component;
+		int32 SpawnId = INDEX_NONE;
+	};
+
+	void ProcessPendingSpawns(double EndTime);
+	bool PopPendingSpawn(FPendingPartSpawn& OutSpawn);
+	void BroadcastChangedComponents();
+
+	UPROPERTY(Transient)
+	TMap<TObjectPtr<UClass>, FLyraCharacterPartActorPool> ActorPools;
+
+	// FIFO queues, consumed from the head and compacted once drained
+	TArray<FPendingPartSpawn> HighPrioritySpawns;
+	TArray<FPendingPartSpawn> PendingSpawns;
+	int32 HighPriorityHead = 0;
+	int32 PendingHead = 0;
+
+	// Components that finished spawning parts this frame, told once all of this frame's spawns are done
+	TArray<TWeakObjectPtr<ULyraPawnComponent_CharacterParts>> ChangedComponents;
+};
@@ -7,29 +7,179 @@
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(LyraCosmeticAnimationTypes)
 
-TSubclassOf<UAnimInstance> FLyraAnimLayerSelectionSet::SelectBestLayer(const FGameplayTagContainer& CosmeticTags) const
+namespace LyraCosmeticAnimationTypes
 {
-	for (const FLyraAnimLayerSelectionEntry& Rule : LayerRules)
+	// Cosmetic states seen by one selection set are few, this only guards against unbounded growth
+	static constexpr int32 MaxMemoizedResults = 64;
+
+	static constexpr int32 MaxMaskedTags = 64;
+}
+
+//////////////////////////////////////////////////////////////////////
+// FLyraCosmeticRuleSelector
+
+FLyraCosmeticRuleSelector& FLyraCosmeticRuleSelector::operator=(const FLyraCosmeticRuleSelector& Other)
+{
+	if (this != &Other)
 	{
-		if ((Rule.Layer != nullptr) && CosmeticTags.HasAll(Rule.RequiredTags))
+		Reset();
+	}
+	return *this;
+}
+
+void FLyraCosmeticRuleSelector::Reset()
+{
+	CompiledNumRules = INDEX_NONE;
+	RelevantTags.Reset();
+	RuleMasks.Reset();
+	bUseLinearRules = false;
+	MemoizedResults.Reset();
+}
+
+int32 FLyraCosmeticRuleSelector::GetNumMemoizedResults() const
+{
+	return MemoizedResults.Num();
+}
+
+int32 FLyraCosmeticRuleSelector::SelectRule(int32 NumRules, FGetRuleTags GetRuleTags, const FGameplayTagContainer& CosmeticTags) const
+{
+	check(IsInGameThread());
+
+	// Rules edited in place are caught by the owner resetting the selector, only added or removed ones are noticed here
+	if (NumRules != CompiledNumRules)
+	{
+		CompileRules(NumRules, GetRuleTags);
+	}
+
+	const uint32 Hash = HashTags(CosmeticTags);
+	if (const FMemoizedResult* MemoizedResult = MemoizedResults.Find(Hash))
+	{
+		if (MemoizedResult->CosmeticTags == CosmeticTags)
 		{
-			return Rule.Layer;
+			return MemoizedResult->RuleIndex;
 		}
 	}
 
-	return DefaultLayer;
+	const int32 RuleIndex = EvaluateRules(NumRules, GetRuleTags, CosmeticTags);
+
+	if (MemoizedResults.Num() >= LyraCosmeticAnimationTypes::MaxMemoizedResults)
+	{
+		MemoizedResults.Reset();
+	}
+
+	// On a hash collision the newer state wins, the older one is evaluated again if it comes back
+	FMemoizedResult& NewResult = MemoizedResults.FindOrAdd(Hash);
+	NewResult.CosmeticTags = CosmeticTags;
+	NewResult.RuleIndex = RuleIndex;
+
+	return RuleIndex;
 }
 
-USkeletalMesh* FLyraAnimBodyStyleSelectionSet::SelectBestBodyStyle(const FGameplayTagContainer& CosmeticTags) const
+void FLyraCosmeticRuleSelector::CompileRules(int32 NumRules, FGetRuleTags GetRuleTags) const
+{
+	CompiledNumRules = NumRules;
+	RelevantTags.Reset();
+	RuleMasks.Reset(NumRules);
+	bUseLinearRules = false;
+	MemoizedResults.Reset();
+
+	for (int32 RuleIndex = 0; RuleIndex < NumRules; ++RuleIndex)
+	{
+		uint64 RuleMask = 0;
+
+		if (const FGameplayTagContainer* RequiredTags = GetRuleTags(RuleIndex))
+		{
+			for (const FGameplayTag& Tag : *RequiredTags)
+			{
+				const int32 TagIndex = RelevantTags.AddUnique(Tag);
+				if (TagIndex >= LyraCosmeticAnimationTypes::MaxMaskedTags)
+				{
+					bUseLinearRules = true;
+					RelevantTags.Reset();
+					RuleMasks.Reset();
+					return;
+				}
+
+				RuleMask |= (uint64(1) << TagIndex);
+			}
+		}
+
+		RuleMasks.Add(RuleMask);
+	}
+}
+
+int32 FLyraCosmeticRuleSelector::EvaluateRules(int32 NumRules, FGetRuleTags GetRuleTags, const FGameplayTagContainer& CosmeticTags) const
 {
-	for (const FLyraAnimBodyStyleSelectionEntry& Rule : MeshRules)
+	if (bUseLinearRules)
 	{
-		if ((Rule.Mesh != nullptr) && CosmeticTags.HasAll(Rule.RequiredTags))
+		for (int32 RuleIndex = 0; RuleIndex < NumRules; ++RuleIndex)
 		{
-			return Rule.Mesh;
+			const FGameplayTagContainer* RequiredTags = GetRuleTags(RuleIndex);
+			if ((RequiredTags != nullptr) && CosmeticTags.HasAll(*RequiredTags))
+			{
+				return RuleIndex;
+			}
 		}
+		return INDEX_NONE;
 	}
 
-	return DefaultMesh;
+	// HasTag also matches parents of the cosmetic tags, the same as HasAll does per required tag
+	uint64 PresentMask = 0;
+	for (int32 TagIndex = 0; TagIndex < RelevantTags.Num(); ++TagIndex)
+	{
+		if (CosmeticTags.HasTag(RelevantTags[TagIndex]))
+		{
+			PresentMask |= (uint64(1) << TagIndex);
+		}
+	}
+
+	for (int32 RuleIndex = 0; RuleIndex < NumRules; ++RuleIndex)
+	{
+		if (((RuleMasks[RuleIndex] & ~PresentMask) == 0) && (GetRuleTags(RuleIndex) != nullptr))
+		{
+			return RuleIndex;
+		}
+	}
+
+	return INDEX_NONE;
+}
+
+uint32 FLyraCosmeticRuleSelector::HashTags(const FGameplayTagContainer& Tags)
+{
+	// Summed so the same tags added in a different order share a result
+	uint32 Hash = Tags.Num();
+	for (const FGameplayTag& Tag : Tags)
+	{
+		Hash += MurmurFinalize32(GetTypeHash(Tag));
+	}
+	return Hash;
+}
+
+//////////////////////////////////////////////////////////////////////
+
+TSubclassOf<UAnimInstance> FLyraAnimLayerSelectionSet::SelectBestLayer(const FGameplayTagContainer& CosmeticTags) const
+{
+	const int32 RuleIndex = RuleSelector.SelectRule(LayerRules.Num(),
+		[this](int32 Index) -> const FGameplayTagContainer*
+		{
+			const FLyraAnimLayerSelectionEntry& Rule = LayerRules[Index];
+			return (Rule.Layer != nullptr) ? &Rule.RequiredTags : nullptr;
+		},
+		CosmeticTags);
+
+	return LayerRules.IsValidIndex(RuleIndex) ? LayerRules[RuleIndex].Layer : DefaultLayer;
+}
+
+USkeletalMesh* FLyraAnimBodyStyleSelectionSet::SelectBestBodyStyle(const FGameplayTagContainer& CosmeticTags) const
+{
+	const int32 RuleIndex = RuleSelector.SelectRule(MeshRules.Num(),
+		[this](int32 Index) -> const FGameplayTagContainer*
+		{
+			const FLyraAnimBodyStyleSelectionEntry& Rule = MeshRules[Index];
+			return (Rule.Mesh != nullptr) ? &Rule.RequiredTags : nullptr;
+		},
+		CosmeticTags);
+
+	return MeshRules.IsValidIndex(RuleIndex) ? MeshRules[RuleIndex].Mesh : DefaultMesh;
 }
 
@@ -13,6 +13,64 @@ class USkeletalMesh;
 
 //////////////////////////////////////////////////////////////////////
 
+/**
+ * FLyraCosmeticRuleSelector
+ *
+ *	Finds the first rule of a selection set whose required tags are all present in a cosmetic tag container.
+ *	The rules are compiled into one bit per distinct required tag, so a selection tests every distinct tag once instead of
+ *	running HasAll per rule, and results are memoized by the hash of the cosmetic tag container.
+ *	Rules are compiled on the first selection and again when their number changes. Owners call Reset after editing rules in place,
+ *	selection doesn't look at the required tags again. Selection is only done on the game thread. Copies start out empty.
+ */
+struct LYRAGAME_API FLyraCosmeticRuleSelector
+{
+public:
+
+	// Returns the rule to consider for the given index, or nullptr if the rule has no result and can never be selected
+	using FGetRuleTags = TFunctionRef<const FGameplayTagContainer*(int32 RuleIndex)>;
+
+	FLyraCosmeticRuleSelector() = default;
+	FLyraCosmeticRuleSelector(const FLyraCosmeticRuleSelector&) {}
+	FLyraCosmeticRuleSelector& operator=(const FLyraCosmeticRuleSelector&);
+
+	// Returns the index of the first usable rule matching CosmeticTags, or INDEX_NONE if none matches
+	int32 SelectRule(int32 NumRules, FGetRuleTags GetRuleTags, const FGameplayTagContainer& CosmeticTags) const;
+
+	// Drops the compiled rules and memoized results
+	void Reset();
+
+	int32 GetNumMemoizedResults() const;
+
+private:
+
+	void CompileRules(int32 NumRules, FGetRuleTags GetRuleTags) const;
+	int32 EvaluateRules(int32 NumRules, FGetRuleTags GetRuleTags, const FGameplayTagContainer& CosmeticTags) const;
+
+	static uint32 HashTags(const FGameplayTagContainer& Tags);
+
+private:
+
+	struct FMemoizedResult
+	{
+		FGameplayTagContainer CosmeticTags;
+		int32 RuleIndex = INDEX_NONE;
+	};
+
+	// Number of rules the compiled state was built from, INDEX_NONE until they are compiled
+	mutable int32 CompiledNumRules = INDEX_NONE;
+
+	// Distinct tags required by any usable rule, bit N of a rule mask stands for RelevantTags[N]
+	mutable TArray<FGameplayTag> RelevantTags;
+	mutable TArray<uint64> RuleMasks;
+
+	// Set if there are too many distinct tags for a mask, rules are then tested one by one
+	mutable bool bUseLinearRules = false;
+
+	mutable TMap<uint32, FMemoizedResult> MemoizedResults;
+};
+
+//////////////////////////////////////////////////////////////////////
+
 USTRUCT(BlueprintType)
 struct FLyraAnimLayerSelectionEntry
 {
@@ -42,6 +100,12 @@ struct FLyraAnimLayerSelectionSet
 
 	// Choose the best layer given the rules
 	TSubclassOf<UAnimInstance> SelectBestLayer(const FGameplayTagContainer& CosmeticTags) const;
+
+	// Must be called after LayerRules are edited in place, so the next selection compiles them again
+	void ResetRuleSelection() { RuleSelector.Reset(); }
+
+private:
+	FLyraCosmeticRuleSelector RuleSelector;
 };
 
 //////////////////////////////////////////////////////////////////////
@@ -79,4 +143,10 @@ struct FLyraAnimBodyStyleSelectionSet
 
 	// Choose the best body style skeletal mesh given the rules
 	USkeletalMesh* SelectBestBodyStyle(const FGameplayTagContainer& CosmeticTags) const;
+
+	// Must be called after MeshRules are edited in place, so the next selection compiles them again
+	void ResetRuleSelection() { RuleSelector.Reset(); }
+
+private:
+	FLyraCosmeticRuleSelector RuleSelector;
 };
@@ -3,7 +3,9 @@
 #include "Cosmetics/LyraPawnComponent_CharacterParts.h"
 
 #include "Components/SkeletalMeshComponent.h"
+#include "Cosmetics/LyraCharacterPartSpawner.h"
 #include "Cosmetics/LyraCharacterPartTypes.h"
+#include "Engine/World.h"
 #include "GameFramework/Character.h"
 #include "GameplayTagAssetInterface.h"
 #include "Net/UnrealNetwork.h"
@@ -19,7 +21,7 @@ class UWorld;
 
 FString FLyraAppliedCharacterPartEntry::GetDebugString() const
 {
-	return FString::Printf(TEXT("(PartClass: %s, Socket: %s, Instance: %s)"), *GetPathNameSafe(Part.PartClass), *Part.SocketName.ToString(), *GetPathNameSafe(SpawnedComponent));
+	return FString::Printf(TEXT("(PartClass: %s, Socket: %s, Instance: %s)"), *GetPathNameSafe(Part.PartClass), *Part.SocketName.ToString(), *GetPathNameSafe(SpawnedActor));
 }
 
 //////////////////////////////////////////////////////////////////////
@@ -132,22 +134,45 @@ void FLyraCharacterPartList::ClearAllEntries(bool bBroadcastChangeDelegate)
 	}
 }
 
-FGameplayTagContainer FLyraCharacterPartList::CollectCombinedTags() const
+void FLyraCharacterPartList::AddCombinedTags(const FGameplayTagContainer& Tags)
 {
-	FGameplayTagContainer Result;
+	bool bChanged = false;
+	for (const FGameplayTag& Tag : Tags)
+	{
+		int32& Count = CombinedTagCounts.FindOrAdd(Tag);
+		if (Count++ == 0)
+		{
+			CombinedTags.AddTagFast(Tag);
+			bChanged = true;
+		}
+	}
 
-	for (const FLyraAppliedCharacterPartEntry& Entry : Entries)
+	if (bChanged)
 	{
-		if (Entry.SpawnedComponent != nullptr)
+		++CombinedTagsRevision;
+	}
+}
+
+void FLyraCharacterPartList::RemoveCombinedTags(const FGameplayTagContainer& Tags)
+{
+	bool bChanged = false;
+	for (const FGameplayTag& Tag : Tags)
+	{
+		if (int32* Count = CombinedTagCounts.Find(Tag))
 		{
-			if (IGameplayTagAssetInterface* TagInterface = Cast<IGameplayTagAssetInterface>(Entry.SpawnedComponent->GetChildActor()))
+			if (--(*Count) <= 0)
 			{
-				TagInterface->GetOwnedGameplayTags(/*inout*/ Result);
+				CombinedTagCounts.Remove(Tag);
+				CombinedTags.RemoveTag(Tag);
+				bChanged = true;
 			}
 		}
 	}
 
-	return Result;
+	if (bChanged)
+	{
+		++CombinedTagsRevision;
+	}
 }
 
 bool FLyraCharacterPartList::SpawnActorForEntry(FLyraAppliedCharacterPartEntry& Entry)
@@ -158,55 +183,145 @@ bool FLyraCharacterPartList::SpawnActorForEntry(FLyraAppliedCharacterPartEntry&
 	{
 		if (Entry.Part.PartClass != nullptr)
 		{
-			UWorld* World = OwnerComponent->GetWorld();
+			// Every request gets a new id, so a request queued before the entry changed is ignored
+			Entry.SpawnId = SpawnIdCounter++;
+
+			ULyraCharacterPartSpawner* Spawner = OwnerComponent->GetWorld()->GetSubsystem<ULyraCharacterPartSpawner>();
+			if ((Spawner != nullptr) && ULyraCharacterPartSpawner::ShouldQueueSpawns())
+			{
+				// The local player's own parts jump the queue
+				const APawn* OwnerPawn = OwnerComponent->GetPawn<APawn>();
+				const bool bHighPriority = (OwnerPawn != nullptr) && OwnerPawn->IsLocallyControlled();
+
+				Entry.bSpawnPending = true;
+				Spawner->QueuePartSpawn(OwnerComponent, Entry.SpawnId, bHighPriority);
+			}
+			else
+			{
+				bCreatedAnyActors = FinishSpawnForEntry(Entry, Spawner);
+			}
+		}
+	}
+
+	return bCreatedAnyActors;
+}
 
-			if (USceneComponent* ComponentToAttachTo = OwnerComponent->GetSceneComponentToAttachTo())
+bool FLyraCharacterPartList::SpawnPendingEntry(int32 SpawnId)
+{
+	if (OwnerComponent != nullptr)
+	{
+		for (FLyraAppliedCharacterPartEntry& Entry : Entries)
+		{
+			if (Entry.bSpawnPending && (Entry.SpawnId == SpawnId))
 			{
-				const FTransform SpawnTransform = ComponentToAttachTo->GetSocketTransform(Entry.Part.SocketName);
+				Entry.bSpawnPending = false;
+				return FinishSpawnForEntry(Entry, OwnerComponent->GetWorld()->GetSubsystem<ULyraCharacterPartSpawner>());
+			}
+		}
+	}
+
+	return false;
+}
+
+bool FLyraCharacterPartList::FinishSpawnForEntry(FLyraAppliedCharacterPartEntry& Entry, ULyraCharacterPartSpawner* Spawner)
+{
+	USceneComponent* ComponentToAttachTo = OwnerComponent->GetSceneComponentToAttachTo();
+	if (ComponentToAttachTo == nullptr)
+	{
+		return false;
+	}
+
+	const FTransform SpawnTransform = ComponentToAttachTo->GetSocketTransform(Entry.Part.SocketName);
+
+	AActor* SpawnedActor = nullptr;
+	bool bReusedActor = false;
+	if (Spawner != nullptr)
+	{
+		SpawnedActor = Spawner->AcquirePartActor(Entry.Part.PartClass, OwnerComponent->GetOwner(), SpawnTransform, /*out*/ bReusedActor);
+	}
+	else
+	{
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.Owner = OwnerComponent->GetOwner();
+		SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+		SpawnParams.ObjectFlags |= RF_Transient;
+		SpawnedActor = OwnerComponent->GetWorld()->SpawnActor<AActor>(Entry.Part.PartClass, SpawnTransform, SpawnParams);
+	}
+
+	if (SpawnedActor == nullptr)
+	{
+		return false;
+	}
+
+	SpawnedActor->AttachToComponent(ComponentToAttachTo, FAttachmentTransformRules::SnapToTargetIncludingScale, Entry.Part.SocketName);
 
-				UChildActorComponent* PartComponent = NewObject<UChildActorComponent>(OwnerComponent->GetOwner());
+	switch (Entry.Part.CollisionMode)
+	{
+	case ECharacterCustomizationCollisionMode::UseCollisionFromCharacterPart:
+		// Do nothing
+		break;
 
-				PartComponent->SetupAttachment(ComponentToAttachTo, Entry.Part.SocketName);
-				PartComponent->SetChildActorClass(Entry.Part.PartClass);
-				PartComponent->RegisterComponent();
+	case ECharacterCustomizationCollisionMode::NoCollision:
+		SpawnedActor->SetActorEnableCollision(false);
+		break;
+	}
 
-				if (AActor* SpawnedActor = PartComponent->GetChildActor())
+	// Set up a direct tick dependency so the part ticks after the mesh it's attached to
+	if (USceneComponent* SpawnedRootComponent = SpawnedActor->GetRootComponent())
+	{
+		SpawnedRootComponent->AddTickPrerequisiteComponent(ComponentToAttachTo);
+	}
+
+	// A reused part may still be following the pose of the pawn it was released from
+	if (bReusedActor)
+	{
+		if (USkinnedMeshComponent* NewLeaderPoseComponent = Cast<USkinnedMeshComponent>(ComponentToAttachTo))
+		{
+			SpawnedActor->ForEachComponent<USkinnedMeshComponent>(/*bIncludeFromChildActors=*/ false, [NewLeaderPoseComponent](USkinnedMeshComponent* PartMeshComponent)
+			{
+				if (PartMeshComponent->LeaderPoseComponent.IsValid() || PartMeshComponent->LeaderPoseComponent.IsStale())
 				{
-					switch (Entry.Part.CollisionMode)
-					{
-					case ECharacterCustomizationCollisionMode::UseCollisionFromCharacterPart:
-						// Do nothing
-						break;
-
-					case ECharacterCustomizationCollisionMode::NoCollision:
-						SpawnedActor->SetActorEnableCollision(false);
-						break;
-					}
-
-					// Set up a direct tick dependency to work around the child actor component not providing one
-					if (USceneComponent* SpawnedRootComponent = SpawnedActor->GetRootComponent())
-					{
-						SpawnedRootComponent->AddTickPrerequisiteComponent(ComponentToAttachTo);
-					}
+					PartMeshComponent->SetLeaderPoseComponent(NewLeaderPoseComponent);
 				}
-
-				Entry.SpawnedComponent = PartComponent;
-				bCreatedAnyActors = true;
-			}
+			});
 		}
 	}
 
-	return bCreatedAnyActors;
+	Entry.SpawnedActor = SpawnedActor;
+
+	Entry.SpawnedActorTags.Reset();
+	if (IGameplayTagAssetInterface* TagInterface = Cast<IGameplayTagAssetInterface>(SpawnedActor))
+	{
+		TagInterface->GetOwnedGameplayTags(/*inout*/ Entry.SpawnedActorTags);
+	}
+	AddCombinedTags(Entry.SpawnedActorTags);
+
+	return true;
 }
 
 bool FLyraCharacterPartList::DestroyActorForEntry(FLyraAppliedCharacterPartEntry& Entry)
 {
 	bool bDestroyedAnyActors = false;
 
-	if (Entry.SpawnedComponent != nullptr)
+	// Any queued request for this entry is now stale
+	Entry.bSpawnPending = false;
+
+	if (Entry.SpawnedActor != nullptr)
 	{
-		Entry.SpawnedComponent->DestroyComponent();
-		Entry.SpawnedComponent = nullptr;
+		RemoveCombinedTags(Entry.SpawnedActorTags);
+		Entry.SpawnedActorTags.Reset();
+
+		UWorld* World = (OwnerComponent != nullptr) ? OwnerComponent->GetWorld() : nullptr;
+		if (ULyraCharacterPartSpawner* Spawner = (World != nullptr) ? World->GetSubsystem<ULyraCharacterPartSpawner>() : nullptr)
+		{
+			Spawner->ReleasePartActor(Entry.SpawnedActor);
+		}
+		else
+		{
+			Entry.SpawnedActor->Destroy();
+		}
+
+		Entry.SpawnedActor = nullptr;
 		bDestroyedAnyActors = true;
 	}
 
@@ -221,6 +336,17 @@ ULyraPawnComponent_CharacterParts::ULyraPawnComponent_CharacterParts(const FObje
 	SetIsReplicatedByDefault(true);
 }
 
+#if WITH_EDITOR
+void ULyraPawnComponent_CharacterParts::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+
+	// The body style rules don't notice being edited in place, and the body style is selected again on the next change
+	BodyMeshes.ResetRuleSelection();
+	BodyStyleTagsRevision = MAX_uint32;
+}
+#endif
+
 void ULyraPawnComponent_CharacterParts::GetLifetimeReplicatedProps(TArray< FLifetimeProperty >& OutLifetimeProps) const
 {
 	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
@@ -272,12 +398,9 @@ TArray<AActor*> ULyraPawnComponent_CharacterParts::GetCharacterPartActors() cons
 
 	for (const FLyraAppliedCharacterPartEntry& Entry : CharacterPartList.Entries)
 	{
-		if (UChildActorComponent* PartComponent = Entry.SpawnedComponent)
+		if (AActor* SpawnedActor = Entry.SpawnedActor)
 		{
-			if (AActor* SpawnedActor = PartComponent->GetChildActor())
-			{
-				Result.Add(SpawnedActor);
-			}
+			Result.Add(SpawnedActor);
 		}
 	}
 
@@ -316,9 +439,22 @@ USceneComponent* ULyraPawnComponent_CharacterParts::GetSceneComponentToAttachTo(
 	}
 }
 
+bool ULyraPawnComponent_CharacterParts::HasPendingParts() const
+{
+	for (const FLyraAppliedCharacterPartEntry& Entry : CharacterPartList.Entries)
+	{
+		if (Entry.bSpawnPending)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
 FGameplayTagContainer ULyraPawnComponent_CharacterParts::GetCombinedTags(FGameplayTag RequiredPrefix) const
 {
-	FGameplayTagContainer Result = CharacterPartList.CollectCombinedTags();
+	const FGameplayTagContainer& Result = CharacterPartList.CollectCombinedTags();
 	if (RequiredPrefix.IsValid())
 	{
 		return Result.Filter(FGameplayTagContainer(RequiredPrefix));
@@ -336,17 +472,24 @@ void ULyraPawnComponent_CharacterParts::BroadcastChanged()
 	// Check to see if the body type has changed
 	if (USkeletalMeshComponent* MeshComponent = GetParentMeshComponent())
 	{
-		// Determine the mesh to use based on cosmetic part tags
-		const FGameplayTagContainer MergedTags = GetCombinedTags(FGameplayTag());
-		USkeletalMesh* DesiredMesh = BodyMeshes.SelectBestBodyStyle(MergedTags);
+		// The body style only depends on the combined part tags, so it's only reselected when they changed
+		const uint32 TagsRevision = CharacterPartList.GetCombinedTagsRevision();
+		if (TagsRevision != BodyStyleTagsRevision)
+		{
+			BodyStyleTagsRevision = TagsRevision;
 
-		// Apply the desired mesh (this call is a no-op if the mesh hasn't changed)
-		MeshComponent->SetSkeletalMesh(DesiredMesh, /*bReinitPose=*/ bReinitPose);
+			// Determine the mesh to use based on cosmetic part tags
+			USkeletalMesh* DesiredMesh = BodyMeshes.SelectBestBodyStyle(CharacterPartList.CollectCombinedTags());
 
-		// Apply the desired physics asset if there's a forced override independent of the one from the mesh
-		if (UPhysicsAsset* PhysicsAsset = BodyMeshes.ForcedPhysicsAsset)
-		{
-			MeshComponent->SetPhysicsAsset(PhysicsAsset, /*bForceReInit=*/ bReinitPose);
+			// Apply the desired mesh (this call is a no-op if the mesh hasn't changed)
+			MeshComponent->SetSkeletalMesh(DesiredMesh, /*bReinitPose=*/ bReinitPose);
+
+			// Apply the desired physics asset if there's a forced override independent of the one from the mesh
+			UPhysicsAsset* PhysicsAsset = BodyMeshes.ForcedPhysicsAsset;
+			if ((PhysicsAsset != nullptr) && (MeshComponent->GetPhysicsAsset() != PhysicsAsset))
+			{
+				MeshComponent->SetPhysicsAsset(PhysicsAsset, /*bForceReInit=*/ bReinitPose);
+			}
 		}
 	}
 
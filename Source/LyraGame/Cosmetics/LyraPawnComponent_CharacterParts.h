@@ -15,7 +15,7 @@ struct FGameplayTag;
 struct FLyraCharacterPartList;
 
 class AActor;
-class UChildActorComponent;
+class ULyraCharacterPartSpawner;
 class UObject;
 class USceneComponent;
 class USkeletalMeshComponent;
@@ -52,7 +52,19 @@ private:
 
 	// The spawned actor instance (client only)
 	UPROPERTY(NotReplicated)
-	TObjectPtr<UChildActorComponent> SpawnedComponent = nullptr;
+	TObjectPtr<AActor> SpawnedActor = nullptr;
+
+	// Gameplay tags owned by the spawned actor, gathered once when it was spawned (client only)
+	UPROPERTY(NotReplicated)
+	FGameplayTagContainer SpawnedActorTags;
+
+	// Identifies the latest spawn request for this entry, so stale queued requests are ignored (client only)
+	UPROPERTY(NotReplicated)
+	int32 SpawnId = INDEX_NONE;
+
+	// True while the actor for this entry is waiting in the ULyraCharacterPartSpawner queue (client only)
+	UPROPERTY(NotReplicated)
+	bool bSpawnPending = false;
 };
 
 //////////////////////////////////////////////////////////////////////
@@ -84,7 +96,11 @@ public:
 	void RemoveEntry(FLyraCharacterPartHandle Handle);
 	void ClearAllEntries(bool bBroadcastChangeDelegate);
 
-	FGameplayTagContainer CollectCombinedTags() const;
+	// Returns the tags of every spawned part, kept up to date as parts are spawned and destroyed
+	const FGameplayTagContainer& CollectCombinedTags() const { return CombinedTags; }
+
+	// Incremented whenever the combined tags change
+	uint32 GetCombinedTagsRevision() const { return CombinedTagsRevision; }
 
 	void SetOwnerComponent(ULyraPawnComponent_CharacterParts* InOwnerComponent)
 	{
@@ -97,6 +113,13 @@ private:
 	bool SpawnActorForEntry(FLyraAppliedCharacterPartEntry& Entry);
 	bool DestroyActorForEntry(FLyraAppliedCharacterPartEntry& Entry);
 
+	// Spawns the actor for the entry whose queued request matches SpawnId, returns false if the request is stale
+	bool SpawnPendingEntry(int32 SpawnId);
+	bool FinishSpawnForEntry(FLyraAppliedCharacterPartEntry& Entry, ULyraCharacterPartSpawner* Spawner);
+
+	void AddCombinedTags(const FGameplayTagContainer& Tags);
+	void RemoveCombinedTags(const FGameplayTagContainer& Tags);
+
 private:
 	// Replicated list of equipment entries
 	UPROPERTY()
@@ -108,6 +131,14 @@ private:
 
 	// Upcounter for handles
 	int32 PartHandleCounter = 0;
+
+	// Upcounter for spawn requests
+	int32 SpawnIdCounter = 0;
+
+	// Number of spawned parts owning each tag, and the union of those tags
+	TMap<FGameplayTag, int32> CombinedTagCounts;
+	FGameplayTagContainer CombinedTags;
+	uint32 CombinedTagsRevision = 0;
 };
 
 template<>
@@ -120,13 +151,19 @@ struct TStructOpsTypeTraits<FLyraCharacterPartList> : public TStructOpsTypeTrait
 
 // A component that handles spawning cosmetic actors attached to the owner pawn on all clients
 UCLASS(meta=(BlueprintSpawnableComponent))
-class ULyraPawnComponent_CharacterParts : public UPawnComponent
+class LYRAGAME_API ULyraPawnComponent_CharacterParts : public UPawnComponent
 {
 	GENERATED_BODY()
 
 public:
 	ULyraPawnComponent_CharacterParts(const FObjectInitializer& ObjectInitializer = FObjectInitializer::Get());
 
+	//~UObject interface
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+	//~End of UObject interface
+
 	//~UActorComponent interface
 	virtual void BeginPlay() override;
 	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
@@ -162,6 +199,12 @@ public:
 
 	void BroadcastChanged();
 
+	// Called by ULyraCharacterPartSpawner when a queued part reaches the front of the queue, returns true if an actor was spawned
+	bool SpawnPendingPart(int32 SpawnId) { return CharacterPartList.SpawnPendingEntry(SpawnId); }
+
+	// Returns true if any character part is still waiting to be spawned
+	bool HasPendingParts() const;
+
 public:
 	// Delegate that will be called when the list of spawned character parts has changed
 	UPROPERTY(BlueprintAssignable, Category=Cosmetics, BlueprintCallable)
@@ -175,4 +218,7 @@ private:
 	// Rules for how to pick a body style mesh for animation to play on, based on character part cosmetics tags
 	UPROPERTY(EditAnywhere, Category=Cosmetics)
 	FLyraAnimBodyStyleSelectionSet BodyMeshes;
+
+	// The combined tags revision the body style was last selected for, so unrelated part changes skip the selection
+	uint32 BodyStyleTagsRevision = MAX_uint32;
 };
@@ -44,6 +44,16 @@ void ULyraBotCheats::RemovePlayerBot()
 #endif	
 }
 
+void ULyraBotCheats::SetPlayerBotCount(int32 NumBots)
+{
+#if WITH_SERVER_CODE && UE_WITH_CHEAT_MANAGER
+	if (ULyraBotCreationComponent* BotComponent = GetBotComponent())
+	{
+		BotComponent->Cheat_SetBotCount(NumBots);
+	}
+#endif
+}
+
 ULyraBotCreationComponent* ULyraBotCheats::GetBotComponent() const
 {
 	if (UWorld* World = GetWorld())
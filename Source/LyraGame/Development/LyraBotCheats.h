@@ -27,6 +27,10 @@ public:
 	UFUNCTION(Exec, BlueprintAuthorityOnly)
 	void RemovePlayerBot();
 
+	// Adds or removes bot players over the next few frames until there are NumBots
+	UFUNCTION(Exec, BlueprintAuthorityOnly)
+	void SetPlayerBotCount(int32 NumBots);
+
 private:
 	ULyraBotCreationComponent* GetBotComponent() const;
 };
@@ -1,10 +1,15 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "GameFeatureAction_AddAbilities.h"
+#include "Engine/AssetManager.h"
+#include "Engine/DataTable.h"
 #include "Engine/GameInstance.h"
+#include "Engine/StreamableManager.h"
 #include "Components/GameFrameworkComponentManager.h"
 #include "AbilitySystem/LyraAbilitySystemComponent.h"
+#include "AttributeSet.h"
 #include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
 #include "Player/LyraPlayerState.h" //@TODO: For the fname
 #include "GameFeatures/GameFeatureAction_WorldActionBase.h"
 
@@ -16,6 +21,17 @@
 
 #define LOCTEXT_NAMESPACE "GameFeatures"
 
+namespace LyraAddAbilities
+{
+	static bool bPreloadAbilityGrants = true;
+	static FAutoConsoleVariableRef CVarPreloadAbilityGrants(
+		TEXT("Lyra.GameFeatures.PreloadAbilityGrants"),
+		bPreloadAbilityGrants,
+		TEXT("Should Add Abilities actions load everything they grant and parse attribute initialization data when their feature activates?\n")
+		TEXT("  If false, every actor that receives the grants loads them synchronously and parses the data tables itself"),
+		ECVF_Default);
+}
+
 //////////////////////////////////////////////////////////////////////
 // UGameFeatureAction_AddAbilities
 
@@ -28,6 +44,10 @@ void UGameFeatureAction_AddAbilities::OnGameFeatureActivating(FGameFeatureActiva
 	{
 		Reset(ActiveData);
 	}
+
+	// Start loading before the extension handlers are added, the actors they find wait for it
+	StartPreload(Context, ActiveData);
+
 	Super::OnGameFeatureActivating(Context);
 }
 
@@ -139,6 +159,145 @@ void UGameFeatureAction_AddAbilities::Reset(FPerContextData& ActiveData)
 	}
 
 	ActiveData.ComponentRequests.Empty();
+
+	if (ActiveData.PreloadHandle.IsValid())
+	{
+		ActiveData.PreloadHandle->CancelHandle();
+		ActiveData.PreloadHandle.Reset();
+	}
+
+	ActiveData.bGrantsReady = false;
+	ActiveData.bUseAttributeInitCache = false;
+	ActiveData.PendingExtensions.Empty();
+	ActiveData.AttributeInitData.Empty();
+}
+
+void UGameFeatureAction_AddAbilities::StartPreload(const FGameFeatureStateChangeContext& ChangeContext, FPerContextData& ActiveData)
+{
+	if (!LyraAddAbilities::bPreloadAbilityGrants)
+	{
+		ActiveData.bGrantsReady = true;
+		return;
+	}
+
+	TArray<FSoftObjectPath> PathsToLoad;
+	for (const FGameFeatureAbilitiesEntry& Entry : AbilitiesList)
+	{
+		for (const FLyraAbilityGrant& Ability : Entry.GrantedAbilities)
+		{
+			if (!Ability.AbilityType.IsNull())
+			{
+				PathsToLoad.AddUnique(Ability.AbilityType.ToSoftObjectPath());
+			}
+		}
+
+		for (const FLyraAttributeSetGrant& Attributes : Entry.GrantedAttributes)
+		{
+			if (!Attributes.AttributeSetType.IsNull())
+			{
+				PathsToLoad.AddUnique(Attributes.AttributeSetType.ToSoftObjectPath());
+			}
+			if (!Attributes.InitializationData.IsNull())
+			{
+				PathsToLoad.AddUnique(Attributes.InitializationData.ToSoftObjectPath());
+			}
+		}
+
+		for (const TSoftObjectPtr<const ULyraAbilitySet>& SetPtr : Entry.GrantedAbilitySets)
+		{
+			if (!SetPtr.IsNull())
+			{
+				PathsToLoad.AddUnique(SetPtr.ToSoftObjectPath());
+			}
+		}
+	}
+
+	ActiveData.bUseAttributeInitCache = true;
+
+	if (PathsToLoad.Num() > 0)
+	{
+		FStreamableManager& StreamableManager = UAssetManager::GetStreamableManager();
+		ActiveData.PreloadHandle = StreamableManager.RequestAsyncLoad(PathsToLoad, FStreamableDelegate::CreateUObject(this, &ThisClass::HandlePreloadComplete, ChangeContext), FStreamableManager::AsyncLoadHighPriority, false, false, TEXT("GameFeatureAction_AddAbilities"));
+	}
+
+	if (!ActiveData.PreloadHandle.IsValid() || ActiveData.PreloadHandle->HasLoadCompleted())
+	{
+		OnGrantsReady(ActiveData);
+	}
+}
+
+void UGameFeatureAction_AddAbilities::HandlePreloadComplete(FGameFeatureStateChangeContext ChangeContext)
+{
+	if (FPerContextData* ActiveData = ContextData.Find(ChangeContext))
+	{
+		OnGrantsReady(*ActiveData);
+	}
+}
+
+void UGameFeatureAction_AddAbilities::OnGrantsReady(FPerContextData& ActiveData)
+{
+	if (ActiveData.bGrantsReady)
+	{
+		return;
+	}
+
+	ActiveData.bGrantsReady = true;
+
+	// Parse each table now, so the actors that receive it only copy the values
+	for (const FGameFeatureAbilitiesEntry& Entry : AbilitiesList)
+	{
+		for (const FLyraAttributeSetGrant& Attributes : Entry.GrantedAttributes)
+		{
+			const UClass* SetType = Attributes.AttributeSetType.Get();
+			const UDataTable* InitData = Attributes.InitializationData.Get();
+			if (SetType && InitData)
+			{
+				FindOrAddAttributeInitData(SetType, InitData, ActiveData);
+			}
+		}
+	}
+
+	TArray<FPendingActorExtension> PendingExtensions = MoveTemp(ActiveData.PendingExtensions);
+	ActiveData.PendingExtensions.Reset();
+
+	for (const FPendingActorExtension& PendingExtension : PendingExtensions)
+	{
+		AActor* Actor = PendingExtension.Actor.Get();
+		if (Actor && AbilitiesList.IsValidIndex(PendingExtension.EntryIndex))
+		{
+			AddActorAbilities(Actor, AbilitiesList[PendingExtension.EntryIndex], ActiveData);
+		}
+	}
+}
+
+const TArray<UGameFeatureAction_AddAbilities::FAttributeInitValue>& UGameFeatureAction_AddAbilities::FindOrAddAttributeInitData(const UClass* SetType, const UDataTable* InitData, FPerContextData& ActiveData)
+{
+	const TPair<const UClass*, const UDataTable*> Key(SetType, InitData);
+	if (const TArray<FAttributeInitValue>* ExistingValues = ActiveData.AttributeInitData.Find(Key))
+	{
+		return *ExistingValues;
+	}
+
+	static const FString Context = FString(TEXT("UGameFeatureAction_AddAbilities::FindOrAddAttributeInitData"));
+
+	// Finds the same rows as UAttributeSet::InitFromMetaDataTable, which builds every row name and looks it up for every set it initializes
+	TArray<FAttributeInitValue>& Values = ActiveData.AttributeInitData.Add(Key);
+	for (TFieldIterator<FProperty> It(SetType, EFieldIteratorFlags::IncludeSuper); It; ++It)
+	{
+		FProperty* Property = *It;
+		if (CastField<FNumericProperty>(Property) || FGameplayAttribute::IsGameplayAttributeDataProperty(Property))
+		{
+			const FString RowNameStr = FString::Printf(TEXT("%s.%s"), *Property->GetOwnerVariant().GetName(), *Property->GetName());
+			if (const FAttributeMetaData* MetaData = InitData->FindRow<FAttributeMetaData>(FName(*RowNameStr), Context, false))
+			{
+				FAttributeInitValue& Value = Values.AddDefaulted_GetRef();
+				Value.Property = Property;
+				Value.BaseValue = MetaData->BaseValue;
+			}
+		}
+	}
+
+	return Values;
 }
 
 void UGameFeatureAction_AddAbilities::HandleActorExtension(AActor* Actor, FName EventName, int32 EntryIndex, FGameFeatureStateChangeContext ChangeContext)
@@ -149,10 +308,24 @@ void UGameFeatureAction_AddAbilities::HandleActorExtension(AActor* Actor, FName
 		const FGameFeatureAbilitiesEntry& Entry = AbilitiesList[EntryIndex];
 		if ((EventName == UGameFrameworkComponentManager::NAME_ExtensionRemoved) || (EventName == UGameFrameworkComponentManager::NAME_ReceiverRemoved))
 		{
+			ActiveData->PendingExtensions.RemoveAll([Actor](const FPendingActorExtension& PendingExtension) { return PendingExtension.Actor == Actor; });
 			RemoveActorAbilities(Actor, *ActiveData);
 		}
 		else if ((EventName == UGameFrameworkComponentManager::NAME_ExtensionAdded) || (EventName == ALyraPlayerState::NAME_LyraAbilityReady))
 		{
+			if (!ActiveData->bGrantsReady)
+			{
+				// Granted when the preload finishes
+				const bool bAlreadyPending = ActiveData->PendingExtensions.ContainsByPredicate([Actor, EntryIndex](const FPendingActorExtension& PendingExtension) { return (PendingExtension.Actor == Actor) && (PendingExtension.EntryIndex == EntryIndex); });
+				if (!bAlreadyPending)
+				{
+					FPendingActorExtension& PendingExtension = ActiveData->PendingExtensions.AddDefaulted_GetRef();
+					PendingExtension.Actor = Actor;
+					PendingExtension.EntryIndex = EntryIndex;
+				}
+				return;
+			}
+
 			AddActorAbilities(Actor, Entry, *ActiveData);
 		}
 	}
@@ -183,6 +356,7 @@ void UGameFeatureAction_AddAbilities::AddActorAbilities(AActor* Actor, const FGa
 		{
 			if (!Ability.AbilityType.IsNull())
 			{
+				// Already loaded unless Lyra.GameFeatures.PreloadAbilityGrants is off
 				FGameplayAbilitySpec NewAbilitySpec(Ability.AbilityType.LoadSynchronous());
 				FGameplayAbilitySpecHandle AbilityHandle = AbilitySystemComponent->GiveAbility(NewAbilitySpec);
 
@@ -201,7 +375,23 @@ void UGameFeatureAction_AddAbilities::AddActorAbilities(AActor* Actor, const FGa
 					if (!Attributes.InitializationData.IsNull())
 					{
 						UDataTable* InitData = Attributes.InitializationData.LoadSynchronous();
-						if (InitData)
+						if (InitData && ActiveData.bUseAttributeInitCache)
+						{
+							for (const FAttributeInitValue& Value : FindOrAddAttributeInitData(SetType, InitData, ActiveData))
+							{
+								if (const FNumericProperty* NumericProperty = CastField<FNumericProperty>(Value.Property))
+								{
+									NumericProperty->SetFloatingPointPropertyValue(NumericProperty->ContainerPtrToValuePtr<void>(NewSet), Value.BaseValue);
+								}
+								else
+								{
+									FGameplayAttributeData* DataPtr = CastFieldChecked<FStructProperty>(Value.Property)->ContainerPtrToValuePtr<FGameplayAttributeData>(NewSet);
+									DataPtr->SetBaseValue(Value.BaseValue);
+									DataPtr->SetCurrentValue(Value.BaseValue);
+								}
+							}
+						}
+						else if (InitData)
 						{
 							NewSet->InitFromMetaDataTable(InitData);
 						}
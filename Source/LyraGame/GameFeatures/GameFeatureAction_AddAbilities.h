@@ -13,6 +13,7 @@ class UInputAction;
 class UAttributeSet;
 class UDataTable;
 struct FComponentRequestHandle;
+struct FStreamableHandle;
 class ULyraAbilitySet;
 
 USTRUCT(BlueprintType)
@@ -70,6 +71,10 @@ struct FGameFeatureAbilitiesEntry
 
 /**
  * GameFeatureAction responsible for granting abilities (and attributes) to actors of a specified type.
+ *
+ * Everything the grants reference is loaded asynchronously when the feature activates, and each attribute set's
+ * initialization data table is parsed once then. Actors that ask for their grants before that has finished are
+ * queued and granted when it does. Lyra.GameFeatures.PreloadAbilityGrants=0 loads and parses for each actor instead.
  */
 UCLASS(MinimalAPI, meta = (DisplayName = "Add Abilities"))
 class UGameFeatureAction_AddAbilities final : public UGameFeatureAction_WorldActionBase
@@ -100,10 +105,34 @@ private:
 		TArray<FLyraAbilitySet_GrantedHandles> AbilitySetHandles;
 	};
 
+	struct FPendingActorExtension
+	{
+		TWeakObjectPtr<AActor> Actor;
+		int32 EntryIndex = INDEX_NONE;
+	};
+
+	/** An attribute and the base value an initialization data table gives it */
+	struct FAttributeInitValue
+	{
+		FProperty* Property = nullptr;
+		float BaseValue = 0.0f;
+	};
+
 	struct FPerContextData
 	{
 		TMap<AActor*, FActorExtensions> ActiveExtensions;
 		TArray<TSharedPtr<FComponentRequestHandle>> ComponentRequests;
+
+		// Keeps everything the grants reference loaded while the feature is active
+		TSharedPtr<FStreamableHandle> PreloadHandle;
+
+		// Actors are only granted once the preload has finished, until then they wait in PendingExtensions
+		bool bGrantsReady = false;
+		bool bUseAttributeInitCache = false;
+		TArray<FPendingActorExtension> PendingExtensions;
+
+		// What InitFromMetaDataTable would set, for each attribute set class and table
+		TMap<TPair<const UClass*, const UDataTable*>, TArray<FAttributeInitValue>> AttributeInitData;
 	};
 	
 	TMap<FGameFeatureStateChangeContext, FPerContextData> ContextData;	
@@ -113,6 +142,10 @@ private:
 	//~ End UGameFeatureAction_WorldActionBase interface
 
 	void Reset(FPerContextData& ActiveData);
+	void StartPreload(const FGameFeatureStateChangeContext& ChangeContext, FPerContextData& ActiveData);
+	void HandlePreloadComplete(FGameFeatureStateChangeContext ChangeContext);
+	void OnGrantsReady(FPerContextData& ActiveData);
+	const TArray<FAttributeInitValue>& FindOrAddAttributeInitData(const UClass* SetType, const UDataTable* InitData, FPerContextData& ActiveData);
 	void HandleActorExtension(AActor* Actor, FName EventName, int32 EntryIndex, FGameFeatureStateChangeContext ChangeContext);
 	void AddActorAbilities(AActor* Actor, const FGameFeatureAbilitiesEntry& AbilitiesEntry, FPerContextData& ActiveData);
 	void RemoveActorAbilities(AActor* Actor, FPerContextData& ActiveData);
@@ -10,12 +10,32 @@
 #include "AIController.h"
 #include "Kismet/GameplayStatics.h"
 #include "Character/LyraHealthComponent.h"
+#include "HAL/IConsoleManager.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(LyraBotCreationComponent)
 
+namespace LyraBotCreation
+{
+	static float SpawnBudgetMs = 4.0f;
+	static FAutoConsoleVariableRef CVarSpawnBudgetMs(
+		TEXT("Lyra.Bots.SpawnBudgetMs"),
+		SpawnBudgetMs,
+		TEXT("Time in milliseconds the bot creation component may spend per frame adding or removing bots. At least one bot is processed per frame."),
+		ECVF_Default);
+
+	static int32 MaxPooledBots = 64;
+	static FAutoConsoleVariableRef CVarMaxPooledBots(
+		TEXT("Lyra.Bots.MaxPooledBots"),
+		MaxPooledBots,
+		TEXT("Maximum number of removed bots whose controller and player state are kept for reuse. 0 destroys removed bots."),
+		ECVF_Default);
+}
+
 ULyraBotCreationComponent::ULyraBotCreationComponent(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
 {
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
 }
 
 void ULyraBotCreationComponent::BeginPlay()
@@ -70,10 +90,45 @@ void ULyraBotCreationComponent::ServerCreateBots_Implementation()
 		EffectiveBotCount = UGameplayStatics::GetIntOption(GameModeBase->OptionsString, TEXT("NumBots"), EffectiveBotCount);
 	}
 
-	// Create them
-	for (int32 Count = 0; Count < EffectiveBotCount; ++Count)
+	// Create them over the next few frames
+	SetTargetBotCount(EffectiveBotCount);
+}
+
+void ULyraBotCreationComponent::SetTargetBotCount(int32 NewTargetBotCount)
+{
+	TargetBotCount = FMath::Max(NewTargetBotCount, 0);
+	SetComponentTickEnabled(TargetBotCount != SpawnedBotList.Num());
+}
+
+void ULyraBotCreationComponent::TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	const double EndTime = FPlatformTime::Seconds() + (LyraBotCreation::SpawnBudgetMs / 1000.0);
+
+	do
 	{
-		SpawnOneBot();
+		const int32 NumBots = SpawnedBotList.Num();
+		if (NumBots < TargetBotCount)
+		{
+			SpawnOneBot();
+		}
+		else if (NumBots > TargetBotCount)
+		{
+			RemoveOneBot();
+		}
+
+		// Stop if the bot count didn't change so a failing spawn can't stall the frame
+		if (SpawnedBotList.Num() == NumBots)
+		{
+			break;
+		}
+	}
+	while ((SpawnedBotList.Num() != TargetBotCount) && (FPlatformTime::Seconds() < EndTime));
+
+	if (SpawnedBotList.Num() == TargetBotCount)
+	{
+		SetComponentTickEnabled(false);
 	}
 }
 
@@ -97,21 +152,27 @@ FString ULyraBotCreationComponent::CreateBotName(int32 PlayerIndex)
 
 void ULyraBotCreationComponent::SpawnOneBot()
 {
-	FActorSpawnParameters SpawnInfo;
-	SpawnInfo.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
-	SpawnInfo.OverrideLevel = GetComponentLevel();
-	SpawnInfo.ObjectFlags |= RF_Transient;
-	AAIController* NewController = GetWorld()->SpawnActor<AAIController>(BotControllerClass, FVector::ZeroVector, FRotator::ZeroRotator, SpawnInfo);
+	// Reusing a removed bot skips creating the controller, player state and the abilities granted from its pawn data
+	AAIController* NewController = ReactivatePooledBot();
 
-	if (NewController != nullptr)
+	if (NewController == nullptr)
 	{
-		ALyraGameMode* GameMode = GetGameMode<ALyraGameMode>();
-		check(GameMode);
+		FActorSpawnParameters SpawnInfo;
+		SpawnInfo.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+		SpawnInfo.OverrideLevel = GetComponentLevel();
+		SpawnInfo.ObjectFlags |= RF_Transient;
+		NewController = GetWorld()->SpawnActor<AAIController>(BotControllerClass, FVector::ZeroVector, FRotator::ZeroRotator, SpawnInfo);
 
-		if (NewController->PlayerState != nullptr)
+		if ((NewController != nullptr) && (NewController->PlayerState != nullptr))
 		{
 			NewController->PlayerState->SetPlayerName(CreateBotName(NewController->PlayerState->GetPlayerId()));
 		}
+	}
+
+	if (NewController != nullptr)
+	{
+		ALyraGameMode* GameMode = GetGameMode<ALyraGameMode>();
+		check(GameMode);
 
 		GameMode->GenericPlayerInitialization(NewController);
 		GameMode->RestartPlayer(NewController);
@@ -146,8 +207,8 @@ void ULyraBotCreationComponent::RemoveOneBot()
 			{
 				if (ULyraHealthComponent* HealthComponent = ULyraHealthComponent::FindHealthComponent(ControlledPawn))
 				{
-					// Note, right now this doesn't work quite as desired: as soon as the player state goes away when
-					// the controller is destroyed, the abilities like the death animation will be interrupted immediately
+					// Note, right now this doesn't work quite as desired when the bot isn't pooled: as soon as the player state goes
+					// away when the controller is destroyed, the abilities like the death animation will be interrupted immediately
 					HealthComponent->DamageSelfDestruct();
 				}
 				else
@@ -156,12 +217,62 @@ void ULyraBotCreationComponent::RemoveOneBot()
 				}
 			}
 
-			// Destroy the controller (will cause it to Logout, etc...)
-			BotToRemove->Destroy();
+			RetireBot(BotToRemove);
 		}
 	}
 }
 
+void ULyraBotCreationComponent::RetireBot(AAIController* BotToRemove)
+{
+	APlayerState* PlayerState = BotToRemove->PlayerState;
+	AGameStateBase* GameState = GetGameStateChecked<AGameStateBase>();
+
+	if ((PlayerState == nullptr) || (PooledBotList.Num() >= LyraBotCreation::MaxPooledBots))
+	{
+		// Destroy the controller (will cause it to Logout, etc...)
+		BotToRemove->Destroy();
+		return;
+	}
+
+	// Take the player state out of the match; inactive bots are refused by ALyraGameMode::ControllerCanRestart.
+	// It stops replicating so clients drop it from their player lists as well.
+	PlayerState->SetIsInactive(true);
+	PlayerState->SetReplicates(false);
+	GameState->RemovePlayerState(PlayerState);
+
+	PooledBotList.Add(BotToRemove);
+}
+
+AAIController* ULyraBotCreationComponent::ReactivatePooledBot()
+{
+	for (int32 PoolIndex = PooledBotList.Num() - 1; PoolIndex >= 0; --PoolIndex)
+	{
+		AAIController* PooledBot = PooledBotList[PoolIndex];
+		if (!IsValid(PooledBot) || (PooledBot->PlayerState == nullptr))
+		{
+			PooledBotList.RemoveAtSwap(PoolIndex);
+			continue;
+		}
+
+		// Wait for the previous pawn to finish dying before it gets a new one
+		if (PooledBot->GetPawn() != nullptr)
+		{
+			continue;
+		}
+
+		PooledBotList.RemoveAtSwap(PoolIndex);
+
+		APlayerState* PlayerState = PooledBot->PlayerState;
+		PlayerState->SetIsInactive(false);
+		PlayerState->SetReplicates(true);
+		GetGameStateChecked<AGameStateBase>()->AddPlayerState(PlayerState);
+
+		return PooledBot;
+	}
+
+	return nullptr;
+}
+
 #else // !WITH_SERVER_CODE
 
 void ULyraBotCreationComponent::ServerCreateBots_Implementation()
@@ -169,6 +280,16 @@ void ULyraBotCreationComponent::ServerCreateBots_Implementation()
 	ensureMsgf(0, TEXT("Bot functions do not exist in LyraClient!"));
 }
 
+void ULyraBotCreationComponent::SetTargetBotCount(int32 NewTargetBotCount)
+{
+	ensureMsgf(0, TEXT("Bot functions do not exist in LyraClient!"));
+}
+
+void ULyraBotCreationComponent::TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+}
+
 void ULyraBotCreationComponent::SpawnOneBot()
 {
 	ensureMsgf(0, TEXT("Bot functions do not exist in LyraClient!"));
@@ -10,8 +10,14 @@ class ULyraExperienceDefinition;
 class ULyraPawnData;
 class AAIController;
 
+/**
+ * ULyraBotCreationComponent
+ *
+ * Maintains a population of bots on the server. Changes to the target population are applied over several frames
+ * within a time budget, and the controllers and player states of removed bots are kept in a pool for later reuse.
+ */
 UCLASS(Blueprintable, Abstract)
-class ULyraBotCreationComponent : public UGameStateComponent
+class LYRAGAME_API ULyraBotCreationComponent : public UGameStateComponent
 {
 	GENERATED_BODY()
 
@@ -20,8 +26,21 @@ public:
 
 	//~UActorComponent interface
 	virtual void BeginPlay() override;
+	virtual void TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
 	//~End of UActorComponent interface
 
+	/** Sets the number of bots to maintain; bots are added or removed over the following frames */
+	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category=Gameplay)
+	void SetTargetBotCount(int32 NewTargetBotCount);
+
+	UFUNCTION(BlueprintCallable, Category=Gameplay)
+	int32 GetTargetBotCount() const { return TargetBotCount; }
+
+	UFUNCTION(BlueprintCallable, Category=Gameplay)
+	int32 GetNumBots() const { return SpawnedBotList.Num(); }
+
+	int32 GetNumPooledBots() const { return PooledBotList.Num(); }
+
 private:
 	void OnExperienceLoaded(const ULyraExperienceDefinition* Experience);
 
@@ -41,6 +60,12 @@ protected:
 	UPROPERTY(Transient)
 	TArray<TObjectPtr<AAIController>> SpawnedBotList;
 
+	/** Controllers of removed bots, their player states are inactive until they are reused */
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<AAIController>> PooledBotList;
+
+	int32 TargetBotCount = 0;
+
 	/** Always creates a single bot */
 	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category=Gameplay)
 	virtual void SpawnOneBot();
@@ -55,9 +80,17 @@ protected:
 
 #if WITH_SERVER_CODE
 public:
-	void Cheat_AddBot() { SpawnOneBot(); }
-	void Cheat_RemoveBot() { RemoveOneBot(); }
+	void Cheat_AddBot() { SetTargetBotCount(FMath::Max(TargetBotCount, GetNumBots()) + 1); }
+	void Cheat_RemoveBot() { SetTargetBotCount(FMath::Min(TargetBotCount, GetNumBots()) - 1); }
+	void Cheat_SetBotCount(int32 NumBots) { SetTargetBotCount(NumBots); }
 
 	FString CreateBotName(int32 PlayerIndex);
+
+private:
+	/** Takes a pooled bot whose previous pawn is gone and makes its player state active again */
+	AAIController* ReactivatePooledBot();
+
+	/** Returns the bot to the pool, or destroys it if the pool is full */
+	void RetireBot(AAIController* BotToRemove);
 #endif
 };
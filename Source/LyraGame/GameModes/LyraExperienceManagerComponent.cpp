@@ -13,6 +13,7 @@
 #include "TimerManager.h"
 #include "Settings/LyraSettingsLocal.h"
 #include "LyraLogChannels.h"
+#include "AbilitySystem/LyraGameplayCueManager.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(LyraExperienceManagerComponent)
 
@@ -202,6 +203,16 @@ void ULyraExperienceManagerComponent::StartExperienceLoad()
 			}));
 	}
 
+	// Preload the gameplay cues this experience was seen using before, rather than loading them when first played
+	if (bLoadClient)
+	{
+		if (ULyraGameplayCueManager* CueManager = ULyraGameplayCueManager::Get())
+		{
+			CueManager->BeginExperienceCueUsage(CurrentExperience->GetPrimaryAssetId().PrimaryAssetName);
+			bBeganGameplayCueUsage = true;
+		}
+	}
+
 	// This set of assets gets preloaded, but we don't block the start of the experience based on it
 	TSet<FPrimaryAssetId> PreloadAssetList;
 	//@TODO: Determine assets to preload (but not blocking-ly)
@@ -381,6 +392,15 @@ void ULyraExperienceManagerComponent::EndPlay(const EEndPlayReason::Type EndPlay
 {
 	Super::EndPlay(EndPlayReason);
 
+	if (bBeganGameplayCueUsage && CurrentExperience)
+	{
+		if (ULyraGameplayCueManager* CueManager = ULyraGameplayCueManager::Get())
+		{
+			CueManager->EndExperienceCueUsage(CurrentExperience->GetPrimaryAssetId().PrimaryAssetName);
+		}
+		bBeganGameplayCueUsage = false;
+	}
+
 	// deactivate any features this experience loaded
 	//@TODO: This should be handled FILO as well
 	for (const FString& PluginURL : GameFeaturePluginURLs)
@@ -88,6 +88,9 @@ private:
 	int32 NumObservedPausers = 0;
 	int32 NumExpectedPausers = 0;
 
+	// Did this component begin the gameplay cue usage of the experience (profile preloads, and recording if enabled)?
+	bool bBeganGameplayCueUsage = false;
+
 	/**
 	 * Delegate called when the experience has finished loading just before others
 	 * (e.g., subsystems that set up for regular gameplay)
@@ -439,6 +439,12 @@ bool ALyraGameMode::ControllerCanRestart(AController* Controller)
 		{
 			return false;
 		}
+
+		// Bots pooled by ULyraBotCreationComponent keep their controller but are out of the match
+		if ((Controller->PlayerState != nullptr) && Controller->PlayerState->IsInactive())
+		{
+			return false;
+		}
 	}
 
 	if (ULyraPlayerSpawningManagerComponent* PlayerSpawningComponent = GameState->FindComponentByClass<ULyraPlayerSpawningManagerComponent>())
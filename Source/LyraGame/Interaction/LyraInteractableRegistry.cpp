@@ -0,0 +1,370 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "LyraInteractableRegistry.h"
+
+#include "Components/PrimitiveComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "Interaction/IInteractableTarget.h"
+#include "Interaction/InteractionStatics.h"
+#include "Physics/LyraCollisionChannels.h"
+#include "UObject/ScriptInterface.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(LyraInteractableRegistry)
+
+namespace LyraInteractableRegistry
+{
+	static float CellSize = 1000.0f;
+	static FAutoConsoleVariableRef CVarCellSize(
+		TEXT("Lyra.Interaction.Registry.CellSize"),
+		CellSize,
+		TEXT("Size of the spatial hash cells used by the interactable registry. Only applies to worlds created after the change."),
+		ECVF_Default);
+
+	// Avatars that moved less than this since their last query (and saw no registry changes) are not re-queried
+	static float MovementTolerance = 10.0f;
+	static FAutoConsoleVariableRef CVarMovementTolerance(
+		TEXT("Lyra.Interaction.Registry.MovementTolerance"),
+		MovementTolerance,
+		TEXT("Distance a watching avatar must move before its nearby interactables are re-evaluated."),
+		ECVF_Default);
+
+	static FVector GetInteractableLocation(const UObject* Object, const AActor* OwningActor)
+	{
+		if (const USceneComponent* SceneComponent = Cast<USceneComponent>(Object))
+		{
+			return SceneComponent->GetComponentLocation();
+		}
+		return OwningActor->GetActorLocation();
+	}
+
+	static bool DoesPrimitiveRespondToInteraction(const UPrimitiveComponent* Primitive)
+	{
+		return Primitive->IsQueryCollisionEnabled() && (Primitive->GetCollisionResponseToChannel(Lyra_TraceChannel_Interaction) != ECR_Ignore);
+	}
+
+	// Mirrors what an overlap on Lyra_TraceChannel_Interaction would find: an interactable actor with any primitive responding to the
+	// channel, or an interactable primitive component that responds to it itself
+	static bool IsInteractableFoundByInteractionChannel(const UObject* Object)
+	{
+		if (const AActor* Actor = Cast<AActor>(Object))
+		{
+			bool bResponds = false;
+			Actor->ForEachComponent<UPrimitiveComponent>(/*bIncludeFromChildActors=*/ false, [&bResponds](const UPrimitiveComponent* Primitive)
+			{
+				bResponds = bResponds || DoesPrimitiveRespondToInteraction(Primitive);
+			});
+			return bResponds;
+		}
+
+		if (const UPrimitiveComponent* Primitive = Cast<UPrimitiveComponent>(Object))
+		{
+			return DoesPrimitiveRespondToInteraction(Primitive);
+		}
+
+		return false;
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+// FLyraInteractableSpatialHash
+
+FLyraInteractableSpatialHash::FLyraInteractableSpatialHash(float InCellSize)
+	: CellSize(FMath::Max(InCellSize, 1.0f))
+{
+}
+
+FIntVector FLyraInteractableSpatialHash::GetCell(const FVector& Location) const
+{
+	return FIntVector(
+		FMath::FloorToInt32(Location.X / CellSize),
+		FMath::FloorToInt32(Location.Y / CellSize),
+		FMath::FloorToInt32(Location.Z / CellSize));
+}
+
+void FLyraInteractableSpatialHash::AddToCell(const FIntVector& Cell, int32 Id)
+{
+	Cells.FindOrAdd(Cell).Add(Id);
+}
+
+void FLyraInteractableSpatialHash::RemoveFromCell(const FIntVector& Cell, int32 Id)
+{
+	if (TArray<int32>* CellIds = Cells.Find(Cell))
+	{
+		CellIds->RemoveSingleSwap(Id, EAllowShrinking::No);
+		if (CellIds->IsEmpty())
+		{
+			Cells.Remove(Cell);
+		}
+	}
+}
+
+void FLyraInteractableSpatialHash::Add(int32 Id, const FVector& Location, float Radius)
+{
+	check(!Entries.Contains(Id));
+
+	const FIntVector Cell = GetCell(Location);
+	Entries.Add(Id, FEntry{ Location, Radius, Cell });
+	AddToCell(Cell, Id);
+
+	MaxEntryRadius = FMath::Max(MaxEntryRadius, Radius);
+}
+
+void FLyraInteractableSpatialHash::Remove(int32 Id)
+{
+	FEntry Entry;
+	if (Entries.RemoveAndCopyValue(Id, Entry))
+	{
+		RemoveFromCell(Entry.Cell, Id);
+	}
+}
+
+void FLyraInteractableSpatialHash::Move(int32 Id, const FVector& NewLocation)
+{
+	if (FEntry* Entry = Entries.Find(Id))
+	{
+		const FIntVector NewCell = GetCell(NewLocation);
+		if (NewCell != Entry->Cell)
+		{
+			RemoveFromCell(Entry->Cell, Id);
+			AddToCell(NewCell, Id);
+			Entry->Cell = NewCell;
+		}
+		Entry->Location = NewLocation;
+	}
+}
+
+void FLyraInteractableSpatialHash::QuerySphere(const FVector& Origin, float Radius, TArray<int32>& OutIds) const
+{
+	const int32 FirstNewIndex = OutIds.Num();
+
+	const FVector Extent(Radius + MaxEntryRadius);
+	const FIntVector MinCell = GetCell(Origin - Extent);
+	const FIntVector MaxCell = GetCell(Origin + Extent);
+
+	for (int32 X = MinCell.X; X <= MaxCell.X; ++X)
+	{
+		for (int32 Y = MinCell.Y; Y <= MaxCell.Y; ++Y)
+		{
+			for (int32 Z = MinCell.Z; Z <= MaxCell.Z; ++Z)
+			{
+				const TArray<int32>* CellIds = Cells.Find(FIntVector(X, Y, Z));
+				if (CellIds == nullptr)
+				{
+					continue;
+				}
+
+				for (int32 Id : *CellIds)
+				{
+					const FEntry& Entry = Entries.FindChecked(Id);
+					const float ReachDistance = Radius + Entry.Radius;
+					if (FVector::DistSquared(Origin, Entry.Location) <= FMath::Square(ReachDistance))
+					{
+						OutIds.Add(Id);
+					}
+				}
+			}
+		}
+	}
+
+	// Entries are stored in exactly one cell, so there are no duplicates to remove
+	TArrayView<int32>(OutIds).RightChop(FirstNewIndex).Sort();
+}
+
+//////////////////////////////////////////////////////////////////////
+// ULyraInteractableRegistry
+
+ULyraInteractableRegistry::ULyraInteractableRegistry()
+	: SpatialHash(LyraInteractableRegistry::CellSize)
+{
+}
+
+void ULyraInteractableRegistry::Deinitialize()
+{
+	Watchers.Reset();
+	Interactables.Reset();
+	ActorToInteractableIds.Reset();
+
+	Super::Deinitialize();
+}
+
+TStatId ULyraInteractableRegistry::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(ULyraInteractableRegistry, STATGROUP_Tickables);
+}
+
+void ULyraInteractableRegistry::RegisterInteractableActor(AActor* Actor)
+{
+	if ((Actor == nullptr) || ActorToInteractableIds.Contains(Actor))
+	{
+		return;
+	}
+
+	TArray<TScriptInterface<IInteractableTarget>> Targets;
+	UInteractionStatics::GetInteractableTargetsFromActor(Actor, Targets);
+	if (Targets.IsEmpty())
+	{
+		return;
+	}
+
+	const float Radius = Actor->GetSimpleCollisionRadius();
+
+	TArray<int32>& Ids = ActorToInteractableIds.Add(Actor);
+	for (const TScriptInterface<IInteractableTarget>& Target : Targets)
+	{
+		UObject* TargetObject = Target.GetObject();
+
+		const int32 Id = NextInteractableId++;
+		Interactables.Add(Id, FRegisteredInteractable{ TargetObject, FObjectKey(TargetObject) });
+		SpatialHash.Add(Id, LyraInteractableRegistry::GetInteractableLocation(TargetObject, Actor), Radius);
+		Ids.Add(Id);
+	}
+
+	++Revision;
+}
+
+void ULyraInteractableRegistry::UnregisterInteractableActor(AActor* Actor)
+{
+	TArray<int32> Ids;
+	if (ActorToInteractableIds.RemoveAndCopyValue(Actor, Ids))
+	{
+		for (int32 Id : Ids)
+		{
+			Interactables.Remove(Id);
+			SpatialHash.Remove(Id);
+		}
+
+		++Revision;
+	}
+}
+
+void ULyraInteractableRegistry::UpdateInteractableActorLocation(AActor* Actor)
+{
+	if (const TArray<int32>* Ids = ActorToInteractableIds.Find(Actor))
+	{
+		for (int32 Id : *Ids)
+		{
+			const FRegisteredInteractable& Interactable = Interactables.FindChecked(Id);
+			if (const UObject* TargetObject = Interactable.Object.Get())
+			{
+				SpatialHash.Move(Id, LyraInteractableRegistry::GetInteractableLocation(TargetObject, Actor));
+			}
+		}
+
+		++Revision;
+	}
+}
+
+int32 ULyraInteractableRegistry::RegisterProximityWatcher(AActor* Avatar, float Range, float UpdateInterval, FLyraInteractableProximityChanged&& OnChanged)
+{
+	if (Avatar == nullptr)
+	{
+		return INDEX_NONE;
+	}
+
+	const int32 WatcherHandle = NextWatcherHandle++;
+
+	FProximityWatcher& Watcher = Watchers.Add(WatcherHandle);
+	Watcher.Avatar = Avatar;
+	Watcher.Range = Range;
+	Watcher.UpdateInterval = UpdateInterval;
+	Watcher.OnChanged = MoveTemp(OnChanged);
+
+	return WatcherHandle;
+}
+
+void ULyraInteractableRegistry::UnregisterProximityWatcher(int32 WatcherHandle)
+{
+	Watchers.Remove(WatcherHandle);
+}
+
+void ULyraInteractableRegistry::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	const double Now = GetWorld()->GetTimeSeconds();
+
+	// Watchers may be added or removed by the change callbacks, so iterate over a snapshot of handles
+	Watchers.GenerateKeyArray(ScratchWatcherHandles);
+	for (int32 WatcherHandle : ScratchWatcherHandles)
+	{
+		UpdateWatcher(WatcherHandle, Now);
+	}
+}
+
+void ULyraInteractableRegistry::UpdateWatcher(int32 WatcherHandle, double Now)
+{
+	FProximityWatcher* Watcher = Watchers.Find(WatcherHandle);
+	if ((Watcher == nullptr) || (Now < Watcher->NextUpdateTime))
+	{
+		return;
+	}
+	Watcher->NextUpdateTime = Now + Watcher->UpdateInterval;
+
+	const AActor* Avatar = Watcher->Avatar.Get();
+	if (Avatar == nullptr)
+	{
+		return;
+	}
+
+	const FVector AvatarLocation = Avatar->GetActorLocation();
+	if (Watcher->bHasUpdated &&
+		(Watcher->LastRevision == Revision) &&
+		(FVector::DistSquared(AvatarLocation, Watcher->LastLocation) < FMath::Square(LyraInteractableRegistry::MovementTolerance)))
+	{
+		return;
+	}
+	Watcher->bHasUpdated = true;
+	Watcher->LastRevision = Revision;
+	Watcher->LastLocation = AvatarLocation;
+
+	ScratchQueryIds.Reset();
+	SpatialHash.QuerySphere(AvatarLocation, Watcher->Range, ScratchQueryIds);
+
+	ScratchNearby.Reset();
+	ScratchEntered.Reset();
+	ScratchLeft.Reset();
+
+	// Both lists are sorted by id, so a single merge pass finds everything that entered or left
+	const TArray<FNearbyInteractable>& Previous = Watcher->Nearby;
+	int32 PreviousIndex = 0;
+	int32 QueryIndex = 0;
+	while ((PreviousIndex < Previous.Num()) || (QueryIndex < ScratchQueryIds.Num()))
+	{
+		const int32 PreviousId = (PreviousIndex < Previous.Num()) ? Previous[PreviousIndex].Id : MAX_int32;
+		const int32 QueryId = (QueryIndex < ScratchQueryIds.Num()) ? ScratchQueryIds[QueryIndex] : MAX_int32;
+
+		if (PreviousId == QueryId)
+		{
+			ScratchNearby.Add(Previous[PreviousIndex]);
+			++PreviousIndex;
+			++QueryIndex;
+		}
+		else if (PreviousId < QueryId)
+		{
+			ScratchLeft.Add(Previous[PreviousIndex].Key);
+			++PreviousIndex;
+		}
+		else
+		{
+			// Interactables that don't respond to the interaction channel stay out of range until a later query finds they do
+			const FRegisteredInteractable& Interactable = Interactables.FindChecked(QueryId);
+			UObject* TargetObject = Interactable.Object.Get();
+			if ((TargetObject != nullptr) && LyraInteractableRegistry::IsInteractableFoundByInteractionChannel(TargetObject))
+			{
+				ScratchNearby.Add(FNearbyInteractable{ QueryId, Interactable.Key });
+				ScratchEntered.Add(TScriptInterface<IInteractableTarget>(TargetObject));
+			}
+			++QueryIndex;
+		}
+	}
+
+	Watcher->Nearby = ScratchNearby;
+
+	if ((ScratchEntered.Num() > 0) || (ScratchLeft.Num() > 0))
+	{
+		// Copy the delegate out, the callback is allowed to unregister this watcher
+		FLyraInteractableProximityChanged OnChanged = Watcher->OnChanged;
+		OnChanged.ExecuteIfBound(ScratchEntered, ScratchLeft);
+	}
+}
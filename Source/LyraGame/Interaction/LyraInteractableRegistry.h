@@ -0,0 +1,153 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+
+#include "LyraInteractableRegistry.generated.h"
+
+template <typename InterfaceType> class TScriptInterface;
+
+class AActor;
+class IInteractableTarget;
+class UObject;
+class UWorld;
+
+/**
+ * Uniform grid of interactable bounds, keyed by caller-provided ids.
+ * Kept free of UObjects so it can be exercised (and benchmarked) without a world.
+ */
+class LYRAGAME_API FLyraInteractableSpatialHash
+{
+public:
+	explicit FLyraInteractableSpatialHash(float InCellSize = 1000.0f);
+
+	void Add(int32 Id, const FVector& Location, float Radius);
+	void Remove(int32 Id);
+	void Move(int32 Id, const FVector& NewLocation);
+
+	/** Appends the ids of every entry whose bounds touch the sphere, sorted ascending */
+	void QuerySphere(const FVector& Origin, float Radius, TArray<int32>& OutIds) const;
+
+	int32 Num() const { return Entries.Num(); }
+
+private:
+	struct FEntry
+	{
+		FVector Location;
+		float Radius;
+		FIntVector Cell;
+	};
+
+	FIntVector GetCell(const FVector& Location) const;
+	void AddToCell(const FIntVector& Cell, int32 Id);
+	void RemoveFromCell(const FIntVector& Cell, int32 Id);
+
+	float CellSize;
+
+	// Largest registered radius, used to widen queries so entries straddling a cell boundary are not missed
+	float MaxEntryRadius = 0.0f;
+
+	TMap<int32, FEntry> Entries;
+	TMap<FIntVector, TArray<int32>> Cells;
+};
+
+/** Called when interactables enter or leave a watcher's range; left targets are reported by key since they may already be gone */
+DECLARE_DELEGATE_TwoParams(FLyraInteractableProximityChanged, TConstArrayView<TScriptInterface<IInteractableTarget>> /*Entered*/, TConstArrayView<FObjectKey> /*Left*/);
+
+/**
+ * ULyraInteractableRegistry
+ *
+ * World-level registry of interactable targets. Interactables register themselves once,
+ * and pawns register a proximity watcher that is told when targets enter or leave range,
+ * replacing per-pawn periodic overlap queries on the interaction channel. Targets only enter
+ * range if that overlap would have found them, i.e., they respond to Lyra_TraceChannel_Interaction.
+ */
+UCLASS()
+class LYRAGAME_API ULyraInteractableRegistry : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	ULyraInteractableRegistry();
+
+	//~USubsystem interface
+	virtual void Deinitialize() override;
+	//~End of USubsystem interface
+
+	//~FTickableGameObject interface
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	//~End of FTickableGameObject interface
+
+	/** Registers the actor and any of its components that implement IInteractableTarget */
+	UFUNCTION(BlueprintCallable, Category="Lyra|Interaction")
+	void RegisterInteractableActor(AActor* Actor);
+
+	UFUNCTION(BlueprintCallable, Category="Lyra|Interaction")
+	void UnregisterInteractableActor(AActor* Actor);
+
+	/** Interactables that move after registration must call this so watchers see the new location */
+	UFUNCTION(BlueprintCallable, Category="Lyra|Interaction")
+	void UpdateInteractableActorLocation(AActor* Actor);
+
+	/**
+	 * Starts tracking interactables within Range of Avatar, re-evaluated at most every UpdateInterval seconds.
+	 * Returns a handle for UnregisterProximityWatcher, or INDEX_NONE if Avatar is invalid.
+	 */
+	int32 RegisterProximityWatcher(AActor* Avatar, float Range, float UpdateInterval, FLyraInteractableProximityChanged&& OnChanged);
+	void UnregisterProximityWatcher(int32 WatcherHandle);
+
+	int32 GetNumInteractables() const { return Interactables.Num(); }
+
+private:
+	struct FRegisteredInteractable
+	{
+		TWeakObjectPtr<UObject> Object;
+		FObjectKey Key;
+	};
+
+	struct FNearbyInteractable
+	{
+		int32 Id;
+		FObjectKey Key;
+	};
+
+	struct FProximityWatcher
+	{
+		TWeakObjectPtr<AActor> Avatar;
+		float Range = 0.0f;
+		float UpdateInterval = 0.0f;
+		double NextUpdateTime = 0.0;
+		FVector LastLocation = FVector::ZeroVector;
+		uint32 LastRevision = 0;
+		bool bHasUpdated = false;
+
+		// Sorted by Id
+		TArray<FNearbyInteractable> Nearby;
+
+		FLyraInteractableProximityChanged OnChanged;
+	};
+
+	void UpdateWatcher(int32 WatcherHandle, double Now);
+
+	FLyraInteractableSpatialHash SpatialHash;
+
+	TMap<int32, FRegisteredInteractable> Interactables;
+	TMap<FObjectKey, TArray<int32>> ActorToInteractableIds;
+	TMap<int32, FProximityWatcher> Watchers;
+
+	int32 NextInteractableId = 0;
+	int32 NextWatcherHandle = 0;
+
+	// Bumped whenever an interactable is added, removed or moved so stationary watchers can skip re-querying
+	uint32 Revision = 1;
+
+	// Scratch storage reused across watcher updates
+	TArray<int32> ScratchWatcherHandles;
+	TArray<int32> ScratchQueryIds;
+	TArray<FNearbyInteractable> ScratchNearby;
+	TArray<TScriptInterface<IInteractableTarget>> ScratchEntered;
+	TArray<FObjectKey> ScratchLeft;
+};
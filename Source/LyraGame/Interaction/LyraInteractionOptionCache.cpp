@@ -0,0 +1,204 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "LyraInteractionOptionCache.h"
+
+#include "AbilitySystem/LyraAbilitySystemComponent.h"
+#include "Interaction/IInteractableTarget.h"
+#include "UObject/ScriptInterface.h"
+
+namespace LyraInteractionOptionCache
+{
+	// Upper bound on how long a resolved option is trusted, covering activation inputs we don't track (e.g., attribute based costs)
+	static float MaxResolvedAge = 1.0f;
+	static FAutoConsoleVariableRef CVarMaxResolvedAge(
+		TEXT("Lyra.Interaction.OptionCache.MaxAge"),
+		MaxResolvedAge,
+		TEXT("Maximum time in seconds a cached interaction option is reused before CanActivateAbility is re-evaluated. Negative disables reuse."),
+		ECVF_Default);
+}
+
+bool FLyraInteractionOptionCache::Update(UAbilitySystemComponent& AbilitySystem, const FInteractionQuery& InteractQuery, TConstArrayView<TScriptInterface<IInteractableTarget>> InteractableTargets, double CurrentTime, TArray<FInteractionOption>& InOutCurrentOptions)
+{
+	++UpdateCounter;
+	NumTargetsResolvedLastUpdate = 0;
+	ScratchNewOptions.Reset();
+
+	for (const TScriptInterface<IInteractableTarget>& InteractiveTarget : InteractableTargets)
+	{
+		ScratchGatheredOptions.Reset();
+		FInteractionOptionBuilder InteractionBuilder(InteractiveTarget, ScratchGatheredOptions);
+		InteractiveTarget->GatherInteractionOptions(InteractQuery, InteractionBuilder);
+
+		FTargetEntry& Entry = TargetEntries.FindOrAdd(FObjectKey(InteractiveTarget.GetObject()));
+		Entry.LastSeenUpdate = UpdateCounter;
+
+		uint32 ValidationKey = 0;
+		const bool bTrackable = ComputeValidationKey(AbilitySystem, ScratchGatheredOptions, ValidationKey);
+
+		const bool bUpToDate = Entry.bCanReuse && bTrackable &&
+			(Entry.ValidationKey == ValidationKey) &&
+			((CurrentTime - Entry.ResolveTime) <= LyraInteractionOptionCache::MaxResolvedAge) &&
+			(Entry.GatheredOptions == ScratchGatheredOptions);
+
+		if (!bUpToDate)
+		{
+			Entry.GatheredOptions = ScratchGatheredOptions;
+			ResolveActivatableOptions(AbilitySystem, Entry);
+			Entry.ValidationKey = ValidationKey;
+			Entry.ResolveTime = CurrentTime;
+			Entry.bCanReuse = bTrackable;
+			++NumTargetsResolvedLastUpdate;
+		}
+
+		ScratchNewOptions.Append(Entry.ActivatableOptions);
+	}
+
+	// Forget targets that are no longer being considered
+	if (TargetEntries.Num() > InteractableTargets.Num())
+	{
+		for (auto It = TargetEntries.CreateIterator(); It; ++It)
+		{
+			if (It->Value.LastSeenUpdate != UpdateCounter)
+			{
+				It.RemoveCurrent();
+			}
+		}
+	}
+
+	// Options only order by target, keep the per-target gather order stable so equal sets compare equal
+	ScratchNewOptions.StableSort();
+
+	if (ScratchNewOptions == InOutCurrentOptions)
+	{
+		return false;
+	}
+
+	InOutCurrentOptions = ScratchNewOptions;
+	return true;
+}
+
+void FLyraInteractionOptionCache::Reset()
+{
+	TargetEntries.Reset();
+	AbilityClassToSpec.Reset();
+	SpecMapAbilitySystem.Reset();
+	bSpecMapValid = false;
+}
+
+void FLyraInteractionOptionCache::ResolveActivatableOptions(UAbilitySystemComponent& AbilitySystem, FTargetEntry& Entry)
+{
+	Entry.ActivatableOptions.Reset();
+
+	for (const FInteractionOption& GatheredOption : Entry.GatheredOptions)
+	{
+		FInteractionOption& Option = Entry.ActivatableOptions.Add_GetRef(GatheredOption);
+		FGameplayAbilitySpec* InteractionAbilitySpec = nullptr;
+
+		// if there is a handle an a target ability system, we're triggering the ability on the target.
+		if (Option.TargetAbilitySystem && Option.TargetInteractionAbilityHandle.IsValid())
+		{
+			// Find the spec
+			InteractionAbilitySpec = Option.TargetAbilitySystem->FindAbilitySpecFromHandle(Option.TargetInteractionAbilityHandle);
+		}
+		// If there's an interaction ability then we're activating it on ourselves.
+		else if (Option.InteractionAbilityToGrant)
+		{
+			// Find the spec
+			InteractionAbilitySpec = FindAbilitySpecFromClass(AbilitySystem, Option.InteractionAbilityToGrant);
+
+			if (InteractionAbilitySpec)
+			{
+				// update the option
+				Option.TargetAbilitySystem = &AbilitySystem;
+				Option.TargetInteractionAbilityHandle = InteractionAbilitySpec->Handle;
+			}
+		}
+
+		// Filter any options that we can't activate right now for whatever reason.
+		const bool bCanActivate = InteractionAbilitySpec &&
+			InteractionAbilitySpec->Ability->CanActivateAbility(InteractionAbilitySpec->Handle, AbilitySystem.AbilityActorInfo.Get());
+
+		if (!bCanActivate)
+		{
+			Entry.ActivatableOptions.Pop(EAllowShrinking::No);
+		}
+	}
+}
+
+FGameplayAbilitySpec* FLyraInteractionOptionCache::FindAbilitySpecFromClass(UAbilitySystemComponent& AbilitySystem, TSubclassOf<UGameplayAbility> AbilityClass)
+{
+	const ULyraAbilitySystemComponent* LyraASC = Cast<ULyraAbilitySystemComponent>(&AbilitySystem);
+	if (LyraASC == nullptr)
+	{
+		// No way to know when the specs change, so the map can't be trusted
+		return AbilitySystem.FindAbilitySpecFromClass(AbilityClass);
+	}
+
+	TArray<FGameplayAbilitySpec>& Specs = AbilitySystem.GetActivatableAbilities();
+
+	if (!bSpecMapValid || (SpecMapAbilitySystem.Get() != &AbilitySystem) || (SpecMapRevision != LyraASC->GetAbilitySpecRevision()))
+	{
+		AbilityClassToSpec.Reset();
+		for (int32 SpecIndex = 0; SpecIndex < Specs.Num(); ++SpecIndex)
+		{
+			const FGameplayAbilitySpec& Spec = Specs[SpecIndex];
+			if (Spec.Ability == nullptr)
+			{
+				continue;
+			}
+
+			// Match FindAbilitySpecFromClass, which returns the first spec of a class
+			const FObjectKey ClassKey(Spec.Ability->GetClass());
+			if (!AbilityClassToSpec.Contains(ClassKey))
+			{
+				AbilityClassToSpec.Add(ClassKey, FCachedSpecLocation{ Spec.Handle, SpecIndex });
+			}
+		}
+
+		SpecMapAbilitySystem = &AbilitySystem;
+		SpecMapRevision = LyraASC->GetAbilitySpecRevision();
+		bSpecMapValid = true;
+	}
+
+	if (const FCachedSpecLocation* Location = AbilityClassToSpec.Find(FObjectKey(AbilityClass)))
+	{
+		if (Specs.IsValidIndex(Location->Index) && (Specs[Location->Index].Handle == Location->Handle))
+		{
+			return &Specs[Location->Index];
+		}
+
+		// The specs moved without a revision change, fall back to a full search and rebuild next time
+		bSpecMapValid = false;
+		return AbilitySystem.FindAbilitySpecFromClass(AbilityClass);
+	}
+
+	return nullptr;
+}
+
+bool FLyraInteractionOptionCache::ComputeValidationKey(const UAbilitySystemComponent& AbilitySystem, TConstArrayView<FInteractionOption> Options, uint32& OutKey)
+{
+	const ULyraAbilitySystemComponent* LyraASC = Cast<ULyraAbilitySystemComponent>(&AbilitySystem);
+	if (LyraASC == nullptr)
+	{
+		return false;
+	}
+
+	uint32 Key = HashCombine(GetTypeHash(LyraASC), LyraASC->GetActivationStateRevision());
+
+	for (const FInteractionOption& Option : Options)
+	{
+		if (Option.TargetAbilitySystem)
+		{
+			const ULyraAbilitySystemComponent* TargetLyraASC = Cast<ULyraAbilitySystemComponent>(Option.TargetAbilitySystem);
+			if (TargetLyraASC == nullptr)
+			{
+				return false;
+			}
+
+			Key = HashCombine(Key, HashCombine(GetTypeHash(TargetLyraASC), TargetLyraASC->GetActivationStateRevision()));
+		}
+	}
+
+	OutKey = Key;
+	return true;
+}
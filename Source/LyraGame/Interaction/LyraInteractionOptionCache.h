@@ -0,0 +1,81 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "GameplayAbilitySpecHandle.h"
+#include "Interaction/InteractionOption.h"
+#include "UObject/ObjectKey.h"
+
+template <typename InterfaceType> class TScriptInterface;
+
+class IInteractableTarget;
+class UAbilitySystemComponent;
+class UGameplayAbility;
+struct FGameplayAbilitySpec;
+struct FInteractionQuery;
+
+/**
+ * FLyraInteractionOptionCache
+ *
+ * Resolves and filters the interaction options offered by a set of targets, remembering the result per target
+ * so CanActivateAbility and ability spec lookups only run again when the target's options or the activation
+ * state of an involved ability system changed.
+ */
+class LYRAGAME_API FLyraInteractionOptionCache
+{
+public:
+	/**
+	 * Gathers the options of every target and keeps those that can currently be activated.
+	 * InOutCurrentOptions is replaced (sorted) and true is returned only if the resulting options differ.
+	 */
+	bool Update(UAbilitySystemComponent& AbilitySystem, const FInteractionQuery& InteractQuery, TConstArrayView<TScriptInterface<IInteractableTarget>> InteractableTargets, double CurrentTime, TArray<FInteractionOption>& InOutCurrentOptions);
+
+	void Reset();
+
+	/** Number of targets whose options had to be re-resolved during the last Update */
+	int32 GetNumTargetsResolvedLastUpdate() const { return NumTargetsResolvedLastUpdate; }
+
+private:
+	struct FTargetEntry
+	{
+		// Options exactly as the target gathered them, used to detect target state changes
+		TArray<FInteractionOption> GatheredOptions;
+
+		// Resolved options that passed CanActivateAbility
+		TArray<FInteractionOption> ActivatableOptions;
+
+		uint32 ValidationKey = 0;
+		double ResolveTime = 0.0;
+		uint32 LastSeenUpdate = 0;
+		bool bCanReuse = false;
+	};
+
+	/** Equivalent to UAbilitySystemComponent::FindAbilitySpecFromClass, resolved through a class -> handle map */
+	FGameplayAbilitySpec* FindAbilitySpecFromClass(UAbilitySystemComponent& AbilitySystem, TSubclassOf<UGameplayAbility> AbilityClass);
+
+	void ResolveActivatableOptions(UAbilitySystemComponent& AbilitySystem, FTargetEntry& Entry);
+
+	/** Combines the activation state revisions of every ability system the options depend on; returns false if any of them can't be tracked */
+	static bool ComputeValidationKey(const UAbilitySystemComponent& AbilitySystem, TConstArrayView<FInteractionOption> Options, uint32& OutKey);
+
+	TMap<FObjectKey, FTargetEntry> TargetEntries;
+
+	struct FCachedSpecLocation
+	{
+		FGameplayAbilitySpecHandle Handle;
+		int32 Index = INDEX_NONE;
+	};
+
+	// Ability class -> spec location on the ability system, rebuilt when its specs change
+	TMap<FObjectKey, FCachedSpecLocation> AbilityClassToSpec;
+	TWeakObjectPtr<UAbilitySystemComponent> SpecMapAbilitySystem;
+	uint32 SpecMapRevision = 0;
+	bool bSpecMapValid = false;
+
+	uint32 UpdateCounter = 0;
+	int32 NumTargetsResolvedLastUpdate = 0;
+
+	// Scratch storage reused across updates
+	TArray<FInteractionOption> ScratchGatheredOptions;
+	TArray<FInteractionOption> ScratchNewOptions;
+};
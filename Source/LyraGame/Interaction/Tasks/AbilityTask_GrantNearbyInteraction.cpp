@@ -10,11 +10,23 @@
 #include "Interaction/InteractionOption.h"
 #include "Interaction/InteractionQuery.h"
 #include "Interaction/InteractionStatics.h"
+#include "Interaction/LyraInteractableRegistry.h"
 #include "Physics/LyraCollisionChannels.h"
 #include "TimerManager.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(AbilityTask_GrantNearbyInteraction)
 
+namespace LyraInteraction
+{
+	// Off by default, interactables that don't call ULyraInteractableRegistry::RegisterInteractableActor are invisible to the registry
+	static bool bUseInteractableRegistry = false;
+	static FAutoConsoleVariableRef CVarUseInteractableRegistry(
+		TEXT("Lyra.Interaction.UseRegistry"),
+		bUseInteractableRegistry,
+		TEXT("If true, nearby interaction abilities are granted from the interactable registry instead of periodic overlap queries. Only interactables registered with the registry are found."),
+		ECVF_Default);
+}
+
 UAbilityTask_GrantNearbyInteraction::UAbilityTask_GrantNearbyInteraction(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
 {
@@ -33,7 +45,20 @@ void UAbilityTask_GrantNearbyInteraction::Activate()
 	SetWaitingOnAvatar();
 
 	UWorld* World = GetWorld();
-	World->GetTimerManager().SetTimer(QueryTimerHandle, this, &ThisClass::QueryInteractables, InteractionScanRate, true);
+
+	if (LyraInteraction::bUseInteractableRegistry)
+	{
+		if (ULyraInteractableRegistry* Registry = World->GetSubsystem<ULyraInteractableRegistry>())
+		{
+			ProximityWatcherHandle = Registry->RegisterProximityWatcher(GetAvatarActor(), InteractionScanRange, InteractionScanRate,
+				FLyraInteractableProximityChanged::CreateUObject(this, &ThisClass::OnNearbyInteractablesChanged));
+		}
+	}
+
+	if (ProximityWatcherHandle == INDEX_NONE)
+	{
+		World->GetTimerManager().SetTimer(QueryTimerHandle, this, &ThisClass::QueryInteractables, InteractionScanRate, true);
+	}
 }
 
 void UAbilityTask_GrantNearbyInteraction::OnDestroy(bool AbilityEnded)
@@ -41,11 +66,121 @@ void UAbilityTask_GrantNearbyInteraction::OnDestroy(bool AbilityEnded)
 	if (UWorld* World = GetWorld())
 	{
 		World->GetTimerManager().ClearTimer(QueryTimerHandle);
+
+		if (ProximityWatcherHandle != INDEX_NONE)
+		{
+			if (ULyraInteractableRegistry* Registry = World->GetSubsystem<ULyraInteractableRegistry>())
+			{
+				Registry->UnregisterProximityWatcher(ProximityWatcherHandle);
+			}
+			ProximityWatcherHandle = INDEX_NONE;
+		}
 	}
 
+	ReleaseAllAbilityGrants();
+
 	Super::OnDestroy(AbilityEnded);
 }
 
+void UAbilityTask_GrantNearbyInteraction::OnNearbyInteractablesChanged(TConstArrayView<TScriptInterface<IInteractableTarget>> EnteredTargets, TConstArrayView<FObjectKey> LeftTargets)
+{
+	for (const FObjectKey& TargetKey : LeftTargets)
+	{
+		TArray<TSubclassOf<UGameplayAbility>> GrantedClasses;
+		if (TargetAbilityGrants.RemoveAndCopyValue(TargetKey, GrantedClasses))
+		{
+			for (const TSubclassOf<UGameplayAbility>& AbilityClass : GrantedClasses)
+			{
+				ReleaseAbilityGrantReference(AbilityClass);
+			}
+		}
+	}
+
+	if (EnteredTargets.IsEmpty())
+	{
+		return;
+	}
+
+	AActor* ActorOwner = GetAvatarActor();
+	if (ActorOwner == nullptr)
+	{
+		return;
+	}
+
+	FInteractionQuery InteractionQuery;
+	InteractionQuery.RequestingAvatar = ActorOwner;
+	InteractionQuery.RequestingController = Cast<AController>(ActorOwner->GetOwner());
+
+	for (const TScriptInterface<IInteractableTarget>& InteractiveTarget : EnteredTargets)
+	{
+		ScratchOptions.Reset();
+		FInteractionOptionBuilder InteractionBuilder(InteractiveTarget, ScratchOptions);
+		InteractiveTarget->GatherInteractionOptions(InteractionQuery, InteractionBuilder);
+
+		// Check if any of the options need to grant the ability to the user before they can be used.
+		TArray<TSubclassOf<UGameplayAbility>>* GrantedClasses = nullptr;
+		for (const FInteractionOption& Option : ScratchOptions)
+		{
+			if (Option.InteractionAbilityToGrant)
+			{
+				if (GrantedClasses == nullptr)
+				{
+					GrantedClasses = &TargetAbilityGrants.FindOrAdd(FObjectKey(InteractiveTarget.GetObject()));
+				}
+
+				if (!GrantedClasses->Contains(Option.InteractionAbilityToGrant))
+				{
+					GrantedClasses->Add(Option.InteractionAbilityToGrant);
+					AddAbilityGrantReference(Option.InteractionAbilityToGrant);
+				}
+			}
+		}
+	}
+}
+
+void UAbilityTask_GrantNearbyInteraction::AddAbilityGrantReference(TSubclassOf<UGameplayAbility> AbilityClass)
+{
+	FLyraInteractionAbilityGrant& Grant = InteractionAbilityCache.FindOrAdd(FObjectKey(AbilityClass));
+	if (Grant.RefCount++ == 0)
+	{
+		// Grant the ability to the GAS, otherwise it won't be able to do whatever the interaction is.
+		FGameplayAbilitySpec Spec(AbilityClass, 1, INDEX_NONE, this);
+		Grant.Handle = AbilitySystemComponent->GiveAbility(Spec);
+	}
+}
+
+void UAbilityTask_GrantNearbyInteraction::ReleaseAbilityGrantReference(TSubclassOf<UGameplayAbility> AbilityClass)
+{
+	const FObjectKey ObjectKey(AbilityClass);
+	FLyraInteractionAbilityGrant* Grant = InteractionAbilityCache.Find(ObjectKey);
+	if ((Grant != nullptr) && (--Grant->RefCount <= 0))
+	{
+		// Let an in-progress interaction finish before the ability goes away
+		if (Grant->Handle.IsValid() && AbilitySystemComponent.IsValid())
+		{
+			AbilitySystemComponent->SetRemoveAbilityOnEnd(Grant->Handle);
+		}
+		InteractionAbilityCache.Remove(ObjectKey);
+	}
+}
+
+void UAbilityTask_GrantNearbyInteraction::ReleaseAllAbilityGrants()
+{
+	if (AbilitySystemComponent.IsValid())
+	{
+		for (const TPair<FObjectKey, FLyraInteractionAbilityGrant>& Pair : InteractionAbilityCache)
+		{
+			if (Pair.Value.Handle.IsValid())
+			{
+				AbilitySystemComponent->SetRemoveAbilityOnEnd(Pair.Value.Handle);
+			}
+		}
+	}
+
+	InteractionAbilityCache.Reset();
+	TargetAbilityGrants.Reset();
+}
+
 void UAbilityTask_GrantNearbyInteraction::QueryInteractables()
 {
 	UWorld* World = GetWorld();
@@ -79,13 +214,10 @@ void UAbilityTask_GrantNearbyInteraction::QueryInteractables()
 			{
 				if (Option.InteractionAbilityToGrant)
 				{
-					// Grant the ability to the GAS, otherwise it won't be able to do whatever the interaction is.
-					FObjectKey ObjectKey(Option.InteractionAbilityToGrant);
-					if (!InteractionAbilityCache.Find(ObjectKey))
+					// Without the registry there are no leave events, so grants are held until the task ends
+					if (!InteractionAbilityCache.Contains(FObjectKey(Option.InteractionAbilityToGrant)))
 					{
-						FGameplayAbilitySpec Spec(Option.InteractionAbilityToGrant, 1, INDEX_NONE, this);
-						FGameplayAbilitySpecHandle Handle = AbilitySystemComponent->GiveAbility(Spec);
-						InteractionAbilityCache.Add(ObjectKey, Handle);
+						AddAbilityGrantReference(Option.InteractionAbilityToGrant);
 					}
 				}
 			}
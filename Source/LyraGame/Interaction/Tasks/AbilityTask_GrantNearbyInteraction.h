@@ -2,17 +2,26 @@
 #pragma once
 
 #include "Abilities/Tasks/AbilityTask.h"
+#include "Interaction/InteractionOption.h"
 
 #include "AbilityTask_GrantNearbyInteraction.generated.h"
 
+class IInteractableTarget;
 class UGameplayAbility;
 class UObject;
 struct FFrame;
 struct FGameplayAbilitySpecHandle;
 struct FObjectKey;
 
+/** An interaction ability granted on behalf of one or more nearby interactables */
+struct FLyraInteractionAbilityGrant
+{
+	FGameplayAbilitySpecHandle Handle;
+	int32 RefCount = 0;
+};
+
 UCLASS()
-class UAbilityTask_GrantNearbyInteraction : public UAbilityTask
+class LYRAGAME_API UAbilityTask_GrantNearbyInteraction : public UAbilityTask
 {
 	GENERATED_UCLASS_BODY()
 
@@ -28,10 +37,26 @@ private:
 
 	void QueryInteractables();
 
+	void OnNearbyInteractablesChanged(TConstArrayView<TScriptInterface<IInteractableTarget>> EnteredTargets, TConstArrayView<FObjectKey> LeftTargets);
+
+	void AddAbilityGrantReference(TSubclassOf<UGameplayAbility> AbilityClass);
+	void ReleaseAbilityGrantReference(TSubclassOf<UGameplayAbility> AbilityClass);
+	void ReleaseAllAbilityGrants();
+
 	float InteractionScanRange = 100;
 	float InteractionScanRate = 0.100;
 
 	FTimerHandle QueryTimerHandle;
 
-	TMap<FObjectKey, FGameplayAbilitySpecHandle> InteractionAbilityCache;
+	// Handle of our proximity watcher in the world's ULyraInteractableRegistry
+	int32 ProximityWatcherHandle = INDEX_NONE;
+
+	// Granted abilities, keyed by ability class
+	TMap<FObjectKey, FLyraInteractionAbilityGrant> InteractionAbilityCache;
+
+	// Ability classes each nearby interactable holds a grant reference on
+	TMap<FObjectKey, TArray<TSubclassOf<UGameplayAbility>>> TargetAbilityGrants;
+
+	// Scratch storage reused across membership changes
+	TArray<FInteractionOption> ScratchOptions;
 };
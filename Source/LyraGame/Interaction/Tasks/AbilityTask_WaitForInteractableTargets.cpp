@@ -106,74 +106,14 @@ bool UAbilityTask_WaitForInteractableTargets::ClipCameraRayToAbilityRange(FVecto
 
 void UAbilityTask_WaitForInteractableTargets::UpdateInteractableOptions(const FInteractionQuery& InteractQuery, const TArray<TScriptInterface<IInteractableTarget>>& InteractableTargets)
 {
-	TArray<FInteractionOption> NewOptions;
-
-	for (const TScriptInterface<IInteractableTarget>& InteractiveTarget : InteractableTargets)
-	{
-		TArray<FInteractionOption> TempOptions;
-		FInteractionOptionBuilder InteractionBuilder(InteractiveTarget, TempOptions);
-		InteractiveTarget->GatherInteractionOptions(InteractQuery, InteractionBuilder);
-
-		for (FInteractionOption& Option : TempOptions)
-		{
-			FGameplayAbilitySpec* InteractionAbilitySpec = nullptr;
-
-			// if there is a handle an a target ability system, we're triggering the ability on the target.
-			if (Option.TargetAbilitySystem && Option.TargetInteractionAbilityHandle.IsValid())
-			{
-				// Find the spec
-				InteractionAbilitySpec = Option.TargetAbilitySystem->FindAbilitySpecFromHandle(Option.TargetInteractionAbilityHandle);
-			}
-			// If there's an interaction ability then we're activating it on ourselves.
-			else if (Option.InteractionAbilityToGrant)
-			{
-				// Find the spec
-				InteractionAbilitySpec = AbilitySystemComponent->FindAbilitySpecFromClass(Option.InteractionAbilityToGrant);
-
-				if (InteractionAbilitySpec)
-				{
-					// update the option
-					Option.TargetAbilitySystem = AbilitySystemComponent.Get();
-					Option.TargetInteractionAbilityHandle = InteractionAbilitySpec->Handle;
-				}
-			}
-
-			if (InteractionAbilitySpec)
-			{
-				// Filter any options that we can't activate right now for whatever reason.
-				if (InteractionAbilitySpec->Ability->CanActivateAbility(InteractionAbilitySpec->Handle, AbilitySystemComponent->AbilityActorInfo.Get()))
-				{
-					NewOptions.Add(Option);
-				}
-			}
-		}
-	}
-
-	bool bOptionsChanged = false;
-	if (NewOptions.Num() == CurrentOptions.Num())
+	UAbilitySystemComponent* ASC = AbilitySystemComponent.Get();
+	if (ASC == nullptr)
 	{
-		NewOptions.Sort();
-
-		for (int OptionIndex = 0; OptionIndex < NewOptions.Num(); OptionIndex++)
-		{
-			const FInteractionOption& NewOption = NewOptions[OptionIndex];
-			const FInteractionOption& CurrentOption = CurrentOptions[OptionIndex];
-
-			if (NewOption != CurrentOption)
-			{
-				bOptionsChanged = true;
-				break;
-			}
-		}
-	}
-	else
-	{
-		bOptionsChanged = true;
+		return;
 	}
 
-	if (bOptionsChanged)
+	if (OptionCache.Update(*ASC, InteractQuery, InteractableTargets, GetWorld()->GetTimeSeconds(), CurrentOptions))
 	{
-		CurrentOptions = NewOptions;
 		InteractableObjectsChanged.Broadcast(CurrentOptions);
 	}
 }
@@ -4,6 +4,7 @@
 #include "Abilities/Tasks/AbilityTask.h"
 #include "Engine/CollisionProfile.h"
 #include "Interaction/InteractionOption.h"
+#include "Interaction/LyraInteractionOptionCache.h"
 
 #include "AbilityTask_WaitForInteractableTargets.generated.h"
 
@@ -43,4 +44,7 @@ protected:
 	bool bTraceAffectsAimPitch = true;
 
 	TArray<FInteractionOption> CurrentOptions;
+
+	// Per-target resolved options, so unchanged targets skip spec lookups and CanActivateAbility
+	FLyraInteractionOptionCache OptionCache;
 };
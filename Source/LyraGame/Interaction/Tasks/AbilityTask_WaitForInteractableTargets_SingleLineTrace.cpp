@@ -54,12 +54,9 @@ void UAbilityTask_WaitForInteractableTargets_SingleLineTrace::PerformTrace()
 
 	UWorld* World = GetWorld();
 
-	TArray<AActor*> ActorsToIgnore;
-	ActorsToIgnore.Add(AvatarActor);
-
 	const bool bTraceComplex = false;
 	FCollisionQueryParams Params(SCENE_QUERY_STAT(UAbilityTask_WaitForInteractableTargets_SingleLineTrace), bTraceComplex);
-	Params.AddIgnoredActors(ActorsToIgnore);
+	Params.AddIgnoredActor(AvatarActor);
 
 	FVector TraceStart = StartLocation.GetTargetingTransform().GetLocation();
 	FVector TraceEnd;
@@ -68,10 +65,10 @@ void UAbilityTask_WaitForInteractableTargets_SingleLineTrace::PerformTrace()
 	FHitResult OutHitResult;
 	LineTrace(OutHitResult, World, TraceStart, TraceEnd, TraceProfile.Name, Params);
 
-	TArray<TScriptInterface<IInteractableTarget>> InteractableTargets;
-	UInteractionStatics::AppendInteractableTargetsFromHitResult(OutHitResult, InteractableTargets);
+	ScratchInteractableTargets.Reset();
+	UInteractionStatics::AppendInteractableTargetsFromHitResult(OutHitResult, ScratchInteractableTargets);
 
-	UpdateInteractableOptions(InteractionQuery, InteractableTargets);
+	UpdateInteractableOptions(InteractionQuery, ScratchInteractableTargets);
 
 #if ENABLE_DRAW_DEBUG
 	if (bShowDebug)
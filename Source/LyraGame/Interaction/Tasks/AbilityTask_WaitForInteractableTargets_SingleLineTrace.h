@@ -40,4 +40,7 @@ private:
 	bool bShowDebug = false;
 
 	FTimerHandle TimerHandle;
+
+	// Reused between traces to avoid a per-scan allocation
+	TArray<TScriptInterface<IInteractableTarget>> ScratchInteractableTargets;
 };
@@ -9,3 +9,13 @@ UPhysicalMaterialWithTags::UPhysicalMaterialWithTags(const FObjectInitializer& O
 {
 }
 
+#if WITH_EDITOR
+uint32 UPhysicalMaterialWithTags::TagsRevision = 0;
+
+void UPhysicalMaterialWithTags::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+
+	++TagsRevision;
+}
+#endif
@@ -15,14 +15,28 @@ class UObject;
  * A piece of equipment representing a weapon spawned and applied to a pawn
  */
 UCLASS()
-class UPhysicalMaterialWithTags : public UPhysicalMaterial
+class LYRAGAME_API UPhysicalMaterialWithTags : public UPhysicalMaterial
 {
 	GENERATED_BODY()
 
 public:
 	UPhysicalMaterialWithTags(const FObjectInitializer& ObjectInitializer = FObjectInitializer::Get());
 
+#if WITH_EDITOR
+	//~UObject interface
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+	//~End of UObject interface
+
+	// Changes whenever the tags of any physical material are edited, so anything cached from them can be rebuilt
+	static uint32 GetTagsRevision() { return TagsRevision; }
+#endif
+
 	// A container of gameplay tags that game code can use to reason about this physical material
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category=PhysicalProperties)
 	FGameplayTagContainer Tags;
+
+#if WITH_EDITOR
+private:
+	static uint32 TagsRevision;
+#endif
 };
@@ -1,15 +1,57 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "LyraPlayerSpawningManagerComponent.h"
+#include "GameFramework/GameStateBase.h"
+#include "GameFramework/Pawn.h"
 #include "GameFramework/PlayerState.h"
 #include "EngineUtils.h"
 #include "Engine/PlayerStartPIE.h"
+#include "GameModes/LyraExperienceManagerComponent.h"
 #include "LyraPlayerStart.h"
+#include "Teams/LyraTeamSubsystem.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(LyraPlayerSpawningManagerComponent)
 
 DEFINE_LOG_CATEGORY_STATIC(LogPlayerSpawning, Log, All);
 
+namespace LyraSpawnScoring
+{
+	static bool bUseScoring = true;
+	static FAutoConsoleVariableRef CVarUseScoring(
+		TEXT("Lyra.Spawn.UseScoring"),
+		bUseScoring,
+		TEXT("Should the default player start selection use the spawn scoring service instead of picking a random unoccupied start?"),
+		ECVF_Default);
+
+	static int32 OccupancyChecksPerFrame = 8;
+	static FAutoConsoleVariableRef CVarOccupancyChecksPerFrame(
+		TEXT("Lyra.Spawn.Scoring.OccupancyChecksPerFrame"),
+		OccupancyChecksPerFrame,
+		TEXT("Maximum number of player start occupancy queries (encroachment and teleport spot tests) per frame, shared by spawning and background refreshes."),
+		ECVF_Default);
+
+	static int32 LineOfSightChecksPerFrame = 8;
+	static FAutoConsoleVariableRef CVarLineOfSightChecksPerFrame(
+		TEXT("Lyra.Spawn.Scoring.LineOfSightChecksPerFrame"),
+		LineOfSightChecksPerFrame,
+		TEXT("Number of line of sight traces between player starts and nearby pawns per frame."),
+		ECVF_Default);
+
+	static int32 ThreatUpdatesPerFrame = 128;
+	static FAutoConsoleVariableRef CVarThreatUpdatesPerFrame(
+		TEXT("Lyra.Spawn.Scoring.ThreatUpdatesPerFrame"),
+		ThreatUpdatesPerFrame,
+		TEXT("Number of player starts whose nearest enemy and ally distances are refreshed per frame."),
+		ECVF_Default);
+
+	static int32 NumCandidates = 8;
+	static FAutoConsoleVariableRef CVarNumCandidates(
+		TEXT("Lyra.Spawn.Scoring.Candidates"),
+		NumCandidates,
+		TEXT("Number of best scored player starts considered when choosing where to spawn."),
+		ECVF_Default);
+}
+
 ULyraPlayerSpawningManagerComponent::ULyraPlayerSpawningManagerComponent(const FObjectInitializer& ObjectInitializer)
 : Super(ObjectInitializer)
 {
@@ -37,8 +79,30 @@ void ULyraPlayerSpawningManagerComponent::InitializeComponent()
 		if (ALyraPlayerStart* PlayerStart = *It)
 		{
 			CachedPlayerStarts.Add(PlayerStart);
+			AddScoringStart(PlayerStart);
 		}
 	}
+
+	// Only the authority picks player starts
+	SetComponentTickEnabled(GetOwner()->HasAuthority());
+}
+
+void ULyraPlayerSpawningManagerComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// Occupancy depends on the pawn class, which comes from the experience's pawn data
+	AGameStateBase* GameState = GetGameStateChecked<AGameStateBase>();
+	if (ULyraExperienceManagerComponent* ExperienceComponent = GameState->FindComponentByClass<ULyraExperienceManagerComponent>())
+	{
+		ExperienceComponent->CallOrRegister_OnExperienceLoaded_HighPriority(FOnLyraExperienceLoaded::FDelegate::CreateUObject(this, &ThisClass::OnExperienceLoaded));
+	}
+}
+
+void ULyraPlayerSpawningManagerComponent::OnExperienceLoaded(const ULyraExperienceDefinition* Experience)
+{
+	// Anything cached before was measured with the engine default pawn
+	ScoringService.InvalidateAllOccupancy();
 }
 
 void ULyraPlayerSpawningManagerComponent::OnLevelAdded(ULevel* InLevel, UWorld* InWorld)
@@ -51,6 +115,7 @@ void ULyraPlayerSpawningManagerComponent::OnLevelAdded(ULevel* InLevel, UWorld*
 			{
 				ensure(!CachedPlayerStarts.Contains(PlayerStart));
 				CachedPlayerStarts.Add(PlayerStart);
+				AddScoringStart(PlayerStart);
 			}
 		}
 	}
@@ -61,6 +126,7 @@ void ULyraPlayerSpawningManagerComponent::HandleOnActorSpawned(AActor* SpawnedAc
 	if (ALyraPlayerStart* PlayerStart = Cast<ALyraPlayerStart>(SpawnedActor))
 	{
 		CachedPlayerStarts.Add(PlayerStart);
+		AddScoringStart(PlayerStart);
 	}
 }
 
@@ -110,12 +176,18 @@ AActor* ULyraPlayerSpawningManagerComponent::ChoosePlayerStart(AController* Play
 
 		if (!PlayerStart)
 		{
-			PlayerStart = GetFirstRandomUnoccupiedPlayerStart(Player, StarterPoints);
+			PlayerStart = LyraSpawnScoring::bUseScoring ? ChooseScoredPlayerStart(Player) : GetFirstRandomUnoccupiedPlayerStart(Player, StarterPoints);
 		}
 
 		if (ALyraPlayerStart* LyraStart = Cast<ALyraPlayerStart>(PlayerStart))
 		{
 			LyraStart->TryClaim(Player);
+
+			// Let the next spawns this frame know, the claim is only synced to the service on tick
+			if (const int32* StartIndex = ScoringStartIndices.Find(FObjectKey(LyraStart)))
+			{
+				ScoringService.SetClaimed(*StartIndex, true);
+			}
 		}
 
 		return PlayerStart;
@@ -170,6 +242,206 @@ void ULyraPlayerSpawningManagerComponent::FinishRestartPlayer(AController* NewPl
 void ULyraPlayerSpawningManagerComponent::TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
 {
 	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	if (LyraSpawnScoring::bUseScoring)
+	{
+		UpdateScoring();
+	}
+}
+
+void ULyraPlayerSpawningManagerComponent::AddScoringStart(ALyraPlayerStart* PlayerStart)
+{
+	const FObjectKey StartKey(PlayerStart);
+	if (ScoringStartIndices.Contains(StartKey))
+	{
+		return;
+	}
+
+	const int32 StartIndex = ScoringService.AddStart(PlayerStart->GetActorLocation());
+	if (StartIndex >= ScoringStartActors.Num())
+	{
+		ScoringStartActors.SetNum(StartIndex + 1);
+	}
+	ScoringStartActors[StartIndex] = PlayerStart;
+	ScoringStartIndices.Add(StartKey, StartIndex);
+}
+
+void ULyraPlayerSpawningManagerComponent::RemoveScoringStart(int32 StartIndex)
+{
+	ScoringService.RemoveStart(StartIndex);
+	ScoringStartActors[StartIndex].Reset();
+
+	// The start is gone so its key can't be rebuilt, find the index instead (rare)
+	for (auto It = ScoringStartIndices.CreateIterator(); It; ++It)
+	{
+		if (It->Value == StartIndex)
+		{
+			It.RemoveCurrent();
+			break;
+		}
+	}
+}
+
+void ULyraPlayerSpawningManagerComponent::UpdateScoring()
+{
+	UWorld* World = GetWorld();
+	AGameStateBase* GameState = GetGameStateChecked<AGameStateBase>();
+	const ULyraTeamSubsystem* TeamSubsystem = World->GetSubsystem<ULyraTeamSubsystem>();
+
+	ScratchPawns.Reset();
+	for (APlayerState* PS : GameState->PlayerArray)
+	{
+		if (PS && !PS->IsOnlyASpectator())
+		{
+			if (APawn* Pawn = PS->GetPawn())
+			{
+				FLyraSpawnScoringPawn& ScoringPawn = ScratchPawns.AddDefaulted_GetRef();
+				ScoringPawn.Id = PS->GetUniqueID();
+				ScoringPawn.Location = Pawn->GetActorLocation();
+				ScoringPawn.TeamId = TeamSubsystem ? TeamSubsystem->FindTeamFromObject(PS) : INDEX_NONE;
+			}
+		}
+	}
+
+	ScoringService.UpdatePawns(ScratchPawns, World->GetTimeSeconds());
+
+	for (int32 StartIndex = 0; StartIndex < ScoringStartActors.Num(); ++StartIndex)
+	{
+		if (ScoringService.IsValidStart(StartIndex))
+		{
+			if (const ALyraPlayerStart* PlayerStart = ScoringStartActors[StartIndex].Get())
+			{
+				ScoringService.SetClaimed(StartIndex, PlayerStart->IsClaimed());
+			}
+			else
+			{
+				RemoveScoringStart(StartIndex);
+			}
+		}
+	}
+
+	ScoringService.UpdateThreat(LyraSpawnScoring::ThreatUpdatesPerFrame);
+
+	const FCollisionQueryParams TraceParams(SCENE_QUERY_STAT(LyraSpawnLineOfSight), false);
+	ScoringService.UpdateLineOfSight(LyraSpawnScoring::LineOfSightChecksPerFrame, [World, &TraceParams](const FVector& From, const FVector& To)
+	{
+		// Stop short of the pawn so its own capsule doesn't block the trace
+		const FVector TraceEnd = To - (To - From).GetSafeNormal() * 100.0f;
+		return !World->LineTraceTestByChannel(From, TraceEnd, ECC_Visibility, TraceParams);
+	});
+
+	// Spend what is left of this frame's occupancy budget on starts that went stale
+	int32 StaleStartIndex = INDEX_NONE;
+	while (HasOccupancyCheckBudget() && ScoringService.PopStaleOccupancy(StaleStartIndex))
+	{
+		if (ALyraPlayerStart* PlayerStart = ScoringStartActors[StaleStartIndex].Get())
+		{
+			RefreshOccupancy(StaleStartIndex, PlayerStart);
+		}
+		else
+		{
+			RemoveScoringStart(StaleStartIndex);
+		}
+	}
+}
+
+bool ULyraPlayerSpawningManagerComponent::HasOccupancyCheckBudget() const
+{
+	return (OccupancyCheckFrame != GFrameCounter) || (OccupancyChecksThisFrame < LyraSpawnScoring::OccupancyChecksPerFrame);
+}
+
+void ULyraPlayerSpawningManagerComponent::RefreshOccupancy(int32 StartIndex, ALyraPlayerStart* PlayerStart)
+{
+	if (OccupancyCheckFrame != GFrameCounter)
+	{
+		OccupancyCheckFrame = GFrameCounter;
+		OccupancyChecksThisFrame = 0;
+	}
+	++OccupancyChecksThisFrame;
+
+	// Cached for the default pawn, which is what every controller spawns as unless an experience overrides pawn data per player
+	ScoringService.SetOccupancy(StartIndex, PlayerStart->GetLocationOccupancy(nullptr));
+}
+
+AActor* ULyraPlayerSpawningManagerComponent::ChooseScoredPlayerStart(AController* Player)
+{
+	const ULyraTeamSubsystem* TeamSubsystem = GetWorld()->GetSubsystem<ULyraTeamSubsystem>();
+	const int32 PlayerTeamId = TeamSubsystem ? TeamSubsystem->FindTeamFromObject(Player) : INDEX_NONE;
+
+	ScoringService.GetRankedStarts(PlayerTeamId, LyraSpawnScoring::NumCandidates, ScratchCandidates);
+	ScratchUncheckedCandidates.Reset();
+
+	ALyraPlayerStart* FallbackPlayerStart = nullptr;
+	for (const int32 StartIndex : ScratchCandidates)
+	{
+		ALyraPlayerStart* PlayerStart = ScoringStartActors[StartIndex].Get();
+		if (PlayerStart == nullptr)
+		{
+			RemoveScoringStart(StartIndex);
+			continue;
+		}
+
+		if (!ScoringService.IsOccupancyValid(StartIndex))
+		{
+			if (!HasOccupancyCheckBudget())
+			{
+				// Out of queries this frame, a checked candidate further down is used if there is one
+				ScratchUncheckedCandidates.Add(StartIndex);
+				continue;
+			}
+
+			RefreshOccupancy(StartIndex, PlayerStart);
+		}
+
+		switch (ScoringService.GetOccupancy(StartIndex))
+		{
+			case ELyraPlayerStartLocationOccupancy::Empty:
+				return PlayerStart;
+			case ELyraPlayerStartLocationOccupancy::Partial:
+				FallbackPlayerStart = FallbackPlayerStart ? FallbackPlayerStart : PlayerStart;
+				break;
+		}
+	}
+
+	// No checked candidate is empty, check the skipped ones over the budget rather than spawn on one that may be full
+	for (const int32 StartIndex : ScratchUncheckedCandidates)
+	{
+		ALyraPlayerStart* PlayerStart = ScoringStartActors[StartIndex].Get();
+		RefreshOccupancy(StartIndex, PlayerStart);
+
+		switch (ScoringService.GetOccupancy(StartIndex))
+		{
+			case ELyraPlayerStartLocationOccupancy::Empty:
+				return PlayerStart;
+			case ELyraPlayerStartLocationOccupancy::Partial:
+				FallbackPlayerStart = FallbackPlayerStart ? FallbackPlayerStart : PlayerStart;
+				break;
+		}
+	}
+
+	return FallbackPlayerStart;
+}
+
+ELyraPlayerStartLocationOccupancy ULyraPlayerSpawningManagerComponent::GetCachedLocationOccupancy(ALyraPlayerStart* PlayerStart, AController* Controller)
+{
+	const int32* StartIndex = LyraSpawnScoring::bUseScoring ? ScoringStartIndices.Find(FObjectKey(PlayerStart)) : nullptr;
+	if (StartIndex == nullptr)
+	{
+		return PlayerStart->GetLocationOccupancy(Controller);
+	}
+
+	if (!ScoringService.IsOccupancyValid(*StartIndex))
+	{
+		if (!HasOccupancyCheckBudget())
+		{
+			// Never checked or out of date, don't risk spawning on top of someone
+			return PlayerStart->GetLocationOccupancy(Controller);
+		}
+
+		RefreshOccupancy(*StartIndex, PlayerStart);
+	}
+
+	return ScoringService.GetOccupancy(*StartIndex);
 }
 
 APlayerStart* ULyraPlayerSpawningManagerComponent::GetFirstRandomUnoccupiedPlayerStart(AController* Controller, const TArray<ALyraPlayerStart*>& StartPoints) const
@@ -3,6 +3,7 @@
 #pragma once
 
 #include "Components/GameStateComponent.h"
+#include "Player/LyraSpawnScoringService.h"
 
 #include "LyraPlayerSpawningManagerComponent.generated.h"
 
@@ -12,6 +13,7 @@ class APlayerState;
 class APlayerStart;
 class ALyraPlayerStart;
 class AActor;
+class ULyraExperienceDefinition;
 
 /**
  * @class ULyraPlayerSpawningManagerComponent
@@ -26,13 +28,20 @@ public:
 
 	/** UActorComponent */
 	virtual void InitializeComponent() override;
+	virtual void BeginPlay() override;
 	virtual void TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
 	/** ~UActorComponent */
 
 protected:
 	// Utility
 	APlayerStart* GetFirstRandomUnoccupiedPlayerStart(AController* Controller, const TArray<ALyraPlayerStart*>& FoundStartPoints) const;
-	
+
+	/**
+	 * Occupancy of a start as seen by the spawn scoring service. Only runs the physics queries of GetLocationOccupancy if the cached
+	 * value is out of date. Those refresh the cache while this frame's budget allows it, after that they are run uncached.
+	 */
+	ELyraPlayerStartLocationOccupancy GetCachedLocationOccupancy(ALyraPlayerStart* PlayerStart, AController* Controller);
+
 	virtual AActor* OnChoosePlayerStart(AController* Player, TArray<ALyraPlayerStart*>& PlayerStarts) { return nullptr; }
 	virtual void OnFinishRestartPlayer(AController* Player, const FRotator& StartRotation) { }
 
@@ -54,6 +63,29 @@ private:
 private:
 	void OnLevelAdded(ULevel* InLevel, UWorld* InWorld);
 	void HandleOnActorSpawned(AActor* SpawnedActor);
+	void OnExperienceLoaded(const ULyraExperienceDefinition* Experience);
+
+	// Spawn scoring
+	void AddScoringStart(ALyraPlayerStart* PlayerStart);
+	void RemoveScoringStart(int32 StartIndex);
+	void UpdateScoring();
+	AActor* ChooseScoredPlayerStart(AController* Player);
+	bool HasOccupancyCheckBudget() const;
+	void RefreshOccupancy(int32 StartIndex, ALyraPlayerStart* PlayerStart);
+
+	FLyraSpawnScoringService ScoringService;
+
+	// Scoring service start index -> player start, and back
+	TArray<TWeakObjectPtr<ALyraPlayerStart>> ScoringStartActors;
+	TMap<FObjectKey, int32> ScoringStartIndices;
+
+	uint64 OccupancyCheckFrame = 0;
+	int32 OccupancyChecksThisFrame = 0;
+
+	// Scratch storage reused between updates
+	TArray<FLyraSpawnScoringPawn> ScratchPawns;
+	TArray<int32> ScratchCandidates;
+	TArray<int32> ScratchUncheckedCandidates;
 
 #if WITH_EDITOR
 	APlayerStart* FindPlayFromHereStart(AController* Player);
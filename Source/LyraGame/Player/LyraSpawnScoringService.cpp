@@ -0,0 +1,344 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "LyraSpawnScoringService.h"
+
+FLyraSpawnScoringService::FLyraSpawnScoringService(const FLyraSpawnScoringSettings& InSettings)
+	: Settings(InSettings)
+{
+	Settings.CellSize = FMath::Max(Settings.CellSize, 1.0f);
+}
+
+FIntPoint FLyraSpawnScoringService::GetCell(const FVector& Location) const
+{
+	return FIntPoint(FMath::FloorToInt32(Location.X / Settings.CellSize), FMath::FloorToInt32(Location.Y / Settings.CellSize));
+}
+
+int32 FLyraSpawnScoringService::AddStart(const FVector& Location)
+{
+	FStart NewStart;
+	NewStart.Location = Location;
+	NewStart.Cell = GetCell(Location);
+
+	const int32 StartIndex = Starts.Add(MoveTemp(NewStart));
+	Cells.FindOrAdd(Starts[StartIndex].Cell).Add(StartIndex);
+
+	RefreshThreat(Starts[StartIndex]);
+	InvalidateOccupancy(StartIndex);
+
+	return StartIndex;
+}
+
+void FLyraSpawnScoringService::RemoveStart(int32 StartIndex)
+{
+	if (!Starts.IsValidIndex(StartIndex))
+	{
+		return;
+	}
+
+	if (TArray<int32>* CellStarts = Cells.Find(Starts[StartIndex].Cell))
+	{
+		CellStarts->RemoveSingleSwap(StartIndex, EAllowShrinking::No);
+		if (CellStarts->IsEmpty())
+		{
+			Cells.Remove(Starts[StartIndex].Cell);
+		}
+	}
+
+	Starts.RemoveAt(StartIndex);
+}
+
+void FLyraSpawnScoringService::UpdatePawns(TConstArrayView<FLyraSpawnScoringPawn> InPawns, double InCurrentTime)
+{
+	CurrentTime = InCurrentTime;
+	Pawns.Reset();
+	Pawns.Append(InPawns.GetData(), InPawns.Num());
+
+	++PawnGeneration;
+
+	for (const FLyraSpawnScoringPawn& Pawn : Pawns)
+	{
+		if (FTrackedPawn* Tracked = TrackedPawns.Find(Pawn.Id))
+		{
+			if (FVector::DistSquared(Tracked->Location, Pawn.Location) > FMath::Square(Settings.PawnMoveThreshold))
+			{
+				InvalidateOccupancyNear(Tracked->Location);
+				InvalidateOccupancyNear(Pawn.Location);
+				Tracked->Location = Pawn.Location;
+			}
+			Tracked->Generation = PawnGeneration;
+		}
+		else
+		{
+			InvalidateOccupancyNear(Pawn.Location);
+			TrackedPawns.Add(Pawn.Id, FTrackedPawn{ Pawn.Location, PawnGeneration });
+		}
+	}
+
+	// Pawns that went away may have been blocking a start
+	for (auto It = TrackedPawns.CreateIterator(); It; ++It)
+	{
+		if (It->Value.Generation != PawnGeneration)
+		{
+			InvalidateOccupancyNear(It->Value.Location);
+			It.RemoveCurrent();
+		}
+	}
+}
+
+void FLyraSpawnScoringService::InvalidateOccupancyNear(const FVector& Location)
+{
+	const float Radius = Settings.OccupancyInvalidationRadius;
+	const FIntPoint MinCell = GetCell(Location - FVector(Radius));
+	const FIntPoint MaxCell = GetCell(Location + FVector(Radius));
+
+	for (int32 X = MinCell.X; X <= MaxCell.X; ++X)
+	{
+		for (int32 Y = MinCell.Y; Y <= MaxCell.Y; ++Y)
+		{
+			if (const TArray<int32>* CellStarts = Cells.Find(FIntPoint(X, Y)))
+			{
+				for (int32 StartIndex : *CellStarts)
+				{
+					if (FVector::DistSquared(Starts[StartIndex].Location, Location) <= FMath::Square(Radius))
+					{
+						InvalidateOccupancy(StartIndex);
+					}
+				}
+			}
+		}
+	}
+}
+
+void FLyraSpawnScoringService::RefreshThreat(FStart& Start) const
+{
+	for (FTeamThreat& Threat : Start.Threats)
+	{
+		Threat.NearestDistance = MAX_flt;
+	}
+
+	for (const FLyraSpawnScoringPawn& Pawn : Pawns)
+	{
+		FTeamThreat* Threat = Start.Threats.FindByPredicate([&Pawn](const FTeamThreat& Entry) { return Entry.TeamId == Pawn.TeamId; });
+		if (Threat == nullptr)
+		{
+			Threat = &Start.Threats.AddDefaulted_GetRef();
+			Threat->TeamId = Pawn.TeamId;
+			Threat->NearestDistance = MAX_flt;
+		}
+
+		const float Distance = FVector::Dist(Start.Location, Pawn.Location);
+		if (Distance < Threat->NearestDistance)
+		{
+			Threat->NearestDistance = Distance;
+			Threat->NearestLocation = Pawn.Location;
+		}
+	}
+
+	Start.Threats.RemoveAllSwap([](const FTeamThreat& Threat) { return Threat.NearestDistance == MAX_flt; });
+}
+
+void FLyraSpawnScoringService::UpdateThreat(int32 NumStarts)
+{
+	const int32 MaxIndex = Starts.GetMaxIndex();
+	if (MaxIndex == 0)
+	{
+		return;
+	}
+
+	NumStarts = FMath::Min(NumStarts, MaxIndex);
+	for (int32 Step = 0; Step < NumStarts; ++Step)
+	{
+		ThreatCursor = (ThreatCursor + 1) % MaxIndex;
+		if (Starts.IsAllocated(ThreatCursor))
+		{
+			RefreshThreat(Starts[ThreatCursor]);
+		}
+	}
+}
+
+void FLyraSpawnScoringService::UpdateLineOfSight(int32 NumSamples, TFunctionRef<bool(const FVector& From, const FVector& To)> LineOfSightTest)
+{
+	const int32 MaxIndex = Starts.GetMaxIndex();
+	if (MaxIndex == 0)
+	{
+		return;
+	}
+
+	// Pawn and start locations are capsule centers, raise both to roughly eye height
+	const FVector EyeOffset(0.0f, 0.0f, 50.0f);
+
+	int32 SamplesTaken = 0;
+	for (int32 Visited = 0; (Visited < MaxIndex) && (SamplesTaken < NumSamples); )
+	{
+		if (!Starts.IsAllocated(LineOfSightStartCursor) || !Starts[LineOfSightStartCursor].Threats.IsValidIndex(LineOfSightTeamCursor))
+		{
+			LineOfSightStartCursor = (LineOfSightStartCursor + 1) % MaxIndex;
+			LineOfSightTeamCursor = 0;
+			++Visited;
+			continue;
+		}
+
+		FStart& Start = Starts[LineOfSightStartCursor];
+		FTeamThreat& Threat = Start.Threats[LineOfSightTeamCursor++];
+
+		if (Threat.NearestDistance <= Settings.LineOfSightCheckRadius)
+		{
+			Threat.bHasLineOfSight = LineOfSightTest(Start.Location + EyeOffset, Threat.NearestLocation + EyeOffset);
+			++SamplesTaken;
+		}
+		else
+		{
+			Threat.bHasLineOfSight = false;
+		}
+		Threat.LineOfSightTime = CurrentTime;
+	}
+}
+
+bool FLyraSpawnScoringService::PopStaleOccupancy(int32& OutStartIndex)
+{
+	while (StaleOccupancyQueue.Num() > 0)
+	{
+		const int32 StartIndex = StaleOccupancyQueue.Pop(EAllowShrinking::No);
+		if (Starts.IsValidIndex(StartIndex) && Starts[StartIndex].bInStaleQueue)
+		{
+			Starts[StartIndex].bInStaleQueue = false;
+			if (!Starts[StartIndex].bOccupancyValid)
+			{
+				OutStartIndex = StartIndex;
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
+void FLyraSpawnScoringService::SetOccupancy(int32 StartIndex, ELyraPlayerStartLocationOccupancy Occupancy)
+{
+	if (Starts.IsValidIndex(StartIndex))
+	{
+		Starts[StartIndex].Occupancy = Occupancy;
+		Starts[StartIndex].bOccupancyValid = true;
+	}
+}
+
+void FLyraSpawnScoringService::InvalidateOccupancy(int32 StartIndex)
+{
+	if (Starts.IsValidIndex(StartIndex))
+	{
+		FStart& Start = Starts[StartIndex];
+		Start.bOccupancyValid = false;
+		if (!Start.bInStaleQueue)
+		{
+			Start.bInStaleQueue = true;
+			StaleOccupancyQueue.Add(StartIndex);
+		}
+	}
+}
+
+void FLyraSpawnScoringService::InvalidateAllOccupancy()
+{
+	for (auto It = Starts.CreateConstIterator(); It; ++It)
+	{
+		InvalidateOccupancy(It.GetIndex());
+	}
+}
+
+bool FLyraSpawnScoringService::IsOccupancyValid(int32 StartIndex) const
+{
+	return Starts.IsValidIndex(StartIndex) && Starts[StartIndex].bOccupancyValid;
+}
+
+ELyraPlayerStartLocationOccupancy FLyraSpawnScoringService::GetOccupancy(int32 StartIndex) const
+{
+	return Starts.IsValidIndex(StartIndex) ? Starts[StartIndex].Occupancy : ELyraPlayerStartLocationOccupancy::Full;
+}
+
+void FLyraSpawnScoringService::SetClaimed(int32 StartIndex, bool bClaimed)
+{
+	if (Starts.IsValidIndex(StartIndex))
+	{
+		Starts[StartIndex].bClaimed = bClaimed;
+	}
+}
+
+float FLyraSpawnScoringService::ScoreStart(int32 StartIndex, int32 TeamId) const
+{
+	const FStart& Start = Starts[StartIndex];
+
+	float NearestEnemy = Settings.SafeEnemyDistance;
+	float NearestAlly = MAX_flt;
+	bool bSeenByEnemy = false;
+
+	for (const FTeamThreat& Threat : Start.Threats)
+	{
+		// Without a team (or against teamless pawns) everyone is an enemy
+		const bool bIsEnemy = (TeamId == INDEX_NONE) || (Threat.TeamId == INDEX_NONE) || (Threat.TeamId != TeamId);
+		if (bIsEnemy)
+		{
+			NearestEnemy = FMath::Min(NearestEnemy, Threat.NearestDistance);
+			bSeenByEnemy |= Threat.bHasLineOfSight && ((CurrentTime - Threat.LineOfSightTime) <= Settings.LineOfSightValidity);
+		}
+		else
+		{
+			NearestAlly = FMath::Min(NearestAlly, Threat.NearestDistance);
+		}
+	}
+
+	float Score = Settings.EnemyDistanceWeight * NearestEnemy;
+
+	if (NearestAlly < MAX_flt)
+	{
+		Score -= Settings.AllyDistanceWeight * FMath::Abs(NearestAlly - Settings.PreferredAllyDistance);
+	}
+
+	if (bSeenByEnemy)
+	{
+		Score -= Settings.LineOfSightPenalty;
+	}
+
+	if (Start.bOccupancyValid && (Start.Occupancy == ELyraPlayerStartLocationOccupancy::Partial))
+	{
+		Score -= Settings.PartialOccupancyPenalty;
+	}
+
+	if (Start.bClaimed)
+	{
+		Score -= Settings.ClaimedPenalty;
+	}
+
+	return Score;
+}
+
+void FLyraSpawnScoringService::GetRankedStarts(int32 TeamId, int32 MaxCandidates, TArray<int32>& OutStartIndices)
+{
+	OutStartIndices.Reset();
+	ScratchScores.Reset();
+
+	for (auto It = Starts.CreateConstIterator(); It; ++It)
+	{
+		if (It->bOccupancyValid && (It->Occupancy == ELyraPlayerStartLocationOccupancy::Full))
+		{
+			continue;
+		}
+
+		const float Score = ScoreStart(It.GetIndex(), TeamId) + FMath::FRandRange(0.0f, Settings.RandomJitter);
+		ScratchScores.Emplace(Score, It.GetIndex());
+	}
+
+	const int32 NumCandidates = FMath::Min(MaxCandidates, ScratchScores.Num());
+	if (NumCandidates <= 0)
+	{
+		return;
+	}
+
+	// Only the best few are needed, heapify the scores and pop them off in order
+	const auto HigherScore = [](const TPair<float, int32>& A, const TPair<float, int32>& B) { return A.Key > B.Key; };
+	ScratchScores.Heapify(HigherScore);
+	for (int32 Candidate = 0; Candidate < NumCandidates; ++Candidate)
+	{
+		TPair<float, int32> Best;
+		ScratchScores.HeapPop(Best, HigherScore, EAllowShrinking::No);
+		OutStartIndices.Add(Best.Value);
+	}
+}
@@ -0,0 +1,142 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Containers/SparseArray.h"
+#include "Player/LyraPlayerStart.h"
+
+/** A pawn the spawn scoring service should keep spawns away from (or near, for allies) */
+struct FLyraSpawnScoringPawn
+{
+	uint32 Id = 0;
+	FVector Location = FVector::ZeroVector;
+	int32 TeamId = INDEX_NONE;
+};
+
+struct FLyraSpawnScoringSettings
+{
+	// Size of the grid cells used to find the starts around a pawn
+	float CellSize = 2000.0f;
+
+	// Pawns within this distance of a start may change its occupancy
+	float OccupancyInvalidationRadius = 300.0f;
+
+	// Pawns have to move this far before the starts around them are invalidated again
+	float PawnMoveThreshold = 50.0f;
+
+	// Enemies further away than this don't make a start any safer
+	float SafeEnemyDistance = 5000.0f;
+
+	// Distance to the nearest ally that is considered ideal
+	float PreferredAllyDistance = 1500.0f;
+
+	float EnemyDistanceWeight = 1.0f;
+	float AllyDistanceWeight = 0.25f;
+
+	// Only the nearest pawn of each team within this distance is tested for line of sight
+	float LineOfSightCheckRadius = 6000.0f;
+
+	// How long a line of sight sample is trusted for
+	float LineOfSightValidity = 2.0f;
+
+	// Score penalties, in distance units
+	float LineOfSightPenalty = 3000.0f;
+	float PartialOccupancyPenalty = 2000.0f;
+	float ClaimedPenalty = 4000.0f;
+	float RandomJitter = 250.0f;
+};
+
+/**
+ * FLyraSpawnScoringService
+ *
+ * Keeps a grid of player start locations with cached occupancy, per-team threat distances and line of sight samples.
+ * Occupancy is invalidated when pawns move near a start, and the threat and line of sight data is refreshed a few
+ * starts at a time, so choosing a start costs a scoring pass over cached data instead of physics queries per start.
+ */
+class LYRAGAME_API FLyraSpawnScoringService
+{
+public:
+	explicit FLyraSpawnScoringService(const FLyraSpawnScoringSettings& InSettings = FLyraSpawnScoringSettings());
+
+	int32 AddStart(const FVector& Location);
+	void RemoveStart(int32 StartIndex);
+	bool IsValidStart(int32 StartIndex) const { return Starts.IsValidIndex(StartIndex); }
+	int32 GetNumStarts() const { return Starts.Num(); }
+
+	/** Updates the tracked pawns, invalidating the occupancy of starts around pawns that moved, appeared or disappeared */
+	void UpdatePawns(TConstArrayView<FLyraSpawnScoringPawn> Pawns, double CurrentTime);
+
+	/** Refreshes the threat data of up to NumStarts starts */
+	void UpdateThreat(int32 NumStarts);
+
+	/** Runs up to NumSamples line of sight samples, LineOfSightTest returns true if From can see To */
+	void UpdateLineOfSight(int32 NumSamples, TFunctionRef<bool(const FVector& From, const FVector& To)> LineOfSightTest);
+
+	/** Pops the next start whose cached occupancy is out of date, returns false if there are none */
+	bool PopStaleOccupancy(int32& OutStartIndex);
+
+	void SetOccupancy(int32 StartIndex, ELyraPlayerStartLocationOccupancy Occupancy);
+	void InvalidateOccupancy(int32 StartIndex);
+	void InvalidateAllOccupancy();
+	bool IsOccupancyValid(int32 StartIndex) const;
+	ELyraPlayerStartLocationOccupancy GetOccupancy(int32 StartIndex) const;
+
+	void SetClaimed(int32 StartIndex, bool bClaimed);
+
+	/** Writes the best MaxCandidates starts for a member of TeamId, best first. Starts known to be full are skipped. */
+	void GetRankedStarts(int32 TeamId, int32 MaxCandidates, TArray<int32>& OutStartIndices);
+
+	/** Scores a single start for a member of TeamId, higher is better */
+	float ScoreStart(int32 StartIndex, int32 TeamId) const;
+
+private:
+	struct FTeamThreat
+	{
+		int32 TeamId = INDEX_NONE;
+		float NearestDistance = 0.0f;
+		FVector NearestLocation = FVector::ZeroVector;
+		double LineOfSightTime = -1.0;
+		bool bHasLineOfSight = false;
+	};
+
+	struct FStart
+	{
+		FVector Location;
+		FIntPoint Cell;
+		ELyraPlayerStartLocationOccupancy Occupancy = ELyraPlayerStartLocationOccupancy::Empty;
+		bool bOccupancyValid = false;
+		bool bInStaleQueue = false;
+		bool bClaimed = false;
+		TArray<FTeamThreat, TInlineAllocator<4>> Threats;
+	};
+
+	struct FTrackedPawn
+	{
+		FVector Location;
+		uint32 Generation = 0;
+	};
+
+	FIntPoint GetCell(const FVector& Location) const;
+	void InvalidateOccupancyNear(const FVector& Location);
+	void RefreshThreat(FStart& Start) const;
+
+	FLyraSpawnScoringSettings Settings;
+
+	TSparseArray<FStart> Starts;
+	TMap<FIntPoint, TArray<int32>> Cells;
+
+	TArray<FLyraSpawnScoringPawn> Pawns;
+	TMap<uint32, FTrackedPawn> TrackedPawns;
+	uint32 PawnGeneration = 0;
+
+	TArray<int32> StaleOccupancyQueue;
+
+	int32 ThreatCursor = 0;
+	int32 LineOfSightStartCursor = 0;
+	int32 LineOfSightTeamCursor = 0;
+
+	double CurrentTime = 0.0;
+
+	// Scratch storage reused between rankings
+	TArray<TPair<float, int32>> ScratchScores;
+};
@@ -0,0 +1,158 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "LyraReplayStorageManager.h"
+
+#include "Algo/Sort.h"
+#include "HAL/PlatformTime.h"
+#include "LyraLogChannels.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(LyraReplayStorageManager)
+
+FLyraReplayStorageManager::FLyraReplayStorageManager(const TSharedPtr<INetworkReplayStreamer>& InReplayStreamer)
+	: ReplayStreamer(InReplayStreamer)
+{
+}
+
+bool FLyraReplayStorageManager::StartCleanup(int32 UserIndex, const FLyraReplayStoragePolicy& Policy, bool bReserveLiveStream, const FLyraReplayCleanupComplete& OnComplete)
+{
+	if (bCleanupInProgress || !ReplayStreamer.IsValid())
+	{
+		return false;
+	}
+
+	bCleanupInProgress = true;
+	CurrentPolicy = Policy;
+	CurrentOnComplete = OnComplete;
+	CurrentResult = FLyraReplayCleanupResult();
+	CurrentUserIndex = UserIndex;
+	bCurrentReserveLiveStream = bReserveLiveStream;
+	NumDeletesPending = 0;
+	CleanupStartTime = FPlatformTime::Seconds();
+
+	// Use the default version to get old version replays as well
+	FNetworkReplayVersion EnumerateStreamsVersion;
+
+	ReplayStreamer->EnumerateStreams(EnumerateStreamsVersion, UserIndex, FString(), TArray<FString>(), FEnumerateStreamsCallback::CreateSP(this, &FLyraReplayStorageManager::OnEnumerateStreamsComplete));
+	return true;
+}
+
+TArray<FNetworkReplayStreamInfo> FLyraReplayStorageManager::SelectStreamsToDelete(TConstArrayView<FNetworkReplayStreamInfo> Streams, const FLyraReplayStoragePolicy& Policy, const FDateTime& Now, bool bReserveLiveStream)
+{
+	TArray<const FNetworkReplayStreamInfo*> SortedStreams;
+	SortedStreams.Reserve(Streams.Num());
+	for (const FNetworkReplayStreamInfo& StreamInfo : Streams)
+	{
+		SortedStreams.Add(&StreamInfo);
+	}
+
+	// Newest first, so the oldest streams are the ones over the budgets
+	Algo::SortBy(SortedStreams, [](const FNetworkReplayStreamInfo* StreamInfo) { return StreamInfo->Timestamp.GetTicks(); }, TGreater<>());
+
+	// If we're recording, the live stream may or may not show up in the query which affects the keep count
+	const bool bHasLiveStream = SortedStreams.ContainsByPredicate([](const FNetworkReplayStreamInfo* StreamInfo) { return StreamInfo->bIsLive; });
+	const bool bReserveSlot = bReserveLiveStream && !bHasLiveStream;
+	int32 NumKept = bReserveSlot ? 1 : 0;
+	int64 BytesKept = 0;
+
+	// A recording that isn't in the results has no size yet, so budget it as big as the newest finished stream
+	if (bReserveSlot)
+	{
+		if (const FNetworkReplayStreamInfo* const* NewestStream = SortedStreams.FindByPredicate([](const FNetworkReplayStreamInfo* StreamInfo) { return !StreamInfo->bIsLive; }))
+		{
+			BytesKept = (*NewestStream)->SizeInBytes;
+		}
+	}
+
+	const int64 MaxTotalBytes = static_cast<int64>(Policy.MaxTotalSizeInMB) * 1024 * 1024;
+	const FDateTime OldestTimestamp = (Policy.MaxAgeInDays > 0) ? (Now - FTimespan::FromDays(Policy.MaxAgeInDays)) : FDateTime::MinValue();
+
+	TArray<FNetworkReplayStreamInfo> StreamsToDelete;
+	bool bSizeBudgetExceeded = false;
+	for (const FNetworkReplayStreamInfo* StreamInfo : SortedStreams)
+	{
+		// Never delete keep streams or the one being recorded, but they still use up the budgets
+		const bool bCanDelete = !StreamInfo->bShouldKeep && !StreamInfo->bIsLive;
+
+		const bool bOverCount = (Policy.MaxNumReplays > 0) && (NumKept >= Policy.MaxNumReplays);
+		const bool bOverSize = bSizeBudgetExceeded || ((MaxTotalBytes > 0) && ((BytesKept + StreamInfo->SizeInBytes) > MaxTotalBytes));
+		const bool bTooOld = StreamInfo->Timestamp < OldestTimestamp;
+
+		if (bCanDelete && (bOverCount || bOverSize || bTooOld))
+		{
+			// Once a stream doesn't fit, every older one goes too, a smaller older stream must not be kept over a newer one
+			bSizeBudgetExceeded |= bOverSize;
+			StreamsToDelete.Add(*StreamInfo);
+		}
+		else
+		{
+			NumKept++;
+			BytesKept += StreamInfo->SizeInBytes;
+		}
+	}
+
+	return StreamsToDelete;
+}
+
+void FLyraReplayStorageManager::OnEnumerateStreamsComplete(const FEnumerateStreamsResult& Result)
+{
+	if (!Result.WasSuccessful())
+	{
+		UE_LOG(LogLyra, Warning, TEXT("Failed to enumerate replays for cleanup with error %d!"), (int32)Result.Result);
+		CurrentResult.bEnumerateFailed = true;
+		FinishCleanup();
+		return;
+	}
+
+	const TArray<FNetworkReplayStreamInfo> StreamsToDelete = SelectStreamsToDelete(Result.FoundStreams, CurrentPolicy, FDateTime::UtcNow(), bCurrentReserveLiveStream);
+
+	CurrentResult.NumStreamsFound = Result.FoundStreams.Num();
+	CurrentResult.NumStreamsToDelete = StreamsToDelete.Num();
+
+	if (StreamsToDelete.Num() == 0)
+	{
+		FinishCleanup();
+		return;
+	}
+
+	UE_LOG(LogLyra, Log, TEXT("LyraReplayStorageManager deleting %d of %d replays"), StreamsToDelete.Num(), Result.FoundStreams.Num());
+
+	// Count them all first, a streamer may call back before the next delete is queued
+	NumDeletesPending = StreamsToDelete.Num();
+	for (const FNetworkReplayStreamInfo& StreamInfo : StreamsToDelete)
+	{
+		ReplayStreamer->DeleteFinishedStream(StreamInfo.Name, CurrentUserIndex, FDeleteFinishedStreamCallback::CreateSP(this, &FLyraReplayStorageManager::OnDeleteStreamComplete, StreamInfo.SizeInBytes));
+	}
+}
+
+void FLyraReplayStorageManager::OnDeleteStreamComplete(const FDeleteFinishedStreamResult& Result, int64 SizeInBytes)
+{
+	if (Result.WasSuccessful())
+	{
+		CurrentResult.NumStreamsDeleted++;
+		CurrentResult.BytesDeleted += SizeInBytes;
+	}
+	else
+	{
+		// TODO properly integrate with platform-specific error reporting
+		UE_LOG(LogLyra, Warning, TEXT("Failed to delete replay with error %d!"), (int32)Result.Result);
+		CurrentResult.NumStreamsFailed++;
+	}
+
+	if (--NumDeletesPending == 0)
+	{
+		FinishCleanup();
+	}
+}
+
+void FLyraReplayStorageManager::FinishCleanup()
+{
+	CurrentResult.Seconds = FPlatformTime::Seconds() - CleanupStartTime;
+	bCleanupInProgress = false;
+
+	UE_LOG(LogLyra, Log, TEXT("LyraReplayStorageManager deleted %d replays (%lld bytes, %d failed) out of %d in %.3f s"),
+		CurrentResult.NumStreamsDeleted, CurrentResult.BytesDeleted, CurrentResult.NumStreamsFailed, CurrentResult.NumStreamsFound, CurrentResult.Seconds);
+
+	FLyraReplayCleanupComplete OnComplete = MoveTemp(CurrentOnComplete);
+	CurrentOnComplete.Unbind();
+	OnComplete.ExecuteIfBound(CurrentResult);
+}
@@ -0,0 +1,83 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "NetworkReplayStreaming.h"
+
+#include "LyraReplayStorageManager.generated.h"
+
+/** Limits on the finished replays kept by a streamer, a limit of 0 means no limit */
+USTRUCT(BlueprintType)
+struct FLyraReplayStoragePolicy
+{
+	GENERATED_BODY()
+
+	/** Number of replays to keep, including the one being recorded */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category=Replays)
+	int32 MaxNumReplays = 0;
+
+	/** Total size of the replays to keep */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category=Replays)
+	int32 MaxTotalSizeInMB = 0;
+
+	/** Replays recorded longer ago than this are deleted */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category=Replays)
+	int32 MaxAgeInDays = 0;
+
+	bool HasAnyLimit() const { return (MaxNumReplays > 0) || (MaxTotalSizeInMB > 0) || (MaxAgeInDays > 0); }
+};
+
+/** What a cleanup did */
+struct FLyraReplayCleanupResult
+{
+	int32 NumStreamsFound = 0;
+	int32 NumStreamsToDelete = 0;
+	int32 NumStreamsDeleted = 0;
+	int32 NumStreamsFailed = 0;
+	int64 BytesDeleted = 0;
+	double Seconds = 0.0;
+	bool bEnumerateFailed = false;
+};
+
+DECLARE_DELEGATE_OneParam(FLyraReplayCleanupComplete, const FLyraReplayCleanupResult& /*Result*/);
+
+/**
+ * Applies a FLyraReplayStoragePolicy to the finished replays of a streamer.
+ *
+ * The streams are enumerated once, the ones over the count, size or age budget are picked newest first, and every delete is then
+ * queued on the streamer at once instead of enumerating again after each one.  Streamers do their storage work off the game thread
+ * (the local file streamer runs its queue on the thread pool), so the whole batch is deleted in the background and the callback is
+ * called on the game thread once all of the deletes have finished.  Streams marked to be kept and the live stream are never deleted.
+ */
+class LYRAGAME_API FLyraReplayStorageManager : public TSharedFromThis<FLyraReplayStorageManager>
+{
+public:
+	explicit FLyraReplayStorageManager(const TSharedPtr<INetworkReplayStreamer>& InReplayStreamer);
+
+	/**
+	 * Starts deleting the streams of UserIndex over the policy's budgets, returns false if a cleanup is already running.
+	 * If bReserveLiveStream is set, a recording that doesn't show up in the streams yet is counted as the newest one, with the size of the newest finished stream.
+	 */
+	bool StartCleanup(int32 UserIndex, const FLyraReplayStoragePolicy& Policy, bool bReserveLiveStream, const FLyraReplayCleanupComplete& OnComplete);
+
+	bool IsCleanupInProgress() const { return bCleanupInProgress; }
+
+	/** Picks the streams over the policy's budgets, exposed so the policy can be tested without a streamer */
+	static TArray<FNetworkReplayStreamInfo> SelectStreamsToDelete(TConstArrayView<FNetworkReplayStreamInfo> Streams, const FLyraReplayStoragePolicy& Policy, const FDateTime& Now, bool bReserveLiveStream);
+
+private:
+	void OnEnumerateStreamsComplete(const FEnumerateStreamsResult& Result);
+	void OnDeleteStreamComplete(const FDeleteFinishedStreamResult& Result, int64 SizeInBytes);
+	void FinishCleanup();
+
+	TSharedPtr<INetworkReplayStreamer> ReplayStreamer;
+
+	FLyraReplayStoragePolicy CurrentPolicy;
+	FLyraReplayCleanupComplete CurrentOnComplete;
+	FLyraReplayCleanupResult CurrentResult;
+	int32 CurrentUserIndex = INDEX_NONE;
+	int32 NumDeletesPending = 0;
+	double CleanupStartTime = 0.0;
+	bool bCurrentReserveLiveStream = false;
+	bool bCleanupInProgress = false;
+};
@@ -8,7 +8,10 @@
 #include "Misc/DateTime.h"
 #include "CommonUISettings.h"
 #include "ICommonUIModule.h"
+#include "GameFramework/PlayerState.h"
+#include "HAL/IConsoleManager.h"
 #include "LyraLogChannels.h"
+#include "Messages/LyraVerbMessage.h"
 #include "Player/LyraLocalPlayer.h"
 #include "Settings/LyraSettingsLocal.h"
 
@@ -16,10 +19,90 @@
 
 UE_DEFINE_GAMEPLAY_TAG_STATIC(TAG_Platform_Trait_ReplaySupport, "Platform.Trait.ReplaySupport");
 
+namespace LyraReplaySubsystem
+{
+	static bool bCheckpointOnEvents = true;
+	static FAutoConsoleVariableRef CVarCheckpointOnEvents(
+		TEXT("Lyra.Replay.CheckpointOnEvents"),
+		bCheckpointOnEvents,
+		TEXT("If true, recording replays request a checkpoint when an indexed gameplay event happens"),
+		ECVF_Default);
+
+	static float EventCheckpointWindow = 10.0f;
+	static FAutoConsoleVariableRef CVarEventCheckpointWindow(
+		TEXT("Lyra.Replay.EventCheckpointWindow"),
+		EventCheckpointWindow,
+		TEXT("Seconds after an indexed gameplay event during which checkpoints keep being requested, fights tend to produce several events close together"),
+		ECVF_Default);
+
+	static float EventCheckpointInterval = 2.0f;
+	static FAutoConsoleVariableRef CVarEventCheckpointInterval(
+		TEXT("Lyra.Replay.EventCheckpointInterval"),
+		EventCheckpointInterval,
+		TEXT("Minimum seconds between checkpoints requested for indexed gameplay events"),
+		ECVF_Default);
+
+	static float EventSeekLeadSeconds = 0.0f;
+	static FAutoConsoleVariableRef CVarEventSeekLeadSeconds(
+		TEXT("Lyra.Replay.EventSeekLeadSeconds"),
+		EventSeekLeadSeconds,
+		TEXT("How many seconds before an indexed gameplay event SeekToReplayEvent goes to"),
+		ECVF_Default);
+
+	// Separates the fields of an event's metadata
+	static const TCHAR* EventMetadataSeparator = TEXT("\t");
+
+	static FString GetEventObjectName(const UObject* Object)
+	{
+		if (const APlayerState* PlayerState = Cast<APlayerState>(Object))
+		{
+			return PlayerState->GetPlayerName();
+		}
+		return GetNameSafe(Object);
+	}
+}
+
+const FString ULyraReplaySubsystem::ReplayEventGroup(TEXT("LyraEvents"));
+
 ULyraReplaySubsystem::ULyraReplaySubsystem()
 {
 }
 
+void ULyraReplaySubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	UGameplayMessageSubsystem* MessageSubsystem = Collection.InitializeDependency<UGameplayMessageSubsystem>();
+	// Recordings can be started without RecordClientReplay (e.g. demorec), so this listens whenever something may record
+	if (MessageSubsystem)
+	{
+		for (const FGameplayTag& EventTag : IndexedEventTags)
+		{
+			if (EventTag.IsValid())
+			{
+				EventListenerHandles.Add(MessageSubsystem->RegisterListener(EventTag, this, &ThisClass::OnIndexedEventMessage));
+			}
+		}
+	}
+}
+
+void ULyraReplaySubsystem::Deinitialize()
+{
+	for (FGameplayMessageListenerHandle& ListenerHandle : EventListenerHandles)
+	{
+		ListenerHandle.Unregister();
+	}
+	EventListenerHandles.Reset();
+
+	if (EventCheckpointTickerHandle.IsValid())
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker(EventCheckpointTickerHandle);
+		EventCheckpointTickerHandle.Reset();
+	}
+
+	Super::Deinitialize();
+}
+
 bool ULyraReplaySubsystem::DoesPlatformSupportReplays()
 {
 	if (ICommonUIModule::GetSettings().GetPlatformTraits().HasTag(GetPlatformSupportTraitTag()))
@@ -53,135 +136,206 @@ void ULyraReplaySubsystem::RecordClientReplay(APlayerController* PlayerControlle
 		if (ULyraLocalPlayer* LyraLocalPlayer = Cast<ULyraLocalPlayer>(PlayerController->GetLocalPlayer()))
 		{
 			// Start a cleanup of existing saved streams
-			int32 NumToKeep = LyraLocalPlayer->GetLocalSettings()->GetNumberOfReplaysToKeep();
-			CleanupLocalReplays(LyraLocalPlayer, NumToKeep);
+			const ULyraSettingsLocal* LocalSettings = LyraLocalPlayer->GetLocalSettings();
+
+			FLyraReplayStoragePolicy Policy;
+			Policy.MaxNumReplays = LocalSettings->GetNumberOfReplaysToKeep();
+			Policy.MaxTotalSizeInMB = LocalSettings->GetReplayStorageLimitInMB();
+			Policy.MaxAgeInDays = LocalSettings->GetReplayAgeLimitInDays();
+			CleanupLocalReplaysWithPolicy(LyraLocalPlayer, Policy);
 		}
 	}
 }
 
 void ULyraReplaySubsystem::CleanupLocalReplays(ULocalPlayer* LocalPlayer, int32 NumReplaysToKeep)
 {
-	// TODO this was only tested with the generic file streamer and may not fully work with the save game streamer
-	// This only handles one delete at a time, and will loop until it gets an error or goes below NumReplaysToKeep
-	// It does it this way because each delete may involve a server or save game query that invalidates the replay list
-	if (LocalPlayer != nullptr && LocalPlayerDeletingReplays == nullptr && NumReplaysToKeep != 0)
-	{
-		LocalPlayerDeletingReplays = LocalPlayer;
-		DeletingReplaysNumberToKeep = NumReplaysToKeep;
-
-		CurrentReplayStreamer = FNetworkReplayStreaming::Get().GetFactory().CreateReplayStreamer();
-		if (CurrentReplayStreamer.IsValid())
-		{
-			// Use the default version to get old version replays as well
-			FNetworkReplayVersion EnumerateStreamsVersion;
-
-			CurrentReplayStreamer->EnumerateStreams(EnumerateStreamsVersion, LocalPlayer->GetPlatformUserIndex(), FString(), TArray<FString>(), FEnumerateStreamsCallback::CreateUObject(this, &ThisClass::OnEnumerateStreamsCompleteForDelete));
-		}
-	}
+	FLyraReplayStoragePolicy Policy;
+	Policy.MaxNumReplays = NumReplaysToKeep;
+	CleanupLocalReplaysWithPolicy(LocalPlayer, Policy);
 }
 
-void ULyraReplaySubsystem::OnEnumerateStreamsCompleteForDelete(const FEnumerateStreamsResult& Result)
+void ULyraReplaySubsystem::CleanupLocalReplaysWithPolicy(ULocalPlayer* LocalPlayer, const FLyraReplayStoragePolicy& Policy)
 {
-	if (!CurrentReplayStreamer.IsValid() || !IsValid(LocalPlayerDeletingReplays))
+	// TODO this was only tested with the generic file streamer and may not fully work with the save game streamer
+	// The streams are only enumerated once, each delete is queued on the streamer right away and runs off the game thread
+	if (LocalPlayer == nullptr || !Policy.HasAnyLimit())
 	{
-		// Lost context, don't do anything
 		return;
 	}
 
-	TArray<FNetworkReplayStreamInfo> StreamsToDelete;
-	for (const FNetworkReplayStreamInfo& StreamInfo : Result.FoundStreams)
+	if (ReplayStorageManager.IsValid() && ReplayStorageManager->IsCleanupInProgress())
 	{
-		// Never delete keep streams
-		if (!StreamInfo.bShouldKeep)
-		{
-			StreamsToDelete.Add(StreamInfo);
-		}
+		// The cleanup that's running will free up space already, the next recording cleans up again
+		return;
 	}
 
-	// Sort by date
-	Algo::SortBy(StreamsToDelete, [](const FNetworkReplayStreamInfo& Data) { return Data.Timestamp.GetTicks(); }, TGreater<>());
+	TSharedPtr<INetworkReplayStreamer> ReplayStreamer = FNetworkReplayStreaming::Get().GetFactory().CreateReplayStreamer();
+	if (ReplayStreamer.IsValid())
+	{
+		UDemoNetDriver* DemoDriver = GetDemoDriver();
+		const bool bIsRecording = DemoDriver && DemoDriver->IsRecording();
 
+		ReplayStorageManager = MakeShared<FLyraReplayStorageManager>(ReplayStreamer);
+		ReplayStorageManager->StartCleanup(LocalPlayer->GetPlatformUserIndex(), Policy, bIsRecording, FLyraReplayCleanupComplete());
+	}
+}
+
+void ULyraReplaySubsystem::SeekInActiveReplay(float TimeInSeconds)
+{
 	if (UDemoNetDriver* DemoDriver = GetDemoDriver())
 	{
-		if (DemoDriver->IsRecording())
-		{
-			// If we're recording, the live stream may or may not show up in the query which affects the keep count
-			// Add a fake live stream if the active one is missing from the results
-			if (StreamsToDelete.Num() > 0 && !StreamsToDelete[0].bIsLive)
-			{
-				StreamsToDelete.Insert(FNetworkReplayStreamInfo(), 0);
-			}
-		}
+		DemoDriver->GotoTimeInSeconds(TimeInSeconds);
 	}
+}
 
-	if (StreamsToDelete.Num() > DeletingReplaysNumberToKeep)
+float ULyraReplaySubsystem::GetReplayLengthInSeconds() const
+{
+	if (UDemoNetDriver* DemoDriver = GetDemoDriver())
 	{
-		// Delete the first replay above the limit, if successful it won't be in the loop during the next loop
-		// If unsuccessful, it will stop looping
-		FString ReplayName = StreamsToDelete[DeletingReplaysNumberToKeep].Name;
-		UE_LOG(LogLyra, Log, TEXT("LyraReplaySubsystem asked to delete replay %s"), *ReplayName);
-		CurrentReplayStreamer->DeleteFinishedStream(ReplayName, LocalPlayerDeletingReplays->GetPlatformUserIndex(), FDeleteFinishedStreamCallback::CreateUObject(this, &ThisClass::OnDeleteReplay));
+		return DemoDriver->GetDemoTotalTime();
 	}
-	else
+	return 0.0f;
+}
+
+float ULyraReplaySubsystem::GetReplayCurrentTime() const
+{
+	if (UDemoNetDriver* DemoDriver = GetDemoDriver())
 	{
-		// We're below the limit so stop iterating
-		CurrentReplayStreamer = nullptr;
-		LocalPlayerDeletingReplays = nullptr;
-		DeletingReplaysNumberToKeep = 0;
+		return DemoDriver->GetDemoCurrentTime();
 	}
+	return 0.0f;
 }
 
-void ULyraReplaySubsystem::OnDeleteReplay(const FDeleteFinishedStreamResult& DeleteResult)
+void ULyraReplaySubsystem::OnIndexedEventMessage(FGameplayTag Channel, const FLyraVerbMessage& Message)
 {
-	if (!CurrentReplayStreamer.IsValid() || !IsValid(LocalPlayerDeletingReplays))
+	using namespace LyraReplaySubsystem;
+
+	UDemoNetDriver* DemoDriver = GetDemoDriver();
+	if (!DemoDriver || !DemoDriver->IsRecording())
 	{
-		// Lost context, don't do anything
 		return;
 	}
 
-	if (DeleteResult.WasSuccessful())
+	// Starting a new recording starts a new index
+	const FString ReplayName = DemoDriver->GetActiveReplayName();
+	if (ReplayName != IndexedReplayName)
 	{
-		// Enumerate list again to see if we're under the limit yet
-		FNetworkReplayVersion EnumerateStreamsVersion;
+		ReplayEvents.Reset();
+		IndexedReplayName = ReplayName;
+		LastEventCheckpointTime = -1.0f;
+		EventCheckpointWindowEndTime = -1.0f;
+	}
+
+	FLyraReplayEvent& Event = ReplayEvents.AddDefaulted_GetRef();
+	Event.EventTag = Message.Verb.IsValid() ? Message.Verb : Channel;
+	Event.TimeInSeconds = DemoDriver->GetDemoCurrentTime();
+	Event.InstigatorName = GetEventObjectName(Message.Instigator);
+	Event.TargetName = GetEventObjectName(Message.Target);
 
-		CurrentReplayStreamer->EnumerateStreams(EnumerateStreamsVersion, LocalPlayerDeletingReplays->GetPlatformUserIndex(), FString(), TArray<FString>(), FEnumerateStreamsCallback::CreateUObject(this, &ThisClass::OnEnumerateStreamsCompleteForDelete));
+	// The event's time is taken by the stream, only the names are kept as metadata and no payload is written
+	const FString EventName = FString::Printf(TEXT("%s_%d"), *Event.EventTag.ToString(), ReplayEvents.Num() - 1);
+	const FString Metadata = FString::Join(TArray<FString>({ Event.EventTag.ToString(), Event.InstigatorName, Event.TargetName }), EventMetadataSeparator);
+	DemoDriver->AddOrUpdateEvent(EventName, ReplayEventGroup, Metadata, TArray<uint8>());
+
+	if (bCheckpointOnEvents)
+	{
+		RequestEventCheckpoint(DemoDriver);
+
+		EventCheckpointWindowEndTime = Event.TimeInSeconds + EventCheckpointWindow;
+		if (!EventCheckpointTickerHandle.IsValid() && (EventCheckpointWindow > 0.0f))
+		{
+			EventCheckpointTickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &ThisClass::TickEventCheckpoints), EventCheckpointInterval);
+		}
 	}
-	else
+}
+
+void ULyraReplaySubsystem::RequestEventCheckpoint(UDemoNetDriver* DemoDriver)
+{
+	const float CurrentTime = DemoDriver->GetDemoCurrentTime();
+	if ((LastEventCheckpointTime < 0.0f) || ((CurrentTime - LastEventCheckpointTime) >= LyraReplaySubsystem::EventCheckpointInterval))
 	{
-		// Failed, stop trying to delete anything else
-		// TODO properly integrate with platform-specific error reporting
-		UE_LOG(LogLyra, Warning, TEXT("Failed to delete replay with error %d!"), (int32)DeleteResult.Result);
+		DemoDriver->RequestCheckpoint();
+		LastEventCheckpointTime = CurrentTime;
+	}
+}
 
-		CurrentReplayStreamer = nullptr;
-		LocalPlayerDeletingReplays = nullptr;
-		DeletingReplaysNumberToKeep = 0;
+bool ULyraReplaySubsystem::TickEventCheckpoints(float DeltaTime)
+{
+	UDemoNetDriver* DemoDriver = GetDemoDriver();
+	if (!DemoDriver || !DemoDriver->IsRecording() || (DemoDriver->GetDemoCurrentTime() > EventCheckpointWindowEndTime))
+	{
+		EventCheckpointTickerHandle.Reset();
+		return false;
 	}
+
+	RequestEventCheckpoint(DemoDriver);
+	return true;
 }
 
-void ULyraReplaySubsystem::SeekInActiveReplay(float TimeInSeconds)
+void ULyraReplaySubsystem::RefreshReplayEventIndex()
 {
-	if (UDemoNetDriver* DemoDriver = GetDemoDriver())
+	UDemoNetDriver* DemoDriver = GetDemoDriver();
+	if (DemoDriver && DemoDriver->IsPlaying() && DemoDriver->GetReplayStreamer().IsValid())
 	{
-		DemoDriver->GotoTimeInSeconds(TimeInSeconds);
+		// The index is read from the stream's header, this doesn't need to download or scan the replay data
+		ReplayEvents.Reset();
+		IndexedReplayName = DemoDriver->GetActiveReplayName();
+		DemoDriver->GetReplayStreamer()->EnumerateEvents(ReplayEventGroup, FEnumerateEventsCallback::CreateUObject(this, &ThisClass::OnEnumerateReplayEventsComplete));
 	}
 }
 
-float ULyraReplaySubsystem::GetReplayLengthInSeconds() const
+void ULyraReplaySubsystem::OnEnumerateReplayEventsComplete(const FEnumerateEventsResult& Result)
 {
-	if (UDemoNetDriver* DemoDriver = GetDemoDriver())
+	using namespace LyraReplaySubsystem;
+
+	ReplayEvents.Reset();
+
+	if (!Result.WasSuccessful())
 	{
-		return DemoDriver->GetDemoTotalTime();
+		UE_LOG(LogLyra, Warning, TEXT("Failed to read the event index of replay %s with error %d"), *IndexedReplayName, (int32)Result.Result);
+		OnReplayEventIndexUpdated.Broadcast();
+		return;
 	}
-	return 0.0f;
+
+	ReplayEvents.Reserve(Result.ReplayEventList.ReplayEvents.Num());
+	for (const FReplayEventListItem& Item : Result.ReplayEventList.ReplayEvents)
+	{
+		TArray<FString> Fields;
+		Item.Metadata.ParseIntoArray(Fields, EventMetadataSeparator, /*bCullEmpty=*/ false);
+
+		FLyraReplayEvent& Event = ReplayEvents.AddDefaulted_GetRef();
+		Event.EventTag = FGameplayTag::RequestGameplayTag(Fields.IsValidIndex(0) ? FName(*Fields[0]) : NAME_None, /*ErrorIfNotFound=*/ false);
+		Event.TimeInSeconds = Item.Time1 / 1000.0f;
+		Event.InstigatorName = Fields.IsValidIndex(1) ? Fields[1] : FString();
+		Event.TargetName = Fields.IsValidIndex(2) ? Fields[2] : FString();
+	}
+
+	Algo::SortBy(ReplayEvents, &FLyraReplayEvent::TimeInSeconds);
+
+	OnReplayEventIndexUpdated.Broadcast();
 }
 
-float ULyraReplaySubsystem::GetReplayCurrentTime() const
+bool ULyraReplaySubsystem::SeekToReplayEvent(int32 EventIndex)
 {
-	if (UDemoNetDriver* DemoDriver = GetDemoDriver())
+	return SeekToReplayEventWithCallback(EventIndex, FLyraReplaySeekComplete());
+}
+
+bool ULyraReplaySubsystem::SeekToReplayEventWithCallback(int32 EventIndex, const FLyraReplaySeekComplete& OnSeekComplete)
+{
+	UDemoNetDriver* DemoDriver = GetDemoDriver();
+	if (!DemoDriver || !DemoDriver->IsPlaying() || !ReplayEvents.IsValidIndex(EventIndex))
 	{
-		return DemoDriver->GetDemoCurrentTime();
+		return false;
 	}
-	return 0.0f;
+
+	// Events were recorded with a checkpoint next to them, so this is a checkpoint load with little or no fast forwarding
+	const float TargetTime = FMath::Max(0.0f, ReplayEvents[EventIndex].TimeInSeconds - LyraReplaySubsystem::EventSeekLeadSeconds);
+	DemoDriver->GotoTimeInSeconds(TargetTime, FOnGotoTimeDelegate::CreateLambda([OnSeekComplete](bool bWasSuccessful)
+	{
+		OnSeekComplete.ExecuteIfBound(bWasSuccessful);
+	}));
+
+	return true;
 }
 
 UDemoNetDriver* ULyraReplaySubsystem::GetDemoDriver() const
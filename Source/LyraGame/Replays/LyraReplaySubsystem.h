@@ -2,6 +2,9 @@
 
 #pragma once
 
+#include "Containers/Ticker.h"
+#include "GameFramework/GameplayMessageSubsystem.h"
+#include "LyraReplayStorageManager.h"
 #include "NetworkReplayStreaming.h"
 #include "Subsystems/GameInstanceSubsystem.h"
 #include "GameplayTagContainer.h"
@@ -12,6 +15,7 @@ class UDemoNetDriver;
 class APlayerController;
 class ULocalPlayer;
 struct FFrame;
+struct FLyraVerbMessage;
 
 /** An available replay for display in the UI */
 UCLASS(BlueprintType)
@@ -54,8 +58,39 @@ public:
 	TArray<TObjectPtr<ULyraReplayListEntry>> Results;
 };
 
-/** Subsystem to handle recording/loading replays */
-UCLASS()
+/** A gameplay event written to the event index of a replay while it was recorded */
+USTRUCT(BlueprintType)
+struct FLyraReplayEvent
+{
+	GENERATED_BODY()
+
+	/** The verb message that was broadcast, e.g. Lyra.Elimination.Message */
+	UPROPERTY(BlueprintReadOnly, Category=Replays)
+	FGameplayTag EventTag;
+
+	/** Replay time the event happened at */
+	UPROPERTY(BlueprintReadOnly, Category=Replays)
+	float TimeInSeconds = 0.0f;
+
+	UPROPERTY(BlueprintReadOnly, Category=Replays)
+	FString InstigatorName;
+
+	UPROPERTY(BlueprintReadOnly, Category=Replays)
+	FString TargetName;
+};
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE(FLyraReplayEventIndexUpdated);
+DECLARE_DELEGATE_OneParam(FLyraReplaySeekComplete, bool /*bWasSuccessful*/);
+
+/**
+ * Subsystem to handle recording/loading replays
+ *
+ * While a replay is recording, the verb messages listed in IndexedEventTags are written into the stream as replay events, and a
+ * checkpoint is requested at each of them and then every Lyra.Replay.EventCheckpointInterval seconds for
+ * Lyra.Replay.EventCheckpointWindow seconds afterwards.  During playback the events can be read back with RefreshReplayEventIndex
+ * without scanning the stream, and SeekToReplayEvent lands next to a checkpoint instead of fast forwarding from the last periodic one.
+ */
+UCLASS(Config=Game)
 class LYRAGAME_API ULyraReplaySubsystem : public UGameInstanceSubsystem
 {
 	GENERATED_BODY()
@@ -63,6 +98,11 @@ class LYRAGAME_API ULyraReplaySubsystem : public UGameInstanceSubsystem
 public:
 	ULyraReplaySubsystem();
 
+	//~USubsystem interface
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	//~End of USubsystem interface
+
 	/** Returns true if this platform supports replays at all */
 	UFUNCTION(BlueprintCallable, Category = Replays, BlueprintPure = false)
 	static bool DoesPlatformSupportReplays();
@@ -82,6 +122,10 @@ public:
 	UFUNCTION(BlueprintCallable, Category = Replays)
 	void CleanupLocalReplays(ULocalPlayer* LocalPlayer, int32 NumReplaysToKeep);
 
+	/** Starts deleting the local replays over any of the policy's budgets, oldest first, in one batch */
+	UFUNCTION(BlueprintCallable, Category = Replays)
+	void CleanupLocalReplaysWithPolicy(ULocalPlayer* LocalPlayer, const FLyraReplayStoragePolicy& Policy);
+
 	/** Move forward or back in currently playing replay */
 	UFUNCTION(BlueprintCallable, Category=Replays)
 	void SeekInActiveReplay(float TimeInSeconds);
@@ -94,16 +138,51 @@ public:
 	UFUNCTION(BlueprintCallable, Category=Replays, BlueprintPure=false)
 	float GetReplayCurrentTime() const;
 
-private:
-	TSharedPtr<INetworkReplayStreamer> CurrentReplayStreamer;
+	/** Replaces the events with the index of the replay that is playing, OnReplayEventIndexUpdated is called once it has been read */
+	UFUNCTION(BlueprintCallable, Category=Replays)
+	void RefreshReplayEventIndex();
 
-	UPROPERTY()
-	TObjectPtr<ULocalPlayer> LocalPlayerDeletingReplays;
+	/** Events of the replay being recorded, or of the one playing after RefreshReplayEventIndex, in time order */
+	UFUNCTION(BlueprintCallable, Category=Replays, BlueprintPure=false)
+	const TArray<FLyraReplayEvent>& GetReplayEvents() const { return ReplayEvents; }
+
+	/** Seeks the replay that is playing to Lyra.Replay.EventSeekLeadSeconds before an indexed event, returns false if the seek couldn't start */
+	UFUNCTION(BlueprintCallable, Category=Replays)
+	bool SeekToReplayEvent(int32 EventIndex);
+
+	/** Same as SeekToReplayEvent, calling OnSeekComplete once the replay has finished loading the checkpoint and fast forwarding */
+	bool SeekToReplayEventWithCallback(int32 EventIndex, const FLyraReplaySeekComplete& OnSeekComplete);
 
-	int32 DeletingReplaysNumberToKeep;
+	UPROPERTY(BlueprintAssignable, Category=Replays)
+	FLyraReplayEventIndexUpdated OnReplayEventIndexUpdated;
+
+	/** Replay event group the index is written to */
+	static const FString ReplayEventGroup;
+
+private:
+	TSharedPtr<FLyraReplayStorageManager> ReplayStorageManager;
 
 	UDemoNetDriver* GetDemoDriver() const;
 
-	void OnEnumerateStreamsCompleteForDelete(const FEnumerateStreamsResult& Result);
-	void OnDeleteReplay(const FDeleteFinishedStreamResult& DeleteResult);
+	void OnIndexedEventMessage(FGameplayTag Channel, const FLyraVerbMessage& Message);
+	void RequestEventCheckpoint(UDemoNetDriver* DemoDriver);
+	bool TickEventCheckpoints(float DeltaTime);
+	void OnEnumerateReplayEventsComplete(const FEnumerateEventsResult& Result);
+
+	/** Verb messages written to the event index of recorded replays */
+	UPROPERTY(Config)
+	TArray<FGameplayTag> IndexedEventTags;
+
+	TArray<FGameplayMessageListenerHandle> EventListenerHandles;
+
+	TArray<FLyraReplayEvent> ReplayEvents;
+
+	/** The replay ReplayEvents belongs to */
+	FString IndexedReplayName;
+
+	FTSTicker::FDelegateHandle EventCheckpointTickerHandle;
+
+	/** Replay time of the last checkpoint requested for an event, and until when they are requested */
+	float LastEventCheckpointTime = -1.0f;
+	float EventCheckpointWindowEndTime = -1.0f;
 };
@@ -53,23 +53,38 @@ bool ULyraGameSettingRegistry::IsFinishedInitializing() const
 
 void ULyraGameSettingRegistry::OnInitialize(ULocalPlayer* InLocalPlayer)
 {
-	ULyraLocalPlayer* LyraLocalPlayer = Cast<ULyraLocalPlayer>(InLocalPlayer);
-
-	VideoSettings = InitializeVideoSettings(LyraLocalPlayer);
-	InitializeVideoSettings_FrameRates(VideoSettings, LyraLocalPlayer);
-	RegisterSetting(VideoSettings);
+	// Each tab is built the first time the settings screen looks it up
+	RegisterLazySetting(TEXT("VideoCollection"), [this]() -> UGameSetting*
+	{
+		ULyraLocalPlayer* LyraLocalPlayer = Cast<ULyraLocalPlayer>(OwningLocalPlayer);
+		VideoSettings = InitializeVideoSettings(LyraLocalPlayer);
+		InitializeVideoSettings_FrameRates(VideoSettings, LyraLocalPlayer);
+		return VideoSettings;
+	});
 
-	AudioSettings = InitializeAudioSettings(LyraLocalPlayer);
-	RegisterSetting(AudioSettings);
+	RegisterLazySetting(TEXT("AudioCollection"), [this]() -> UGameSetting*
+	{
+		AudioSettings = InitializeAudioSettings(Cast<ULyraLocalPlayer>(OwningLocalPlayer));
+		return AudioSettings;
+	});
 
-	GameplaySettings = InitializeGameplaySettings(LyraLocalPlayer);
-	RegisterSetting(GameplaySettings);
+	RegisterLazySetting(TEXT("GameplayCollection"), [this]() -> UGameSetting*
+	{
+		GameplaySettings = InitializeGameplaySettings(Cast<ULyraLocalPlayer>(OwningLocalPlayer));
+		return GameplaySettings;
+	});
 
-	MouseAndKeyboardSettings = InitializeMouseAndKeyboardSettings(LyraLocalPlayer);
-	RegisterSetting(MouseAndKeyboardSettings);
+	RegisterLazySetting(TEXT("MouseAndKeyboardCollection"), [this]() -> UGameSetting*
+	{
+		MouseAndKeyboardSettings = InitializeMouseAndKeyboardSettings(Cast<ULyraLocalPlayer>(OwningLocalPlayer));
+		return MouseAndKeyboardSettings;
+	});
 
-	GamepadSettings = InitializeGamepadSettings(LyraLocalPlayer);
-	RegisterSetting(GamepadSettings);
+	RegisterLazySetting(TEXT("GamepadCollection"), [this]() -> UGameSetting*
+	{
+		GamepadSettings = InitializeGamepadSettings(Cast<ULyraLocalPlayer>(OwningLocalPlayer));
+		return GamepadSettings;
+	});
 }
 
 void ULyraGameSettingRegistry::SaveChanges()
@@ -36,7 +36,7 @@ DECLARE_LOG_CATEGORY_EXTERN(LogLyraGameSettingRegistry, Log, Log);
  * 
  */
 UCLASS()
-class ULyraGameSettingRegistry : public UGameSettingRegistry
+class LYRAGAME_API ULyraGameSettingRegistry : public UGameSettingRegistry
 {
 	GENERATED_BODY()
 
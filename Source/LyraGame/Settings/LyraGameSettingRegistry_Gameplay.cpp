@@ -94,6 +94,46 @@ UGameSettingCollection* ULyraGameSettingRegistry::InitializeGameplaySettings(ULy
 
 		}
 		//----------------------------------------------------------------------------------
+		{
+			UGameSettingValueDiscreteDynamic_Number* Setting = NewObject<UGameSettingValueDiscreteDynamic_Number>();
+			Setting->SetDevName(TEXT("ReplayStorageLimit"));
+			Setting->SetDisplayName(LOCTEXT("ReplayStorageLimitSetting_Name", "Replay Storage Limit"));
+			Setting->SetDescriptionRichText(LOCTEXT("ReplayStorageLimitSetting_Description", "Total size of saved replays to keep, the oldest are deleted first. Set to 0 for infinite."));
+
+			Setting->SetDynamicGetter(GET_LOCAL_SETTINGS_FUNCTION_PATH(GetReplayStorageLimitInMB));
+			Setting->SetDynamicSetter(GET_LOCAL_SETTINGS_FUNCTION_PATH(SetReplayStorageLimitInMB));
+			Setting->SetDefaultValue(GetDefault<ULyraSettingsLocal>()->GetReplayStorageLimitInMB());
+			for (int32 LimitInMB : { 0, 256, 512, 1024, 2048, 4096, 8192 })
+			{
+				Setting->AddOption(LimitInMB, (LimitInMB == 0) ? LOCTEXT("ReplayStorageLimit_None", "No Limit") : FText::AsMemory(static_cast<uint64>(LimitInMB) * 1024 * 1024));
+			}
+
+			Setting->AddEditCondition(FWhenPlayingAsPrimaryPlayer::Get());
+			Setting->AddEditCondition(FWhenPlatformHasTrait::KillIfMissing(ULyraReplaySubsystem::GetPlatformSupportTraitTag(), TEXT("Platform does not support saving replays")));
+
+			ReplaySubsection->AddSetting(Setting);
+		}
+		//----------------------------------------------------------------------------------
+		{
+			UGameSettingValueDiscreteDynamic_Number* Setting = NewObject<UGameSettingValueDiscreteDynamic_Number>();
+			Setting->SetDevName(TEXT("ReplayAgeLimit"));
+			Setting->SetDisplayName(LOCTEXT("ReplayAgeLimitSetting_Name", "Replay Age Limit"));
+			Setting->SetDescriptionRichText(LOCTEXT("ReplayAgeLimitSetting_Description", "Saved replays older than this many days are deleted. Set to 0 for infinite."));
+
+			Setting->SetDynamicGetter(GET_LOCAL_SETTINGS_FUNCTION_PATH(GetReplayAgeLimitInDays));
+			Setting->SetDynamicSetter(GET_LOCAL_SETTINGS_FUNCTION_PATH(SetReplayAgeLimitInDays));
+			Setting->SetDefaultValue(GetDefault<ULyraSettingsLocal>()->GetReplayAgeLimitInDays());
+			for (int32 LimitInDays : { 0, 1, 7, 14, 30, 90 })
+			{
+				Setting->AddOption(LimitInDays, FText::AsNumber(LimitInDays));
+			}
+
+			Setting->AddEditCondition(FWhenPlayingAsPrimaryPlayer::Get());
+			Setting->AddEditCondition(FWhenPlatformHasTrait::KillIfMissing(ULyraReplaySubsystem::GetPlatformSupportTraitTag(), TEXT("Platform does not support saving replays")));
+
+			ReplaySubsection->AddSetting(Setting);
+		}
+		//----------------------------------------------------------------------------------
 	}
 
 	return Screen;
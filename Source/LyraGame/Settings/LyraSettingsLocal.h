@@ -401,6 +401,16 @@ public:
 	UFUNCTION()
 	void SetNumberOfReplaysToKeep(int32 InNumberOfReplays) { NumberOfReplaysToKeep = InNumberOfReplays; }
 
+	UFUNCTION()
+	int32 GetReplayStorageLimitInMB() const { return ReplayStorageLimitInMB; }
+	UFUNCTION()
+	void SetReplayStorageLimitInMB(int32 InLimitInMB) { ReplayStorageLimitInMB = InLimitInMB; }
+
+	UFUNCTION()
+	int32 GetReplayAgeLimitInDays() const { return ReplayAgeLimitInDays; }
+	UFUNCTION()
+	void SetReplayAgeLimitInDays(int32 InLimitInDays) { ReplayAgeLimitInDays = InLimitInDays; }
+
 private:
 
 	UPROPERTY(Config)
@@ -409,6 +419,14 @@ private:
 	UPROPERTY(Config)
 	int32 NumberOfReplaysToKeep = 5;
 
+	// Total size of the saved replays to keep in MB, 0 for no limit
+	UPROPERTY(Config)
+	int32 ReplayStorageLimitInMB = 0;
+
+	// Saved replays older than this many days are deleted, 0 for no limit
+	UPROPERTY(Config)
+	int32 ReplayAgeLimitInDays = 0;
+
 private:
 	void OnAppActivationStateChanged(bool bIsActive);
 	void ReapplyThingsDueToPossibleDeviceProfileChange();
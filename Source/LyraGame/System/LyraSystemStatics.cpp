@@ -8,6 +8,7 @@
 #include "LyraLogChannels.h"
 #include "Components/MeshComponent.h"
 #include "GameModes/LyraUserFacingExperienceDefinition.h"
+#include "Teams/LyraTeamDisplayAsset.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(LyraSystemStatics)
 
@@ -78,6 +79,8 @@ void ULyraSystemStatics::SetScalarParameterValueOnAllMeshComponents(AActor* Targ
 	{
 		TargetActor->ForEachComponent<UMeshComponent>(bIncludeChildActors, [=](UMeshComponent* InComponent)
 		{
+			// Per-component values, they must not reach other meshes through a shared team material instance
+			ULyraTeamDisplayAsset::UnshareMaterialInstances(InComponent);
 			InComponent->SetScalarParameterValueOnMaterials(ParameterName, ParameterValue);
 		});
 	}
@@ -89,6 +92,8 @@ void ULyraSystemStatics::SetVectorParameterValueOnAllMeshComponents(AActor* Targ
 	{
 		TargetActor->ForEachComponent<UMeshComponent>(bIncludeChildActors, [=](UMeshComponent* InComponent)
 		{
+			// Per-component values, they must not reach other meshes through a shared team material instance
+			ULyraTeamDisplayAsset::UnshareMaterialInstances(InComponent);
 			InComponent->SetVectorParameterValueOnMaterials(ParameterName, ParameterValue);
 		});
 	}
@@ -6,11 +6,29 @@
 #include "NiagaraComponent.h"
 #include "Materials/MaterialInstanceDynamic.h"
 #include "Engine/Texture.h"
+#include "HAL/IConsoleManager.h"
 #include "Teams/LyraTeamSubsystem.h"
 #include "UObject/UObjectIterator.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(LyraTeamDisplayAsset)
 
+namespace LyraTeamDisplay
+{
+	static bool bShareMaterialInstances = true;
+	static FAutoConsoleVariableRef CVarShareMaterialInstances(
+		TEXT("Lyra.Teams.ShareMaterialInstances"),
+		bShareMaterialInstances,
+		TEXT("Should team display assets share one dynamic material instance per base material, and set parameters that use custom primitive data on the component?\n")
+		TEXT("  If false, every material slot of every mesh component gets its own dynamic material instance"),
+		ECVF_Default);
+
+	// Shared instances are owned by the display asset that created them, anything else belongs to the component
+	static bool IsSharedMaterial(const UMaterialInstanceDynamic* DynamicMaterial)
+	{
+		return DynamicMaterial && DynamicMaterial->GetOuter()->IsA<ULyraTeamDisplayAsset>();
+	}
+}
+
 void ULyraTeamDisplayAsset::ApplyToMaterial(UMaterialInstanceDynamic* Material)
 {
 	if (Material)
@@ -34,8 +52,15 @@ void ULyraTeamDisplayAsset::ApplyToMaterial(UMaterialInstanceDynamic* Material)
 
 void ULyraTeamDisplayAsset::ApplyToMeshComponent(UMeshComponent* MeshComponent)
 {
-	if (MeshComponent)
+	if (MeshComponent && LyraTeamDisplay::bShareMaterialInstances)
+	{
+		ApplySharedMaterialsToMeshComponent(MeshComponent);
+	}
+	else if (MeshComponent)
 	{
+		// The setters below would write through an instance shared before the cvar was turned off
+		UnshareMaterialInstances(MeshComponent);
+
 		for (const auto& KVP : ScalarParameters)
 		{
 			MeshComponent->SetScalarParameterValueOnMaterials(KVP.Key, KVP.Value);
@@ -66,6 +91,140 @@ void ULyraTeamDisplayAsset::ApplyToMeshComponent(UMeshComponent* MeshComponent)
 	}
 }
 
+void ULyraTeamDisplayAsset::UnshareMaterialInstances(UMeshComponent* MeshComponent)
+{
+	if (MeshComponent == nullptr)
+	{
+		return;
+	}
+
+	const int32 NumMaterials = MeshComponent->GetNumMaterials();
+	for (int32 MaterialIndex = 0; MaterialIndex < NumMaterials; ++MaterialIndex)
+	{
+		UMaterialInstanceDynamic* SharedMaterial = Cast<UMaterialInstanceDynamic>(MeshComponent->GetMaterial(MaterialIndex));
+		if (LyraTeamDisplay::IsSharedMaterial(SharedMaterial))
+		{
+			// Owned by the component from now on, team changes are then applied to it directly
+			UMaterialInstanceDynamic* OwnMaterial = UMaterialInstanceDynamic::Create(SharedMaterial->Parent, MeshComponent);
+			OwnMaterial->CopyParameterOverrides(SharedMaterial);
+			MeshComponent->SetMaterial(MaterialIndex, OwnMaterial);
+		}
+	}
+}
+
+void ULyraTeamDisplayAsset::ApplySharedMaterialsToMeshComponent(UMeshComponent* MeshComponent)
+{
+	const int32 NumMaterials = MeshComponent->GetNumMaterials();
+	for (int32 MaterialIndex = 0; MaterialIndex < NumMaterials; ++MaterialIndex)
+	{
+		UMaterialInterface* MaterialInterface = MeshComponent->GetMaterial(MaterialIndex);
+		if (!MaterialInterface)
+		{
+			continue;
+		}
+
+		// Look through the shared instance of whichever team was applied before
+		UMaterialInstanceDynamic* DynamicMaterial = Cast<UMaterialInstanceDynamic>(MaterialInterface);
+		const bool bIsSharedMaterial = LyraTeamDisplay::IsSharedMaterial(DynamicMaterial);
+		UMaterialInterface* BaseMaterial = (DynamicMaterial && DynamicMaterial->Parent) ? DynamicMaterial->Parent.Get() : MaterialInterface;
+
+		const FMaterialBindings& Bindings = FindOrAddMaterialBindings(BaseMaterial);
+		for (const TPair<int32, float>& ScalarData : Bindings.ScalarPrimitiveData)
+		{
+			MeshComponent->SetCustomPrimitiveDataFloat(ScalarData.Key, ScalarData.Value);
+		}
+
+		for (const TPair<int32, FVector4>& VectorData : Bindings.VectorPrimitiveData)
+		{
+			MeshComponent->SetCustomPrimitiveDataVector4(VectorData.Key, VectorData.Value);
+		}
+
+		if (DynamicMaterial && !bIsSharedMaterial)
+		{
+			// The component may have set its own parameters on it, so it can't be swapped for a shared one
+			ApplyToMaterial(DynamicMaterial);
+		}
+		else
+		{
+			UMaterialInterface* NewMaterial = Bindings.bNeedsMaterialInstance ? FindOrAddSharedMaterial(BaseMaterial) : BaseMaterial;
+			if (NewMaterial != MaterialInterface)
+			{
+				MeshComponent->SetMaterial(MaterialIndex, NewMaterial);
+			}
+		}
+	}
+}
+
+const ULyraTeamDisplayAsset::FMaterialBindings& ULyraTeamDisplayAsset::FindOrAddMaterialBindings(UMaterialInterface* BaseMaterial)
+{
+	if (const FMaterialBindings* ExistingBindings = MaterialBindings.Find(BaseMaterial))
+	{
+		return *ExistingBindings;
+	}
+
+	FMaterialBindings& Bindings = MaterialBindings.Add(BaseMaterial);
+
+	// Only global parameters, the ones the name based setters on dynamic material instances and components change
+	TMap<FMaterialParameterInfo, FMaterialParameterMetadata> Parameters;
+	BaseMaterial->GetAllParametersOfType(EMaterialParameterType::Scalar, Parameters);
+	for (const TPair<FMaterialParameterInfo, FMaterialParameterMetadata>& Parameter : Parameters)
+	{
+		const float* Value = (Parameter.Key.Association == EMaterialParameterAssociation::GlobalParameter) ? ScalarParameters.Find(Parameter.Key.Name) : nullptr;
+		if (Value && (Parameter.Value.PrimitiveDataIndex > INDEX_NONE))
+		{
+			Bindings.ScalarPrimitiveData.Emplace(Parameter.Value.PrimitiveDataIndex, *Value);
+		}
+		else if (Value)
+		{
+			Bindings.bNeedsMaterialInstance = true;
+		}
+	}
+
+	Parameters.Reset();
+	BaseMaterial->GetAllParametersOfType(EMaterialParameterType::Vector, Parameters);
+	for (const TPair<FMaterialParameterInfo, FMaterialParameterMetadata>& Parameter : Parameters)
+	{
+		const FLinearColor* Value = (Parameter.Key.Association == EMaterialParameterAssociation::GlobalParameter) ? ColorParameters.Find(Parameter.Key.Name) : nullptr;
+		if (Value && (Parameter.Value.PrimitiveDataIndex > INDEX_NONE))
+		{
+			// Matches the alpha SetVectorParameterValue gives a vector
+			Bindings.VectorPrimitiveData.Emplace(Parameter.Value.PrimitiveDataIndex, FVector4(FLinearColor(FVector(*Value))));
+		}
+		else if (Value)
+		{
+			Bindings.bNeedsMaterialInstance = true;
+		}
+	}
+
+	Parameters.Reset();
+	BaseMaterial->GetAllParametersOfType(EMaterialParameterType::Texture, Parameters);
+	for (const TPair<FMaterialParameterInfo, FMaterialParameterMetadata>& Parameter : Parameters)
+	{
+		if ((Parameter.Key.Association == EMaterialParameterAssociation::GlobalParameter) && TextureParameters.Contains(Parameter.Key.Name))
+		{
+			Bindings.bNeedsMaterialInstance = true;
+		}
+	}
+
+	return Bindings;
+}
+
+UMaterialInstanceDynamic* ULyraTeamDisplayAsset::FindOrAddSharedMaterial(UMaterialInterface* BaseMaterial)
+{
+	if (TObjectPtr<UMaterialInstanceDynamic>* ExistingMaterial = SharedMaterials.Find(BaseMaterial))
+	{
+		return *ExistingMaterial;
+	}
+
+	// Transient, so the asset is never saved with it
+	UMaterialInstanceDynamic* SharedMaterial = UMaterialInstanceDynamic::Create(BaseMaterial, this);
+	SharedMaterial->SetFlags(RF_Transient);
+	ApplyToMaterial(SharedMaterial);
+
+	SharedMaterials.Add(BaseMaterial, SharedMaterial);
+	return SharedMaterial;
+}
+
 void ULyraTeamDisplayAsset::ApplyToNiagaraComponent(UNiagaraComponent* NiagaraComponent)
 {
 	if (NiagaraComponent)
@@ -111,6 +270,14 @@ void ULyraTeamDisplayAsset::PostEditChangeProperty(FPropertyChangedEvent& Proper
 {
 	Super::PostEditChangeProperty(PropertyChangedEvent);
 
+	// Parameters may have been added or removed, so start the shared instances over before they are applied again
+	MaterialBindings.Reset();
+	for (const TPair<TObjectPtr<UMaterialInterface>, TObjectPtr<UMaterialInstanceDynamic>>& SharedMaterial : SharedMaterials)
+	{
+		SharedMaterial.Value->ClearParameterValues();
+		ApplyToMaterial(SharedMaterial.Value);
+	}
+
 	for (ULyraTeamSubsystem* TeamSubsystem : TObjectRange<ULyraTeamSubsystem>())
 	{
 		TeamSubsystem->NotifyTeamDisplayAssetModified(this);
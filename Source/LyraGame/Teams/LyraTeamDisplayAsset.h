@@ -3,19 +3,28 @@
 #pragma once
 
 #include "Engine/DataAsset.h"
+#include "UObject/ObjectKey.h"
 #include "LyraTeamDisplayAsset.generated.h"
 
 struct FPropertyChangedEvent;
 
 class UMaterialInstanceDynamic;
+class UMaterialInterface;
 class UMeshComponent;
 class UNiagaraComponent;
 class AActor;
 class UTexture;
 
 // Represents the display information for team definitions (e.g., colors, display names, textures, etc...)
+//
+// Mesh components share one dynamic material instance per base material and display asset instead of each creating
+// their own, and parameters their materials read from custom primitive data are set on the component instead.
+// Dynamic material instances the components already own are still written directly.
+// Anything that sets per-component material parameters has to call UnshareMaterialInstances on the component first,
+// the engine's setters on mesh components write to whichever instance is in the slot, shared or not.
+// Lyra.Teams.ShareMaterialInstances=0 creates a dynamic material instance per component material slot instead.
 UCLASS(BlueprintType)
-class ULyraTeamDisplayAsset : public UDataAsset
+class LYRAGAME_API ULyraTeamDisplayAsset : public UDataAsset
 {
 	GENERATED_BODY()
 	
@@ -45,6 +54,10 @@ public:
 	UFUNCTION(BlueprintCallable, Category=Teams, meta=(DefaultToSelf="TargetActor"))
 	void ApplyToActor(AActor* TargetActor, bool bIncludeChildActors = true);
 
+	// Replaces the shared team material instances of the component with copies it owns, so its own parameters don't reach other meshes
+	UFUNCTION(BlueprintCallable, Category=Teams)
+	static void UnshareMaterialInstances(UMeshComponent* MeshComponent);
+
 public:
 
 	//~UObject interface
@@ -52,4 +65,26 @@ public:
 	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
 #endif
 	//~End of UObject interface
+
+private:
+	// How the parameters of this asset reach a base material
+	struct FMaterialBindings
+	{
+		// Parameters the material reads from custom primitive data, by data index
+		TArray<TPair<int32, float>> ScalarPrimitiveData;
+		TArray<TPair<int32, FVector4>> VectorPrimitiveData;
+
+		// Whether the material has any other parameter of this asset, which needs a dynamic material instance
+		bool bNeedsMaterialInstance = false;
+	};
+
+	void ApplySharedMaterialsToMeshComponent(UMeshComponent* MeshComponent);
+	const FMaterialBindings& FindOrAddMaterialBindings(UMaterialInterface* BaseMaterial);
+	UMaterialInstanceDynamic* FindOrAddSharedMaterial(UMaterialInterface* BaseMaterial);
+
+	// One dynamic material instance per base material, shared by every mesh component this asset is applied to
+	UPROPERTY(Transient)
+	TMap<TObjectPtr<UMaterialInterface>, TObjectPtr<UMaterialInstanceDynamic>> SharedMaterials;
+
+	TMap<TObjectKey<UMaterialInterface>, FMaterialBindings> MaterialBindings;
 };
@@ -0,0 +1,440 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Tests/LyraTestControllerSoakTest.h"
+
+#include "AIController.h"
+#include "Character/LyraHealthComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/GameStateBase.h"
+#include "GameFramework/PlayerState.h"
+#include "GameModes/LyraBotCreationComponent.h"
+#include "GameModes/LyraExperienceManagerComponent.h"
+#include "HAL/PlatformFileManager.h"
+#include "Inventory/LyraInventoryItemDefinition.h"
+#include "Inventory/LyraInventoryItemInstance.h"
+#include "Inventory/LyraInventoryManagerComponent.h"
+#include "LyraLogChannels.h"
+#include "Misc/App.h"
+#include "Misc/CommandLine.h"
+#include "Misc/CoreDelegates.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "UObject/UObjectArray.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(LyraTestControllerSoakTest)
+
+//////////////////////////////////////////////////////////////////////
+// FLyraSoakFrameTimeHistogram
+
+void FLyraSoakFrameTimeHistogram::AddFrame(float FrameTimeMs)
+{
+	if (Buckets.IsEmpty())
+	{
+		Buckets.SetNumZeroed(NumBuckets);
+	}
+
+	const int32 BucketIndex = FMath::Clamp(FMath::FloorToInt32(FrameTimeMs / BucketSizeMs), 0, NumBuckets - 1);
+	++Buckets[BucketIndex];
+	++NumFrames;
+	MaxFrameTimeMs = FMath::Max(MaxFrameTimeMs, FrameTimeMs);
+}
+
+float FLyraSoakFrameTimeHistogram::GetPercentile(float Percentile) const
+{
+	if (NumFrames == 0)
+	{
+		return 0.0f;
+	}
+
+	const int64 FramesAtPercentile = FMath::CeilToInt64(NumFrames * FMath::Clamp(Percentile, 0.0f, 1.0f));
+
+	int64 FramesSoFar = 0;
+	for (int32 BucketIndex = 0; BucketIndex < Buckets.Num(); ++BucketIndex)
+	{
+		FramesSoFar += Buckets[BucketIndex];
+		if (FramesSoFar >= FramesAtPercentile)
+		{
+			// Report the upper edge of the bucket, but never more than the slowest frame seen
+			return FMath::Min((BucketIndex + 1) * BucketSizeMs, MaxFrameTimeMs);
+		}
+	}
+
+	return MaxFrameTimeMs;
+}
+
+void FLyraSoakFrameTimeHistogram::Reset()
+{
+	Buckets.Reset();
+	NumFrames = 0;
+	MaxFrameTimeMs = 0.0f;
+}
+
+//////////////////////////////////////////////////////////////////////
+// ULyraTestControllerSoakTest
+
+void ULyraTestControllerSoakTest::OnInit()
+{
+	Super::OnInit();
+
+	const TCHAR* CommandLine = FCommandLine::Get();
+	FParse::Value(CommandLine, TEXT("SoakMinutes="), SoakMinutes);
+	FParse::Value(CommandLine, TEXT("SoakWarmupMinutes="), WarmupMinutes);
+	FParse::Value(CommandLine, TEXT("SoakSampleSeconds="), SampleIntervalSeconds);
+	FParse::Value(CommandLine, TEXT("SoakBots="), NumBots);
+	FParse::Value(CommandLine, TEXT("SoakMaxP95Ms="), MaxFrameTimeP95Ms);
+	FParse::Value(CommandLine, TEXT("SoakMaxP99Ms="), MaxFrameTimeP99Ms);
+	FParse::Value(CommandLine, TEXT("SoakMaxGCPauseMs="), MaxGCPauseMs);
+	FParse::Value(CommandLine, TEXT("SoakMaxMemoryGrowthMB="), MaxMemoryGrowthMBPerHour);
+	FParse::Value(CommandLine, TEXT("SoakMaxObjectGrowth="), MaxObjectGrowthPerHour);
+
+	PreGarbageCollectHandle = FCoreUObjectDelegates::GetPreGarbageCollectDelegate().AddUObject(this, &ThisClass::HandlePreGarbageCollect);
+	PostGarbageCollectHandle = FCoreUObjectDelegates::GetPostGarbageCollect().AddUObject(this, &ThisClass::HandlePostGarbageCollect);
+	BeginFrameHandle = FCoreDelegates::OnBeginFrame.AddUObject(this, &ThisClass::HandleBeginFrame);
+	EndFrameHandle = FCoreDelegates::OnEndFrame.AddUObject(this, &ThisClass::HandleEndFrame);
+
+	UE_LOG(LogLyra, Display, TEXT("Soak test initialized: %.0f minutes with %d bots"), SoakMinutes, NumBots);
+}
+
+void ULyraTestControllerSoakTest::BeginDestroy()
+{
+	FCoreUObjectDelegates::GetPreGarbageCollectDelegate().Remove(PreGarbageCollectHandle);
+	FCoreUObjectDelegates::GetPostGarbageCollect().Remove(PostGarbageCollectHandle);
+	FCoreDelegates::OnBeginFrame.Remove(BeginFrameHandle);
+	FCoreDelegates::OnEndFrame.Remove(EndFrameHandle);
+
+	Super::BeginDestroy();
+}
+
+void ULyraTestControllerSoakTest::HandleBeginFrame()
+{
+	FrameStartCycles = FPlatformTime::Cycles64();
+}
+
+void ULyraTestControllerSoakTest::HandleEndFrame()
+{
+	if (!bSoakStarted || bSoakFinished || (FrameStartCycles == 0))
+	{
+		return;
+	}
+
+	// The frame includes the wait for the server's tick rate cap, which isn't work
+	const double FrameMs = FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - FrameStartCycles);
+	const float FrameWorkMs = static_cast<float>(FMath::Max(FrameMs - (FApp::GetIdleTime() * 1000.0), 0.0));
+	FrameStartCycles = 0;
+
+	if ((FPlatformTime::Seconds() - SoakStartTime) >= WarmupMinutes * 60.0)
+	{
+		RunFrameTimes.AddFrame(FrameWorkMs);
+	}
+	IntervalFrameTimes.AddFrame(FrameWorkMs);
+}
+
+void ULyraTestControllerSoakTest::HandlePreGarbageCollect()
+{
+	GCStartTime = FPlatformTime::Seconds();
+}
+
+void ULyraTestControllerSoakTest::HandlePostGarbageCollect()
+{
+	if (GCStartTime > 0.0)
+	{
+		const double PauseMs = (FPlatformTime::Seconds() - GCStartTime) * 1000.0;
+		IntervalMaxGCPauseMs = FMath::Max(IntervalMaxGCPauseMs, PauseMs);
+		++IntervalNumGCs;
+		GCStartTime = 0.0;
+	}
+}
+
+bool ULyraTestControllerSoakTest::IsMatchReady() const
+{
+	UWorld* World = GetWorld();
+	AGameStateBase* GameState = World ? World->GetGameState() : nullptr;
+	if (GameState == nullptr)
+	{
+		return false;
+	}
+
+	const ULyraExperienceManagerComponent* ExperienceComponent = GameState->FindComponentByClass<ULyraExperienceManagerComponent>();
+	return ExperienceComponent && ExperienceComponent->IsExperienceLoaded();
+}
+
+void ULyraTestControllerSoakTest::OnTick(float TimeDelta)
+{
+	Super::OnTick(TimeDelta);
+
+	if (bSoakFinished)
+	{
+		return;
+	}
+
+	if (!bSoakStarted)
+	{
+		if (IsMatchReady())
+		{
+			StartSoak();
+		}
+		return;
+	}
+
+	const double Now = FPlatformTime::Seconds();
+	const double Elapsed = Now - SoakStartTime;
+
+	if (Now >= NextCombatTime)
+	{
+		RunCombatCycle();
+		NextCombatTime = Now + CombatIntervalSeconds;
+	}
+
+	if (Now >= NextLootTime)
+	{
+		RunLootCycle();
+		NextLootTime = Now + LootIntervalSeconds;
+	}
+
+	if (Now >= NextPopulationTime)
+	{
+		RunPopulationCycle();
+		NextPopulationTime = Now + PopulationIntervalSeconds;
+	}
+
+	if (Now >= NextSampleTime)
+	{
+		RecordSample();
+		NextSampleTime = Now + SampleIntervalSeconds;
+	}
+
+	if (Elapsed >= SoakMinutes * 60.0)
+	{
+		FinishSoak();
+	}
+}
+
+void ULyraTestControllerSoakTest::StartSoak()
+{
+	bSoakStarted = true;
+
+	SoakStartTime = FPlatformTime::Seconds();
+	NextSampleTime = SoakStartTime + SampleIntervalSeconds;
+	NextCombatTime = SoakStartTime + CombatIntervalSeconds;
+	NextLootTime = SoakStartTime + LootIntervalSeconds;
+	NextPopulationTime = SoakStartTime + PopulationIntervalSeconds;
+
+	for (const TSoftClassPtr<ULyraInventoryItemDefinition>& ItemDefinition : LootItemDefinitions)
+	{
+		if (TSubclassOf<ULyraInventoryItemDefinition> LoadedDefinition = ItemDefinition.LoadSynchronous())
+		{
+			LoadedLootItemDefinitions.Add(LoadedDefinition);
+		}
+		else
+		{
+			UE_LOG(LogLyra, Warning, TEXT("Soak test could not load loot item definition %s"), *ItemDefinition.ToString());
+		}
+	}
+
+	if (LoadedLootItemDefinitions.IsEmpty())
+	{
+		UE_LOG(LogLyra, Error, TEXT("Soak test has no loot item definitions, inventories will not be exercised. Set LootItemDefinitions in [/Script/LyraGame.LyraTestControllerSoakTest]."));
+	}
+
+	if (ULyraBotCreationComponent* BotComponent = GetWorld()->GetGameState()->FindComponentByClass<ULyraBotCreationComponent>())
+	{
+		BotComponent->SetTargetBotCount(NumBots);
+	}
+	else
+	{
+		UE_LOG(LogLyra, Warning, TEXT("Soak test found no bot creation component, the population will not be scripted"));
+	}
+
+	const FString SoakDir = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Soak"));
+	FPlatformFileManager::Get().GetPlatformFile().CreateDirectoryTree(*SoakDir);
+	CsvFilename = FPaths::Combine(SoakDir, FString::Printf(TEXT("Soak_%s.csv"), *FDateTime::Now().ToString()));
+	WriteSampleLine(TEXT("ElapsedMinutes,Frames,P50Ms,P95Ms,P99Ms,MaxMs,NumGCs,MaxGCPauseMs,UObjects,UsedPhysicalMB,Bots,Kills,LootGrants"));
+
+	UE_LOG(LogLyra, Display, TEXT("Soak test started, writing samples to %s"), *CsvFilename);
+}
+
+TArray<AAIController*> ULyraTestControllerSoakTest::GetBotControllers() const
+{
+	TArray<AAIController*> Bots;
+	for (APlayerState* PlayerState : GetWorld()->GetGameState()->PlayerArray)
+	{
+		if (PlayerState && PlayerState->IsABot() && !PlayerState->IsInactive())
+		{
+			if (AAIController* Controller = Cast<AAIController>(PlayerState->GetOwner()))
+			{
+				Bots.Add(Controller);
+			}
+		}
+	}
+	return Bots;
+}
+
+void ULyraTestControllerSoakTest::RunCombatCycle()
+{
+	TArray<AAIController*> Bots = GetBotControllers();
+
+	for (int32 Kill = 0; (Kill < KillsPerCombatCycle) && !Bots.IsEmpty(); ++Kill)
+	{
+		AAIController* Bot = Bots[FMath::RandRange(0, Bots.Num() - 1)];
+		Bots.RemoveSingleSwap(Bot);
+
+		if (ULyraHealthComponent* HealthComponent = ULyraHealthComponent::FindHealthComponent(Bot->GetPawn()))
+		{
+			if (!HealthComponent->IsDeadOrDying())
+			{
+				HealthComponent->DamageSelfDestruct();
+				++NumKills;
+			}
+		}
+	}
+}
+
+void ULyraTestControllerSoakTest::RunLootCycle()
+{
+	// Drop last cycle's loot so inventories churn without growing
+	for (ULyraInventoryItemInstance* ItemInstance : GrantedLoot)
+	{
+		if (ItemInstance)
+		{
+			// Item instances are outered to the actor owning the inventory
+			const AActor* InventoryOwner = Cast<AActor>(ItemInstance->GetOuter());
+			if (ULyraInventoryManagerComponent* Inventory = InventoryOwner ? InventoryOwner->FindComponentByClass<ULyraInventoryManagerComponent>() : nullptr)
+			{
+				Inventory->RemoveItemInstance(ItemInstance);
+			}
+		}
+	}
+	GrantedLoot.Reset();
+
+	if (LoadedLootItemDefinitions.IsEmpty())
+	{
+		return;
+	}
+
+	TArray<AAIController*> Bots = GetBotControllers();
+	for (int32 Grant = 0; (Grant < LootGrantsPerCycle) && !Bots.IsEmpty(); ++Grant)
+	{
+		AAIController* Bot = Bots[FMath::RandRange(0, Bots.Num() - 1)];
+		if (ULyraInventoryManagerComponent* Inventory = Bot->FindComponentByClass<ULyraInventoryManagerComponent>())
+		{
+			const TSubclassOf<ULyraInventoryItemDefinition> ItemDefinition = LoadedLootItemDefinitions[FMath::RandRange(0, LoadedLootItemDefinitions.Num() - 1)];
+			if (ULyraInventoryItemInstance* ItemInstance = Inventory->AddItemDefinition(ItemDefinition, 1))
+			{
+				GrantedLoot.Add(ItemInstance);
+				++NumLootGrants;
+			}
+		}
+	}
+}
+
+void ULyraTestControllerSoakTest::RunPopulationCycle()
+{
+	if (ULyraBotCreationComponent* BotComponent = GetWorld()->GetGameState()->FindComponentByClass<ULyraBotCreationComponent>())
+	{
+		bPopulationReduced = !bPopulationReduced;
+		BotComponent->SetTargetBotCount(bPopulationReduced ? FMath::Max(NumBots - PopulationSwing, 0) : NumBots);
+	}
+}
+
+void ULyraTestControllerSoakTest::RecordSample()
+{
+	const double Now = FPlatformTime::Seconds();
+	const double ElapsedMinutes = (Now - SoakStartTime) / 60.0;
+	const double UsedPhysicalMB = FPlatformMemory::GetStats().UsedPhysical / (1024.0 * 1024.0);
+	const int32 NumObjects = GUObjectArray.GetObjectArrayNumMinusAvailable();
+	const int32 NumBotsAlive = GetBotControllers().Num();
+
+	WriteSampleLine(FString::Printf(TEXT("%.2f,%d,%.2f,%.2f,%.2f,%.2f,%d,%.2f,%d,%.1f,%d,%d,%d"),
+		ElapsedMinutes, IntervalFrameTimes.GetNumFrames(), IntervalFrameTimes.GetPercentile(0.5f), IntervalFrameTimes.GetPercentile(0.95f),
+		IntervalFrameTimes.GetPercentile(0.99f), IntervalFrameTimes.GetMaxFrameTimeMs(), IntervalNumGCs, IntervalMaxGCPauseMs,
+		NumObjects, UsedPhysicalMB, NumBotsAlive, NumKills, NumLootGrants));
+
+	if (ElapsedMinutes >= WarmupMinutes)
+	{
+		SampleTimes.Add(Now - SoakStartTime);
+		SampleUsedMemoryMB.Add(UsedPhysicalMB);
+		SampleObjectCounts.Add(NumObjects);
+		RunMaxGCPauseMs = FMath::Max(RunMaxGCPauseMs, IntervalMaxGCPauseMs);
+	}
+
+	IntervalFrameTimes.Reset();
+	IntervalMaxGCPauseMs = 0.0;
+	IntervalNumGCs = 0;
+}
+
+void ULyraTestControllerSoakTest::WriteSampleLine(const FString& Line)
+{
+	FFileHelper::SaveStringToFile(Line + LINE_TERMINATOR, *CsvFilename, FFileHelper::EEncodingOptions::ForceAnsi, &IFileManager::Get(), FILEWRITE_Append);
+}
+
+double ULyraTestControllerSoakTest::ComputeGrowthPerHour(TConstArrayView<double> SampleTimes, TConstArrayView<double> Values)
+{
+	const int32 NumSamples = FMath::Min(SampleTimes.Num(), Values.Num());
+	if (NumSamples < 2)
+	{
+		return 0.0;
+	}
+
+	double MeanTime = 0.0;
+	double MeanValue = 0.0;
+	for (int32 Index = 0; Index < NumSamples; ++Index)
+	{
+		MeanTime += SampleTimes[Index];
+		MeanValue += Values[Index];
+	}
+	MeanTime /= NumSamples;
+	MeanValue /= NumSamples;
+
+	double Covariance = 0.0;
+	double Variance = 0.0;
+	for (int32 Index = 0; Index < NumSamples; ++Index)
+	{
+		Covariance += (SampleTimes[Index] - MeanTime) * (Values[Index] - MeanValue);
+		Variance += FMath::Square(SampleTimes[Index] - MeanTime);
+	}
+
+	return (Variance > 0.0) ? (Covariance / Variance) * 3600.0 : 0.0;
+}
+
+void ULyraTestControllerSoakTest::FinishSoak()
+{
+	bSoakFinished = true;
+	RecordSample();
+
+	const float P95 = RunFrameTimes.GetPercentile(0.95f);
+	const float P99 = RunFrameTimes.GetPercentile(0.99f);
+	const double MemoryGrowth = ComputeGrowthPerHour(SampleTimes, SampleUsedMemoryMB);
+	const double ObjectGrowth = ComputeGrowthPerHour(SampleTimes, SampleObjectCounts);
+
+	TArray<FString> Failures;
+	if (P95 > MaxFrameTimeP95Ms)
+	{
+		Failures.Add(FString::Printf(TEXT("frame time p95 %.2f ms exceeds %.2f ms"), P95, MaxFrameTimeP95Ms));
+	}
+	if (P99 > MaxFrameTimeP99Ms)
+	{
+		Failures.Add(FString::Printf(TEXT("frame time p99 %.2f ms exceeds %.2f ms"), P99, MaxFrameTimeP99Ms));
+	}
+	if (RunMaxGCPauseMs > MaxGCPauseMs)
+	{
+		Failures.Add(FString::Printf(TEXT("GC pause %.2f ms exceeds %.2f ms"), RunMaxGCPauseMs, MaxGCPauseMs));
+	}
+	if (MemoryGrowth > MaxMemoryGrowthMBPerHour)
+	{
+		Failures.Add(FString::Printf(TEXT("memory grows %.1f MB/hour, limit %.1f"), MemoryGrowth, MaxMemoryGrowthMBPerHour));
+	}
+	if (ObjectGrowth > MaxObjectGrowthPerHour)
+	{
+		Failures.Add(FString::Printf(TEXT("UObject count grows %.0f/hour, limit %.0f"), ObjectGrowth, MaxObjectGrowthPerHour));
+	}
+
+	UE_LOG(LogLyra, Display, TEXT("Soak test finished after %.0f minutes: p95 %.2f ms, p99 %.2f ms, max GC pause %.2f ms, memory %+.1f MB/hour, UObjects %+.0f/hour, %d kills, %d loot grants"),
+		SoakMinutes, P95, P99, RunMaxGCPauseMs, MemoryGrowth, ObjectGrowth, NumKills, NumLootGrants);
+
+	for (const FString& Failure : Failures)
+	{
+		UE_LOG(LogLyra, Error, TEXT("Soak test failed: %s"), *Failure);
+	}
+
+	EndTest(Failures.IsEmpty() ? 0 : 1);
+}
@@ -0,0 +1,180 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "GauntletTestController.h"
+
+#include "LyraTestControllerSoakTest.generated.h"
+
+class AAIController;
+class ULyraInventoryItemDefinition;
+class ULyraInventoryItemInstance;
+class UObject;
+
+/** Frame times bucketed at 0.5ms, cheap enough to keep for a run lasting hours */
+struct FLyraSoakFrameTimeHistogram
+{
+	void AddFrame(float FrameTimeMs);
+	float GetPercentile(float Percentile) const;
+	void Reset();
+
+	int32 GetNumFrames() const { return NumFrames; }
+	float GetMaxFrameTimeMs() const { return MaxFrameTimeMs; }
+
+private:
+	static constexpr float BucketSizeMs = 0.5f;
+	static constexpr int32 NumBuckets = 2000;
+
+	TArray<uint32> Buckets;
+	int32 NumFrames = 0;
+	float MaxFrameTimeMs = 0.0f;
+};
+
+/**
+ * ULyraTestControllerSoakTest
+ *
+ * Unattended long running match for a -nullrhi dedicated server. Keeps a bot population alive and scripts combat, looting and
+ * respawn cycles on it, sampling frame time percentiles, UObject counts, GC pauses and memory at intervals into a CSV under
+ * Saved/Soak. The run fails if frame times or the growth rate of memory and UObjects after warmup exceed the configured limits.
+ *
+ * Example:
+ *   LyraServer /ShooterMaps/Maps/L_Expanse -nullrhi -unattended -gauntlet=LyraTestControllerSoakTest -SoakMinutes=240 -SoakBots=150
+ *
+ * Every setting can be changed in the [/Script/LyraGame.LyraTestControllerSoakTest] section of the game ini, and most of them
+ * on the command line.
+ */
+UCLASS(Config=Game)
+class ULyraTestControllerSoakTest : public UGauntletTestController
+{
+	GENERATED_BODY()
+
+protected:
+	//~UGauntletTestController interface
+	virtual void OnInit() override;
+	virtual void OnTick(float TimeDelta) override;
+	//~End of UGauntletTestController interface
+
+	//~UObject interface
+	virtual void BeginDestroy() override;
+	//~End of UObject interface
+
+private:
+	bool IsMatchReady() const;
+	void StartSoak();
+	void FinishSoak();
+
+	void RunCombatCycle();
+	void RunLootCycle();
+	void RunPopulationCycle();
+
+	void RecordSample();
+	void WriteSampleLine(const FString& Line);
+
+	/** Least squares slope of a sampled value, per hour */
+	static double ComputeGrowthPerHour(TConstArrayView<double> SampleTimes, TConstArrayView<double> Values);
+
+	void HandlePreGarbageCollect();
+	void HandlePostGarbageCollect();
+
+	// Frame times are measured around each engine frame, OnTick's delta on a tick rate capped server is just the tick interval
+	void HandleBeginFrame();
+	void HandleEndFrame();
+
+	TArray<AAIController*> GetBotControllers() const;
+
+protected:
+	// How long the soak runs after the match started
+	UPROPERTY(Config)
+	float SoakMinutes = 240.0f;
+
+	// Growth and frame time checks ignore the first few minutes, while caches and pools fill up
+	UPROPERTY(Config)
+	float WarmupMinutes = 10.0f;
+
+	UPROPERTY(Config)
+	float SampleIntervalSeconds = 60.0f;
+
+	UPROPERTY(Config)
+	int32 NumBots = 100;
+
+	// Every CombatIntervalSeconds this many random bots are killed, forcing death and respawn cycles on top of the AI fighting
+	UPROPERTY(Config)
+	float CombatIntervalSeconds = 10.0f;
+
+	UPROPERTY(Config)
+	int32 KillsPerCombatCycle = 4;
+
+	// Every LootIntervalSeconds items are granted to random bots; the items granted in the previous cycle are removed
+	UPROPERTY(Config)
+	float LootIntervalSeconds = 15.0f;
+
+	UPROPERTY(Config)
+	int32 LootGrantsPerCycle = 8;
+
+	UPROPERTY(Config)
+	TArray<TSoftClassPtr<ULyraInventoryItemDefinition>> LootItemDefinitions;
+
+	// Every PopulationIntervalSeconds the bot population drops by PopulationSwing and is restored on the next cycle
+	UPROPERTY(Config)
+	float PopulationIntervalSeconds = 300.0f;
+
+	UPROPERTY(Config)
+	int32 PopulationSwing = 20;
+
+	// Failure thresholds, checked over the samples taken after warmup
+	UPROPERTY(Config)
+	float MaxFrameTimeP95Ms = 50.0f;
+
+	UPROPERTY(Config)
+	float MaxFrameTimeP99Ms = 100.0f;
+
+	UPROPERTY(Config)
+	float MaxGCPauseMs = 250.0f;
+
+	UPROPERTY(Config)
+	float MaxMemoryGrowthMBPerHour = 64.0f;
+
+	UPROPERTY(Config)
+	float MaxObjectGrowthPerHour = 20000.0f;
+
+private:
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<ULyraInventoryItemInstance>> GrantedLoot;
+
+	UPROPERTY(Transient)
+	TArray<TSubclassOf<ULyraInventoryItemDefinition>> LoadedLootItemDefinitions;
+
+	bool bSoakStarted = false;
+	bool bSoakFinished = false;
+	bool bPopulationReduced = false;
+
+	double SoakStartTime = 0.0;
+	double NextSampleTime = 0.0;
+	double NextCombatTime = 0.0;
+	double NextLootTime = 0.0;
+	double NextPopulationTime = 0.0;
+
+	uint64 FrameStartCycles = 0;
+	FLyraSoakFrameTimeHistogram IntervalFrameTimes;
+	FLyraSoakFrameTimeHistogram RunFrameTimes;
+
+	double GCStartTime = 0.0;
+	double IntervalMaxGCPauseMs = 0.0;
+	double RunMaxGCPauseMs = 0.0;
+	int32 IntervalNumGCs = 0;
+
+	// Samples taken after warmup, used for the growth checks
+	TArray<double> SampleTimes;
+	TArray<double> SampleUsedMemoryMB;
+	TArray<double> SampleObjectCounts;
+
+	int32 NumKills = 0;
+	int32 NumLootGrants = 0;
+
+	FString CsvFilename;
+
+	FDelegateHandle PreGarbageCollectHandle;
+	FDelegateHandle PostGarbageCollectHandle;
+	FDelegateHandle BeginFrameHandle;
+	FDelegateHandle EndFrameHandle;
+};
@@ -5,6 +5,7 @@
 #include "GameFramework/Pawn.h"
 #include "GameFramework/CharacterMovementComponent.h"
 #include "Camera/LyraCameraComponent.h"
+#include "HAL/IConsoleManager.h"
 #include "Physics/PhysicalMaterialWithTags.h"
 #include "Weapons/LyraWeaponInstance.h"
 
@@ -12,6 +13,17 @@
 
 UE_DEFINE_GAMEPLAY_TAG_STATIC(TAG_Lyra_Weapon_SteadyAimingCamera, "Lyra.Weapon.SteadyAimingCamera");
 
+namespace LyraRangedWeapon
+{
+	static bool bCachePhysicalMaterialMultipliers = true;
+	static FAutoConsoleVariableRef CVarCachePhysicalMaterialMultipliers(
+		TEXT("Lyra.Weapon.CachePhysicalMaterialMultipliers"),
+		bCachePhysicalMaterialMultipliers,
+		TEXT("Should ranged weapons remember the combined damage multiplier of each physical material they hit?\n")
+		TEXT("  If false, the multipliers of the material's tags are looked up and combined on every hit"),
+		ECVF_Default);
+}
+
 ULyraRangedWeaponInstance::ULyraRangedWeaponInstance(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
 {
@@ -33,6 +45,8 @@ void ULyraRangedWeaponInstance::PostEditChangeProperty(struct FPropertyChangedEv
 {
 	Super::PostEditChangeProperty(PropertyChangedEvent);
 	UpdateDebugVisualization();
+
+	PhysicalMaterialMultipliers.Reset();
 }
 
 void ULyraRangedWeaponInstance::UpdateDebugVisualization()
@@ -129,6 +143,36 @@ float ULyraRangedWeaponInstance::GetDistanceAttenuation(float Distance, const FG
 }
 
 float ULyraRangedWeaponInstance::GetPhysicalMaterialAttenuation(const UPhysicalMaterial* PhysicalMaterial, const FGameplayTagContainer* SourceTags, const FGameplayTagContainer* TargetTags) const
+{
+	if (!PhysicalMaterial || MaterialDamageMultiplier.IsEmpty())
+	{
+		return 1.0f;
+	}
+
+	if (!LyraRangedWeapon::bCachePhysicalMaterialMultipliers)
+	{
+		return ComputePhysicalMaterialAttenuation(PhysicalMaterial);
+	}
+
+#if WITH_EDITOR
+	if (PhysicalMaterialMultipliersRevision != UPhysicalMaterialWithTags::GetTagsRevision())
+	{
+		PhysicalMaterialMultipliersRevision = UPhysicalMaterialWithTags::GetTagsRevision();
+		PhysicalMaterialMultipliers.Reset();
+	}
+#endif
+
+	if (const float* CachedMultiplier = PhysicalMaterialMultipliers.Find(PhysicalMaterial))
+	{
+		return *CachedMultiplier;
+	}
+
+	const float CombinedMultiplier = ComputePhysicalMaterialAttenuation(PhysicalMaterial);
+	PhysicalMaterialMultipliers.Add(PhysicalMaterial, CombinedMultiplier);
+	return CombinedMultiplier;
+}
+
+float ULyraRangedWeaponInstance::ComputePhysicalMaterialAttenuation(const UPhysicalMaterial* PhysicalMaterial) const
 {
 	float CombinedMultiplier = 1.0f;
 	if (const UPhysicalMaterialWithTags* PhysMatWithTags = Cast<const UPhysicalMaterialWithTags>(PhysicalMaterial))
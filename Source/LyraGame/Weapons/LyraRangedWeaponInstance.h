@@ -3,6 +3,7 @@
 #pragma once
 
 #include "Curves/CurveFloat.h"
+#include "UObject/ObjectKey.h"
 
 #include "LyraWeaponInstance.h"
 #include "AbilitySystem/LyraAbilitySourceInterface.h"
@@ -17,7 +18,7 @@ class UPhysicalMaterial;
  * A piece of equipment representing a ranged weapon spawned and applied to a pawn
  */
 UCLASS()
-class ULyraRangedWeaponInstance : public ULyraWeaponInstance, public ILyraAbilitySourceInterface
+class LYRAGAME_API ULyraRangedWeaponInstance : public ULyraWeaponInstance, public ILyraAbilitySourceInterface
 {
 	GENERATED_BODY()
 
@@ -214,6 +215,13 @@ private:
 	// The current crouching multiplier
 	float CrouchingMultiplier = 1.0f;
 
+	// MaterialDamageMultiplier combined for each physical material hit so far, cleared when the weapon or a physical material is edited
+	mutable TMap<TObjectKey<UPhysicalMaterial>, float> PhysicalMaterialMultipliers;
+
+#if WITH_EDITOR
+	mutable uint32 PhysicalMaterialMultipliersRevision = 0;
+#endif
+
 public:
 	void Tick(float DeltaSeconds);
 
@@ -247,4 +255,7 @@ private:
 
 	// Updates the multipliers and returns true if they are at minimum
 	bool UpdateMultipliers(float DeltaSeconds);
+
+	// Combines the multipliers of every tag of PhysicalMaterial
+	float ComputePhysicalMaterialAttenuation(const UPhysicalMaterial* PhysicalMaterial) const;
 };
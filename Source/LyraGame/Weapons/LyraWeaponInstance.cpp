@@ -33,6 +33,17 @@ ULyraWeaponInstance::ULyraWeaponInstance(const FObjectInitializer& ObjectInitial
 	}
 }
 
+#if WITH_EDITOR
+void ULyraWeaponInstance::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+
+	// The anim sets don't notice rules edited in place
+	EquippedAnimSet.ResetRuleSelection();
+	UneuippedAnimSet.ResetRuleSelection();
+}
+#endif
+
 void ULyraWeaponInstance::OnEquipped()
 {
 	Super::OnEquipped();
@@ -27,6 +27,12 @@ class LYRAGAME_API ULyraWeaponInstance : public ULyraEquipmentInstance
 public:
 	ULyraWeaponInstance(const FObjectInitializer& ObjectInitializer = FObjectInitializer::Get());
 
+	//~UObject interface
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+	//~End of UObject interface
+
 	//~ULyraEquipmentInstance interface
 	virtual void OnEquipped() override;
 	virtual void OnUnequipped() override;